@@ -0,0 +1,153 @@
+# Asset compiler: embeds files into a generated C++ source as static byte arrays with an index
+# (see include/asset_bundle.h). Run in script mode at build time:
+#
+#   cmake -DOUTPUT=<file.cpp> -DRAW_FILES=<a;b> [-DASSETS_DIR=<dir>] -P embed_assets.cmake
+#
+# RAW_FILES are stored uncompressed under their file name (e.g. settings.html, which is loaded
+# as a string). Every file under ASSETS_DIR is stored under its relative path; text types are
+# gzip-compressed when that makes them smaller (needs CMake >= 3.18, else stored as-is).
+# Each entry carries the SHA-256 prefix of the original content for ETags / cache busting.
+
+cmake_minimum_required(VERSION 3.15)
+
+if(NOT OUTPUT)
+    message(FATAL_ERROR "embed_assets.cmake: OUTPUT is required")
+endif()
+
+get_filename_component(_OUT_DIR "${OUTPUT}" DIRECTORY)
+set(_TMP_DIR "${_OUT_DIR}/embed_assets_tmp")
+file(REMOVE_RECURSE "${_TMP_DIR}")
+file(MAKE_DIRECTORY "${_TMP_DIR}")
+
+function(_asset_mime_type path out_var)
+    string(TOLOWER "${path}" _p)
+    get_filename_component(_ext "${_p}" LAST_EXT)
+    set(_mime "application/octet-stream")
+    if(_ext STREQUAL ".html" OR _ext STREQUAL ".htm")
+        set(_mime "text/html; charset=utf-8")
+    elseif(_ext STREQUAL ".js" OR _ext STREQUAL ".mjs")
+        set(_mime "text/javascript; charset=utf-8")
+    elseif(_ext STREQUAL ".css")
+        set(_mime "text/css; charset=utf-8")
+    elseif(_ext STREQUAL ".json" OR _ext STREQUAL ".map")
+        set(_mime "application/json")
+    elseif(_ext STREQUAL ".svg")
+        set(_mime "image/svg+xml")
+    elseif(_ext STREQUAL ".txt")
+        set(_mime "text/plain; charset=utf-8")
+    elseif(_ext STREQUAL ".wasm")
+        set(_mime "application/wasm")
+    elseif(_ext STREQUAL ".png")
+        set(_mime "image/png")
+    elseif(_ext STREQUAL ".jpg" OR _ext STREQUAL ".jpeg")
+        set(_mime "image/jpeg")
+    elseif(_ext STREQUAL ".gif")
+        set(_mime "image/gif")
+    elseif(_ext STREQUAL ".webp")
+        set(_mime "image/webp")
+    elseif(_ext STREQUAL ".ico")
+        set(_mime "image/x-icon")
+    elseif(_ext STREQUAL ".woff")
+        set(_mime "font/woff")
+    elseif(_ext STREQUAL ".woff2")
+        set(_mime "font/woff2")
+    elseif(_ext STREQUAL ".ttf")
+        set(_mime "font/ttf")
+    endif()
+    set(${out_var} "${_mime}" PARENT_SCOPE)
+endfunction()
+
+# Byte array initializer for a file (16 bytes per line)
+function(_asset_bytes file out_var)
+    file(READ "${file}" _hex HEX)
+    string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," _bytes "${_hex}")
+    string(REPEAT "0x..," 16 _line)  # CMake regex has no {n} repetition
+    string(REGEX REPLACE "(${_line})" "\\1\n    " _bytes "${_bytes}")
+    set(${out_var} "${_bytes}" PARENT_SCOPE)
+endfunction()
+
+# Collect (key, source file, may-compress) triples; keys sorted for binary search
+set(_KEYS "")
+foreach(_f IN LISTS RAW_FILES)
+    get_filename_component(_name "${_f}" NAME)
+    list(APPEND _KEYS "${_name}")
+    set(_SRC_${_name} "${_f}")
+    set(_RAW_${_name} TRUE)
+endforeach()
+if(ASSETS_DIR AND IS_DIRECTORY "${ASSETS_DIR}")
+    file(GLOB_RECURSE _ASSET_FILES LIST_DIRECTORIES false RELATIVE "${ASSETS_DIR}" "${ASSETS_DIR}/*")
+    foreach(_rel IN LISTS _ASSET_FILES)
+        if(_rel MATCHES "(^|/)\\.")
+            continue()  # skip dotfiles (.DS_Store, .gitkeep, ...)
+        endif()
+        if(DEFINED _SRC_${_rel})
+            message(WARNING "embed_assets: ${_rel} from ${ASSETS_DIR} replaces an earlier entry")
+        else()
+            list(APPEND _KEYS "${_rel}")
+        endif()
+        set(_SRC_${_rel} "${ASSETS_DIR}/${_rel}")
+        set(_RAW_${_rel} FALSE)
+    endforeach()
+endif()
+list(SORT _KEYS)
+
+set(_ARRAYS "")
+set(_INDEX "")
+set(_N 0)
+set(_TOTAL_IN 0)
+set(_TOTAL_OUT 0)
+foreach(_key IN LISTS _KEYS)
+    set(_src "${_SRC_${_key}}")
+    file(SIZE "${_src}" _size)
+    file(SHA256 "${_src}" _sha)
+    string(SUBSTRING "${_sha}" 0 16 _hash)
+    _asset_mime_type("${_key}" _mime)
+
+    set(_data "${_src}")
+    set(_encoding "Identity")
+    if(NOT _RAW_${_key} AND _size GREATER 256 AND CMAKE_VERSION VERSION_GREATER_EQUAL 3.18
+       AND (_mime MATCHES "^text/" OR _mime MATCHES "json|javascript|svg|wasm|x-icon|font/ttf"))
+        set(_gz "${_TMP_DIR}/${_N}.gz")
+        file(ARCHIVE_CREATE OUTPUT "${_gz}" PATHS "${_src}" FORMAT raw COMPRESSION GZip)
+        file(SIZE "${_gz}" _gz_size)
+        if(_gz_size LESS _size)
+            set(_data "${_gz}")
+            set(_encoding "Gzip")
+        endif()
+    endif()
+    file(SIZE "${_data}" _stored)
+    math(EXPR _TOTAL_IN "${_TOTAL_IN} + ${_size}")
+    math(EXPR _TOTAL_OUT "${_TOTAL_OUT} + ${_stored}")
+
+    _asset_bytes("${_data}" _bytes)
+    if(_stored EQUAL 0)
+        set(_bytes "0x00,")  # zero-length arrays are not valid C++; size below stays 0
+    endif()
+    string(APPEND _ARRAYS "// ${_key}\nalignas(16) const unsigned char kAsset${_N}[] = {\n    ${_bytes}\n};\n\n")
+    string(APPEND _INDEX "    {\"${_key}\", kAsset${_N}, ${_stored}, ${_size}, \"${_mime}\", asset_bundle::Encoding::${_encoding}, \"${_hash}\"},\n")
+    math(EXPR _N "${_N} + 1")
+endforeach()
+
+if(_N EQUAL 0)
+    set(_TABLE "const asset_bundle::Asset* kAssets = nullptr;\n")
+else()
+    set(_TABLE "const asset_bundle::Asset kAssets[] = {\n${_INDEX}};\n")
+endif()
+
+set(_CPP "// Auto-generated by cmake/embed_assets.cmake - do not edit.
+#include \"asset_bundle.h\"
+
+namespace {
+
+${_ARRAYS}${_TABLE}
+} // namespace
+
+const asset_bundle::Asset* asset_bundle::entries(size_t& count) {
+    count = ${_N};
+    return kAssets;
+}
+")
+
+file(WRITE "${OUTPUT}" "${_CPP}")
+file(REMOVE_RECURSE "${_TMP_DIR}")
+message(STATUS "Embedded ${_N} asset(s): ${_TOTAL_IN} bytes -> ${_TOTAL_OUT} bytes")
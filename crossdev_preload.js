@@ -10,6 +10,9 @@
  * Binary support: Pass ArrayBuffer/Uint8Array in payload - auto base64. Use
  * invoke(type, payload, { binaryResponse: true }) to decode result.data to ArrayBuffer.
  *
+ * Shared state: CrossDev.state.get/set/subscribe(key) - one native copy for all windows;
+ * subscribers receive only JSON-patch deltas ("state:changed" event) since their version.
+ *
  * Platform support:
  * - WebKit (macOS/iOS): window.webkit.messageHandlers.nativeMessage
  * - WebView2 (Windows): window.chrome.webview.postMessage + addEventListener('message')
@@ -126,6 +129,67 @@
     }
   }
 
+  // Shared state (CrossDev.state): local copy per key, kept current by JSON-patch deltas
+  var _state = {}
+  function _stEntry(key) {
+    return _state[key] || (_state[key] = { version: 0, value: null, listeners: [] })
+  }
+  function _stApply(doc, patch) {
+    for (var i = 0; i < patch.length; i++) {
+      var op = patch[i]
+      var keys =
+        op.path === ''
+          ? []
+          : op.path
+              .slice(1)
+              .split('/')
+              .map(function (s) {
+                return s.replace(/~1/g, '/').replace(/~0/g, '~')
+              })
+      if (!keys.length) {
+        doc = op.op === 'remove' ? null : op.value
+        continue
+      }
+      var parent = doc
+      for (var j = 0; j < keys.length - 1; j++) parent = parent[keys[j]]
+      var last = keys[keys.length - 1]
+      if (Array.isArray(parent)) {
+        var idx = last === '-' ? parent.length : parseInt(last, 10)
+        if (op.op === 'add') parent.splice(idx, 0, op.value)
+        else if (op.op === 'remove') parent.splice(idx, 1)
+        else parent[idx] = op.value
+      } else if (op.op === 'remove') delete parent[last]
+      else parent[last] = op.value
+    }
+    return doc
+  }
+  // Apply a delta from native ({key, fromVersion, version, patch|value}). Out of sync: refetch.
+  function _stDelta(d, quiet) {
+    var s = _stEntry(d.key)
+    if ('value' in d) s.value = d.value
+    else if (d.fromVersion === s.version) s.value = _stApply(s.value, d.patch)
+    else
+      return CrossDev.invoke('stateGet', { key: d.key, sinceVersion: s.version }).then(function (r) {
+        return _stDelta(r, quiet)
+      })
+    var changed = d.version !== s.version
+    s.version = d.version
+    if (changed && !quiet)
+      s.listeners.forEach(function (fn) {
+        try {
+          fn(s.value, s.version)
+        } catch (err) {
+          console.error(err)
+        }
+      })
+    return s.value
+  }
+  _eventListeners['state:changed'] = [
+    function (d) {
+      _stDelta(d)
+    },
+  ]
+
   var CrossDev = {
     invoke: function (type, payload, opts) {
       var opt = opts || {}
@@ -164,8 +228,44 @@
         }
       },
     },
+    state: {
+      get: function (key) {
+        return CrossDev.invoke('stateGet', { key: key, sinceVersion: _stEntry(key).version }).then(
+          function (d) {
+            return _stDelta(d)
+          },
+        )
+      },
+      set: function (key, value) {
+        return CrossDev.invoke('stateSet', { key: key, value: value }).then(function (r) {
+          return r.version
+        })
+      },
+      // fn(value, version) is called with the current value, then on every change
+      subscribe: function (key, fn) {
+        var s = _stEntry(key)
+        s.listeners.push(fn)
+        var p =
+          s.listeners.length === 1
+            ? CrossDev.invoke('stateSubscribe', { key: key, sinceVersion: s.version }).then(
+                function (d) {
+                  return _stDelta(d, true)
+                },
+              )
+            : Promise.resolve(s.value)
+        p.then(function (v) {
+          fn(v, s.version)
+        })
+        return function () {
+          var i = s.listeners.indexOf(fn)
+          if (i >= 0) s.listeners.splice(i, 1)
+          if (!s.listeners.length) CrossDev.invoke('stateUnsubscribe', { key: key })
+        }
+      },
+    },
   }
   Object.freeze(CrossDev.events)
+  Object.freeze(CrossDev.state)
   Object.freeze(CrossDev)
   try {
     Object.defineProperty(window, 'CrossDev', {
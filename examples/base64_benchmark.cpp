@@ -0,0 +1,57 @@
+#include "../include/base64.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+// Throughput of every base64 kernel the CPU supports, over payload sizes seen in binary
+// transfers (small IPC messages up to large readFile chunks).
+//   base64_benchmark [megabytes per measurement, default 256]
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    double volumeMb = argc > 1 ? std::atof(argv[1]) : 256.0;
+    const size_t sizes[] = {256, 4 * 1024, 64 * 1024, 1024 * 1024, 16 * 1024 * 1024};
+
+    std::mt19937 rng(42);
+    std::vector<unsigned char> data(sizes[sizeof(sizes) / sizeof(sizes[0]) - 1]);
+    for (auto& b : data) b = static_cast<unsigned char>(rng());
+    std::vector<char> encoded(base64::encodedSize(data.size()));
+    std::vector<unsigned char> decoded(data.size());
+
+    std::printf("%-8s %10s %14s %14s\n", "kernel", "size", "encode MB/s", "decode MB/s");
+    for (base64::Kernel kernel : base64::supportedKernels()) {
+        base64::setKernel(kernel);
+        for (size_t size : sizes) {
+            size_t iterations = static_cast<size_t>(volumeMb * 1024 * 1024 / size) + 1;
+            size_t encodedLen = base64::encodedSize(size);
+
+            auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < iterations; ++i) {
+                base64::encode(data.data(), size, encoded.data());
+            }
+            double encodeSeconds = secondsSince(start);
+
+            size_t written = 0;
+            bool ok = true;
+            start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < iterations; ++i) {
+                ok = base64::decode(encoded.data(), encodedLen, decoded.data(), written) && ok;
+            }
+            double decodeSeconds = secondsSince(start);
+            if (!ok || written != size) {
+                std::fprintf(stderr, "%s: decode failed at size %zu\n", base64::kernelName(kernel), size);
+                return 1;
+            }
+
+            double mb = static_cast<double>(size) * iterations / (1024.0 * 1024.0);
+            std::printf("%-8s %10zu %14.0f %14.0f\n", base64::kernelName(kernel), size,
+                        mb / encodeSeconds, mb / decodeSeconds);
+        }
+    }
+    return 0;
+}
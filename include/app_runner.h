@@ -2,10 +2,14 @@
 #define APP_RUNNER_H
 
 #include "webview_window.h"
+#include "message_router.h"
 #include <string>
 #include <memory>
+#include <future>
+#include <vector>
 
 class EventHandler;
+class SingleInstance;
 
 // Encapsulates application setup: config, main window, event handling, and handler registration.
 // Keeps main.cpp minimal and separates bootstrap logic for maintainability.
@@ -18,17 +22,33 @@ public:
     int run();
 
 private:
+    using RegisterAppHandlersFn = void (*)(MessageRouter*);
+
+    // Start work that does not touch the UI toolkit (options/preload read, plugin dlopen)
+    // on worker threads so it overlaps platform init and main window creation.
+    void startBackgroundLoads();
+    // Single-instance mode: true if a running instance took this launch's paths (exit now).
+    // --new-instance opts out.
+    bool forwardToRunningInstance();
     void loadConfig();
     void createMainWindow();
     void setupEventHandler();
     void registerHandlers();
+    // Extra (lazily built) handlers for a child window's router
+    std::vector<MessageRouter::LazyHandler> childWindowHandlers(const std::string& name, WebView* webView);
 
     int argc_;
     const char** argv_;
     std::string loadingMethod_;
     WebViewContentType contentType_;
     std::string content_;
+    std::string preloadScript_;
+    std::vector<std::string> precache_;  // url mode: assets to warm in the disk cache after first paint
 
+    std::future<void> configFuture_;
+    std::future<RegisterAppHandlersFn> pluginFuture_;
+
+    std::unique_ptr<SingleInstance> singleInstance_;  // set while this process is the primary
     std::unique_ptr<EventHandler> eventHandler_;
     std::shared_ptr<WebViewWindow> mainWindow_;
 };
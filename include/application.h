@@ -6,6 +6,9 @@ class Application {
 public:
     static Application& getInstance();
     
+    // Initialize the platform toolkit (GTK/Cocoa/Win32) without entering the run loop.
+    // Safe to call more than once; run() calls it too.
+    void init();
     void run();
     void quit();
     
@@ -0,0 +1,48 @@
+#ifndef ASSET_BUNDLE_H
+#define ASSET_BUNDLE_H
+
+#include <cstddef>
+#include <string>
+
+// Web assets compiled into the binary at build time (cmake/embed_assets.cmake): settings.html
+// plus the optional CROSSDEV_WEB_ASSETS_DIR web app. Served by the native app scheme
+// (crossdev://app/<path>) straight from static storage.
+namespace asset_bundle {
+
+enum class Encoding {
+    Identity,  // data is the file content
+    Gzip       // data is a gzip stream of the file content
+};
+
+struct Asset {
+    const char* path;           // relative to the bundle root, '/' separated, no leading '/'
+    const unsigned char* data;  // static storage; never freed
+    size_t size;                // bytes in data
+    size_t originalSize;        // bytes after decoding
+    const char* mimeType;
+    Encoding encoding;
+    const char* hash;           // SHA-256 prefix (16 hex chars) of the original content
+};
+
+constexpr const char* SCHEME = "crossdev";
+constexpr const char* HOST = "app";
+
+// All assets, sorted by path (generated)
+const Asset* entries(size_t& count);
+
+// Exact path lookup (binary search). A leading '/' is ignored. nullptr if not bundled.
+const Asset* find(const std::string& path);
+
+// Path of an app-scheme URL ("crossdev://app/js/main.js?v=1" -> "js/main.js"; directory -> index.html).
+// Returns false for other URLs.
+bool pathFromUrl(const std::string& url, std::string& path);
+
+// App-scheme URL for a bundled path
+std::string url(const std::string& path);
+
+// Cache-Control for bundled responses: content only changes with the binary
+constexpr const char* CACHE_CONTROL = "public, max-age=31536000, immutable";
+
+} // namespace asset_bundle
+
+#endif // ASSET_BUNDLE_H
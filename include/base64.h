@@ -1,11 +1,27 @@
 #ifndef BASE64_H
 #define BASE64_H
 
+#include <cstddef>
 #include <string>
 #include <vector>
 
 namespace base64 {
 
+// Encoded length of len bytes (padded)
+inline size_t encodedSize(size_t len) {
+    return ((len + 2) / 3) * 4;
+}
+
+// Exact decoded length of a padded base64 string; 0 if its length is not a multiple of 4
+size_t decodedSize(const char* encoded, size_t len);
+
+// Encode into out, which must hold encodedSize(len) chars (no terminator). Returns chars written.
+size_t encode(const unsigned char* data, size_t len, char* out);
+
+// Decode into out, which must hold decodedSize(encoded, len) bytes.
+// Returns false on invalid input (outLen is then unspecified).
+bool decode(const char* encoded, size_t len, unsigned char* out, size_t& outLen);
+
 // Encode binary data to base64 string
 std::string encode(const unsigned char* data, size_t len);
 
@@ -17,6 +33,25 @@ inline std::string encode(const std::vector<unsigned char>& data) {
 // Decode base64 string to binary; returns empty vector on error
 std::vector<unsigned char> decode(const std::string& encoded);
 
+// Codec implementations. The fastest one the CPU supports is picked on first use.
+enum class Kernel {
+    Scalar,
+    Ssse3,  // x86: 12 bytes per step
+    Avx2,   // x86: 24 bytes per step
+    Neon    // arm64: 48 bytes per step
+};
+
+const char* kernelName(Kernel kernel);
+
+// Kernel used by encode/decode
+Kernel activeKernel();
+
+// Kernels usable on this CPU, slowest first (Scalar is always available)
+std::vector<Kernel> supportedKernels();
+
+// Route encode/decode through kernel (tests and benchmarks). False if the CPU lacks it.
+bool setKernel(Kernel kernel);
+
 } // namespace base64
 
 #endif // BASE64_H
@@ -0,0 +1,56 @@
+#ifndef BATCH_IO_H
+#define BATCH_IO_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Batched stat / whole-file reads for the file handlers. On Linux the operations of a batch are
+// submitted together through io_uring (a handful of io_uring_enter calls instead of an
+// open/fstat/read/close chain per file); elsewhere, or when the kernel refuses io_uring, they
+// run in parallel on the calling thread and the shared ThreadPool.
+// Both calls block until the whole batch is done; the caller works through the batch itself,
+// so a pool busy with long tasks only slows it down.
+// Setting *cancelled stops a batch between files (operations in flight still finish); its
+// results are then incomplete.
+namespace batch_io {
+
+enum class Backend {
+    IoUring,
+    ThreadPool
+};
+
+// Backend the next batch will use if the ring is free; a batch that finds it busy takes the pool
+Backend activeBackend();
+const char* backendName(Backend backend);  // "io_uring" / "threadPool"
+
+struct StatResult {
+    bool exists = false;
+    bool isDirectory = false;
+    bool isFile = false;
+    uint64_t size = 0;     // regular files only
+    int64_t mtimeMs = 0;   // since the Unix epoch
+    std::string error;     // failures other than "does not exist"
+};
+
+struct ReadResult {
+    std::vector<unsigned char> data;
+    uint64_t fileSize = 0;
+    bool overLimit = false;  // larger than maxFileBytes; error is set and nothing was read
+    std::string error;
+};
+
+// Follows symlinks, like stat(2). Returns the backend that ran this batch.
+Backend statMany(const std::vector<std::string>& paths, std::vector<StatResult>& results,
+                 const std::atomic<bool>* cancelled = nullptr);
+
+// Reads whole regular files. Files that would take the batch past maxTotalBytes (in order)
+// are skipped with an error so the caller can ask for them again. Returns the backend that ran
+// this batch.
+Backend readFiles(const std::vector<std::string>& paths, uint64_t maxFileBytes, uint64_t maxTotalBytes,
+                  std::vector<ReadResult>& results, const std::atomic<bool>* cancelled = nullptr);
+
+} // namespace batch_io
+
+#endif // BATCH_IO_H
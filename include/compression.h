@@ -0,0 +1,77 @@
+#ifndef COMPRESSION_H
+#define COMPRESSION_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// gzip / zlib / raw deflate and ZIP writing on top of the miniz copy vendored with OpenXLSX
+// (external/OpenXLSX/OpenXLSX/external/zippy/zippy.hpp).
+namespace compression {
+
+enum class Format {
+    Gzip,     // RFC 1952 (.gz); decompression accepts concatenated members
+    Zlib,     // RFC 1950
+    Deflate   // RFC 1951, raw
+};
+
+// "gzip" / "zlib" / "deflate"; false for anything else
+bool parseFormat(const std::string& name, Format& format);
+
+// In memory. level 0-9. decompress fails once the output would exceed maxOutput.
+bool compress(const unsigned char* data, size_t len, Format format, int level, std::vector<unsigned char>& out,
+              std::string& error);
+bool decompress(const unsigned char* data, size_t len, Format format, size_t maxOutput,
+                std::vector<unsigned char>& out, std::string& error);
+
+// File to file, streamed in chunks. progress (optional) receives the input bytes consumed per
+// chunk; cancel (optional) stops between chunks. The output is removed on failure.
+bool compressFile(const std::string& source, const std::string& destination, Format format, int level,
+                  uint64_t& outputSize, std::string& error, const std::function<void(uint64_t)>& progress = {},
+                  const std::atomic<bool>* cancel = nullptr);
+bool decompressFile(const std::string& source, const std::string& destination, Format format,
+                    uint64_t& outputSize, std::string& error, const std::function<void(uint64_t)>& progress = {},
+                    const std::atomic<bool>* cancel = nullptr);
+
+// Raw-deflate one ZIP entry's data in memory (CRC-32 included); stored instead when deflate
+// does not shrink it. Entries prepared this way can be compressed in parallel and then
+// appended to a ZipWriter in order.
+struct PreparedEntry {
+    std::vector<unsigned char> data;  // deflated, or the original bytes when stored
+    bool stored = false;
+    uint64_t size = 0;                // uncompressed
+    uint32_t crc32 = 0;
+};
+bool prepareEntry(std::vector<unsigned char> content, int level, PreparedEntry& entry, std::string& error);
+
+// Sequential ZIP archive writer (ZIP64 when needed), writing straight to disk
+class ZipWriter {
+public:
+    ZipWriter();
+    ~ZipWriter();  // abandons an unfinished archive (the file is left for the caller to remove)
+    ZipWriter(const ZipWriter&) = delete;
+    ZipWriter& operator=(const ZipWriter&) = delete;
+
+    // cancel (optional) makes the next write fail, which aborts the entry being added
+    bool open(const std::string& path, std::string& error, const std::atomic<bool>* cancel = nullptr);
+    // mtime: seconds since the Unix epoch
+    bool addPrepared(const std::string& name, const PreparedEntry& entry, int64_t mtime, std::string& error);
+    // Stream a (large) file into the archive without holding it in memory
+    bool addFile(const std::string& name, const std::string& sourcePath, uint64_t size, int64_t mtime, int level,
+                 std::string& error);
+    // name ends with '/'
+    bool addDirectory(const std::string& name, int64_t mtime, std::string& error);
+    bool finish(uint64_t& archiveSize, std::string& error);
+
+private:
+    struct State;
+    std::unique_ptr<State> state_;
+};
+
+} // namespace compression
+
+#endif // COMPRESSION_H
@@ -2,6 +2,7 @@
 #define CONFIG_MANAGER_H
 
 #include <string>
+#include <vector>
 #include <nlohmann/json.hpp>
 
 // Configuration manager for application options
@@ -23,6 +24,12 @@ public:
     // Get the full path to options.json (in app-named folder)
     static std::string getOptionsFilePath();
     
+    // Get the persistent WebView HTTP cache directory (config directory + webcache)
+    static std::string getWebCacheDirectory();
+
+    // Get the persistent image thumbnail cache directory (config directory + thumbnails)
+    static std::string getThumbnailCacheDirectory();
+    
     // Load options from file (creates default if doesn't exist)
     bool loadOptions();
     
@@ -48,7 +55,7 @@ public:
         options_[key] = value;
     }
     
-    // Get HTML loading method: "file", "url", or "html"
+    // Get HTML loading method: "file", "url", "html", or "app" (compiled-in asset bundle)
     std::string getHtmlLoadingMethod() const;
     
     // Set HTML loading method
@@ -63,6 +70,13 @@ public:
     // Get HTML content (if method is "html")
     std::string getHtmlContent() const;
     
+    // Get entry page inside the asset bundle (if method is "app"), e.g. "index.html"
+    std::string getHtmlAppEntry() const;
+    
+    // Get precache manifest (if method is "url"): asset URLs, relative to the page, fetched into
+    // the WebView's disk cache after the first paint so later launches revalidate instead of download
+    std::vector<std::string> getHtmlPrecache() const;
+    
     // Get preload script path (empty = use built-in bridge). Path is relative to cwd or absolute.
     std::string getPreloadPath() const;
     
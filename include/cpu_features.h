@@ -0,0 +1,85 @@
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+#include <atomic>
+#include <initializer_list>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CPU_FEATURES_X86 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+#endif
+
+// Runtime CPU feature checks and kernel selection for the SIMD code paths (base64, line scans).
+// Header-only so every target that links one of those modules gets it without another source.
+namespace cpu_features {
+
+#ifdef CPU_FEATURES_X86
+
+inline bool hasSsse3() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 9)) != 0;
+#else
+    __builtin_cpu_init();  // may run before libgcc's constructor when called during static init
+    return __builtin_cpu_supports("ssse3");
+#endif
+}
+
+// AVX2 in the CPU and YMM state saved by the OS
+inline bool hasAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6;
+    __cpuidex(info, 7, 0);
+    return osSavesYmm && (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // CPU_FEATURES_X86
+
+// The kernel a module routes its work through: the fastest one the CPU supports, picked on
+// first use, unless a test or benchmark selects another. Kernel is the module's enum; the
+// candidates are listed slowest first.
+template <typename Kernel>
+class KernelDispatch {
+public:
+    using Supports = bool (*)(Kernel kernel);
+
+    KernelDispatch(std::initializer_list<Kernel> slowestFirst, Supports supports)
+        : candidates_(slowestFirst), supports_(supports), active_(supported().back()) {}
+
+    Kernel active() const { return active_.load(std::memory_order_relaxed); }
+
+    std::vector<Kernel> supported() const {
+        std::vector<Kernel> kernels;
+        for (Kernel kernel : candidates_) {
+            if (supports_(kernel)) kernels.push_back(kernel);
+        }
+        return kernels;
+    }
+
+    // False if the CPU lacks kernel
+    bool select(Kernel kernel) {
+        if (!supports_(kernel)) return false;
+        active_.store(kernel, std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    const std::vector<Kernel> candidates_;
+    const Supports supports_;
+    std::atomic<Kernel> active_;
+};
+
+} // namespace cpu_features
+
+#endif // CPU_FEATURES_H
@@ -0,0 +1,56 @@
+#ifndef CROSSDEV_PLUGIN_ABI_H
+#define CROSSDEV_PLUGIN_ABI_H
+
+/*
+ * CrossDev plugin ABI v2 (plain C, stable across compilers and C++ runtimes).
+ *
+ * A plugin is a shared library plus a JSON manifest next to it in the plugins directory:
+ *
+ *   plugins/invoice.json
+ *     { "abi": 2, "name": "invoice", "library": "libinvoice.so",
+ *       "messageTypes": ["createInvoice", "previewInvoice"],
+ *       "jobTypes": ["createInvoice"] }
+ *
+ * The host reads manifests at startup and only loads the library when the first message of
+ * one of its types arrives. Messages cross the boundary as byte buffers (UTF-8 JSON payload in,
+ * UTF-8 JSON result out), so plugins are free to use any JSON library or serializer.
+ *
+ * The optional "jobTypes" lists the types JS may also run through startJob: handle() is then
+ * called on a job worker thread, possibly concurrently with other calls into the plugin.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CROSSDEV_PLUGIN_ABI_VERSION 2
+
+/* Name of the exported entry point: const CrossDevPluginApi* crossdevPluginGetApi(void) */
+#define CROSSDEV_PLUGIN_ENTRY_SYMBOL "crossdevPluginGetApi"
+
+typedef struct CrossDevPluginApi {
+    uint32_t abiVersion;               /* CROSSDEV_PLUGIN_ABI_VERSION */
+    const char* name;
+    const char* const* messageTypes;   /* NULL-terminated; must cover the manifest's types */
+
+    /*
+     * Handle one message. type is NUL-terminated; request/requestLen is the JSON payload.
+     * The plugin stores a buffer it owns in *response and its size in *responseLen (NULL/0 = null)
+     * and the host releases it with freeBuffer.
+     * Returns 0 on success (response = JSON result) or non-zero (response = UTF-8 error text).
+     */
+    int (*handle)(const char* type, const char* request, size_t requestLen,
+                  char** response, size_t* responseLen);
+    void (*freeBuffer)(char* buffer);
+} CrossDevPluginApi;
+
+typedef const CrossDevPluginApi* (*CrossDevPluginGetApiFn)(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CROSSDEV_PLUGIN_ABI_H */
@@ -0,0 +1,73 @@
+#ifndef DEFERRED_DELETE_H
+#define DEFERRED_DELETE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Deletes files and directory trees off the UI thread. remove() renames the target into a
+// hidden trash directory under the sandbox root, so it vanishes from its parent at once and
+// atomically, and queues it for a single worker thread running at idle I/O and CPU priority.
+// Entries still in the trash when the process exits (or crashes) are deleted by recover() at
+// the next start. The sandboxed file handlers neither reach nor list the trash directory.
+class DeferredDeleter {
+public:
+    // Trash directory, created inside the sandbox root on first use
+    static const char* const kTrashDirName;
+
+    struct Result {
+        std::string path;         // as passed to remove()
+        uint64_t removedCount = 0;
+        std::string error;        // empty on success
+        int64_t elapsedMs = 0;    // from remove() to completion
+    };
+    using Done = std::function<void(const Result&)>;
+
+    static DeferredDeleter& getInstance();
+
+    DeferredDeleter();
+    ~DeferredDeleter();  // stops between entries; unfinished ones stay for recover()
+
+    // Stage path (absolute, inside base) for deletion. False with error if it cannot be moved
+    // out of the way; otherwise done later runs on the worker thread.
+    bool remove(const std::filesystem::path& path, const std::filesystem::path& base, Done done, std::string& error);
+
+    // Queue whatever an earlier run left in base's trash directory (returns at once)
+    void recover(const std::filesystem::path& base);
+
+    // Staged entries not yet deleted (tests, shutdown diagnostics)
+    size_t pending() const;
+    bool waitIdle(std::chrono::milliseconds timeout) const;
+
+private:
+    struct Task {
+        std::filesystem::path base;
+        std::filesystem::path trash;
+        std::filesystem::path staged;  // what to delete
+        std::filesystem::path marker;  // trash entry naming staged, when staged lies outside the trash
+        bool recover = false;          // delete everything in trash instead
+        std::string path;
+        Done done;
+        std::chrono::steady_clock::time_point queued;
+    };
+
+    void enqueue(Task task);
+    void run();
+    void runTask(Task& task);
+
+    mutable std::mutex mutex_;
+    mutable std::condition_variable changed_;
+    std::deque<Task> queue_;
+    size_t busy_ = 0;
+    std::atomic<bool> stopping_{false};
+    std::thread worker_;
+};
+
+#endif // DEFERRED_DELETE_H
@@ -3,6 +3,7 @@
 
 #include "webview_window.h"
 #include "message_handler.h"
+#include "message_router.h"
 #include <string>
 #include <functional>
 #include <map>
@@ -11,12 +12,13 @@
 
 class Window;
 class WebView;
-class MessageRouter;
 
 // Event handler for managing HTML/webview events
 class EventHandler {
 public:
     EventHandler(Window* window, WebView* webView);
+    // preloadScript: already-read custom preload (empty = built-in bridge); avoids re-reading the file
+    EventHandler(Window* window, WebView* webView, const std::string& preloadScript);
     ~EventHandler();
 
     // Register callback for webview create window event (9-param: name, title, contentType, content, isSingleton, x, y, width, height)
@@ -26,8 +28,11 @@ public:
     void onWebViewCreateWindow(std::function<void(const std::string& title, WebViewContentType contentType, const std::string& content)> callback);
 
     // Attach a child window's WebView so CrossDev.invoke (e.g. createWindow) works from it.
+    // The WebView owns its router: both are released when the WebView is destroyed.
     void attachWebView(WebView* webView);
     void attachWebView(WebView* webView, std::vector<std::shared_ptr<MessageHandler>> extraHandlers);
+    // Same, but extra handlers are only constructed on the first message of their types
+    void attachWebView(WebView* webView, std::vector<MessageRouter::LazyHandler> lazyHandlers);
     
     // Get the message router (for registering additional handlers)
     MessageRouter* getMessageRouter() { return messageRouter_.get(); }
@@ -38,7 +43,6 @@ private:
     WebView* webView_;
     std::shared_ptr<MessageRouter> messageRouter_;
     std::function<void(const std::string&, const std::string&, WebViewContentType, const std::string&, bool, int, int, int, int)> createWindowCallback_;
-    std::vector<std::unique_ptr<MessageRouter>> attachedRouters_;
 };
 
 #endif // EVENT_HANDLER_H
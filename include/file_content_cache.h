@@ -0,0 +1,97 @@
+#ifndef FILE_CONTENT_CACHE_H
+#define FILE_CONTENT_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Process-wide LRU cache of whole file contents (and their base64 form), shared by every window.
+// Entries are keyed by absolute path and tagged with the size, mtime and inode they were read at.
+// Where the FileWatcher is event-driven (inotify) an entry is trusted until the watcher reports
+// a change to its file (a moved or deleted parent directory counts; the entry is then read
+// again under a fresh watch); otherwise every lookup re-stats the file and compares the tag.
+// Code that writes, renames or deletes files in-process should call invalidate(): watcher events
+// arrive asynchronously and would leave a short window in which the old contents are served.
+class FileContentCache {
+public:
+    using Bytes = std::shared_ptr<const std::vector<unsigned char>>;
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t bytes = 0;   // contents plus cached base64
+        uint64_t budget = 0;
+        size_t entries = 0;
+    };
+
+    static FileContentCache& getInstance();
+
+    FileContentCache();
+    FileContentCache(const FileContentCache&) = delete;
+    FileContentCache& operator=(const FileContentCache&) = delete;
+
+    // Whole contents of a regular file; null (with error) on failure. Files larger than
+    // maxEntryBytes(), or that change while being read, are returned without being cached.
+    Bytes get(const std::string& path, std::string& error);
+
+    // Base64 of the whole file, encoded once per cached version. size receives the byte count.
+    std::shared_ptr<const std::string> getBase64(const std::string& path, uint64_t& size, std::string& error);
+
+    // Drop path and, for a directory, everything cached below it
+    void invalidate(const std::string& path);
+    void clear();
+
+    void setBudget(uint64_t bytes);
+    uint64_t maxEntryBytes() const;  // a quarter of the budget
+    Stats stats() const;
+
+private:
+    struct Version {
+        uint64_t size = 0;
+        int64_t mtimeNs = 0;
+        uint64_t inode = 0;
+        bool operator==(const Version& other) const {
+            return size == other.size && mtimeNs == other.mtimeNs && inode == other.inode;
+        }
+        bool operator!=(const Version& other) const { return !(*this == other); }
+    };
+
+    // One FileWatcher registration; the callback bumps events, so an entry read when events
+    // was N is current for as long as it still reads N
+    struct Watch {
+        uint64_t id = 0;
+        std::atomic<uint64_t> events{0};
+    };
+
+    struct Entry {
+        Bytes data;
+        std::shared_ptr<const std::string> base64;
+        Version version;
+        std::shared_ptr<Watch> watch;
+        uint64_t seenEvents = 0;
+        std::list<std::string>::iterator lru;
+    };
+
+    Bytes acquire(const std::string& path, std::string& key, std::string& error);
+    void remove(std::unordered_map<std::string, Entry>::iterator it, std::vector<uint64_t>& unwatch);
+    void evict(std::vector<uint64_t>& unwatch);
+    static bool statVersion(const std::string& path, Version& version, std::string& error);
+    static void release(const std::vector<uint64_t>& unwatch);
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+    std::list<std::string> lru_;  // most recently used first
+    uint64_t bytes_ = 0;
+    uint64_t budget_;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+    size_t watched_ = 0;          // entries holding a FileWatcher registration
+    uint64_t invalidations_ = 0;  // a load that started before an invalidate() is not stored
+};
+
+#endif // FILE_CONTENT_CACHE_H
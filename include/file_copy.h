@@ -0,0 +1,35 @@
+#ifndef FILE_COPY_H
+#define FILE_COPY_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// Single-file copy for the copy/move handler. On Linux the data never passes through user
+// space: the destination is first cloned (FICLONE: a reflink on btrfs, XFS, bcachefs... that
+// shares extents until either side is written), then copied in-kernel with copy_file_range
+// (which NFS and SMB also offload to the server). Both fall back to a read/write loop when the
+// filesystems refuse.
+namespace file_copy {
+
+enum class Method {
+    Clone,
+    CopyRange,
+    ReadWrite
+};
+
+const char* methodName(Method method);  // "clone" / "copyFileRange" / "readWrite"
+
+// Called with the bytes copied since the previous call
+using Progress = std::function<void(uint64_t bytes)>;
+
+// Copy the regular file source to destination (created or truncated), with the source's
+// permission bits. cancel is checked between chunks; a cancelled copy fails with "Cancelled"
+// and leaves a partial destination for the caller to remove.
+bool copyFile(const std::string& source, const std::string& destination, Method& method, std::string& error,
+              const Progress& progress = nullptr, const std::atomic<bool>* cancel = nullptr);
+
+} // namespace file_copy
+
+#endif // FILE_COPY_H
@@ -0,0 +1,85 @@
+#ifndef FILE_WATCHER_H
+#define FILE_WATCHER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Watches files and directories (direct children) for changes on one background thread.
+// Linux uses inotify; other platforms fall back to comparing stat snapshots twice a second.
+// Raw events are debounced per watch: a burst is delivered once it has been quiet for the
+// debounce interval (or after 10 intervals at most), with repeated events on the same name
+// coalesced (created+modified = created, created+deleted = nothing, deleted+created = modified).
+class FileWatcher {
+public:
+    enum class ChangeKind { Created, Modified, Deleted };
+
+    struct Change {
+        std::string name;  // entry within the watched directory; for a file watch, the file name
+        ChangeKind kind;
+    };
+
+    // Runs on the watcher thread. overflow: events were lost (queue overflow or too many
+    // pending changes); changes is then empty and the watcher should rescan.
+    // When the observed directory itself is moved or deleted (inotify), the watch ends: a file
+    // watch gets a last Deleted for its file, a directory watch a last overflow, and nothing
+    // follows. Watch the path again to observe whatever takes its place.
+    using Callback = std::function<void(const std::vector<Change>& changes, bool overflow)>;
+
+    static FileWatcher& getInstance();
+
+    FileWatcher();
+    ~FileWatcher();
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    // Watch an existing file or directory. Returns a watch id, or 0 (with error) on failure.
+    uint64_t watch(const std::string& path, int debounceMs, Callback callback, std::string& error);
+    void unwatch(uint64_t id);
+
+    static const char* kindName(ChangeKind kind);
+    // True when the OS reports changes as they happen (inotify); false for the polling fallback
+    static bool isEventDriven();
+
+private:
+    struct Watch {
+        std::string dir;       // directory observed
+        std::string fileName;  // only this entry (file watch); empty = every entry
+        bool fileExists = false;  // file watch: a create over a file we know is a replacement
+        std::chrono::milliseconds debounce;
+        Callback callback;
+        std::map<std::string, ChangeKind> pending;
+        bool overflow = false;
+        bool ended = false;    // directory moved or deleted; no further events
+        std::chrono::steady_clock::time_point firstEvent, lastEvent;
+        std::map<std::string, std::pair<int64_t, int64_t>> snapshot;  // polling backend: size, mtime
+    };
+
+    void run();
+    void record(Watch& watch, const std::string& name, ChangeKind kind);
+    void collectDue(std::vector<std::pair<Callback, std::pair<std::vector<Change>, bool>>>& due);
+    int nextTimeoutMs() const;
+    bool startBackend(std::string& error);
+    bool addBackendWatch(Watch& watch, std::string& error);
+    void removeBackendWatch(const Watch& watch);
+    void waitForEvents(int timeoutMs);
+    void endWatches(const std::string& dir);
+
+    std::mutex mutex_;
+    std::map<uint64_t, Watch> watches_;
+    uint64_t nextId_ = 0;
+    std::thread thread_;
+    bool stopping_ = false;
+    std::condition_variable wake_;    // polling backend
+    int inotifyFd_ = -1;              // inotify backend
+    int wakeFds_[2] = {-1, -1};       // inotify backend: self-pipe to interrupt poll()
+    std::map<int, std::string> dirsByDescriptor_;
+};
+
+#endif // FILE_WATCHER_H
@@ -0,0 +1,111 @@
+#ifndef HANDLER_JOBS_H
+#define HANDLER_JOBS_H
+
+#include "job_manager.h"
+#include "webview_event_sink.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <nlohmann/json.hpp>
+
+class WebView;
+
+// The background jobs of one handler (searches, hashes, thumbnails, compression, copies,
+// downloads): their ids, the table of running ones, the cancel verb and the window their
+// events go to. Shared between the handler (UI thread) and its jobs (pool or JobManager
+// threads), which may outlive it: the handler close()s it on the way out. Job needs a
+// std::string id and a std::atomic<bool> cancelled, which its work polls.
+// Running jobs are also listed on the JobManager (kind: the id prefix, owner: webView), so
+// jobStatus and cancelJob reach them by the same ids as the handler's own cancel verb.
+template <typename Job>
+class HandlerJobs {
+public:
+    HandlerJobs(WebView* webView, std::string idPrefix, JobManager& manager = JobManager::getInstance())
+        : events_(std::make_shared<WebViewEventSink>(webView)), idPrefix_(std::move(idPrefix)), webView_(webView),
+          manager_(manager) {}
+
+    // Registers job under the next "<prefix>-N" id; false (and no id) if conflicts(running)
+    // holds for a job still running
+    template <typename Conflicts>
+    bool add(const std::shared_ptr<Job>& job, Conflicts conflicts) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (const auto& entry : active_) {
+                if (conflicts(*entry.second)) return false;
+            }
+            job->id = idPrefix_ + "-" + std::to_string(++nextId_);
+            active_[job->id] = job;
+        }
+        std::weak_ptr<Job> weak = job;
+        manager_.addExternal(job->id, idPrefix_, webView_, [weak]() {
+            if (auto running = weak.lock()) running->cancelled = true;
+        });
+        return true;
+    }
+
+    void add(const std::shared_ptr<Job>& job) {
+        add(job, [](const Job&) { return false; });
+    }
+
+    // From any thread
+    void emit(const std::string& name, nlohmann::json payload) {
+        events_->emit(name, std::move(payload));
+    }
+
+    // The job's last event; it is forgotten after
+    void finish(const Job& job, const std::string& name, nlohmann::json payload) {
+        JobManager::State state = JobManager::State::Done;
+        std::string error;
+        if (job.cancelled) {
+            state = JobManager::State::Cancelled;
+        } else if (payload.contains("error") && payload["error"].is_string()) {
+            state = JobManager::State::Failed;
+            error = payload["error"].template get<std::string>();
+        }
+        manager_.finishExternal(job.id, state, std::move(error));
+        emit(name, std::move(payload));
+        std::lock_guard<std::mutex> lock(mutex_);
+        active_.erase(job.id);
+    }
+
+    // Reply to the cancel verb, whose payload[idKey] names the job: { success, found }
+    nlohmann::json cancel(const nlohmann::json& payload, const std::string& idKey = "jobId") {
+        nlohmann::json result;
+        if (!payload.contains(idKey) || !payload[idKey].is_string()) {
+            result["success"] = false;
+            result["error"] = "Missing or invalid '" + idKey + "' in payload";
+            return result;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = active_.find(payload[idKey].template get<std::string>());
+        if (it != active_.end()) {
+            it->second->cancelled = true;
+        }
+        result["success"] = true;
+        result["found"] = it != active_.end();
+        return result;
+    }
+
+    // The handler is going away: running jobs are cancelled and finish in the background,
+    // with nothing delivered to the departed WebView
+    void close() {
+        events_->detach();
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& entry : active_) {
+            entry.second->cancelled = true;
+        }
+    }
+
+private:
+    std::shared_ptr<WebViewEventSink> events_;
+    const std::string idPrefix_;
+    WebView* const webView_;  // owner tag on the JobManager
+    JobManager& manager_;
+    std::mutex mutex_;
+    std::map<std::string, std::shared_ptr<Job>> active_;
+    uint64_t nextId_ = 0;
+};
+
+#endif // HANDLER_JOBS_H
@@ -0,0 +1,11 @@
+#ifndef BATCH_FILE_HANDLER_H
+#define BATCH_FILE_HANDLER_H
+
+#include "../message_handler.h"
+#include <memory>
+
+// Handler for readFiles and statMany: many files per message through the batch_io backend
+// (io_uring on Linux, the shared ThreadPool elsewhere).
+std::shared_ptr<MessageHandler> createBatchFileHandler();
+
+#endif // BATCH_FILE_HANDLER_H
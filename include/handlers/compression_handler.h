@@ -0,0 +1,14 @@
+#ifndef COMPRESSION_HANDLER_H
+#define COMPRESSION_HANDLER_H
+
+#include "../message_handler.h"
+#include <memory>
+
+class WebView;
+
+// Handler for compress, decompress, createZip, cancelCompress: gzip / zlib / deflate of inline
+// data or files, and ZIP archives built from file lists with entries compressed in parallel on
+// the shared ThreadPool. File jobs report to webView as "compress:*" and "zip:*" events.
+std::shared_ptr<MessageHandler> createCompressionHandler(WebView* webView);
+
+#endif // COMPRESSION_HANDLER_H
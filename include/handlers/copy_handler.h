@@ -0,0 +1,14 @@
+#ifndef COPY_HANDLER_H
+#define COPY_HANDLER_H
+
+#include "../message_handler.h"
+#include <memory>
+
+class WebView;
+
+// Handler for copy, move, cancelCopy: files and directory trees copied natively (reflink /
+// copy_file_range where available), the files of a tree in parallel on the shared ThreadPool.
+// Jobs report to webView as "copy:progress" and "copy:done" events.
+std::shared_ptr<MessageHandler> createCopyHandler(WebView* webView);
+
+#endif // COPY_HANDLER_H
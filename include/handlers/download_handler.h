@@ -0,0 +1,14 @@
+#ifndef DOWNLOAD_HANDLER_H
+#define DOWNLOAD_HANDLER_H
+
+#include "../message_handler.h"
+#include <memory>
+
+class WebView;
+
+// Handler for download, cancelDownload: URLs fetched natively (http::Client, kept-alive
+// connections) and streamed to a file, resumable with Range requests. Jobs report to webView
+// as "download:progress" and "download:done" events.
+std::shared_ptr<MessageHandler> createDownloadHandler(WebView* webView);
+
+#endif // DOWNLOAD_HANDLER_H
@@ -2,8 +2,37 @@
 #define FILE_SYSTEM_HANDLER_H
 
 #include "../message_handler.h"
+#include <cstdint>
+#include <filesystem>
 #include <memory>
+#include <string>
 
-std::shared_ptr<MessageHandler> createFileSystemHandler();
+class WebView;
+
+// webView receives "delete:done" events of deferred deletions (none when null)
+std::shared_ptr<MessageHandler> createFileSystemHandler(WebView* webView = nullptr);
+
+// Sandboxing shared by the file handlers: path resolved against base (absolute, normalized).
+// Empty if it escapes base or lies in base's deletion trash (DeferredDeleter::kTrashDirName),
+// which belongs to the app, not the page.
+std::string resolveSandboxedPath(const std::string& path, const std::filesystem::path& base);
+
+// True for base's deletion trash itself; listings and tree walks of the sandbox skip it
+bool isSandboxTrash(const std::filesystem::path& path, const std::filesystem::path& base);
+
+// True if path is base or lies below it (both absolute and normalized)
+bool isWithin(const std::filesystem::path& path, const std::filesystem::path& base);
+
+// 16 random hex digits for temporary names; thread safe
+std::string randomNameId();
+
+// "<dir>/.<name>.<randomNameId()><suffix>" next to target, not existing when returned: on the
+// target's file system so renaming it into place never copies, and hidden from listings.
+// Callers that must own the name still create it exclusively.
+std::filesystem::path hiddenSibling(const std::filesystem::path& target, const std::string& suffix);
+
+// Size and modification time (ms since the Unix epoch) of a directory entry, with at most one
+// stat (none on Windows, where the iterator caches both). False if the entry vanished.
+bool readEntryStat(const std::filesystem::directory_entry& entry, int64_t& size, int64_t& mtimeMs);
 
 #endif // FILE_SYSTEM_HANDLER_H
@@ -0,0 +1,13 @@
+#ifndef FIND_FILES_HANDLER_H
+#define FIND_FILES_HANDLER_H
+
+#include "../message_handler.h"
+#include <memory>
+
+class WebView;
+
+// Handler for findFiles, walk, cancelFind: recursive search on the shared ThreadPool.
+// Matches stream to webView as "find:matches" events, followed by one "find:done".
+std::shared_ptr<MessageHandler> createFindFilesHandler(WebView* webView);
+
+#endif // FIND_FILES_HANDLER_H
@@ -0,0 +1,37 @@
+#ifndef HANDLER_TYPES_H
+#define HANDLER_TYPES_H
+
+#include <string>
+#include <vector>
+
+// Message types served by each built-in handler. The handlers' getSupportedTypes() return these
+// lists and AppRunner registers its lazy factories under them, so the two cannot disagree.
+namespace handler_types {
+
+inline const std::vector<std::string> kAppInfo = {"getAppInfo"};
+inline const std::vector<std::string> kCalculator = {"calculate"};
+inline const std::vector<std::string> kCreateWindow = {"createWindow"};
+inline const std::vector<std::string> kFileDialog = {"openFileDialog"};
+inline const std::vector<std::string> kReadFile = {"readFile"};
+inline const std::vector<std::string> kBatchFile = {"readFiles", "statMany"};
+inline const std::vector<std::string> kWriteFile = {"writeFile", "openWrite", "appendChunk", "commitWrite", "abortWrite"};
+inline const std::vector<std::string> kFileSystem = {"exists", "listDir", "mkdir", "deleteFile", "rename", "stat"};
+inline const std::vector<std::string> kFindFiles = {"findFiles", "walk", "cancelFind"};
+inline const std::vector<std::string> kWatch = {"watchPath", "unwatch"};
+inline const std::vector<std::string> kHashFile = {"hashFile", "hashFiles", "cancelHash"};
+inline const std::vector<std::string> kCompression = {"compress", "decompress", "createZip", "cancelCompress"};
+inline const std::vector<std::string> kCopy = {"copy", "move", "cancelCopy"};
+inline const std::vector<std::string> kDownload = {"download", "cancelDownload"};
+inline const std::vector<std::string> kTextFile = {"readTextFile", "readLines"};
+inline const std::vector<std::string> kThumbnail = {"thumbnail", "cancelThumbnail"};
+inline const std::vector<std::string> kJob = {"startJob", "jobStatus", "cancelJob"};
+inline const std::vector<std::string> kContextMenu = {"showContextMenu"};
+inline const std::vector<std::string> kFocusWindow = {"focusWindow"};
+inline const std::vector<std::string> kOptions = {"getOptionsPath", "readOptions", "writeOptions"};
+inline const std::vector<std::string> kState = {"stateGet", "stateSet", "stateSubscribe", "stateUnsubscribe"};
+inline const std::vector<std::string> kReloadMainContent = {"reloadMainContent"};
+inline const std::vector<std::string> kReloadMainWindow = {"reloadMainWindow"};
+
+} // namespace handler_types
+
+#endif // HANDLER_TYPES_H
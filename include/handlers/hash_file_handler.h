@@ -0,0 +1,13 @@
+#ifndef HASH_FILE_HANDLER_H
+#define HASH_FILE_HANDLER_H
+
+#include "../message_handler.h"
+#include <memory>
+
+class WebView;
+
+// Handler for hashFile, hashFiles, cancelHash: XXH3-64 / SHA-256 of files on the shared
+// ThreadPool. Progress and results go to webView as "hash:progress" and "hash:done" events.
+std::shared_ptr<MessageHandler> createHashFileHandler(WebView* webView);
+
+#endif // HASH_FILE_HANDLER_H
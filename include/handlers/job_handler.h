@@ -0,0 +1,23 @@
+#ifndef JOB_HANDLER_H
+#define JOB_HANDLER_H
+
+#include "../message_handler.h"
+#include "../job_manager.h"
+#include <functional>
+#include <memory>
+#include <string>
+
+class WebView;
+
+// Handler for startJob, jobStatus, cancelJob: any routed message type whose handler opts in
+// (MessageHandler::canRunAsJob) runs on the JobManager instead of inside the request, which
+// answers with a jobId at once. Outcomes arrive at webView (only) as "job:progress" and
+// "job:done" events, and only webView can query or cancel those jobs. jobStatus and cancelJob
+// also reach webView's handler jobs (finds, hashes, thumbnails, compression, copies,
+// downloads) by their own ids, so one id works for every long operation. findHandler resolves
+// a type to its handler (MessageRouter::findHandler), on the UI thread.
+using JobHandlerLookup = std::function<std::shared_ptr<MessageHandler>(const std::string& type)>;
+std::shared_ptr<MessageHandler> createJobHandler(WebView* webView, JobHandlerLookup findHandler,
+                                                 JobManager& manager = JobManager::getInstance());
+
+#endif // JOB_HANDLER_H
@@ -0,0 +1,13 @@
+#ifndef STATE_HANDLER_H
+#define STATE_HANDLER_H
+
+#include "../message_handler.h"
+#include <memory>
+
+class WebView;
+
+// Handler for stateGet, stateSet, stateSubscribe, stateUnsubscribe (SharedStateStore).
+// webView identifies the subscribing window for "state:changed" events.
+std::shared_ptr<MessageHandler> createStateHandler(WebView* webView);
+
+#endif // STATE_HANDLER_H
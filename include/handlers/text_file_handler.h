@@ -0,0 +1,14 @@
+#ifndef TEXT_FILE_HANDLER_H
+#define TEXT_FILE_HANDLER_H
+
+#include "../message_handler.h"
+#include <memory>
+
+class WebView;
+
+// Handler for readTextFile and readLines: UTF-8 text returned as JSON strings (no base64), and
+// line ranges of files too large to load, located through a shared LineIndex. When a readLines
+// leaves an index incomplete it is finished on the ThreadPool and "lines:indexed" goes to webView.
+std::shared_ptr<MessageHandler> createTextFileHandler(WebView* webView);
+
+#endif // TEXT_FILE_HANDLER_H
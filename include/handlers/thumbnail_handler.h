@@ -0,0 +1,16 @@
+#ifndef THUMBNAIL_HANDLER_H
+#define THUMBNAIL_HANDLER_H
+
+#include "../message_handler.h"
+#include <memory>
+#include <string>
+
+class WebView;
+
+// Handler for thumbnail, cancelThumbnail: images decoded and downscaled natively on the shared
+// ThreadPool (platform::createThumbnail), kept in the ThumbnailCache over cacheDirectory
+// (one per directory, shared by every window).
+// Results go to webView as "thumbnail:ready" and "thumbnail:done" events.
+std::shared_ptr<MessageHandler> createThumbnailHandler(WebView* webView, const std::string& cacheDirectory);
+
+#endif // THUMBNAIL_HANDLER_H
@@ -0,0 +1,13 @@
+#ifndef WATCH_HANDLER_H
+#define WATCH_HANDLER_H
+
+#include "../message_handler.h"
+#include <memory>
+
+class WebView;
+
+// Handler for watchPath, unwatch (FileWatcher). Debounced changes go to webView only,
+// as "file:changed" events; watches end with the handler.
+std::shared_ptr<MessageHandler> createWatchHandler(WebView* webView);
+
+#endif // WATCH_HANDLER_H
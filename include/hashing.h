@@ -0,0 +1,60 @@
+#ifndef HASHING_H
+#define HASHING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace hashing {
+
+// Streaming XXH3-64 (seed 0, default secret); digests match xxhsum -H3 / xxhash.xxh3_64
+class Xxh3 {
+public:
+    Xxh3();
+    void update(const void* data, size_t len);
+    uint64_t digest() const;  // does not change the state
+
+private:
+    void consumeStripes(const unsigned char* data, size_t stripes);
+
+    uint64_t acc_[8];
+    unsigned char buffer_[256];
+    size_t buffered_ = 0;
+    unsigned char lastStripe_[64];  // last 64 bytes already consumed (for a short final block)
+    size_t stripesInBlock_ = 0;
+    uint64_t totalLen_ = 0;
+};
+
+// Streaming SHA-256 (FIPS 180-4)
+class Sha256 {
+public:
+    Sha256();
+    void update(const void* data, size_t len);
+    void digest(unsigned char out[32]) const;  // does not change the state
+
+private:
+    uint32_t state_[8];
+    unsigned char buffer_[64];
+    size_t buffered_ = 0;
+    uint64_t totalLen_ = 0;
+};
+
+enum class Algorithm { Xxh3, Sha256 };
+
+// "xxh3" / "sha256"; false for anything else
+bool parseAlgorithm(const std::string& name, Algorithm& algorithm);
+const char* algorithmName(Algorithm algorithm);
+
+// Lowercase hex digest of a buffer (XXH3: 16 chars, big-endian as printed by xxhsum)
+std::string hashBuffer(Algorithm algorithm, const void* data, size_t len);
+
+// Hash a file by reading it in large chunks. progress (optional) receives the bytes read by
+// each chunk. Stops early when cancel (optional) becomes true.
+bool hashFile(const std::string& path, Algorithm algorithm, std::string& hexDigest, std::string& error,
+              const std::function<void(uint64_t)>& progress = {}, const std::atomic<bool>* cancel = nullptr);
+
+} // namespace hashing
+
+#endif // HASHING_H
@@ -0,0 +1,98 @@
+#ifndef HTTP_CLIENT_H
+#define HTTP_CLIENT_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace http {
+
+// http:// or https:// URL split for a request
+struct Url {
+    std::string scheme;  // "http" or "https"
+    std::string host;    // without brackets for IPv6 literals
+    int port = 0;
+    std::string target;  // path and query, at least "/"
+
+    static bool parse(const std::string& text, Url& url, std::string& error);
+
+    std::string toString() const;
+    // scheme://host:port, the key connections are pooled under
+    std::string origin() const;
+    // Host header value (port omitted when it is the scheme's default)
+    std::string hostHeader() const;
+    // Absolute URL of a redirect Location, which may be relative to this one
+    std::string resolve(const std::string& location) const;
+};
+
+struct Response {
+    int status = 0;
+    std::string url;                             // after redirects
+    std::map<std::string, std::string> headers;  // names lower-cased; repeats joined with ", "
+    int64_t contentLength = -1;                  // -1: chunked or delimited by close
+
+    std::string header(const std::string& name) const;
+};
+
+struct Request {
+    std::string url;
+    // Sent as given to the request's origin; a redirect to another origin keeps only the ones
+    // that carry no credentials (Accept*, User-Agent, Range and the conditional headers)
+    std::vector<std::pair<std::string, std::string>> headers;
+    int maxRedirects = 5;                         // https -> http redirects are refused
+    int timeoutMs = 30000;                        // per connect / read, not for the whole transfer
+    const std::atomic<bool>* cancelled = nullptr;  // polled while waiting for the network
+};
+
+// Return false to stop the transfer; the connection is then closed rather than reused
+using ResponseCallback = std::function<bool(const Response& response)>;
+using DataCallback = std::function<bool(const char* data, size_t size)>;
+
+class Connection;
+
+// Minimal HTTP/1.1 GET client. Connections are kept alive and reused per origin, so a run of
+// requests to one server pays the TCP (and TLS) handshake once. Bodies are streamed to the
+// caller as they arrive (Content-Length, chunked or close-delimited); redirects are followed,
+// but never from HTTPS to plain HTTP. HTTPS needs a build with OpenSSL (CROSSDEV_HAVE_OPENSSL).
+// Thread-safe: each call uses a connection of its own.
+class Client {
+public:
+    static Client& getInstance();
+    static bool httpsSupported();
+
+    ~Client();
+
+    // onResponse sees the final response's status and headers, then onData its body. False
+    // with error set on network or protocol failures, cancellation and callback aborts;
+    // HTTP error statuses are responses like any other.
+    bool get(const Request& request, const ResponseCallback& onResponse, const DataCallback& onData,
+             std::string& error);
+
+    size_t idleConnections();
+    uint64_t connectionsOpened() const { return connectionsOpened_; }
+
+private:
+    Client() = default;
+    Client(const Client&) = delete;
+    Client& operator=(const Client&) = delete;
+
+    enum class Attempt { Done, Failed, Redirect };
+    Attempt attempt(const Url& url, const Request& request, bool lastRedirect, const ResponseCallback& onResponse,
+                    const DataCallback& onData, std::string& location, std::string& error);
+    std::unique_ptr<Connection> acquire(const Url& url, const Request& request, bool& reused, std::string& error);
+    void release(std::unique_ptr<Connection> connection);
+
+    std::mutex mutex_;
+    std::multimap<std::string, std::unique_ptr<Connection>> idle_;
+    std::atomic<uint64_t> connectionsOpened_{0};
+};
+
+} // namespace http
+
+#endif // HTTP_CLIENT_H
@@ -0,0 +1,181 @@
+#ifndef JOB_MANAGER_H
+#define JOB_MANAGER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+class JobManager;
+
+// Handed to a running job: cancellation flag and progress reporting
+class JobContext {
+public:
+    const std::string& id() const { return id_; }
+    const std::string& kind() const { return kind_; }
+    bool cancelled() const { return cancelled_.load(); }
+    // The same, for code below the job that polls a flag (hashing, HTTP, batch_io)
+    const std::atomic<bool>* cancelFlag() const { return &cancelled_; }
+
+    // Latest progress for jobStatus; also emitted as "job:progress", at most once per
+    // JobManager::kProgressIntervalMs
+    void progress(nlohmann::json progress);
+
+    // The context of the job running on this thread, nullptr outside jobs
+    static JobContext* current();
+
+private:
+    friend class JobManager;
+    JobContext(JobManager* manager, std::string id, std::string kind)
+        : manager_(manager), id_(std::move(id)), kind_(std::move(kind)) {}
+
+    JobManager* const manager_;
+    const std::string id_;
+    const std::string kind_;
+    std::atomic<bool> cancelled_{false};
+    std::atomic<int64_t> lastProgressMs_{INT64_MIN / 2};  // since started_
+    std::chrono::steady_clock::time_point started_;
+};
+
+// Long operations (export, import, bulk file work, plugin calls) that outlive one request:
+// start() returns a job id at once, the work runs on a bounded set of dedicated workers and
+// reports to the event sink it was started with (JobHandler: the window that asked)
+//   "job:progress" {jobId, kind, progress}
+//   "job:done"     {jobId, kind, state, result?, error?, elapsedMs}
+// The result travels in "job:done" only; finished jobs keep their status, not their result.
+// Queued jobs start by priority, first come first served within one priority. Workers are
+// threads of their own rather than ThreadPool tasks: a job may block for minutes and may
+// itself fan out onto the ThreadPool.
+class JobManager {
+public:
+    enum class Priority { High, Normal, Low };
+    enum class State { Queued, Running, Done, Failed, Cancelled };
+
+    // The result becomes "job:done"'s result; {"success": false, "error": ...} or an exception
+    // fails the job. A job that returns after cancel() ends Cancelled whatever it returns.
+    using Work = std::function<nlohmann::json(JobContext& context)>;
+
+    static const size_t kDefaultWorkers = 3;
+    static const size_t kDefaultPostedThreads = 8;
+    static const size_t kKeepFinished = 100;  // finished jobs jobStatus can still report
+    static const int64_t kProgressIntervalMs = 100;
+
+    // Shared manager with kDefaultWorkers workers and up to kDefaultPostedThreads posted threads
+    static JobManager& getInstance();
+
+    explicit JobManager(size_t workerCount, size_t postedThreadLimit = kDefaultPostedThreads);
+    ~JobManager();  // shutdown()
+    JobManager(const JobManager&) = delete;
+    JobManager& operator=(const JobManager&) = delete;
+
+    // Where events go, called on the worker threads
+    using EventSink = std::function<void(const std::string& name, const nlohmann::json& payload)>;
+
+    // Queue work; returns its id ("job-N"). Its events go to events, else to the default sink.
+    // owner is an opaque tag (JobHandler and HandlerJobs: their window's WebView): cancel,
+    // status and list given an owner see only the jobs started with that owner; given none
+    // they see every job.
+    std::string start(const std::string& kind, Priority priority, Work work, EventSink events = nullptr,
+                      const void* owner = nullptr);
+
+    // Runs task on a posted thread, apart from the workers, unlisted: no id, status or events.
+    // For long handler I/O with ids, events and a cancel verb of its own (zip, copy, download)
+    // that must not hold a worker from the jobs, nor outlive the process's statics. Posted
+    // threads are started as needed up to postedThreadLimit; further tasks wait for one, first
+    // come first served. Dropped after shutdown().
+    void post(std::function<void()> task);
+
+    // Lists a long operation that runs outside the workers under an id of its own (HandlerJobs:
+    // finds, hashes, thumbnails, compression, copies, downloads), so status, list and cancel
+    // reach it like a job; cancel calls cancel. It reports through its own events, not
+    // "job:*" ones, and is running until finishExternal records how it ended.
+    void addExternal(const std::string& id, const std::string& kind, const void* owner, std::function<void()> cancel);
+    void finishExternal(const std::string& id, State state, std::string error = std::string());
+
+    // Drops the queues, cancels running jobs and joins the workers and posted threads; the app
+    // calls it on the way out, before static destruction, so no job touches a destroyed
+    // singleton. Owners of running posted tasks cancel those themselves.
+    void shutdown();
+
+    // Queued jobs end Cancelled at once; running ones see context.cancelled().
+    // False if the id is unknown (to owner) or the job already finished.
+    bool cancel(const std::string& id, const void* owner = nullptr);
+
+    // {jobId, kind, priority, state, queuedMs, elapsedMs, progress?, error?};
+    // false if the id is unknown (or finished long enough ago to be forgotten)
+    bool status(const std::string& id, nlohmann::json& out, const void* owner = nullptr) const;
+    // Status of every known job, oldest first
+    nlohmann::json list(const void* owner = nullptr) const;
+
+    size_t workerCount() const { return workers_.size(); }
+    size_t postedThreadLimit() const { return postedThreadLimit_; }
+
+    // "high" / "normal" / "low"; false for anything else
+    static bool parsePriority(const std::string& name, Priority& out);
+    static const char* priorityName(Priority priority);
+    static const char* stateName(State state);
+
+    // For jobs started without a sink of their own; none by default, so those only report
+    // through status() (tests collect events here)
+    void setEventSink(EventSink sink);
+
+private:
+    struct Job {
+        std::shared_ptr<JobContext> context;
+        Priority priority = Priority::Normal;
+        Work work;
+        EventSink events;
+        std::function<void()> cancelExternal;  // set while an external operation runs
+        bool external = false;
+        const void* owner = nullptr;
+        State state = State::Queued;
+        uint64_t sequence = 0;
+        std::chrono::steady_clock::time_point queued;
+        std::chrono::steady_clock::time_point started;
+        std::chrono::steady_clock::time_point finished;
+        nlohmann::json progress;
+        std::string error;
+    };
+
+    void run();
+    void finish(const std::shared_ptr<Job>& job, State state, nlohmann::json result, std::string error);
+    void emit(const Job& job, const std::string& name, const nlohmann::json& payload);
+    void reportProgress(JobContext& context, nlohmann::json progress, bool emitEvent);
+    nlohmann::json describe(const Job& job) const;  // mutex_ held
+    static bool visible(const Job& job, const void* owner) { return !owner || job.owner == owner; }
+    void forgetOldJobs();                            // mutex_ held
+
+    friend class JobContext;
+
+    std::vector<std::thread> workers_;
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<std::shared_ptr<Job>> queues_[3];      // by Priority
+    std::map<std::string, std::shared_ptr<Job>> jobs_;
+    std::deque<std::string> finished_;                // ids, oldest first
+    uint64_t nextId_ = 1;
+    uint64_t nextSequence_ = 1;  // start order of jobs and external operations
+    bool stopping_ = false;
+    std::mutex sinkMutex_;
+    EventSink sink_;
+
+    void runPosted();
+    const size_t postedThreadLimit_;
+    std::mutex postedMutex_;
+    std::condition_variable postedWake_;
+    std::deque<std::function<void()>> postedQueue_;
+    std::vector<std::thread> postedThreads_;
+    size_t postedIdle_ = 0;  // posted threads waiting for a task
+    bool postedClosed_ = false;
+};
+
+#endif // JOB_MANAGER_H
@@ -0,0 +1,97 @@
+#ifndef LINE_INDEX_H
+#define LINE_INDEX_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Newline scanning for the text handlers, and a sparse line index for files too large to load.
+namespace line_scan {
+
+// Scan implementations. The fastest one the CPU supports is picked on first use.
+enum class Kernel {
+    Scalar,
+    Sse2,  // x86: 16 bytes per step
+    Avx2,  // x86: 32 bytes per step
+    Neon   // arm64: 16 bytes per step
+};
+
+const char* kernelName(Kernel kernel);
+Kernel activeKernel();
+// Kernels usable on this CPU, slowest first (Scalar is always available)
+std::vector<Kernel> supportedKernels();
+// Route scans through kernel (tests and benchmarks). False if the CPU lacks it.
+bool setKernel(Kernel kernel);
+
+// Skip past up to n '\n' bytes. Returns the position just after the n-th newline, with n set
+// to 0; or len, with n reduced by the newlines found, if there are fewer.
+size_t skipNewlines(const unsigned char* data, size_t len, uint64_t& n);
+
+// Copy of text with invalid UTF-8 sequences replaced by U+FFFD. Returns the number replaced.
+size_t sanitizeUtf8(const char* text, size_t len, std::string& out);
+
+} // namespace line_scan
+
+// Offsets of every kCheckpointInterval-th line start of one file, built by scanning the file
+// front to back (lazily: only as far as callers ask, or to the end from a background task).
+// When the file grows and the bytes just before the indexed end are unchanged, it is taken as
+// an append and only the new bytes are scanned; truncation, replacement or a rewrite at the
+// same size rebuilds the index.
+// Indexes are shared process-wide per path; all methods are thread-safe.
+class LineIndex {
+public:
+    static const uint64_t kCheckpointInterval = 256;
+
+    struct Status {
+        uint64_t size = 0;          // file size when last validated
+        uint64_t bytesIndexed = 0;
+        uint64_t linesIndexed = 0;  // newlines within bytesIndexed
+        bool complete = false;      // bytesIndexed == size
+        uint64_t totalLines = 0;    // when complete: lines, counting a last line without '\n'
+    };
+
+    // Shared index for path, revalidated against the file. Null (with error) if the file cannot be read.
+    static std::shared_ptr<LineIndex> forFile(const std::string& path, std::string& error);
+
+    explicit LineIndex(std::string path);
+
+    // Scan until line is locatable (or to the end of the file); cancel is checked between chunks.
+    // With maxScanBytes, also stops (returning true) once that much has been scanned by this call.
+    bool extendTo(uint64_t line, std::string& error, const std::atomic<bool>* cancel = nullptr,
+                  uint64_t maxScanBytes = UINT64_MAX);
+    bool extendToEnd(std::string& error, const std::atomic<bool>* cancel = nullptr);
+
+    // Byte offset where line starts. False if line lies beyond the end of the file (complete)
+    // or has not been indexed yet.
+    bool lineOffset(uint64_t line, uint64_t& offset, std::string& error);
+
+    Status status() const;
+    const std::string& path() const { return path_; }
+
+    // At most one background task completes an index
+    bool claimBackground();
+    void releaseBackground();
+
+private:
+    bool refresh(std::string& error);
+    void reset();
+    bool scanChunk(std::string& error);  // with mutex_ held
+
+    const std::string path_;
+    mutable std::mutex mutex_;
+    uint64_t size_ = 0;
+    uint64_t inode_ = 0;
+    int64_t mtimeNs_ = 0;
+    std::vector<uint64_t> checkpoints_;  // checkpoints_[k] = start of line k * kCheckpointInterval
+    uint64_t bytesIndexed_ = 0;
+    uint64_t linesIndexed_ = 0;
+    bool endsWithNewline_ = false;       // last indexed byte
+    std::string tail_;                   // bytes just before bytesIndexed_, to recognise appends
+    bool backgroundRunning_ = false;
+};
+
+#endif // LINE_INDEX_H
@@ -0,0 +1,10 @@
+#ifndef MAIN_THREAD_H
+#define MAIN_THREAD_H
+
+#include <functional>
+
+// Run fn on the UI thread. Callable from any thread (e.g. ThreadPool tasks that need to touch a
+// WebView); fn runs after the UI events already queued.
+void runOnMainThread(std::function<void()> fn);
+
+#endif // MAIN_THREAD_H
@@ -20,6 +20,13 @@ public:
     
     // Get all message types this handler supports
     virtual std::vector<std::string> getSupportedTypes() const = 0;
+
+    // Whether startJob may run this type on a JobManager worker: handle() must then be safe
+    // off the UI thread and concurrently with other calls. JobContext::current() is set there.
+    virtual bool canRunAsJob(const std::string& messageType) const {
+        (void)messageType;
+        return false;
+    }
 };
 
 #endif // MESSAGE_HANDLER_H
@@ -6,29 +6,50 @@
 #include <memory>
 #include <map>
 #include <vector>
+#include <functional>
 
 class WebView;
 
 // Message router that dispatches JavaScript messages to appropriate handlers
 class MessageRouter {
 public:
+    using HandlerFactory = std::function<std::shared_ptr<MessageHandler>()>;
+
+    // A handler that is only constructed when the first message of one of its types arrives
+    struct LazyHandler {
+        std::vector<std::string> types;
+        HandlerFactory factory;
+    };
+
     MessageRouter(WebView* webView);
     ~MessageRouter();
     
     // Register a handler for one or more message types
     void registerHandler(const std::string& messageType, std::shared_ptr<MessageHandler> handler);
     void registerHandler(std::shared_ptr<MessageHandler> handler);
+
+    // Register a factory for the given types; the handler is built on first use and then
+    // serves all of them. Later registrations for a type (eager or lazy) replace earlier ones.
+    void registerHandlerFactory(const std::vector<std::string>& messageTypes, HandlerFactory factory);
+    void registerHandlerFactory(LazyHandler lazy);
     
     // Route a message from JavaScript (called by platform code)
     void routeMessage(const std::string& jsonMessage);
     
     // Send response back to JavaScript
     void sendResponse(const std::string& requestId, const std::string& resultJson, const std::string& error = "");
+
+    // Find handler for type, instantiating it from factories_ on first use. nullptr if none, or
+    // if its factory failed (threw or returned nullptr): that is remembered for all of the
+    // factory's types until they are registered again. UI thread only, like routeMessage.
+    std::shared_ptr<MessageHandler> findHandler(const std::string& type);
     
 private:
     WebView* webView_;
     std::map<std::string, std::shared_ptr<MessageHandler>> handlers_;
-    
+    std::map<std::string, std::shared_ptr<HandlerFactory>> factories_;  // shared by all types of one factory
+    std::map<std::string, std::string> failedTypes_;  // type -> why its factory failed; not retried
+
     // Helper to parse and validate message
     bool parseMessage(const std::string& jsonMessage, std::string& type, 
                      std::string& payload, std::string& requestId);
@@ -0,0 +1,52 @@
+#ifndef PLUGIN_HOST_H
+#define PLUGIN_HOST_H
+
+#include "crossdev_plugin_abi.h"
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class MessageRouter;
+
+// Discovers and loads ABI v2 plugins (see crossdev_plugin_abi.h).
+// Startup only reads the JSON manifests; each library is loaded on the first message of one
+// of its declared types and then stays loaded for the life of the process.
+class PluginHost {
+public:
+    static PluginHost& getInstance();
+
+    struct Manifest {
+        std::string name;
+        std::string libraryPath;                // absolute, resolved against the manifest's directory
+        std::vector<std::string> messageTypes;
+        std::vector<std::string> jobTypes;      // subset of messageTypes startJob may run off the UI thread
+    };
+
+    // Parse one manifest file. Returns false (with error set) for invalid files or another ABI.
+    static bool parseManifest(const std::string& path, Manifest& out, std::string& error);
+
+    // Read all *.json manifests in dir (no libraries are loaded). Safe on a worker thread.
+    // Returns the number of plugins added.
+    size_t scanDirectory(const std::string& dir);
+    void addManifest(const Manifest& manifest);
+    std::vector<Manifest> getManifests() const;
+
+    // Register one lazy handler per plugin on the router; types already registered are replaced.
+    void registerHandlers(MessageRouter* router);
+
+    // Load the plugin library (once) and return its API; nullptr with error set on failure.
+    const CrossDevPluginApi* load(const Manifest& manifest, std::string& error);
+
+private:
+    PluginHost() = default;
+    ~PluginHost() = default;
+    PluginHost(const PluginHost&) = delete;
+    PluginHost& operator=(const PluginHost&) = delete;
+
+    std::vector<Manifest> manifests_;
+    std::map<std::string, const CrossDevPluginApi*> loaded_;  // by libraryPath
+    mutable std::mutex mutex_;
+};
+
+#endif // PLUGIN_HOST_H
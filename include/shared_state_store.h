@@ -0,0 +1,80 @@
+#ifndef SHARED_STATE_STORE_H
+#define SHARED_STATE_STORE_H
+
+#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+
+class WebView;
+
+// Process-wide key/value store shared by all windows (CrossDev.state in JS).
+// Each key carries its own version counter; every change is recorded as an RFC 6902
+// JSON patch so subscribers only receive the delta since the version they last saw.
+class SharedStateStore {
+public:
+    static SharedStateStore& getInstance();
+
+    // Number of patches kept per key. Older subscribers fall back to a full value.
+    static constexpr size_t MAX_HISTORY = 64;
+
+    struct Snapshot {
+        nlohmann::json value;   // null when the key was never set
+        uint64_t version = 0;   // 0 when the key was never set
+    };
+
+    // Catch-up message for a reader that knows `sinceVersion`.
+    // Exactly one of patch/value is meaningful: isPatch ? patch : value.
+    struct Delta {
+        uint64_t fromVersion = 0;
+        uint64_t version = 0;
+        bool isPatch = false;
+        nlohmann::json patch = nlohmann::json::array();
+        nlohmann::json value;
+    };
+
+    Snapshot get(const std::string& key) const;
+
+    // Patch from sinceVersion to current; falls back to the full value when the history
+    // no longer reaches back that far (or sinceVersion is 0 / ahead of the store).
+    Delta getDelta(const std::string& key, uint64_t sinceVersion) const;
+
+    // Store value; bumps the version only if the value actually changed.
+    // Subscribed WebViews receive a "state:changed" event with the delta. Returns the new version.
+    uint64_t set(const std::string& key, const nlohmann::json& value);
+
+    // Subscribe a WebView to key changes. knownVersion is what the caller already has
+    // (0 = nothing); the returned delta brings it up to date.
+    Delta subscribe(WebView* webView, const std::string& key, uint64_t knownVersion);
+    void unsubscribe(WebView* webView, const std::string& key);
+
+    // Drop all subscriptions of a WebView (called when its WebViewWindow is destroyed)
+    void unsubscribeAll(WebView* webView);
+
+private:
+    SharedStateStore() = default;
+    ~SharedStateStore() = default;
+    SharedStateStore(const SharedStateStore&) = delete;
+    SharedStateStore& operator=(const SharedStateStore&) = delete;
+
+    struct PatchEntry {
+        uint64_t version;       // version produced by applying this patch
+        nlohmann::json patch;
+    };
+    struct Entry {
+        nlohmann::json value;
+        uint64_t version = 0;
+        std::deque<PatchEntry> history;
+    };
+
+    Delta makeDeltaLocked(const std::string& key, uint64_t sinceVersion) const;
+
+    std::map<std::string, Entry> entries_;
+    // Per WebView: key -> last version delivered to it
+    std::map<WebView*, std::map<std::string, uint64_t>> subscribers_;
+    mutable std::mutex mutex_;
+};
+
+#endif // SHARED_STATE_STORE_H
@@ -0,0 +1,65 @@
+#ifndef SINGLE_INSTANCE_H
+#define SINGLE_INSTANCE_H
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// One running instance per user: the first launch becomes the primary and listens on a Unix
+// domain socket; later launches hand their argv paths to it and exit before any toolkit or
+// WebView init. The primary is the process holding an exclusive lock on "<socket>.lock", so a
+// socket file left behind by a crash is never mistaken for a live instance, and two launches
+// racing each other agree on a single primary.
+// Windows: not implemented yet, every launch runs as Standalone.
+class SingleInstance {
+public:
+    enum class Role {
+        Primary,     // this process runs the app and receives later launches' paths
+        Forwarded,   // a running instance took the paths: exit
+        Standalone   // no single-instance coordination (unsupported, or the socket failed)
+    };
+    using PathsHandler = std::function<void(const std::vector<std::string>& paths)>;
+
+    static const int kDefaultTimeoutMs = 3000;
+
+    explicit SingleInstance(std::string socketPath);
+    ~SingleInstance();
+
+    // $XDG_RUNTIME_DIR/<appName>.instance where set (per-user, cleared at logout), else
+    // configDirectory/instance.sock
+    static std::string defaultSocketPath(const std::string& appName, const std::string& configDirectory);
+
+    // The argv entries deliverOpenFilePaths would handle (argv[0] and "-" options skipped),
+    // relative paths made absolute against the current directory
+    static std::vector<std::string> openPaths(int argc, const char* argv[]);
+
+    // Become the primary, or forward paths to the running one. timeoutMs bounds the wait
+    // for the primary to acknowledge; Standalone (with error set) when that fails.
+    Role acquire(const std::vector<std::string>& paths, std::string& error, int timeoutMs = kDefaultTimeoutMs);
+
+    // Primary: paths forwarded by later launches, on the listener thread. Paths that arrived
+    // before a handler was set are delivered to it at once.
+    void setHandler(PathsHandler handler);
+
+    const std::string& socketPath() const { return socketPath_; }
+
+private:
+    bool forward(const std::vector<std::string>& paths, int timeoutMs, std::string& error);
+    bool listen(std::string& error);
+    void acceptLoop();
+    void receive(int fd);
+
+    const std::string socketPath_;
+    int lockFd_ = -1;
+    int listenFd_ = -1;
+    std::atomic<bool> stop_{false};
+    std::thread listener_;
+    std::mutex mutex_;
+    PathsHandler handler_;
+    std::vector<std::vector<std::string>> pending_;
+};
+
+#endif // SINGLE_INSTANCE_H
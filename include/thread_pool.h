@@ -0,0 +1,51 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing pool for background file work (tree walks, hashing, ...).
+// Each worker owns a deque: tasks submitted from a worker go to the back of its own deque and
+// are taken LIFO (depth-first, cache-warm); idle workers steal from the front of the others
+// (the oldest, typically largest, pieces of work). Tasks submitted from other threads are
+// spread round-robin.
+class ThreadPool {
+public:
+    // Shared pool sized to the hardware (at least 2 workers)
+    static ThreadPool& getInstance();
+
+    explicit ThreadPool(size_t threadCount);
+    ~ThreadPool();  // runs the tasks already queued, then joins
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> task);
+    size_t size() const { return workers_.size(); }
+
+private:
+    struct Worker {
+        std::deque<std::function<void()>> tasks;
+        std::mutex mutex;
+        std::thread thread;
+    };
+
+    void run(size_t index);
+    bool popLocal(size_t index, std::function<void()>& task);
+    bool steal(size_t thief, std::function<void()>& task);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+    std::atomic<size_t> queued_{0};
+    std::atomic<size_t> nextWorker_{0};
+    bool stopping_ = false;  // guarded by sleepMutex_
+};
+
+#endif // THREAD_POOL_H
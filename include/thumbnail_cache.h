@@ -0,0 +1,53 @@
+#ifndef THUMBNAIL_CACHE_H
+#define THUMBNAIL_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Encoded thumbnail of an image file
+struct Thumbnail {
+    std::vector<unsigned char> data;
+    std::string mimeType;  // "image/jpeg" or "image/png"
+    int width = 0;
+    int height = 0;
+};
+
+// Thumbnails kept on disk across launches, one file per (path, file size, mtime, max size)
+// so an edited or replaced image is never served stale. Entries are written atomically
+// (temp file + rename) and the directory is trimmed to its budget, least recently used first.
+// All methods are thread-safe.
+class ThumbnailCache {
+public:
+    static const uint64_t kDefaultBudget = 128ull * 1024 * 1024;
+
+    // The process-wide cache over directory: every window's handler shares it, so pruning
+    // and its store counter are not raced by a second instance over the same files
+    static std::shared_ptr<ThumbnailCache> forDirectory(const std::string& directory);
+
+    explicit ThumbnailCache(std::string directory, uint64_t budget = kDefaultBudget);
+
+    // Cache key of the current version of the file at path; false if it is not a regular file
+    static bool key(const std::string& path, int maxSize, std::string& key, std::string& error);
+
+    bool lookup(const std::string& key, Thumbnail& thumbnail);
+    void store(const std::string& key, const Thumbnail& thumbnail);
+
+    // Delete the least recently used entries while the directory is over budget
+    void prune();
+
+    const std::string& directory() const { return directory_; }
+
+private:
+    std::string entryPath(const std::string& key) const;
+
+    const std::string directory_;
+    const uint64_t budget_;
+    std::mutex pruneMutex_;
+    std::atomic<unsigned> storesSincePrune_{0};
+};
+
+#endif // THUMBNAIL_CACHE_H
@@ -0,0 +1,23 @@
+#ifndef WEB_PRECACHE_H
+#define WEB_PRECACHE_H
+
+#include <string>
+#include <vector>
+
+// htmlLoading.precache for url-mode pages: asset URLs fetched once after the main window's first
+// paint so they sit in the WebView's persistent HTTP cache (revalidated with ETag /
+// Last-Modified on later launches). The fetches run inside the page, because only the
+// WebView's own network stack fills its cache.
+namespace web_precache {
+
+// Absolute URLs for the manifest entries, resolved against pageUrl ("." and ".." segments
+// removed). Entries that are not http(s), are on another origin (the page could not read
+// them without CORS) or repeat an earlier one are dropped.
+std::vector<std::string> resolve(const std::string& pageUrl, const std::vector<std::string>& entries);
+
+// Script for the page: fetches urls one at a time when idle, revalidating cached copies
+std::string script(const std::vector<std::string>& urls);
+
+} // namespace web_precache
+
+#endif // WEB_PRECACHE_H
@@ -25,6 +25,8 @@ public:
     void loadURL(const std::string& url);
     void setCreateWindowCallback(std::function<void(const std::string& title)> callback);
     void setMessageCallback(std::function<void(const std::string& jsonMessage)> callback);
+    // Time-to-first-paint: called with ms from the last load*() to the first paint of each document
+    void setFirstPaintCallback(std::function<void(double ms)> callback);
     void postMessageToJavaScript(const std::string& jsonMessage);
     
     // Platform-specific handle (opaque pointer)
@@ -39,6 +41,7 @@ private:
     void* nativeHandle_;
     std::function<void(const std::string& title)> createWindowCallback_;
     std::function<void(const std::string& jsonMessage)> messageCallback_;
+    std::function<void(double ms)> firstPaintCallback_;
     
     // Platform-specific implementation
     void createNativeWebView();
@@ -48,6 +51,7 @@ private:
     // Static callback wrappers
     static void createWindowCallbackWrapper(const std::string& title, void* userData);
     static void messageCallbackWrapper(const std::string& jsonMessage, void* userData);
+    static void firstPaintCallbackWrapper(double ms, void* userData);
 };
 
 #endif // WEBVIEW_H
@@ -0,0 +1,27 @@
+#ifndef WEBVIEW_EVENT_SINK_H
+#define WEBVIEW_EVENT_SINK_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <nlohmann/json.hpp>
+
+class WebView;
+
+// Delivers events from background work (ThreadPool tasks, watcher threads) to one WebView.
+// emit() is callable from any thread; the event is posted to the UI thread and sent with
+// NativeEventBus::emitTo. Handlers share the sink with their jobs and detach() it when they
+// go away, after which pending and later events are dropped.
+class WebViewEventSink : public std::enable_shared_from_this<WebViewEventSink> {
+public:
+    explicit WebViewEventSink(WebView* webView) : webView_(webView) {}
+
+    void emit(const std::string& eventName, nlohmann::json payload);
+    void detach();
+
+private:
+    std::mutex mutex_;
+    WebView* webView_;
+};
+
+#endif // WEBVIEW_EVENT_SINK_H
@@ -11,18 +11,39 @@
 #include "../include/handlers/calculator_handler.h"
 #include "../include/handlers/file_dialog_handler.h"
 #include "../include/handlers/read_file_handler.h"
+#include "../include/handlers/batch_file_handler.h"
 #include "../include/handlers/write_file_handler.h"
 #include "../include/handlers/file_system_handler.h"
+#include "../include/handlers/find_files_handler.h"
+#include "../include/handlers/watch_handler.h"
+#include "../include/handlers/hash_file_handler.h"
+#include "../include/handlers/compression_handler.h"
+#include "../include/handlers/copy_handler.h"
+#include "../include/handlers/download_handler.h"
+#include "../include/handlers/text_file_handler.h"
+#include "../include/handlers/thumbnail_handler.h"
+#include "../include/handlers/job_handler.h"
+#include "../include/handlers/handler_types.h"
 #include "../include/handlers/context_menu_handler.h"
 #include "../include/handlers/focus_window_handler.h"
 #include "../include/handlers/options_handler.h"
 #include "../include/handlers/reload_main_content_handler.h"
 #include "../include/handlers/reload_main_window_handler.h"
+#include "../include/handlers/state_handler.h"
+#include "../include/shared_state_store.h"
 #include "../include/app_handlers.h"
+#include "../include/plugin_host.h"
+#include "../include/asset_bundle.h"
+#include "../include/deferred_delete.h"
+#include "../include/job_manager.h"
+#include "../include/main_thread.h"
+#include "../include/single_instance.h"
+#include "../include/web_precache.h"
 #include "platform/platform_impl.h"
 #include <iostream>
 #include <filesystem>
 #include <stdexcept>
+#include <chrono>
 #if defined(_WIN32)
 #include <windows.h>
 #else
@@ -60,31 +81,40 @@ static std::string getPluginPath(const std::string& exeDir) {
     return name;
 }
 
-static bool tryLoadPluginFromPath(const std::string& path, MessageRouter* router) {
+// ABI v2 plugins: one manifest (*.json) per plugin in <exeDir>/plugins
+static std::string getPluginsDirectory(const std::string& exeDir) {
+    namespace fs = std::filesystem;
+    return exeDir.empty() ? std::string("plugins") : (fs::path(exeDir) / "plugins").string();
+}
+
+// Load the plugin library and resolve registerAppHandlers. Thread-safe (no UI, no router):
+// called from a worker thread at startup. Returns nullptr if missing or invalid.
+static RegisterAppHandlersFn resolvePluginFromPath(const std::string& path) {
 #if defined(_WIN32)
     HMODULE h = LoadLibraryA(path.c_str());
-    if (!h) return false;
+    if (!h) return nullptr;
     auto fn = reinterpret_cast<RegisterAppHandlersFn>(GetProcAddress(h, "registerAppHandlers"));
     if (!fn) {
         FreeLibrary(h);
-        return false;
+        return nullptr;
     }
 #else
     void* h = dlopen(path.c_str(), RTLD_NOW);
-    if (!h) return false;
+    if (!h) return nullptr;
     auto fn = reinterpret_cast<RegisterAppHandlersFn>(dlsym(h, "registerAppHandlers"));
     if (!fn) {
         dlclose(h);
-        return false;
+        return nullptr;
     }
 #endif
-    fn(router);
-    return true;
+    return fn;
 }
 
-static bool tryLoadPlugin(const std::string& exeDir, MessageRouter* router) {
-    std::string path = getPluginPath(exeDir);
-    return tryLoadPluginFromPath(path, router);
+static bool tryLoadPluginFromPath(const std::string& path, MessageRouter* router) {
+    RegisterAppHandlersFn fn = resolvePluginFromPath(path);
+    if (!fn) return false;
+    fn(router);
+    return true;
 }
 
 AppRunner::AppRunner(int argc, const char* argv[])
@@ -92,16 +122,78 @@ AppRunner::AppRunner(int argc, const char* argv[])
 }
 
 AppRunner::~AppRunner() {
+    // Don't leave workers running against this object if run() threw early
+    if (configFuture_.valid()) configFuture_.wait();
+    if (pluginFuture_.valid()) pluginFuture_.wait();
+    singleInstance_.reset();
     eventHandler_.reset();
     mainWindow_.reset();
+    // The handlers just destroyed cancelled their background work; wait for it here, while the
+    // ThreadPool and caches it uses still exist
+    JobManager::getInstance().shutdown();
+}
+
+bool AppRunner::forwardToRunningInstance() {
+    for (int i = 1; i < argc_ && argv_[i]; ++i) {
+        if (std::string(argv_[i]) == "--new-instance") return false;
+    }
+    singleInstance_ = std::make_unique<SingleInstance>(
+        SingleInstance::defaultSocketPath(ConfigManager::getAppName(), ConfigManager::getConfigDirectory()));
+    std::vector<std::string> paths = SingleInstance::openPaths(argc_, argv_);
+    std::string error;
+    switch (singleInstance_->acquire(paths, error)) {
+        case SingleInstance::Role::Forwarded:
+            std::cout << "[AppRunner] Already running; handed " << paths.size() << " path(s) to it" << std::endl;
+            singleInstance_.reset();
+            return true;
+        case SingleInstance::Role::Standalone:
+            std::cerr << "[AppRunner] Single-instance mode off: " << error << std::endl;
+            singleInstance_.reset();
+            return false;
+        case SingleInstance::Role::Primary:
+            break;
+    }
+    return false;
+}
+
+void AppRunner::startBackgroundLoads() {
+    configFuture_ = std::async(std::launch::async, [this]() { loadConfig(); });
+
+    // Deferred deletions cut short by the last exit resume on the (idle-priority) delete worker
+    std::error_code ec;
+    std::filesystem::path cwd = std::filesystem::current_path(ec);
+    if (!ec && std::filesystem::exists(cwd / DeferredDeleter::kTrashDirName, ec)) {
+        DeferredDeleter::getInstance().recover(cwd);
+    }
+
+    std::string exeDir;
+    if (argc_ > 0 && argv_) {
+        exeDir = getExecutableDir(argv_[0]);
+    }
+    std::string pluginPath = getPluginPath(exeDir);
+    std::string pluginsDir = getPluginsDirectory(exeDir);
+    pluginFuture_ = std::async(std::launch::async, [pluginPath, pluginsDir]() {
+        // Manifests only; v2 plugin libraries are loaded on their first message
+        size_t count = PluginHost::getInstance().scanDirectory(pluginsDir);
+        if (count > 0) {
+            std::cout << "[AppRunner] Found " << count << " plugin manifest(s) in " << pluginsDir << std::endl;
+        }
+        return resolvePluginFromPath(pluginPath);
+    });
 }
 
+// Runs on a worker thread (see startBackgroundLoads); only touches ConfigManager and members
+// that the main thread reads after configFuture_.get().
 void AppRunner::loadConfig() {
     ConfigManager& config = ConfigManager::getInstance();
     if (!config.loadOptions()) {
         std::cerr << "Warning: Failed to load options, using defaults" << std::endl;
     }
+    // Seed the shared store so windows read options from memory instead of re-reading options.json
+    SharedStateStore::getInstance().set("options", config.getOptions());
 
+    preloadScript_ = ConfigManager::getPreloadScriptContent();
+    precache_.clear();
     loadingMethod_ = config.getHtmlLoadingMethod();
     contentType_ = WebViewContentType::Default;
     content_.clear();
@@ -122,6 +214,7 @@ void AppRunner::loadConfig() {
             content_ = "<html><body><h1>Error: No URL specified</h1><p>Set url in options.json</p></body></html>";
         } else {
             contentType_ = WebViewContentType::Url;
+            precache_ = web_precache::resolve(content_, config.getHtmlPrecache());
         }
     } else if (loadingMethod_ == "file") {
         content_ = config.getHtmlFilePath();
@@ -134,6 +227,15 @@ void AppRunner::loadConfig() {
         } else {
             contentType_ = WebViewContentType::File;
         }
+    } else if (loadingMethod_ == "app") {
+        std::string entry = config.getHtmlAppEntry();
+        if (asset_bundle::find(entry)) {
+            contentType_ = WebViewContentType::Url;
+            content_ = asset_bundle::url(entry);
+        } else {
+            contentType_ = WebViewContentType::Html;
+            content_ = "<html><body><h1>Error: " + entry + " is not bundled</h1><p>Build with -DCROSSDEV_WEB_ASSETS_DIR=&lt;web app dir&gt;</p></body></html>";
+        }
     } else {
         content_ = ConfigManager::tryLoadFileContent("demo.html");
         if (content_.empty()) {
@@ -149,9 +251,32 @@ void AppRunner::createMainWindow() {
         "Cars", contentType_, content_);
 }
 
+std::vector<MessageRouter::LazyHandler> AppRunner::childWindowHandlers(const std::string& name, WebView* webView) {
+    WebViewWindow* main = mainWindow_.get();
+    std::vector<MessageRouter::LazyHandler> handlers;
+    handlers.push_back({handler_types::kFocusWindow, createFocusWindowHandler});
+    handlers.push_back({handler_types::kOptions, createOptionsHandler});
+    handlers.push_back({handler_types::kFileDialog, [main]() { return createFileDialogHandler(main->getWindow()); }});
+    handlers.push_back({handler_types::kState, [webView]() { return createStateHandler(webView); }});
+    handlers.push_back({handler_types::kWatch, [webView]() { return createWatchHandler(webView); }});
+    handlers.push_back({handler_types::kTextFile, [webView]() { return createTextFileHandler(webView); }});
+    handlers.push_back({handler_types::kThumbnail, [webView]() {
+        return createThumbnailHandler(webView, ConfigManager::getThumbnailCacheDirectory());
+    }});
+    // For settings window, add reloadMainWindow to explicitly reload main window
+    if (name == "settings") {
+        std::cout << "[AppRunner] Attaching reloadMainWindowHandler to settings window ✓" << std::endl;
+        handlers.push_back({handler_types::kReloadMainWindow, [main]() { return createReloadMainWindowHandler(main); }});
+    } else {
+        std::cout << "[AppRunner] Attaching reloadMainContentHandler to window: " << name << std::endl;
+        handlers.push_back({handler_types::kReloadMainContent, [main]() { return createReloadMainContentHandler(main); }});
+    }
+    return handlers;
+}
+
 void AppRunner::setupEventHandler() {
     eventHandler_ = std::make_unique<EventHandler>(
-        mainWindow_->getWindow(), mainWindow_->getWebView());
+        mainWindow_->getWindow(), mainWindow_->getWebView(), preloadScript_);
 
     eventHandler_->onWebViewCreateWindow(
         [this](const std::string& name, const std::string& title, WebViewContentType type, const std::string& cnt, bool isSingleton, int x, int y, int width, int height) {
@@ -168,19 +293,7 @@ void AppRunner::setupEventHandler() {
                 if (height <= 0) height = 700;
                 auto attachFn = [this, name](WebView* wv) {
                     if (eventHandler_ && wv && mainWindow_) {
-                        std::vector<std::shared_ptr<MessageHandler>> extras;
-                        extras.push_back(createFocusWindowHandler());
-                        extras.push_back(createOptionsHandler());
-                        extras.push_back(createFileDialogHandler(mainWindow_->getWindow()));
-                        // For settings window, add reloadMainWindow to explicitly reload main window
-                        if (name == "settings") {
-                            std::cout << "[AppRunner] Attaching reloadMainWindowHandler to settings window ✓" << std::endl;
-                            extras.push_back(createReloadMainWindowHandler(mainWindow_.get()));
-                        } else {
-                            std::cout << "[AppRunner] Attaching reloadMainContentHandler to window: " << name << std::endl;
-                            extras.push_back(createReloadMainContentHandler(mainWindow_.get()));
-                        }
-                        eventHandler_->attachWebView(wv, extras);
+                        eventHandler_->attachWebView(wv, childWindowHandlers(name, wv));
                     }
                 };
                 WebViewWindow* child = nullptr;
@@ -192,19 +305,7 @@ void AppRunner::setupEventHandler() {
                     auto childPtr = std::make_unique<WebViewWindow>(mainWindow_.get(), x, y, width, height, title, contentType, content);
                     child = childPtr.get();
                     if (eventHandler_ && child && mainWindow_) {
-                        std::vector<std::shared_ptr<MessageHandler>> extras;
-                        extras.push_back(createFocusWindowHandler());
-                        extras.push_back(createOptionsHandler());
-                        extras.push_back(createFileDialogHandler(mainWindow_->getWindow()));
-                        // For settings window, add reloadMainWindow to explicitly reload main window
-                        if (name == "settings") {
-                            std::cout << "[AppRunner] Attaching reloadMainWindowHandler to settings window (non-singleton) ✓" << std::endl;
-                            extras.push_back(createReloadMainWindowHandler(mainWindow_.get()));
-                        } else {
-                            std::cout << "[AppRunner] Attaching reloadMainContentHandler to window (non-singleton): " << name << std::endl;
-                            extras.push_back(createReloadMainContentHandler(mainWindow_.get()));
-                        }
-                        eventHandler_->attachWebView(child->getWebView(), extras);
+                        eventHandler_->attachWebView(child->getWebView(), childWindowHandlers(name, child->getWebView()));
                     }
                     child->show();
                     childPtr.release();  // Ownership transferred to Component parent (mainWindow_)
@@ -223,21 +324,48 @@ void AppRunner::registerHandlers() {
 
     SingletonWebViewWindowManager::getInstance().registerWindow(SingletonWebViewWindowManager::MAIN_WINDOW_NAME, mainWindow_.get());
 
-    router->registerHandler(createAppInfoHandler());
-    router->registerHandler(createCalculatorHandler());
-    router->registerHandler(createFileDialogHandler(mainWindow_->getWindow()));
-    router->registerHandler(createReadFileHandler());
-    router->registerHandler(createWriteFileHandler());
-    router->registerHandler(createFileSystemHandler());
-    router->registerHandler(createContextMenuHandler(mainWindow_, eventHandler_->getMessageRouterShared()));
-    router->registerHandler(createFocusWindowHandler());
-    router->registerHandler(createOptionsHandler());
-    router->registerHandler(createReloadMainContentHandler(mainWindow_.get()));
-    std::string exeDir;
-    if (argc_ > 0 && argv_) {
-        exeDir = getExecutableDir(argv_[0]);
-    }
-    if (!tryLoadPlugin(exeDir, router)) {
+    // Handlers are built on the first message of their types; unused capabilities cost nothing
+    WebViewWindow* main = mainWindow_.get();
+    router->registerHandlerFactory(handler_types::kAppInfo, createAppInfoHandler);
+    router->registerHandlerFactory(handler_types::kCalculator, createCalculatorHandler);
+    router->registerHandlerFactory(handler_types::kFileDialog, [main]() { return createFileDialogHandler(main->getWindow()); });
+    router->registerHandlerFactory(handler_types::kReadFile, createReadFileHandler);
+    router->registerHandlerFactory(handler_types::kBatchFile, createBatchFileHandler);
+    router->registerHandlerFactory(handler_types::kWriteFile, createWriteFileHandler);
+    router->registerHandlerFactory(handler_types::kFileSystem, [main]() { return createFileSystemHandler(main->getWebView()); });
+    router->registerHandlerFactory(handler_types::kFindFiles, [main]() { return createFindFilesHandler(main->getWebView()); });
+    router->registerHandlerFactory(handler_types::kWatch, [main]() { return createWatchHandler(main->getWebView()); });
+    router->registerHandlerFactory(handler_types::kHashFile, [main]() { return createHashFileHandler(main->getWebView()); });
+    router->registerHandlerFactory(handler_types::kCompression,
+                                   [main]() { return createCompressionHandler(main->getWebView()); });
+    router->registerHandlerFactory(handler_types::kCopy, [main]() { return createCopyHandler(main->getWebView()); });
+    router->registerHandlerFactory(handler_types::kDownload, [main]() { return createDownloadHandler(main->getWebView()); });
+    router->registerHandlerFactory(handler_types::kTextFile, [main]() { return createTextFileHandler(main->getWebView()); });
+    router->registerHandlerFactory(handler_types::kThumbnail, [main]() {
+        return createThumbnailHandler(main->getWebView(), ConfigManager::getThumbnailCacheDirectory());
+    });
+    // startJob looks types up at call time, so plugin and app handlers registered below count too
+    router->registerHandlerFactory(handler_types::kJob, [main, router]() {
+        return createJobHandler(main->getWebView(),
+                                [router](const std::string& type) { return router->findHandler(type); });
+    });
+    router->registerHandlerFactory(handler_types::kContextMenu, [this]() {
+        return createContextMenuHandler(mainWindow_, eventHandler_->getMessageRouterShared());
+    });
+    router->registerHandlerFactory(handler_types::kFocusWindow, createFocusWindowHandler);
+    router->registerHandlerFactory(handler_types::kOptions, createOptionsHandler);
+    router->registerHandlerFactory(handler_types::kState, [main]() { return createStateHandler(main->getWebView()); });
+    router->registerHandlerFactory(handler_types::kReloadMainContent, [main]() { return createReloadMainContentHandler(main); });
+
+    // Join the plugin load started in startBackgroundLoads; registration must complete
+    // before the run loop routes the first message.
+    RegisterAppHandlersFn pluginFn = pluginFuture_.valid() ? pluginFuture_.get() : nullptr;
+    PluginHost& pluginHost = PluginHost::getInstance();
+    pluginHost.registerHandlers(router);
+    if (pluginFn) {
+        pluginFn(router);
+    } else if (pluginHost.getManifests().empty()) {
+        // Neither a legacy CrossDevAppPlugin nor a plugins directory: ask for the legacy plugin
         std::string manualPath;
         std::string title = "Select CrossDev plugin (CrossDevAppPlugin)";
         std::string filter =
@@ -261,14 +389,44 @@ void AppRunner::registerHandlers() {
 }
 
 int AppRunner::run() {
+    // Before any toolkit, config or plugin work: a second launch costs a socket round trip
+    if (forwardToRunningInstance()) {
+        return 0;
+    }
     std::cout << "Running on " << PLATFORM_NAME << std::endl;
     std::cout << "Config directory: " << ConfigManager::getConfigDirectory() << std::endl;
     std::cout << "Options file: " << ConfigManager::getOptionsFilePath() << std::endl;
 
-    loadConfig();
+    auto startTime = std::chrono::steady_clock::now();
+    startBackgroundLoads();
+    Application::getInstance().init();  // GTK/WebKit init overlaps options + plugin loading
+    configFuture_.get();
+    // Before the first WebView: the HTTP cache persists across launches (url mode reloads
+    // the same bundle every start; cached entries are revalidated instead of downloaded)
+    platform::setWebCacheDirectory(ConfigManager::getWebCacheDirectory());
+    if (!platform::registerAppScheme() && loadingMethod_ == "app") {
+        contentType_ = WebViewContentType::Html;
+        content_ = "<html><body><h1>Error: app loading is not supported on this platform yet</h1></body></html>";
+    }
     createMainWindow();
     setupEventHandler();
     registerHandlers();
+    auto startupMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "[AppRunner] Startup (config, window, handlers, plugin): " << startupMs << " ms" << std::endl;
+    std::string precacheScript = precache_.empty() ? std::string() : web_precache::script(precache_);
+    WebView* mainWebView = mainWindow_->getWebView();
+    mainWebView->setFirstPaintCallback([startTime, precacheScript, mainWebView](double ms) mutable {
+        auto sinceStart = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - startTime).count();
+        std::cout << "[AppRunner] Main window first paint: " << static_cast<long>(ms)
+                  << " ms after load, " << sinceStart << " ms after start" << std::endl;
+        if (!precacheScript.empty()) {
+            // Once per run, after the page is visible so it never competes with the first paint
+            platform::executeWebViewScript(mainWebView->getNativeHandle(), precacheScript);
+            precacheScript.clear();
+        }
+    });
 
     std::cout << "HTML loading method: " << loadingMethod_ << std::endl;
 
@@ -276,6 +434,18 @@ int AppRunner::run() {
     mainWindow_->getWindow()->maximize();
 
     platform::deliverOpenFilePaths(argc_, argv_);
+    if (singleInstance_) {
+        // Later launches' paths arrive on the listener thread; deliver them like our own argv
+        std::weak_ptr<WebViewWindow> window = mainWindow_;
+        singleInstance_->setHandler([window](const std::vector<std::string>& paths) {
+            runOnMainThread([window, paths]() {
+                std::vector<const char*> args = {""};
+                for (const auto& path : paths) args.push_back(path.c_str());
+                platform::deliverOpenFilePaths(static_cast<int>(args.size()), args.data());
+                if (auto main = window.lock()) main->show();
+            });
+        });
+    }
 
     std::cout << "Window created with web view." << std::endl;
 
@@ -7,6 +7,10 @@ Application& Application::getInstance() {
     return instance;
 }
 
+void Application::init() {
+    platform::initApplication();
+}
+
 void Application::run() {
     platform::initApplication();
     platform::runApplication();
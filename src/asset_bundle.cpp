@@ -0,0 +1,61 @@
+#include "../include/asset_bundle.h"
+#include "../include/settings_embed.h"
+#include <cstring>
+
+namespace asset_bundle {
+
+const Asset* find(const std::string& path) {
+    size_t count = 0;
+    const Asset* assets = entries(count);
+    const char* key = path.c_str();
+    if (*key == '/') ++key;
+    size_t lo = 0, hi = count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        int cmp = std::strcmp(assets[mid].path, key);
+        if (cmp == 0) return &assets[mid];
+        if (cmp < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return nullptr;
+}
+
+bool pathFromUrl(const std::string& url, std::string& path) {
+    std::string prefix = std::string(SCHEME) + "://" + HOST;
+    if (url.compare(0, prefix.size(), prefix) != 0) {
+        return false;
+    }
+    std::string rest = url.substr(prefix.size());
+    if (!rest.empty() && rest[0] != '/' && rest[0] != '?' && rest[0] != '#') {
+        return false;  // other host, e.g. crossdev://application
+    }
+    size_t end = rest.find_first_of("?#");
+    if (end != std::string::npos) rest = rest.substr(0, end);
+    while (!rest.empty() && rest[0] == '/') rest.erase(0, 1);
+    if (rest.empty() || rest.back() == '/') rest += "index.html";
+    path = rest;
+    return true;
+}
+
+std::string url(const std::string& path) {
+    std::string p = path;
+    while (!p.empty() && p[0] == '/') p.erase(0, 1);
+    return std::string(SCHEME) + "://" + HOST + "/" + p;
+}
+
+} // namespace asset_bundle
+
+const std::string& getEmbeddedSettingsHtml() {
+    // settings.html is bundled uncompressed (RAW_FILES in CMakeLists.txt)
+    static const std::string html = []() {
+        const asset_bundle::Asset* asset = asset_bundle::find("settings.html");
+        if (!asset || asset->encoding != asset_bundle::Encoding::Identity) {
+            return std::string("<html><body><h1>Settings</h1><p>settings.html is not bundled.</p></body></html>");
+        }
+        return std::string(reinterpret_cast<const char*>(asset->data), asset->size);
+    }();
+    return html;
+}
@@ -1,55 +1,404 @@
 #include "../include/base64.h"
-#include <stdexcept>
+#include "../include/cpu_features.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define BASE64_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define BASE64_NEON 1
+#include <arm_neon.h>
+#endif
+
+// GCC/Clang compile each x86 kernel for its own ISA; MSVC accepts the intrinsics anywhere
+#if defined(__GNUC__) || defined(__clang__)
+#define BASE64_TARGET(isa) __attribute__((target(isa)))
+#else
+#define BASE64_TARGET(isa)
+#endif
 
 namespace base64 {
 
 static const char kChars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 
-std::string encode(const unsigned char* data, size_t len) {
-    if (!data && len > 0) return "";
-    std::string result;
-    result.reserve(((len + 2) / 3) * 4);
-    for (size_t i = 0; i < len; i += 3) {
-        unsigned int n = static_cast<unsigned int>(data[i]) << 16;
-        if (i + 1 < len) n |= static_cast<unsigned int>(data[i + 1]) << 8;
-        if (i + 2 < len) n |= static_cast<unsigned int>(data[i + 2]);
-        result += kChars[(n >> 18) & 63];
-        result += kChars[(n >> 12) & 63];
-        result += (i + 1 < len) ? kChars[(n >> 6) & 63] : '=';
-        result += (i + 2 < len) ? kChars[n & 63] : '=';
+// Sextet for each byte; 0xFF for bytes outside the alphabet (including '=')
+struct DecodeTable {
+    unsigned char values[256];
+    DecodeTable() {
+        for (int i = 0; i < 256; ++i) values[i] = 0xFF;
+        for (int i = 0; i < 64; ++i) values[static_cast<unsigned char>(kChars[i])] = static_cast<unsigned char>(i);
     }
-    return result;
+};
+static const DecodeTable kDecode;
+
+// ---- Scalar reference: also finishes the tail left by the SIMD kernels ----
+
+static void encodeScalar(const unsigned char* in, size_t len, char* out) {
+    size_t i = 0;
+    for (; i + 3 <= len; i += 3) {
+        unsigned int n = (static_cast<unsigned int>(in[i]) << 16) | (static_cast<unsigned int>(in[i + 1]) << 8) | in[i + 2];
+        out[0] = kChars[(n >> 18) & 63];
+        out[1] = kChars[(n >> 12) & 63];
+        out[2] = kChars[(n >> 6) & 63];
+        out[3] = kChars[n & 63];
+        out += 4;
+    }
+    if (i < len) {
+        unsigned int n = static_cast<unsigned int>(in[i]) << 16;
+        if (i + 1 < len) n |= static_cast<unsigned int>(in[i + 1]) << 8;
+        out[0] = kChars[(n >> 18) & 63];
+        out[1] = kChars[(n >> 12) & 63];
+        out[2] = (i + 1 < len) ? kChars[(n >> 6) & 63] : '=';
+        out[3] = '=';
+    }
+}
+
+// len is a multiple of 4; '=' is only accepted as padding in the final quad
+static bool decodeScalar(const char* in, size_t len, unsigned char* out) {
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(in);
+    for (size_t i = 0; i < len; i += 4) {
+        bool last = i + 4 == len;
+        bool padC = last && s[i + 2] == '=' && s[i + 3] == '=';
+        bool padD = last && s[i + 3] == '=';
+        unsigned int a = kDecode.values[s[i]];
+        unsigned int b = kDecode.values[s[i + 1]];
+        unsigned int c = padC ? 0 : kDecode.values[s[i + 2]];
+        unsigned int d = padD ? 0 : kDecode.values[s[i + 3]];
+        if ((a | b | c | d) & 0x80) return false;
+        unsigned int n = (a << 18) | (b << 12) | (c << 6) | d;
+        *out++ = static_cast<unsigned char>(n >> 16);
+        if (!padC) *out++ = static_cast<unsigned char>(n >> 8);
+        if (!padD) *out++ = static_cast<unsigned char>(n);
+    }
+    return true;
+}
+
+// ---- SIMD kernels: each handles a prefix and returns the input consumed ----
+// Encoders consume whole 3-byte groups, decoders whole quads and never the final quad
+// (padding is left to the scalar tail).
+
+#ifdef BASE64_X86
+
+// 12 input bytes (in the low 12 of 16 lanes) -> 16 sextets, one per byte (Mula's multiply-shift split)
+BASE64_TARGET("ssse3")
+static inline __m128i encodeSextets128(__m128i in) {
+    in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+    const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+    const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    return _mm_or_si128(t1, t3);
+}
+
+// Sextet -> ASCII: range index via saturating subtract, then a per-range offset from a 16-entry table
+BASE64_TARGET("ssse3")
+static inline __m128i sextetsToAscii128(__m128i sextets) {
+    __m128i range = _mm_subs_epu8(sextets, _mm_set1_epi8(51));
+    const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), sextets);
+    range = _mm_or_si128(range, _mm_and_si128(less, _mm_set1_epi8(13)));
+    const __m128i offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                          '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    return _mm_add_epi8(_mm_shuffle_epi8(offsets, range), sextets);
+}
+
+BASE64_TARGET("ssse3")
+static size_t encodeSsse3(const unsigned char* in, size_t len, char* out) {
+    size_t i = 0;
+    for (; i + 16 <= len; i += 12) {  // reads 16, uses 12
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), sextetsToAscii128(encodeSextets128(v)));
+        out += 16;
+    }
+    return i;
+}
+
+// ASCII -> sextets for 16 chars; false if any char is outside the alphabet.
+// Validity from nibble tables (a char is valid iff lo[low nibble] & hi[high nibble] == 0).
+BASE64_TARGET("ssse3")
+static inline bool asciiToSextets128(__m128i& v) {
+    const __m128i hiNibble = _mm_and_si128(_mm_srli_epi32(v, 4), _mm_set1_epi8(0x0f));
+    const __m128i loNibble = _mm_and_si128(v, _mm_set1_epi8(0x0f));
+    const __m128i lo = _mm_shuffle_epi8(_mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                                      0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A), loNibble);
+    const __m128i hi = _mm_shuffle_epi8(_mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                                      0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10), hiNibble);
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128())) != 0xFFFF) {
+        return false;
+    }
+    const __m128i isSlash = _mm_cmpeq_epi8(v, _mm_set1_epi8('/'));
+    const __m128i roll = _mm_shuffle_epi8(_mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0),
+                                          _mm_add_epi8(isSlash, hiNibble));
+    v = _mm_add_epi8(v, roll);
+    return true;
+}
+
+// 16 sextets -> 12 bytes in the low lanes
+BASE64_TARGET("ssse3")
+static inline __m128i packSextets128(__m128i v) {
+    const __m128i pairs = _mm_maddubs_epi16(v, _mm_set1_epi32(0x01400140));
+    const __m128i words = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+    return _mm_shuffle_epi8(words, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+BASE64_TARGET("ssse3")
+static size_t decodeSsse3(const char* in, size_t len, unsigned char* out) {
+    size_t i = 0;
+    for (; i + 24 <= len; i += 16) {  // writes 16, keeps 12: at least 8 chars (>= 4 bytes) follow
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        if (!asciiToSextets128(v)) break;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), packSextets128(v));
+        out += 12;
+    }
+    return i;
+}
+
+// AVX2 runs the same per-lane algorithm on two 12-byte groups at once
+BASE64_TARGET("avx2")
+static size_t encodeAvx2(const unsigned char* in, size_t len, char* out) {
+    const __m256i shuffle = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+                                             1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    const __m256i offsets = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                             '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+                                             'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                             '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    size_t i = 0;
+    for (; i + 28 <= len; i += 24) {  // second half reads bytes 12..27
+        __m256i v = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i))),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 12)), 1);
+        v = _mm256_shuffle_epi8(v, shuffle);
+        const __m256i t0 = _mm256_and_si256(v, _mm256_set1_epi32(0x0fc0fc00));
+        const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        const __m256i t2 = _mm256_and_si256(v, _mm256_set1_epi32(0x003f03f0));
+        const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        const __m256i sextets = _mm256_or_si256(t1, t3);
+        __m256i range = _mm256_subs_epu8(sextets, _mm256_set1_epi8(51));
+        const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), sextets);
+        range = _mm256_or_si256(range, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+        const __m256i ascii = _mm256_add_epi8(_mm256_shuffle_epi8(offsets, range), sextets);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), ascii);
+        out += 32;
+    }
+    return i;
+}
+
+BASE64_TARGET("avx2")
+static size_t decodeAvx2(const char* in, size_t len, unsigned char* out) {
+    const __m256i loTable = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                             0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+                                             0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                             0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m256i hiTable = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                             0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                                             0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                             0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m256i rollTable = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+                                               0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i packLanes = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                               2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    size_t i = 0;
+    for (; i + 48 <= len; i += 32) {  // writes 32, keeps 24: at least 16 chars (>= 10 bytes) follow
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        const __m256i hiNibble = _mm256_and_si256(_mm256_srli_epi32(v, 4), _mm256_set1_epi8(0x0f));
+        const __m256i loNibble = _mm256_and_si256(v, _mm256_set1_epi8(0x0f));
+        const __m256i lo = _mm256_shuffle_epi8(loTable, loNibble);
+        const __m256i hi = _mm256_shuffle_epi8(hiTable, hiNibble);
+        if (!_mm256_testz_si256(lo, hi)) break;
+        const __m256i isSlash = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('/'));
+        v = _mm256_add_epi8(v, _mm256_shuffle_epi8(rollTable, _mm256_add_epi8(isSlash, hiNibble)));
+        const __m256i pairs = _mm256_maddubs_epi16(v, _mm256_set1_epi32(0x01400140));
+        const __m256i words = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+        const __m256i packed = _mm256_shuffle_epi8(words, packLanes);
+        // 12 bytes per lane -> 24 contiguous bytes
+        const __m256i joined = _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), joined);
+        out += 24;
+    }
+    return i;
+}
+
+#endif // BASE64_X86
+
+#ifdef BASE64_NEON
+
+static size_t encodeNeon(const unsigned char* in, size_t len, char* out) {
+    uint8x16x4_t alphabet;
+    for (int t = 0; t < 4; ++t) {
+        alphabet.val[t] = vld1q_u8(reinterpret_cast<const uint8_t*>(kChars) + 16 * t);
+    }
+    const uint8x16_t mask = vdupq_n_u8(0x3f);
+    size_t i = 0;
+    for (; i + 48 <= len; i += 48) {
+        uint8x16x3_t bytes = vld3q_u8(in + i);  // de-interleaves the 3-byte groups
+        uint8x16x4_t chars;
+        chars.val[0] = vshrq_n_u8(bytes.val[0], 2);
+        chars.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(bytes.val[0], 4), vshrq_n_u8(bytes.val[1], 4)), mask);
+        chars.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(bytes.val[1], 2), vshrq_n_u8(bytes.val[2], 6)), mask);
+        chars.val[3] = vandq_u8(bytes.val[2], mask);
+        for (int k = 0; k < 4; ++k) {
+            chars.val[k] = vqtbl4q_u8(alphabet, chars.val[k]);
+        }
+        vst4q_u8(reinterpret_cast<uint8_t*>(out), chars);
+        out += 64;
+    }
+    return i;
+}
+
+static size_t decodeNeon(const char* in, size_t len, unsigned char* out) {
+    // Two 64-entry halves of the ASCII decode table (0xFF = invalid)
+    uint8x16x4_t low, high;
+    for (int t = 0; t < 4; ++t) {
+        low.val[t] = vld1q_u8(kDecode.values + 16 * t);
+        high.val[t] = vld1q_u8(kDecode.values + 64 + 16 * t);
+    }
+    const uint8x16_t sixtyFour = vdupq_n_u8(64);
+    const uint8x16_t nonAscii = vdupq_n_u8(128);
+    size_t i = 0;
+    for (; i + 68 <= len; i += 64) {  // exact 48-byte stores; the final quad is never taken
+        uint8x16x4_t chars = vld4q_u8(reinterpret_cast<const uint8_t*>(in + i));
+        uint8x16_t invalid = vdupq_n_u8(0);
+        for (int k = 0; k < 4; ++k) {
+            uint8x16_t c = chars.val[k];
+            uint8x16_t v = vqtbl4q_u8(low, c);                    // c >= 64 -> 0
+            v = vqtbx4q_u8(v, high, vsubq_u8(c, sixtyFour));      // c < 64 wraps out of range -> kept
+            v = vorrq_u8(v, vcgeq_u8(c, nonAscii));               // c >= 128 -> 0xFF
+            invalid = vorrq_u8(invalid, v);
+            chars.val[k] = v;
+        }
+        if (vmaxvq_u8(invalid) > 63) break;
+        uint8x16x3_t bytes;
+        bytes.val[0] = vorrq_u8(vshlq_n_u8(chars.val[0], 2), vshrq_n_u8(chars.val[1], 4));
+        bytes.val[1] = vorrq_u8(vshlq_n_u8(chars.val[1], 4), vshrq_n_u8(chars.val[2], 2));
+        bytes.val[2] = vorrq_u8(vshlq_n_u8(chars.val[2], 6), chars.val[3]);
+        vst3q_u8(out, bytes);
+        out += 48;
+    }
+    return i;
+}
+
+#endif // BASE64_NEON
+
+// ---- Dispatch ----
+
+static bool cpuSupports(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::Scalar:
+            return true;
+#ifdef BASE64_X86
+        case Kernel::Ssse3:
+            return cpu_features::hasSsse3();
+        case Kernel::Avx2:
+            return cpu_features::hasSsse3() && cpu_features::hasAvx2();
+#endif
+#ifdef BASE64_NEON
+        case Kernel::Neon:
+            return true;  // baseline on arm64
+#endif
+        default:
+            return false;
+    }
+}
+
+static cpu_features::KernelDispatch<Kernel>& dispatch() {
+    static cpu_features::KernelDispatch<Kernel> instance(
+        {Kernel::Scalar, Kernel::Ssse3, Kernel::Avx2, Kernel::Neon}, cpuSupports);
+    return instance;
+}
+
+const char* kernelName(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::Scalar: return "scalar";
+        case Kernel::Ssse3: return "ssse3";
+        case Kernel::Avx2: return "avx2";
+        case Kernel::Neon: return "neon";
+    }
+    return "unknown";
+}
+
+Kernel activeKernel() {
+    return dispatch().active();
+}
+
+std::vector<Kernel> supportedKernels() {
+    return dispatch().supported();
+}
+
+bool setKernel(Kernel kernel) {
+    return dispatch().select(kernel);
+}
+
+size_t decodedSize(const char* encoded, size_t len) {
+    if (len == 0 || len % 4 != 0) return 0;
+    size_t size = (len / 4) * 3;
+    if (encoded[len - 1] == '=') --size;
+    if (encoded[len - 2] == '=') --size;
+    return size;
 }
 
-static int decodeChar(char c) {
-    if (c >= 'A' && c <= 'Z') return c - 'A';
-    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
-    if (c >= '0' && c <= '9') return c - '0' + 52;
-    if (c == '+') return 62;
-    if (c == '/') return 63;
-    return -1;
+size_t encode(const unsigned char* data, size_t len, char* out) {
+    size_t done = 0;
+    switch (activeKernel()) {
+#ifdef BASE64_X86
+        case Kernel::Avx2:
+            done = encodeAvx2(data, len, out);
+            done += encodeSsse3(data + done, len - done, out + done / 3 * 4);
+            break;
+        case Kernel::Ssse3:
+            done = encodeSsse3(data, len, out);
+            break;
+#endif
+#ifdef BASE64_NEON
+        case Kernel::Neon:
+            done = encodeNeon(data, len, out);
+            break;
+#endif
+        default:
+            break;
+    }
+    encodeScalar(data + done, len - done, out + done / 3 * 4);
+    return encodedSize(len);
+}
+
+bool decode(const char* encoded, size_t len, unsigned char* out, size_t& outLen) {
+    outLen = 0;
+    if (len % 4 != 0) return false;
+    if (len == 0) return true;
+    size_t done = 0;
+    switch (activeKernel()) {
+#ifdef BASE64_X86
+        case Kernel::Avx2:
+            done = decodeAvx2(encoded, len, out);
+            done += decodeSsse3(encoded + done, len - done, out + done / 4 * 3);
+            break;
+        case Kernel::Ssse3:
+            done = decodeSsse3(encoded, len, out);
+            break;
+#endif
+#ifdef BASE64_NEON
+        case Kernel::Neon:
+            done = decodeNeon(encoded, len, out);
+            break;
+#endif
+        default:
+            break;
+    }
+    // The scalar tail also locates the exact error when a SIMD block rejected its input
+    if (!decodeScalar(encoded + done, len - done, out + done / 4 * 3)) return false;
+    outLen = decodedSize(encoded, len);
+    return true;
+}
+
+std::string encode(const unsigned char* data, size_t len) {
+    if (!data && len > 0) return "";
+    std::string result(encodedSize(len), '\0');
+    if (len > 0) encode(data, len, &result[0]);
+    return result;
 }
 
 std::vector<unsigned char> decode(const std::string& encoded) {
-    std::vector<unsigned char> result;
-    if (encoded.empty()) return result;
-    size_t len = encoded.size();
-    if (len % 4 != 0) return result;  // Invalid base64
-    size_t outLen = (len / 4) * 3;
-    if (len >= 1 && encoded[len - 1] == '=') { outLen--; }
-    if (len >= 2 && encoded[len - 2] == '=') { outLen--; }
-    result.reserve(outLen);
-    for (size_t i = 0; i + 4 <= len; i += 4) {
-        int a = decodeChar(encoded[i]);
-        int b = decodeChar(encoded[i + 1]);
-        int c = decodeChar(encoded[i + 2]);
-        int d = decodeChar(encoded[i + 3]);
-        if (a < 0 || b < 0 || c < 0 || d < 0) return {};
-        unsigned int n = (static_cast<unsigned int>(a) << 18) | (static_cast<unsigned int>(b) << 12) |
-                        (static_cast<unsigned int>(c) << 6) | static_cast<unsigned int>(d);
-        result.push_back(static_cast<unsigned char>((n >> 16) & 255));
-        if (encoded[i + 2] != '=') result.push_back(static_cast<unsigned char>((n >> 8) & 255));
-        if (encoded[i + 3] != '=') result.push_back(static_cast<unsigned char>(n & 255));
+    std::vector<unsigned char> result(decodedSize(encoded.data(), encoded.size()));
+    size_t written = 0;
+    if (result.empty() || !decode(encoded.data(), encoded.size(), result.data(), written)) {
+        return {};
     }
     return result;
 }
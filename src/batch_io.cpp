@@ -0,0 +1,620 @@
+#include "../include/batch_io.h"
+#include "../include/thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <sys/stat.h>
+
+#if defined(__linux__) && !defined(__ANDROID__)
+#include <sys/syscall.h>
+#if defined(__NR_io_uring_setup)
+#include <linux/io_uring.h>
+#if defined(IORING_FEAT_RW_CUR_POS)  // 5.6 headers: OPENAT, STATX, READ, CLOSE and probing
+#define BATCH_IO_URING 1
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+#endif
+#endif
+
+namespace fs = std::filesystem;
+
+namespace batch_io {
+
+// Files without a size (procfs and the like) are read in growing steps from here
+static const uint64_t kUnknownSizeStep = 64 * 1024;
+
+const char* backendName(Backend backend) {
+    return backend == Backend::IoUring ? "io_uring" : "threadPool";
+}
+
+static bool stopped(const std::atomic<bool>* cancelled) {
+    return cancelled && cancelled->load();
+}
+
+// Runs fn(i) for every i in [0, count) on the shared pool and the calling thread, and waits for
+// all of them; after cancellation the remaining ones are skipped. The caller takes items too,
+// so the batch finishes even while long pool tasks (hashing, compression) hold every worker;
+// helpers that only start afterwards find nothing left and return without touching fn.
+static void parallelFor(size_t count, const std::function<void(size_t)>& fn, const std::atomic<bool>* cancelled) {
+    struct Shared {
+        std::atomic<size_t> next{0};
+        std::mutex mutex;
+        std::condition_variable finished;
+        size_t helping = 0;
+        bool closed = false;
+    };
+    auto shared = std::make_shared<Shared>();
+    auto drain = [shared, count, &fn, cancelled]() {
+        for (size_t i = shared->next++; i < count && !stopped(cancelled); i = shared->next++) fn(i);
+    };
+    ThreadPool& pool = ThreadPool::getInstance();
+    size_t helpers = count > 1 ? std::min(count, pool.size() * 2) - 1 : 0;
+    for (size_t t = 0; t < helpers; ++t) {
+        pool.submit([shared, drain]() {
+            {
+                std::lock_guard<std::mutex> lock(shared->mutex);
+                if (shared->closed) return;
+                ++shared->helping;
+            }
+            drain();
+            std::lock_guard<std::mutex> lock(shared->mutex);
+            if (--shared->helping == 0) shared->finished.notify_one();
+        });
+    }
+    drain();
+    std::unique_lock<std::mutex> lock(shared->mutex);
+    shared->closed = true;
+    shared->finished.wait(lock, [&shared]() { return shared->helping == 0; });
+}
+
+static void statOne(const std::string& path, StatResult& result) {
+#ifdef _WIN32
+    std::error_code ec;
+    fs::path p = fs::u8path(path);
+    fs::file_status status = fs::status(p, ec);
+    if (ec || !fs::exists(status)) {
+        if (ec && ec != std::errc::no_such_file_or_directory) result.error = ec.message();
+        return;
+    }
+    result.exists = true;
+    result.isDirectory = fs::is_directory(status);
+    result.isFile = fs::is_regular_file(status);
+    if (result.isFile) result.size = fs::file_size(p, ec);
+    auto time = fs::last_write_time(p, ec);
+    // file_clock counts 100 ns ticks since 1601-01-01
+    if (!ec) result.mtimeMs = (static_cast<int64_t>(time.time_since_epoch().count()) - 116444736000000000LL) / 10000;
+#else
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0) {
+        if (errno != ENOENT && errno != ENOTDIR) result.error = std::generic_category().message(errno);
+        return;
+    }
+    result.exists = true;
+    result.isDirectory = S_ISDIR(st.st_mode);
+    result.isFile = S_ISREG(st.st_mode);
+    result.size = result.isFile ? static_cast<uint64_t>(st.st_size) : 0;
+#ifdef __APPLE__
+    result.mtimeMs = static_cast<int64_t>(st.st_mtimespec.tv_sec) * 1000 + st.st_mtimespec.tv_nsec / 1000000;
+#else
+    result.mtimeMs = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000 + st.st_mtim.tv_nsec / 1000000;
+#endif
+#endif
+}
+
+// Decide, in request order, which files are read and how much room each gets.
+// Returns the buffer size to start with (0: skip the file).
+static uint64_t admit(const StatResult& stat, uint64_t maxFileBytes, uint64_t& budget, ReadResult& result) {
+    if (!stat.error.empty()) {
+        result.error = stat.error;
+    } else if (!stat.exists) {
+        result.error = "File does not exist";
+    } else if (!stat.isFile) {
+        result.error = "Not a file";
+    } else if (stat.size > maxFileBytes) {
+        result.fileSize = stat.size;
+        result.overLimit = true;
+        result.error = "File exceeds the per-file limit of " + std::to_string(maxFileBytes) + " bytes";
+    } else if (stat.size > budget) {
+        result.fileSize = stat.size;
+        result.error = "Batch byte limit reached";
+    } else {
+        result.fileSize = stat.size;
+        uint64_t initial = stat.size > 0 ? stat.size : std::min({kUnknownSizeStep, maxFileBytes, budget});
+        budget -= initial;
+        return initial;
+    }
+    return 0;
+}
+
+// After a file without a stat size filled its buffer: room for the next step, 0 if none left
+static uint64_t growUnknownSize(ReadResult& result, uint64_t maxFileBytes, uint64_t& budget) {
+    uint64_t current = result.data.size();
+    uint64_t step = std::min({current, maxFileBytes - std::min(current, maxFileBytes), budget});
+    if (step == 0) {
+        result.data.clear();
+        result.overLimit = current >= maxFileBytes;
+        result.error = result.overLimit ? "File exceeds the per-file limit of " + std::to_string(maxFileBytes) + " bytes"
+                                        : "Batch byte limit reached";
+        return 0;
+    }
+    budget -= step;
+    return step;
+}
+
+// Reads one admitted file into result.data (sized by admit). A file without a stat size grows
+// within the budget until end of file; room it did not use goes back to the budget.
+static void readOneFile(const std::string& path, const StatResult& stat, uint64_t maxFileBytes, uint64_t& budget,
+                        std::mutex& budgetMutex, ReadResult& result) {
+    std::ifstream file(fs::u8path(path), std::ios::binary);
+    if (!file.is_open()) {
+        result.error = "Failed to open file";
+        std::lock_guard<std::mutex> lock(budgetMutex);
+        budget += result.data.size();
+        result.data.clear();
+        return;
+    }
+    size_t filled = 0;
+    while (true) {
+        file.read(reinterpret_cast<char*>(result.data.data() + filled),
+                  static_cast<std::streamsize>(result.data.size() - filled));
+        filled += static_cast<size_t>(file.gcount());
+        if (file.bad()) {
+            result.error = "Failed to read file";
+            result.data.clear();
+            return;
+        }
+        if (filled < result.data.size() || stat.size > 0 || file.peek() == EOF) break;
+        std::lock_guard<std::mutex> lock(budgetMutex);
+        uint64_t step = growUnknownSize(result, maxFileBytes, budget);
+        if (step == 0) return;
+        result.data.resize(result.data.size() + static_cast<size_t>(step));
+    }
+    std::lock_guard<std::mutex> lock(budgetMutex);
+    budget += result.data.size() - filled;
+    result.data.resize(filled);
+}
+
+static void readFilesOnPool(const std::vector<std::string>& paths, uint64_t maxFileBytes, uint64_t maxTotalBytes,
+                            std::vector<ReadResult>& results, const std::atomic<bool>* cancelled) {
+    std::vector<StatResult> stats(paths.size());
+    parallelFor(paths.size(), [&](size_t i) { statOne(paths[i], stats[i]); }, cancelled);
+    uint64_t budget = maxTotalBytes;
+    for (size_t i = 0; i < paths.size(); ++i) {
+        results[i].data.resize(static_cast<size_t>(admit(stats[i], maxFileBytes, budget, results[i])));
+    }
+    std::mutex budgetMutex;
+    parallelFor(paths.size(), [&](size_t i) {
+        if (results[i].error.empty()) readOneFile(paths[i], stats[i], maxFileBytes, budget, budgetMutex, results[i]);
+    }, cancelled);
+}
+
+#ifdef BATCH_IO_URING
+
+static int ioUringSetup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+static int ioUringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+}
+
+static int ioUringRegister(int fd, unsigned opcode, void* arg, unsigned count) {
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, count));
+}
+
+// Minimal io_uring over the raw syscalls (no liburing dependency). Single submitter: every
+// call happens under the backend mutex.
+class Ring {
+public:
+    static const unsigned kEntries = 256;
+
+    ~Ring() {
+        if (sqes_) munmap(sqes_, sqesSize_);
+        if (cqRing_ && cqRing_ != sqRing_) munmap(cqRing_, cqRingSize_);
+        if (sqRing_) munmap(sqRing_, sqRingSize_);
+        if (fd_ >= 0) close(fd_);
+    }
+
+    bool init() {
+        io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        fd_ = ioUringSetup(kEntries, &params);
+        if (fd_ < 0) return false;  // ENOSYS, or EPERM under io_uring_disabled / seccomp
+        entries_ = params.sq_entries;
+        sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single) sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+        sqRing_ = mapRegion(sqRingSize_, IORING_OFF_SQ_RING);
+        if (!sqRing_) return false;
+        cqRing_ = single ? sqRing_ : mapRegion(cqRingSize_, IORING_OFF_CQ_RING);
+        if (!cqRing_) return false;
+        sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe*>(mapRegion(sqesSize_, IORING_OFF_SQES));
+        if (!sqes_) return false;
+
+        char* sq = static_cast<char*>(sqRing_);
+        sqHead_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sqTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        char* cq = static_cast<char*>(cqRing_);
+        cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        localTail_ = *sqTail_;
+        return supportsOps();
+    }
+
+    // Run count operations with at most the ring's depth in flight. prepare fills the SQE of
+    // operation i; complete gets its result (-errno on failure) and returns true to run it again
+    // (short reads). False if the ring itself failed; operations may then be partly done, as
+    // they are after cancellation, which stops submitting and waits for those in flight.
+    bool run(size_t count, const std::function<void(size_t, io_uring_sqe&)>& prepare,
+             const std::function<bool(size_t, int)>& complete, const std::atomic<bool>* cancelled = nullptr) {
+        std::deque<size_t> queue;
+        for (size_t i = 0; i < count; ++i) queue.push_back(i);
+        size_t inFlight = 0;
+        while (true) {
+            if (stopped(cancelled)) queue.clear();
+            if (queue.empty() && inFlight == 0) break;
+            unsigned prepared = 0;
+            while (!queue.empty() && inFlight < entries_) {
+                size_t i = queue.front();
+                queue.pop_front();
+                unsigned index = localTail_ & sqMask_;
+                io_uring_sqe& sqe = sqes_[index];
+                memset(&sqe, 0, sizeof(sqe));
+                prepare(i, sqe);
+                sqe.user_data = i;
+                sqArray_[index] = index;
+                ++localTail_;
+                ++prepared;
+                ++inFlight;
+            }
+            __atomic_store_n(sqTail_, localTail_, __ATOMIC_RELEASE);
+            if (!enter(prepared)) {
+                // The kernel may still be writing into the callers' buffers: wait those out
+                // before anyone frees them or unmaps the ring
+                retractUnsubmitted(inFlight);
+                while (inFlight > 0 && enter(0)) {
+                    reap([&](size_t, int) { --inFlight; });
+                }
+                wedged_ = inFlight > 0;
+                return false;
+            }
+            reap([&](size_t i, int res) {
+                --inFlight;
+                if (complete(i, res)) queue.push_back(i);
+            });
+        }
+        return true;
+    }
+
+    // Operations run() keeps in flight at once
+    unsigned depth() const { return entries_; }
+
+    // After run() failed: true if operations may still be in flight, so the ring's memory
+    // must never be unmapped
+    bool wedged() const { return wedged_; }
+
+private:
+    // Submits and waits for at least one completion; false on a failure other than EINTR
+    bool enter(unsigned toSubmit) {
+        int entered;
+        do {
+            entered = ioUringEnter(fd_, toSubmit, 1, IORING_ENTER_GETEVENTS);
+        } while (entered < 0 && errno == EINTR);
+        return entered >= 0;
+    }
+
+    template <typename Fn>
+    void reap(Fn&& fn) {
+        unsigned head = *cqHead_;
+        unsigned tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head) {
+            const io_uring_cqe& cqe = cqes_[head & cqMask_];
+            fn(static_cast<size_t>(cqe.user_data), cqe.res);
+        }
+        __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+    }
+
+    // Takes back the SQEs the kernel has not consumed; they never start
+    void retractUnsubmitted(size_t& inFlight) {
+        unsigned consumed = __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE);
+        inFlight -= localTail_ - consumed;
+        localTail_ = consumed;
+        __atomic_store_n(sqTail_, localTail_, __ATOMIC_RELEASE);
+    }
+
+    void* mapRegion(size_t size, uint64_t offset) {
+        void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, static_cast<off_t>(offset));
+        return p == MAP_FAILED ? nullptr : p;
+    }
+
+    bool supportsOps() {
+        const unsigned ops = 256;
+        std::vector<unsigned char> buffer(sizeof(io_uring_probe) + ops * sizeof(io_uring_probe_op));
+        auto* probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+        if (ioUringRegister(fd_, IORING_REGISTER_PROBE, probe, ops) < 0) return false;
+        for (unsigned op : {IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_READ, IORING_OP_CLOSE}) {
+            if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) return false;
+        }
+        return true;
+    }
+
+    int fd_ = -1;
+    unsigned entries_ = 0;
+    void* sqRing_ = nullptr;
+    void* cqRing_ = nullptr;
+    size_t sqRingSize_ = 0;
+    size_t cqRingSize_ = 0;
+    io_uring_sqe* sqes_ = nullptr;
+    size_t sqesSize_ = 0;
+    unsigned* sqHead_ = nullptr;
+    unsigned* sqTail_ = nullptr;
+    unsigned sqMask_ = 0;
+    unsigned* sqArray_ = nullptr;
+    unsigned* cqHead_ = nullptr;
+    unsigned* cqTail_ = nullptr;
+    unsigned cqMask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+    unsigned localTail_ = 0;
+    bool wedged_ = false;
+};
+
+static std::mutex& ringMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+static std::unique_ptr<Ring>& ringSlot() {
+    static std::unique_ptr<Ring> ring;
+    return ring;
+}
+
+// Created on first use; null when the kernel does not offer what we need, or after the ring
+// failed. Call with ringMutex held.
+static Ring* sharedRing() {
+    static bool tried = false;
+    if (!tried) {
+        tried = true;
+        ringSlot().reset(new Ring());
+        if (!ringSlot()->init()) ringSlot().reset();
+    }
+    return ringSlot().get();
+}
+
+// After the ring failed. Call with ringMutex held.
+static void discardRing() {
+    if (ringSlot()->wedged()) {
+        ringSlot().release();  // the kernel may still write through its mappings: never unmap them
+    } else {
+        ringSlot().reset();
+    }
+}
+
+static void fillStat(const struct statx& stx, StatResult& result) {
+    result.exists = true;
+    result.isDirectory = S_ISDIR(stx.stx_mode);
+    result.isFile = S_ISREG(stx.stx_mode);
+    result.size = result.isFile ? stx.stx_size : 0;
+    result.mtimeMs = static_cast<int64_t>(stx.stx_mtime.tv_sec) * 1000 + stx.stx_mtime.tv_nsec / 1000000;
+}
+
+static void prepareStatx(io_uring_sqe& sqe, const std::string& path, struct statx& buffer) {
+    sqe.opcode = IORING_OP_STATX;
+    sqe.fd = AT_FDCWD;
+    sqe.addr = reinterpret_cast<uint64_t>(path.c_str());
+    sqe.len = STATX_TYPE | STATX_SIZE | STATX_MTIME;
+    sqe.off = reinterpret_cast<uint64_t>(&buffer);
+}
+
+static bool statManyRing(Ring& ring, const std::vector<std::string>& paths, std::vector<StatResult>& results,
+                         const std::atomic<bool>* cancelled) {
+    std::vector<struct statx> buffers(paths.size());
+    return ring.run(
+        paths.size(), [&](size_t i, io_uring_sqe& sqe) { prepareStatx(sqe, paths[i], buffers[i]); },
+        [&](size_t i, int res) {
+            if (res == -EINTR || res == -EAGAIN) return true;
+            if (res == 0) {
+                fillStat(buffers[i], results[i]);
+            } else if (res != -ENOENT && res != -ENOTDIR) {
+                results[i].error = std::generic_category().message(-res);
+            }
+            return false;
+        },
+        cancelled);
+}
+
+// Files a ring batch keeps open at once: the ring's depth, and at most a quarter of the
+// descriptor soft limit so a large batch leaves room for the rest of the process
+static size_t openWindow(const Ring& ring) {
+    size_t window = ring.depth();
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY) {
+        window = std::min<size_t>(window, std::max<rlim_t>(limit.rlim_cur / 4, 1));
+    }
+    return window;
+}
+
+// Closes fds[i] for every i in which; by hand if the ring fails. False if it did.
+static bool closeFiles(Ring& ring, std::vector<int>& fds, const std::vector<size_t>& which) {
+    bool closed = ring.run(
+        which.size(),
+        [&](size_t c, io_uring_sqe& sqe) {
+            sqe.opcode = IORING_OP_CLOSE;
+            sqe.fd = fds[which[c]];
+        },
+        [&](size_t c, int) {
+            fds[which[c]] = -1;
+            return false;
+        });
+    for (size_t i : which) {
+        if (fds[i] >= 0) close(fds[i]);
+        fds[i] = -1;
+    }
+    return closed;
+}
+
+// statx for every file, then open, read and close rounds over windows of the admitted files
+// (see openWindow), so the descriptors held at once stay bounded whatever the batch size.
+// Opens that find the process out of descriptors (EMFILE, ENFILE) are read on the pool
+// afterwards. Cancellation skips the remaining rounds; whatever was opened is still closed.
+static bool readFilesRing(Ring& ring, const std::vector<std::string>& paths, uint64_t maxFileBytes,
+                          uint64_t maxTotalBytes, std::vector<ReadResult>& results, const std::atomic<bool>* cancelled) {
+    size_t count = paths.size();
+    std::vector<StatResult> stats(count);
+    if (!statManyRing(ring, paths, stats, cancelled)) return false;
+
+    uint64_t budget = maxTotalBytes;
+    std::vector<size_t> admitted;
+    for (size_t i = 0; i < count; ++i) {
+        results[i].data.resize(static_cast<size_t>(admit(stats[i], maxFileBytes, budget, results[i])));
+        if (results[i].error.empty()) admitted.push_back(i);
+    }
+
+    std::vector<int> fds(count, -1);
+    std::vector<size_t> filled(count, 0);
+    std::vector<size_t> retry;
+    size_t window = openWindow(ring);
+    bool ok = true;
+    for (size_t begin = 0; ok && begin < admitted.size() && !stopped(cancelled); begin += window) {
+        std::vector<size_t> files(admitted.begin() + begin, admitted.begin() + std::min(begin + window, admitted.size()));
+        // O_NONBLOCK keeps a file swapped for a FIFO since statx from blocking the open
+        ok = ring.run(
+            files.size(),
+            [&](size_t f, io_uring_sqe& sqe) {
+                sqe.opcode = IORING_OP_OPENAT;
+                sqe.fd = AT_FDCWD;
+                sqe.addr = reinterpret_cast<uint64_t>(paths[files[f]].c_str());
+                sqe.open_flags = O_RDONLY | O_CLOEXEC | O_NONBLOCK;
+            },
+            [&](size_t f, int res) {
+                if (res == -EINTR || res == -EAGAIN) return true;
+                size_t i = files[f];
+                if (res >= 0) {
+                    fds[i] = res;
+                } else if (res == -EMFILE || res == -ENFILE) {
+                    retry.push_back(i);
+                } else {
+                    results[i].error = std::generic_category().message(-res);
+                    budget += results[i].data.size();
+                    results[i].data.clear();
+                }
+                return false;
+            },
+            cancelled);
+
+        std::vector<size_t> opened;
+        for (size_t i : files) {
+            if (fds[i] >= 0) opened.push_back(i);
+        }
+        if (ok) {
+            ok = ring.run(
+                opened.size(),
+                [&](size_t r, io_uring_sqe& sqe) {
+                    size_t i = opened[r];
+                    sqe.opcode = IORING_OP_READ;
+                    sqe.fd = fds[i];
+                    sqe.addr = reinterpret_cast<uint64_t>(results[i].data.data() + filled[i]);
+                    sqe.len = static_cast<uint32_t>(
+                        std::min<size_t>(results[i].data.size() - filled[i], 1u << 30));
+                    sqe.off = filled[i];
+                },
+                [&](size_t r, int res) {
+                    size_t i = opened[r];
+                    ReadResult& result = results[i];
+                    if (res == -EINTR || res == -EAGAIN) return true;
+                    if (res < 0) {
+                        result.error = std::generic_category().message(-res);
+                        result.data.clear();
+                        return false;
+                    }
+                    filled[i] += static_cast<size_t>(res);
+                    if (res == 0) {  // end of file (shrunk since statx, or a sizeless file)
+                        budget += result.data.size() - filled[i];
+                        result.data.resize(filled[i]);
+                        return false;
+                    }
+                    if (filled[i] < result.data.size()) return true;
+                    if (stats[i].size > 0) return false;
+                    uint64_t step = growUnknownSize(result, maxFileBytes, budget);
+                    if (step == 0) return false;
+                    result.data.resize(result.data.size() + static_cast<size_t>(step));
+                    return true;
+                },
+                cancelled);
+        }
+        if (!closeFiles(ring, fds, opened)) ok = false;
+    }
+
+    if (ok && !retry.empty()) {
+        std::mutex budgetMutex;
+        parallelFor(retry.size(), [&](size_t r) {
+            size_t i = retry[r];
+            readOneFile(paths[i], stats[i], maxFileBytes, budget, budgetMutex, results[i]);
+        }, cancelled);
+    }
+    return ok;
+}
+
+#endif // BATCH_IO_URING
+
+Backend activeBackend() {
+#ifdef BATCH_IO_URING
+    std::lock_guard<std::mutex> lock(ringMutex());
+    if (sharedRing()) return Backend::IoUring;
+#endif
+    return Backend::ThreadPool;
+}
+
+Backend statMany(const std::vector<std::string>& paths, std::vector<StatResult>& results,
+                 const std::atomic<bool>* cancelled) {
+    results.assign(paths.size(), StatResult());
+#ifdef BATCH_IO_URING
+    {
+        // A second caller while the ring is busy takes the pool instead of waiting
+        std::unique_lock<std::mutex> lock(ringMutex(), std::try_to_lock);
+        Ring* ring = lock.owns_lock() ? sharedRing() : nullptr;
+        if (ring && statManyRing(*ring, paths, results, cancelled)) return Backend::IoUring;
+        if (ring) discardRing();  // io_uring_enter failed: stay on the pool from now on
+        results.assign(paths.size(), StatResult());
+    }
+#endif
+    parallelFor(paths.size(), [&](size_t i) { statOne(paths[i], results[i]); }, cancelled);
+    return Backend::ThreadPool;
+}
+
+Backend readFiles(const std::vector<std::string>& paths, uint64_t maxFileBytes, uint64_t maxTotalBytes,
+                  std::vector<ReadResult>& results, const std::atomic<bool>* cancelled) {
+    results.assign(paths.size(), ReadResult());
+#ifdef BATCH_IO_URING
+    {
+        std::unique_lock<std::mutex> lock(ringMutex(), std::try_to_lock);
+        Ring* ring = lock.owns_lock() ? sharedRing() : nullptr;
+        if (ring && readFilesRing(*ring, paths, maxFileBytes, maxTotalBytes, results, cancelled)) {
+            return Backend::IoUring;
+        }
+        if (ring) discardRing();
+        results.assign(paths.size(), ReadResult());
+    }
+#endif
+    readFilesOnPool(paths, maxFileBytes, maxTotalBytes, results, cancelled);
+    return Backend::ThreadPool;
+}
+
+} // namespace batch_io
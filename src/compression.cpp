@@ -0,0 +1,509 @@
+#include "../include/compression.h"
+// miniz would otherwise #define zlib names such as compress and crc32
+#define MINIZ_NO_ZLIB_COMPATIBLE_NAMES
+#include "../external/OpenXLSX/OpenXLSX/external/zippy/zippy.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+
+using namespace ns_miniz;
+
+namespace compression {
+
+static const size_t kChunkSize = 1 << 20;
+// mz_stream counts in unsigned int, so large in-memory buffers are fed in slices
+static const size_t kMaxFeed = 1u << 30;
+
+bool parseFormat(const std::string& name, Format& format) {
+    if (name == "gzip") {
+        format = Format::Gzip;
+    } else if (name == "zlib") {
+        format = Format::Zlib;
+    } else if (name == "deflate") {
+        format = Format::Deflate;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+namespace {
+
+// Input over a memory buffer (all available up front) or a file read in chunks
+struct Input {
+    const unsigned char* next = nullptr;
+    size_t avail = 0;
+    std::ifstream* file = nullptr;
+    std::vector<unsigned char> buffer;
+    const std::function<void(uint64_t)>* progress = nullptr;
+    bool failed = false;
+
+    // Load the next chunk once avail is exhausted; false at end of input
+    bool refill() {
+        if (!file || !*file) return false;
+        if (buffer.empty()) buffer.resize(kChunkSize);
+        file->read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        size_t got = static_cast<size_t>(file->gcount());
+        if (file->bad()) {
+            failed = true;
+            return false;
+        }
+        next = buffer.data();
+        avail = got;
+        if (got > 0 && progress && *progress) (*progress)(got);
+        return got > 0;
+    }
+
+    bool readByte(unsigned char& byte) {
+        if (avail == 0 && !refill()) return false;
+        byte = *next++;
+        --avail;
+        return true;
+    }
+};
+
+struct Output {
+    std::vector<unsigned char>* memory = nullptr;
+    size_t limit = std::numeric_limits<size_t>::max();
+    std::ofstream* file = nullptr;
+    uint64_t total = 0;
+
+    bool write(const unsigned char* data, size_t len, std::string& error) {
+        if (len == 0) return true;
+        if (memory) {
+            if (len > limit - memory->size()) {
+                error = "Output exceeds the size limit";
+                return false;
+            }
+            memory->insert(memory->end(), data, data + len);
+        } else {
+            file->write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(len));
+            if (!*file) {
+                error = "Failed to write output";
+                return false;
+            }
+        }
+        total += len;
+        return true;
+    }
+};
+
+bool isCancelled(const std::atomic<bool>* cancel, std::string& error) {
+    if (cancel && cancel->load()) {
+        error = "Cancelled";
+        return true;
+    }
+    return false;
+}
+
+void putLe32(unsigned char* p, uint32_t v) {
+    p[0] = static_cast<unsigned char>(v);
+    p[1] = static_cast<unsigned char>(v >> 8);
+    p[2] = static_cast<unsigned char>(v >> 16);
+    p[3] = static_cast<unsigned char>(v >> 24);
+}
+
+uint32_t getLe32(const unsigned char* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// miniz only frames zlib; gzip is a fixed header, raw deflate and a CRC-32 / length trailer
+bool deflateStream(Input& in, Output& out, Format format, int level, const std::atomic<bool>* cancel,
+                   std::string& error) {
+    if (level < 0 || level > 9) {
+        error = "Invalid compression level";
+        return false;
+    }
+    if (format == Format::Gzip) {
+        // no name, no mtime; XFL 2 = best, 4 = fastest; OS 255 = unknown
+        const unsigned char header[10] = {0x1f, 0x8b, 8, 0, 0, 0, 0, 0,
+                                          static_cast<unsigned char>(level == 9 ? 2 : level == 1 ? 4 : 0), 255};
+        if (!out.write(header, sizeof(header), error)) return false;
+    }
+
+    mz_stream stream{};
+    if (mz_deflateInit2(&stream, level, MZ_DEFLATED, format == Format::Zlib ? MZ_DEFAULT_WINDOW_BITS
+                                                                             : -MZ_DEFAULT_WINDOW_BITS,
+                        9, MZ_DEFAULT_STRATEGY) != MZ_OK) {
+        error = "Failed to initialize compressor";
+        return false;
+    }
+    std::vector<unsigned char> chunk(kChunkSize);
+    mz_ulong crc = MZ_CRC32_INIT;
+    uint64_t size = 0;
+    bool ok = true;
+    bool done = false;
+    while (ok && !done) {
+        if (isCancelled(cancel, error)) {
+            ok = false;
+            break;
+        }
+        bool finish = in.avail == 0 && !in.refill();
+        if (in.failed) {
+            error = "Failed to read input";
+            ok = false;
+            break;
+        }
+        size_t feed = std::min(in.avail, kMaxFeed);
+        if (format == Format::Gzip && feed > 0) crc = mz_crc32(crc, in.next, feed);
+        size += feed;
+        stream.next_in = in.next;
+        stream.avail_in = static_cast<unsigned int>(feed);
+        while (true) {
+            stream.next_out = chunk.data();
+            stream.avail_out = static_cast<unsigned int>(chunk.size());
+            int status = mz_deflate(&stream, finish ? MZ_FINISH : MZ_NO_FLUSH);
+            size_t produced = chunk.size() - stream.avail_out;
+            if ((status != MZ_OK && status != MZ_STREAM_END && status != MZ_BUF_ERROR) ||
+                (status == MZ_BUF_ERROR && finish && produced == 0)) {
+                error = "Compression failed";
+                ok = false;
+                break;
+            }
+            if (!out.write(chunk.data(), produced, error)) {
+                ok = false;
+                break;
+            }
+            if (status == MZ_STREAM_END) {
+                done = true;
+                break;
+            }
+            if (!finish && stream.avail_in == 0 && stream.avail_out != 0) break;
+        }
+        in.next += feed;
+        in.avail -= feed;
+    }
+    mz_deflateEnd(&stream);
+    if (ok && format == Format::Gzip) {
+        unsigned char trailer[8];
+        putLe32(trailer, static_cast<uint32_t>(crc));
+        putLe32(trailer + 4, static_cast<uint32_t>(size));
+        ok = out.write(trailer, sizeof(trailer), error);
+    }
+    return ok;
+}
+
+// Skips a gzip member header (RFC 1952 2.3). magic is false when the input holds no further
+// member, which ends a multi-member stream.
+bool readGzipHeader(Input& in, bool& magic, std::string& error) {
+    unsigned char header[10];
+    magic = false;
+    for (size_t i = 0; i < sizeof(header); ++i) {
+        if (!in.readByte(header[i])) {
+            if (i == 0) return true;  // clean end of input
+            error = "Truncated gzip header";
+            return false;
+        }
+        if ((i == 0 && header[0] != 0x1f) || (i == 1 && header[1] != 0x8b)) return true;
+    }
+    magic = true;
+    if (header[2] != 8) {
+        error = "Unsupported gzip compression method";
+        return false;
+    }
+    unsigned char flags = header[3];
+    unsigned char byte = 0;
+    if (flags & 0x04) {  // FEXTRA
+        unsigned char len[2];
+        if (!in.readByte(len[0]) || !in.readByte(len[1])) {
+            error = "Truncated gzip header";
+            return false;
+        }
+        for (size_t n = len[0] | (len[1] << 8); n > 0; --n) {
+            if (!in.readByte(byte)) {
+                error = "Truncated gzip header";
+                return false;
+            }
+        }
+    }
+    for (unsigned char bit : {0x08, 0x10}) {  // FNAME, FCOMMENT: zero-terminated
+        if (!(flags & bit)) continue;
+        do {
+            if (!in.readByte(byte)) {
+                error = "Truncated gzip header";
+                return false;
+            }
+        } while (byte != 0);
+    }
+    if (flags & 0x02) {  // FHCRC
+        if (!in.readByte(byte) || !in.readByte(byte)) {
+            error = "Truncated gzip header";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool inflateStream(Input& in, Output& out, Format format, const std::atomic<bool>* cancel, std::string& error) {
+    std::vector<unsigned char> chunk(kChunkSize);
+    for (bool first = true;; first = false) {
+        if (format == Format::Gzip) {
+            bool magic = false;
+            if (!readGzipHeader(in, magic, error)) return false;
+            if (!magic) {
+                if (first) {
+                    error = "Not gzip data";
+                    return false;
+                }
+                return true;  // like gzip(1), trailing bytes after the last member are ignored
+            }
+        }
+
+        mz_stream stream{};
+        if (mz_inflateInit2(&stream, format == Format::Zlib ? MZ_DEFAULT_WINDOW_BITS : -MZ_DEFAULT_WINDOW_BITS) !=
+            MZ_OK) {
+            error = "Failed to initialize decompressor";
+            return false;
+        }
+        mz_ulong crc = MZ_CRC32_INIT;
+        uint64_t size = 0;
+        bool ok = true;
+        bool outputFull = false;  // the inflater may hold more output without needing input
+        while (true) {
+            if (isCancelled(cancel, error)) {
+                ok = false;
+                break;
+            }
+            if (in.avail == 0 && !outputFull && !in.refill()) {
+                error = in.failed ? "Failed to read input" : "Truncated compressed data";
+                ok = false;
+                break;
+            }
+            size_t feed = std::min(in.avail, kMaxFeed);
+            stream.next_in = in.next;
+            stream.avail_in = static_cast<unsigned int>(feed);
+            stream.next_out = chunk.data();
+            stream.avail_out = static_cast<unsigned int>(chunk.size());
+            int status = mz_inflate(&stream, MZ_NO_FLUSH);
+            size_t consumed = feed - stream.avail_in;
+            size_t produced = chunk.size() - stream.avail_out;
+            in.next += consumed;
+            in.avail -= consumed;
+            outputFull = stream.avail_out == 0;
+            if ((status != MZ_OK && status != MZ_STREAM_END && status != MZ_BUF_ERROR) ||
+                (status == MZ_BUF_ERROR && feed > 0 && consumed == 0 && produced == 0)) {
+                error = "Invalid compressed data";
+                ok = false;
+                break;
+            }
+            if (format == Format::Gzip && produced > 0) crc = mz_crc32(crc, chunk.data(), produced);
+            size += produced;
+            if (!out.write(chunk.data(), produced, error)) {
+                ok = false;
+                break;
+            }
+            if (status == MZ_STREAM_END) break;
+        }
+        mz_inflateEnd(&stream);
+        if (!ok) return false;
+        if (format != Format::Gzip) return true;
+
+        unsigned char trailer[8];
+        for (unsigned char& byte : trailer) {
+            if (!in.readByte(byte)) {
+                error = "Truncated gzip trailer";
+                return false;
+            }
+        }
+        if (getLe32(trailer) != static_cast<uint32_t>(crc) || getLe32(trailer + 4) != static_cast<uint32_t>(size)) {
+            error = "gzip CRC or length mismatch";
+            return false;
+        }
+    }
+}
+
+bool transformFile(const std::string& source, const std::string& destination, bool compressing, Format format,
+                   int level, uint64_t& outputSize, std::string& error,
+                   const std::function<void(uint64_t)>& progress, const std::atomic<bool>* cancel) {
+    std::ifstream file(source, std::ios::binary);
+    if (!file.is_open()) {
+        error = "Failed to open file";
+        return false;
+    }
+    std::ofstream target(destination, std::ios::binary | std::ios::trunc);
+    if (!target.is_open()) {
+        error = "Failed to create output file";
+        return false;
+    }
+    Input in;
+    in.file = &file;
+    in.progress = &progress;
+    Output out;
+    out.file = &target;
+    bool ok = compressing ? deflateStream(in, out, format, level, cancel, error)
+                          : inflateStream(in, out, format, cancel, error);
+    target.close();
+    if (ok && !target) {
+        error = "Failed to write output";
+        ok = false;
+    }
+    if (!ok) {
+        std::error_code ec;
+        std::filesystem::remove(destination, ec);
+        return false;
+    }
+    outputSize = out.total;
+    return true;
+}
+
+} // namespace
+
+bool compress(const unsigned char* data, size_t len, Format format, int level, std::vector<unsigned char>& out,
+              std::string& error) {
+    Input in;
+    in.next = data;
+    in.avail = len;
+    Output sink;
+    sink.memory = &out;
+    out.clear();
+    out.reserve(len / 2 + 64);
+    return deflateStream(in, sink, format, level, nullptr, error);
+}
+
+bool decompress(const unsigned char* data, size_t len, Format format, size_t maxOutput,
+                std::vector<unsigned char>& out, std::string& error) {
+    Input in;
+    in.next = data;
+    in.avail = len;
+    Output sink;
+    sink.memory = &out;
+    sink.limit = maxOutput;
+    out.clear();
+    return inflateStream(in, sink, format, nullptr, error);
+}
+
+bool compressFile(const std::string& source, const std::string& destination, Format format, int level,
+                  uint64_t& outputSize, std::string& error, const std::function<void(uint64_t)>& progress,
+                  const std::atomic<bool>* cancel) {
+    return transformFile(source, destination, true, format, level, outputSize, error, progress, cancel);
+}
+
+bool decompressFile(const std::string& source, const std::string& destination, Format format,
+                    uint64_t& outputSize, std::string& error, const std::function<void(uint64_t)>& progress,
+                    const std::atomic<bool>* cancel) {
+    return transformFile(source, destination, false, format, 0, outputSize, error, progress, cancel);
+}
+
+bool prepareEntry(std::vector<unsigned char> content, int level, PreparedEntry& entry, std::string& error) {
+    entry.size = content.size();
+    entry.crc32 = static_cast<uint32_t>(mz_crc32(MZ_CRC32_INIT, content.data(), content.size()));
+    entry.data.clear();
+    if (level > 0 && !content.empty()) {
+        if (!compress(content.data(), content.size(), Format::Deflate, level, entry.data, error)) return false;
+    }
+    entry.stored = entry.data.empty() || entry.data.size() >= content.size();
+    if (entry.stored) entry.data = std::move(content);
+    return true;
+}
+
+struct ZipWriter::State {
+    mz_zip_archive zip{};
+    std::ofstream file;
+    uint64_t position = 0;
+    const std::atomic<bool>* cancel = nullptr;
+    bool cancelled = false;
+    bool active = false;  // between mz_zip_writer_init_v2 and mz_zip_writer_end
+
+    std::string lastError() {
+        if (cancelled) return "Cancelled";
+        return mz_zip_get_error_string(mz_zip_get_last_error(&zip));
+    }
+};
+
+ZipWriter::ZipWriter() : state_(new State()) {}
+
+ZipWriter::~ZipWriter() {
+    if (state_->active) mz_zip_writer_end(&state_->zip);
+}
+
+bool ZipWriter::open(const std::string& path, std::string& error, const std::atomic<bool>* cancel) {
+    state_->file.open(path, std::ios::binary | std::ios::trunc);
+    if (!state_->file.is_open()) {
+        error = "Failed to create archive";
+        return false;
+    }
+    state_->cancel = cancel;
+    // miniz seeks back to patch local headers, so writes carry an absolute offset
+    state_->zip.m_pWrite = [](void* opaque, mz_uint64 offset, const void* data, size_t len) -> size_t {
+        auto* state = static_cast<State*>(opaque);
+        if (state->cancel && state->cancel->load()) {
+            state->cancelled = true;
+            return 0;
+        }
+        if (offset != state->position) {
+            state->file.seekp(static_cast<std::streamoff>(offset));
+        }
+        state->file.write(static_cast<const char*>(data), static_cast<std::streamsize>(len));
+        if (!state->file) return 0;
+        state->position = offset + len;
+        return len;
+    };
+    state_->zip.m_pIO_opaque = state_.get();
+    if (!mz_zip_writer_init_v2(&state_->zip, 0, 0)) {
+        error = state_->lastError();
+        return false;
+    }
+    state_->active = true;
+    return true;
+}
+
+bool ZipWriter::addPrepared(const std::string& name, const PreparedEntry& entry, int64_t mtime, std::string& error) {
+    // Stored data goes through miniz's own path (level 0); deflated data is copied as-is
+    mz_uint flags = entry.stored ? 0 : (MZ_DEFAULT_LEVEL | MZ_ZIP_FLAG_COMPRESSED_DATA);
+    MZ_TIME_T modified = static_cast<MZ_TIME_T>(mtime);
+    if (!mz_zip_writer_add_mem_ex_v2(&state_->zip, name.c_str(), entry.data.data(), entry.data.size(), nullptr, 0,
+                                     flags, entry.stored ? 0 : entry.size, entry.stored ? 0 : entry.crc32,
+                                     &modified, nullptr, 0, nullptr, 0)) {
+        error = state_->lastError();
+        return false;
+    }
+    return true;
+}
+
+bool ZipWriter::addFile(const std::string& name, const std::string& sourcePath, uint64_t size, int64_t mtime,
+                        int level, std::string& error) {
+#ifdef _WIN32
+    FILE* source = _wfopen(std::filesystem::u8path(sourcePath).wstring().c_str(), L"rb");
+#else
+    FILE* source = fopen(sourcePath.c_str(), "rb");
+#endif
+    if (!source) {
+        error = "Failed to open file";
+        return false;
+    }
+    MZ_TIME_T modified = static_cast<MZ_TIME_T>(mtime);
+    bool ok = mz_zip_writer_add_cfile(&state_->zip, name.c_str(), source, size, &modified, nullptr, 0,
+                                      static_cast<mz_uint>(level), nullptr, 0, nullptr, 0);
+    fclose(source);
+    if (!ok) error = state_->lastError();
+    return ok;
+}
+
+bool ZipWriter::addDirectory(const std::string& name, int64_t mtime, std::string& error) {
+    MZ_TIME_T modified = static_cast<MZ_TIME_T>(mtime);
+    if (!mz_zip_writer_add_mem_ex_v2(&state_->zip, name.c_str(), nullptr, 0, nullptr, 0, 0, 0, 0, &modified, nullptr,
+                                     0, nullptr, 0)) {
+        error = state_->lastError();
+        return false;
+    }
+    return true;
+}
+
+bool ZipWriter::finish(uint64_t& archiveSize, std::string& error) {
+    bool ok = mz_zip_writer_finalize_archive(&state_->zip);
+    if (!ok) error = state_->lastError();
+    archiveSize = state_->zip.m_archive_size;
+    mz_zip_writer_end(&state_->zip);
+    state_->active = false;
+    state_->file.close();
+    if (ok && !state_->file) {
+        error = "Failed to write archive";
+        ok = false;
+    }
+    return ok;
+}
+
+} // namespace compression
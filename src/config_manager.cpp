@@ -1,9 +1,9 @@
 #include "../include/config_manager.h"
 #include "../include/platform.h"
+#include "../include/file_content_cache.h"
 #include <cerrno>
 #include <fstream>
 #include <iostream>
-#include <sstream>
 #include <filesystem>
 
 #ifdef _WIN32
@@ -94,6 +94,26 @@ std::string ConfigManager::getOptionsFilePath() {
            ;
 }
 
+std::string ConfigManager::getWebCacheDirectory() {
+    return getConfigDirectory() +
+#ifdef _WIN32
+           "\\webcache"
+#else
+           "/webcache"
+#endif
+           ;
+}
+
+std::string ConfigManager::getThumbnailCacheDirectory() {
+    return getConfigDirectory() +
+#ifdef _WIN32
+           "\\thumbnails"
+#else
+           "/thumbnails"
+#endif
+           ;
+}
+
 bool ConfigManager::ensureConfigDirectory() {
     std::string configDir = getConfigDirectory();
     
@@ -159,15 +179,10 @@ bool ConfigManager::ensureConfigDirectory() {
 static std::string tryLoadFromPaths(const std::string& filename) {
     std::string paths[] = {filename, "./" + filename, "../" + filename, "../../" + filename};
     for (const std::string& path : paths) {
-        std::ifstream f(path);
-        if (f.is_open()) {
-            std::stringstream buffer;
-            buffer << f.rdbuf();
-            std::string content = buffer.str();
-            f.close();
-            if (!content.empty()) {
-                return content;
-            }
+        std::string error;
+        FileContentCache::Bytes content = FileContentCache::getInstance().get(path, error);
+        if (content && !content->empty()) {
+            return std::string(content->begin(), content->end());
         }
     }
     return "";
@@ -217,9 +232,11 @@ nlohmann::json ConfigManager::createDefaultOptions() {
     
     // HTML loading configuration - default to loading from embedded JSON content
     defaultOptions["htmlLoading"] = nlohmann::json::object();
-    defaultOptions["htmlLoading"]["method"] = "html";  // "file", "url", or "html"
+    defaultOptions["htmlLoading"]["method"] = "html";  // "file", "url", "html", or "app"
     defaultOptions["htmlLoading"]["filePath"] = "demo.html";  // Path to HTML file (when method is "file")
     defaultOptions["htmlLoading"]["url"] = "";  // URL to load (when method is "url")
+    defaultOptions["htmlLoading"]["precache"] = nlohmann::json::array();  // Asset URLs to keep in the disk cache (when method is "url")
+    defaultOptions["htmlLoading"]["appEntry"] = "index.html";  // Bundled entry page (when method is "app")
     defaultOptions["htmlLoading"]["htmlContent"] = readDemoHtmlContent();  // Copy from demo.html on first run
     defaultOptions["htmlLoading"]["preloadPath"] = "";  // Custom preload script path; empty = use built-in bridge
     
@@ -346,7 +363,7 @@ std::string ConfigManager::getHtmlLoadingMethod() const {
         options_["htmlLoading"].contains("method") &&
         options_["htmlLoading"]["method"].is_string()) {
         std::string method = options_["htmlLoading"]["method"].get<std::string>();
-        if (method == "file" || method == "url" || method == "html") {
+        if (method == "file" || method == "url" || method == "html" || method == "app") {
             return method;
         }
     }
@@ -354,9 +371,9 @@ std::string ConfigManager::getHtmlLoadingMethod() const {
 }
 
 void ConfigManager::setHtmlLoadingMethod(const std::string& method) {
-    if (method != "file" && method != "url" && method != "html") {
+    if (method != "file" && method != "url" && method != "html" && method != "app") {
         std::cerr << "Warning: Invalid HTML loading method: " << method 
-                  << ". Must be 'file', 'url', or 'html'" << std::endl;
+                  << ". Must be 'file', 'url', 'html', or 'app'" << std::endl;
         return;
     }
     
@@ -393,6 +410,30 @@ std::string ConfigManager::getHtmlContent() const {
     return "";  // Default
 }
 
+std::string ConfigManager::getHtmlAppEntry() const {
+    if (options_.contains("htmlLoading") && 
+        options_["htmlLoading"].contains("appEntry") &&
+        options_["htmlLoading"]["appEntry"].is_string() &&
+        !options_["htmlLoading"]["appEntry"].get<std::string>().empty()) {
+        return options_["htmlLoading"]["appEntry"].get<std::string>();
+    }
+    return "index.html";  // Default
+}
+
+std::vector<std::string> ConfigManager::getHtmlPrecache() const {
+    std::vector<std::string> urls;
+    if (options_.contains("htmlLoading") && 
+        options_["htmlLoading"].contains("precache") &&
+        options_["htmlLoading"]["precache"].is_array()) {
+        for (const auto& u : options_["htmlLoading"]["precache"]) {
+            if (u.is_string() && !u.get<std::string>().empty()) {
+                urls.push_back(u.get<std::string>());
+            }
+        }
+    }
+    return urls;
+}
+
 std::string ConfigManager::getPreloadPath() const {
     if (options_.contains("htmlLoading") && 
         options_["htmlLoading"].contains("preloadPath") &&
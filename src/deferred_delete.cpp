@@ -0,0 +1,262 @@
+#include "../include/deferred_delete.h"
+#include "../include/handlers/file_system_handler.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+const char* const DeferredDeleter::kTrashDirName = ".crossdev-trash";
+
+// Suffix of hidden siblings used when the target cannot be renamed into the trash
+static const char* const kSiblingSuffix = ".deleting";
+// Trash entries naming such a sibling
+static const char* const kMarkerSuffix = ".ref";
+
+static bool endsWith(const std::string& s, const char* suffix) {
+    size_t n = std::char_traits<char>::length(suffix);
+    return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+// The worker competes with nothing the user is waiting for
+static void lowerThreadPriority() {
+#if defined(__linux__)
+    // IOPRIO_WHO_PROCESS with id 0 is the calling thread; IOPRIO_CLASS_IDLE (3) only gets the
+    // disk when no other I/O is queued. Unlink-heavy work is mostly metadata, but journal
+    // writes and the reads of directory blocks still go through the scheduler.
+    syscall(SYS_ioprio_set, 1, 0, 3 << 13);
+    setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 19);
+#elif defined(__APPLE__)
+    setiopolicy_np(IOPOL_TYPE_DISK, IOPOL_SCOPE_THREAD, IOPOL_THROTTLE);
+#elif defined(_WIN32)
+    SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+#endif
+}
+
+// Depth-first removal, counting what it removed. Stops between entries once stop is set
+// (returning false with ec clear); entries that vanished meanwhile are not an error.
+static bool removeTree(const fs::path& path, uint64_t& removed, const std::atomic<bool>& stop, std::error_code& ec) {
+    if (stop) return false;
+    fs::file_status status = fs::symlink_status(path, ec);
+    if (ec) {
+        if (ec == std::errc::no_such_file_or_directory) {
+            ec.clear();
+            return true;
+        }
+        return false;
+    }
+    if (fs::is_directory(status)) {
+        // Listed first: unlinking while a directory stream is open may skip entries
+        std::vector<fs::path> children;
+        for (fs::directory_iterator it(path, ec), end; !ec && it != end; it.increment(ec)) {
+            children.push_back(it->path());
+        }
+        if (ec) return false;
+        for (const auto& child : children) {
+            if (!removeTree(child, removed, stop, ec)) return false;
+        }
+    }
+    if (fs::remove(path, ec)) ++removed;
+    return !ec;
+}
+
+DeferredDeleter& DeferredDeleter::getInstance() {
+    static DeferredDeleter instance;
+    return instance;
+}
+
+DeferredDeleter::DeferredDeleter() = default;
+
+DeferredDeleter::~DeferredDeleter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    changed_.notify_all();
+    if (worker_.joinable()) worker_.join();
+}
+
+bool DeferredDeleter::remove(const fs::path& target, const fs::path& base, Done done, std::string& error) {
+    fs::path path = target.has_filename() ? target : target.parent_path();  // "dir/" names dir
+    std::error_code ec;
+    if (!fs::exists(fs::symlink_status(path, ec))) {
+        error = "Path does not exist";
+        return false;
+    }
+    fs::path trash = base / kTrashDirName;
+    if (isWithin(base, path)) {
+        error = "Cannot delete the working directory or one of its parents";
+        return false;
+    }
+    if (isWithin(path, trash)) {
+        error = "Path is already being deleted";
+        return false;
+    }
+
+    Task task;
+    task.base = base.lexically_normal();
+    task.trash = trash;
+    task.path = target.u8string();
+    task.done = std::move(done);
+    task.queued = std::chrono::steady_clock::now();
+    {
+        // Held across create + rename so the worker cannot remove an empty trash directory in between
+        std::lock_guard<std::mutex> lock(mutex_);
+        fs::create_directories(trash, ec);
+        if (ec) {
+            error = "Failed to create trash directory: " + ec.message();
+            return false;
+        }
+        std::string id = randomNameId();
+        std::string name = path.filename().u8string();
+        task.staged = trash / fs::u8path(id + "-" + name);
+        fs::rename(path, task.staged, ec);
+        if (ec == std::errc::cross_device_link) {
+            // A mount inside the sandbox: hide the target next to itself, and record where in
+            // the trash first so a crash between the two steps leaves nothing unaccounted for
+            task.staged = hiddenSibling(path, kSiblingSuffix);
+            task.marker = trash / (id + kMarkerSuffix);
+            {
+                std::ofstream marker(task.marker, std::ios::binary);
+                marker << task.staged.u8string();
+                if (!marker.flush()) {
+                    error = "Failed to write to the trash directory";
+                    return false;
+                }
+            }
+            fs::rename(path, task.staged, ec);
+            if (ec) {
+                std::error_code ignored;
+                fs::remove(task.marker, ignored);
+            }
+        }
+        if (ec) {
+            error = "Failed to stage for deletion: " + ec.message();
+            return false;
+        }
+    }
+    enqueue(std::move(task));
+    return true;
+}
+
+void DeferredDeleter::recover(const fs::path& base) {
+    Task task;
+    task.base = base.lexically_normal();
+    task.trash = base / kTrashDirName;
+    task.recover = true;
+    task.queued = std::chrono::steady_clock::now();
+    enqueue(std::move(task));
+}
+
+void DeferredDeleter::enqueue(Task task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(std::move(task));
+        if (!worker_.joinable()) {
+            worker_ = std::thread([this]() { run(); });
+        }
+    }
+    changed_.notify_all();
+}
+
+size_t DeferredDeleter::pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size() + busy_;
+}
+
+bool DeferredDeleter::waitIdle(std::chrono::milliseconds timeout) const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return changed_.wait_for(lock, timeout, [this]() { return queue_.empty() && busy_ == 0; });
+}
+
+void DeferredDeleter::run() {
+    lowerThreadPriority();
+    while (true) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            changed_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+            if (stopping_) return;
+            task = std::move(queue_.front());
+            queue_.pop_front();
+            ++busy_;
+        }
+        runTask(task);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --busy_;
+            if (queue_.empty()) {
+                std::error_code ignored;
+                fs::remove(task.trash, ignored);  // only if empty
+            }
+        }
+        changed_.notify_all();
+    }
+}
+
+void DeferredDeleter::runTask(Task& task) {
+    std::error_code ec;
+    if (task.recover) {
+        std::vector<fs::path> entries;
+        for (fs::directory_iterator it(task.trash, ec), end; !ec && it != end; it.increment(ec)) {
+            entries.push_back(it->path());
+        }
+        size_t recovered = 0;
+        for (const auto& entry : entries) {
+            uint64_t removed = 0;
+            if (endsWith(entry.filename().u8string(), kMarkerSuffix)) {
+                std::ifstream in(entry, std::ios::binary);
+                fs::path sibling = fs::u8path(std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()));
+                in.close();
+                // Only what remove() could have staged: a hidden sibling below base. Markers
+                // naming anything else are dropped without touching their target.
+                sibling = sibling.lexically_normal();
+                bool staged = sibling.is_absolute() && endsWith(sibling.filename().u8string(), kSiblingSuffix) &&
+                              isWithin(sibling, task.base) && !isWithin(task.base, sibling);
+                if (staged && !removeTree(sibling, removed, stopping_, ec)) {
+                    if (stopping_) return;
+                    continue;
+                }
+                fs::remove(entry, ec);
+            } else if (!removeTree(entry, removed, stopping_, ec)) {
+                if (stopping_) return;
+                continue;
+            }
+            ++recovered;
+        }
+        if (recovered > 0) {
+            std::cout << "[DeferredDeleter] Finished " << recovered << " interrupted deletion(s) in "
+                      << task.trash.u8string() << std::endl;
+        }
+        return;
+    }
+
+    Result result;
+    result.path = task.path;
+    if (!removeTree(task.staged, result.removedCount, stopping_, ec) && !ec) {
+        return;  // shutting down: recover() finishes it next time
+    }
+    if (ec) {
+        // Left in the trash (or behind its marker) for recover() to retry
+        result.error = "Failed to delete " + task.path + ": " + ec.message();
+    } else if (!task.marker.empty()) {
+        fs::remove(task.marker, ec);
+    }
+    result.elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - task.queued).count();
+    if (task.done) {
+        task.done(result);
+    }
+}
@@ -8,13 +8,16 @@
 #include <iostream>
 
 EventHandler::EventHandler(Window* window, WebView* webView)
+    : EventHandler(window, webView, ConfigManager::getPreloadScriptContent()) {
+}
+
+EventHandler::EventHandler(Window* window, WebView* webView, const std::string& preload)
     : window_(window), webView_(webView) {
     if (!window_ || !webView_) {
         throw std::runtime_error("EventHandler requires valid window and webView");
     }
     
     // Set custom preload script if configured (must be before message callback)
-    std::string preload = ConfigManager::getPreloadScriptContent();
     if (!preload.empty() && webView_->getNativeHandle()) {
         platform::setWebViewPreloadScript(webView_->getNativeHandle(), preload);
     }
@@ -51,23 +54,31 @@ void EventHandler::onWebViewCreateWindow(std::function<void(const std::string& t
 }
 
 void EventHandler::attachWebView(WebView* webView) {
-    attachWebView(webView, {});
+    attachWebView(webView, std::vector<std::shared_ptr<MessageHandler>>{});
 }
 
 void EventHandler::attachWebView(WebView* webView, std::vector<std::shared_ptr<MessageHandler>> extraHandlers) {
+    std::vector<MessageRouter::LazyHandler> lazy;
+    for (auto& h : extraHandlers) {
+        if (h) lazy.push_back({h->getSupportedTypes(), [h]() { return h; }});
+    }
+    attachWebView(webView, std::move(lazy));
+}
+
+void EventHandler::attachWebView(WebView* webView, std::vector<MessageRouter::LazyHandler> lazyHandlers) {
     if (!webView) return;
-    auto router = std::make_unique<MessageRouter>(webView);
+    auto router = std::make_shared<MessageRouter>(webView);
     if (createWindowCallback_) {
         router->registerHandler(createCreateWindowHandler(createWindowCallback_));
     }
-    for (auto& h : extraHandlers) {
-        if (h) router->registerHandler(h);
+    for (auto& lazy : lazyHandlers) {
+        router->registerHandlerFactory(std::move(lazy));
     }
-    MessageRouter* routerPtr = router.get();
-    attachedRouters_.push_back(std::move(router));
-    webView->setMessageCallback([routerPtr](const std::string& jsonMessage) {
-        if (routerPtr) {
-            routerPtr->routeMessage(jsonMessage);
-        }
+    // The WebView's message callback is the router's only owner, so the router and its handlers
+    // are released together with the WebView (child windows open and close for the app's lifetime).
+    webView->setMessageCallback([router](const std::string& jsonMessage) {
+        // Keep the router alive even if a handler closes this WebView and drops the callback
+        std::shared_ptr<MessageRouter> keepAlive = router;
+        keepAlive->routeMessage(jsonMessage);
     });
 }
@@ -0,0 +1,320 @@
+#include "../include/file_content_cache.h"
+#include "../include/file_watcher.h"
+#include "../include/base64.h"
+#include <cerrno>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <sys/stat.h>
+
+namespace fs = std::filesystem;
+
+static const uint64_t kDefaultBudget = 64ull * 1024 * 1024;
+// inotify watches are per directory and shared, but each entry still holds a FileWatcher
+// registration; past this many, new entries are validated by stat instead
+static const size_t kMaxWatchedEntries = 1024;
+// Read step for files that grow past their stat size while being read
+static const size_t kReadStep = 64 * 1024;
+
+FileContentCache& FileContentCache::getInstance() {
+    static FileContentCache instance;
+    return instance;
+}
+
+FileContentCache::FileContentCache() : budget_(kDefaultBudget) {}
+
+static std::string keyFor(const std::string& path) {
+    std::error_code ec;
+    fs::path absolute = fs::absolute(fs::u8path(path), ec);
+    if (ec) return path;
+    return absolute.lexically_normal().u8string();
+}
+
+bool FileContentCache::statVersion(const std::string& path, Version& version, std::string& error) {
+#ifdef _WIN32
+    std::error_code ec;
+    fs::path p = fs::u8path(path);
+    fs::file_status status = fs::status(p, ec);
+    if (ec || !fs::exists(status)) {
+        error = "File does not exist: " + path;
+        return false;
+    }
+    if (!fs::is_regular_file(status)) {
+        error = "Not a regular file: " + path;
+        return false;
+    }
+    version.size = fs::file_size(p, ec);
+    auto time = fs::last_write_time(p, ec);
+    if (ec) {
+        error = "Failed to stat file: " + path;
+        return false;
+    }
+    version.mtimeNs = static_cast<int64_t>(time.time_since_epoch().count()) * 100;
+    version.inode = 0;
+#else
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0) {
+        error = (errno == ENOENT || errno == ENOTDIR) ? "File does not exist: " + path
+                                                      : "Failed to stat file: " + path;
+        return false;
+    }
+    if (!S_ISREG(st.st_mode)) {
+        error = "Not a regular file: " + path;
+        return false;
+    }
+    version.size = static_cast<uint64_t>(st.st_size);
+#ifdef __APPLE__
+    version.mtimeNs = static_cast<int64_t>(st.st_mtimespec.tv_sec) * 1000000000LL + st.st_mtimespec.tv_nsec;
+#else
+    version.mtimeNs = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+#endif
+    version.inode = static_cast<uint64_t>(st.st_ino);
+#endif
+    return true;
+}
+
+// Reads to end of file rather than trusting sizeHint: the caller compares the two to detect
+// files that changed under it
+static bool readWhole(const std::string& path, uint64_t sizeHint, std::vector<unsigned char>& data, std::string& error) {
+    std::ifstream file(fs::u8path(path), std::ios::binary);
+    if (!file.is_open()) {
+        error = "Failed to open file: " + path;
+        return false;
+    }
+    size_t filled = 0;
+    data.resize(static_cast<size_t>(sizeHint) + 1);
+    while (true) {
+        file.read(reinterpret_cast<char*>(data.data() + filled), static_cast<std::streamsize>(data.size() - filled));
+        filled += static_cast<size_t>(file.gcount());
+        if (file.bad()) {
+            error = "Failed to read file: " + path;
+            return false;
+        }
+        if (file.eof()) break;
+        data.resize(data.size() + kReadStep);
+    }
+    data.resize(filled);
+    return true;
+}
+
+void FileContentCache::release(const std::vector<uint64_t>& unwatch) {
+    for (uint64_t id : unwatch) {
+        FileWatcher::getInstance().unwatch(id);
+    }
+}
+
+void FileContentCache::remove(std::unordered_map<std::string, Entry>::iterator it, std::vector<uint64_t>& unwatch) {
+    Entry& entry = it->second;
+    bytes_ -= entry.data->size() + (entry.base64 ? entry.base64->size() : 0);
+    if (entry.watch) {
+        unwatch.push_back(entry.watch->id);
+        --watched_;
+    }
+    lru_.erase(entry.lru);
+    entries_.erase(it);
+}
+
+void FileContentCache::evict(std::vector<uint64_t>& unwatch) {
+    while (bytes_ > budget_ && !lru_.empty()) {
+        remove(entries_.find(lru_.back()), unwatch);
+    }
+}
+
+FileContentCache::Bytes FileContentCache::acquire(const std::string& path, std::string& key, std::string& error) {
+    key = keyFor(path);
+    std::vector<uint64_t> unwatch;
+    bool canWatch = false;
+    uint64_t invalidations;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it != entries_.end() && it->second.watch) {
+            Entry& entry = it->second;
+            if (entry.watch->events.load() == entry.seenEvents) {
+                ++hits_;
+                lru_.splice(lru_.begin(), lru_, entry.lru);
+                return entry.data;
+            }
+            // Changed since it was read. Reload under a new registration: the event may have
+            // been the last one of a watch whose directory was moved or deleted
+            remove(it, unwatch);
+        }
+        canWatch = FileWatcher::isEventDriven() && watched_ < kMaxWatchedEntries;
+        invalidations = invalidations_;
+    }
+    release(unwatch);
+    unwatch.clear();
+
+    std::shared_ptr<Watch> watch;
+    if (canWatch) {
+        // Only canonical paths: FileWatcher resolves symlinks and would miss a retargeted link
+        std::error_code ec;
+        if (fs::canonical(fs::u8path(key), ec).u8string() == key && !ec) {
+            auto created = std::make_shared<Watch>();
+            std::weak_ptr<Watch> weak = created;
+            std::string watchError;
+            created->id = FileWatcher::getInstance().watch(key, 0,
+                [weak](const std::vector<FileWatcher::Change>&, bool) {
+                    if (auto target = weak.lock()) target->events.fetch_add(1);
+                }, watchError);
+            if (created->id != 0) {
+                watch = std::move(created);
+            }
+        }
+    }
+    // Snapshot before stat and read: an event for anything we read bumps past it
+    uint64_t seenEvents = watch ? watch->events.load() : 0;
+
+    Version before;
+    if (!statVersion(key, before, error)) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = entries_.find(key);
+            if (it != entries_.end()) remove(it, unwatch);
+        }
+        if (watch) unwatch.push_back(watch->id);
+        release(unwatch);
+        return nullptr;
+    }
+    Bytes cached;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it != entries_.end() && !it->second.watch && it->second.version == before) {
+            ++hits_;
+            lru_.splice(lru_.begin(), lru_, it->second.lru);
+            cached = it->second.data;
+        } else {
+            ++misses_;
+        }
+    }
+    if (cached) {
+        if (watch) release({watch->id});
+        return cached;
+    }
+
+    auto data = std::make_shared<std::vector<unsigned char>>();
+    if (!readWhole(key, before.size, *data, error)) {
+        if (watch) release({watch->id});
+        return nullptr;
+    }
+    Version after;
+    std::string statError;
+    bool cacheable = data->size() == before.size && before.size <= maxEntryBytes() &&
+                     statVersion(key, after, statError) && after == before;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it != entries_.end()) remove(it, unwatch);  // a concurrent load got there first
+        if (cacheable && invalidations == invalidations_) {
+            bool keepWatch = watch && watched_ < kMaxWatchedEntries;
+            if (watch && !keepWatch) unwatch.push_back(watch->id);
+
+            Entry& entry = entries_[key];
+            entry.data = data;
+            entry.version = before;
+            if (keepWatch) {
+                entry.watch = watch;
+                entry.seenEvents = seenEvents;
+                ++watched_;
+            }
+            lru_.push_front(key);
+            entry.lru = lru_.begin();
+            bytes_ += data->size();
+            evict(unwatch);
+        } else if (watch) {
+            unwatch.push_back(watch->id);
+        }
+    }
+    release(unwatch);
+    return data;
+}
+
+FileContentCache::Bytes FileContentCache::get(const std::string& path, std::string& error) {
+    std::string key;
+    return acquire(path, key, error);
+}
+
+std::shared_ptr<const std::string> FileContentCache::getBase64(const std::string& path, uint64_t& size, std::string& error) {
+    std::string key;
+    Bytes data = acquire(path, key, error);
+    if (!data) return nullptr;
+    size = data->size();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it != entries_.end() && it->second.data == data && it->second.base64) {
+            return it->second.base64;
+        }
+    }
+    auto encoded = std::make_shared<const std::string>(base64::encode(*data));
+    std::vector<uint64_t> unwatch;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it != entries_.end() && it->second.data == data && !it->second.base64) {
+            it->second.base64 = encoded;
+            bytes_ += encoded->size();
+            evict(unwatch);
+        }
+    }
+    release(unwatch);
+    return encoded;
+}
+
+void FileContentCache::invalidate(const std::string& path) {
+    std::string key = keyFor(path);
+    std::string prefix = (fs::u8path(key) / "").u8string();
+    std::vector<uint64_t> unwatch;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++invalidations_;
+        for (auto it = entries_.begin(); it != entries_.end();) {
+            auto next = std::next(it);
+            if (it->first == key || it->first.compare(0, prefix.size(), prefix) == 0) {
+                remove(it, unwatch);
+            }
+            it = next;
+        }
+    }
+    release(unwatch);
+}
+
+void FileContentCache::clear() {
+    std::vector<uint64_t> unwatch;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++invalidations_;
+        while (!entries_.empty()) {
+            remove(entries_.begin(), unwatch);
+        }
+    }
+    release(unwatch);
+}
+
+void FileContentCache::setBudget(uint64_t bytes) {
+    std::vector<uint64_t> unwatch;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        budget_ = bytes;
+        evict(unwatch);
+    }
+    release(unwatch);
+}
+
+uint64_t FileContentCache::maxEntryBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return budget_ / 4;
+}
+
+FileContentCache::Stats FileContentCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats;
+    stats.hits = hits_;
+    stats.misses = misses_;
+    stats.bytes = bytes_;
+    stats.budget = budget_;
+    stats.entries = entries_.size();
+    return stats;
+}
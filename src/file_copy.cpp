@@ -0,0 +1,213 @@
+#include "../include/file_copy.h"
+#include <cerrno>
+#include <filesystem>
+#include <system_error>
+#include <vector>
+
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#if defined(__linux__)
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace file_copy {
+
+// Bytes per copy_file_range / read-write step: the unit of progress and cancellation
+static const size_t kChunkSize = 8 * 1024 * 1024;
+static const size_t kBufferSize = 1024 * 1024;
+
+const char* methodName(Method method) {
+    switch (method) {
+        case Method::Clone: return "clone";
+        case Method::CopyRange: return "copyFileRange";
+        case Method::ReadWrite: return "readWrite";
+    }
+    return "readWrite";
+}
+
+static bool cancelled(const std::atomic<bool>* cancel, std::string& error) {
+    if (cancel && cancel->load()) {
+        error = "Cancelled";
+        return true;
+    }
+    return false;
+}
+
+#ifdef _WIN32
+
+bool copyFile(const std::string& source, const std::string& destination, Method& method, std::string& error,
+              const Progress& progress, const std::atomic<bool>* cancel) {
+    method = Method::ReadWrite;
+    std::ifstream in(fs::u8path(source), std::ios::binary);
+    if (!in.is_open()) {
+        error = "Failed to open file: " + source;
+        return false;
+    }
+    std::ofstream out(fs::u8path(destination), std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        error = "Failed to create file: " + destination;
+        return false;
+    }
+    std::vector<char> buffer(kBufferSize);
+    while (true) {
+        if (cancelled(cancel, error)) return false;
+        in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        std::streamsize n = in.gcount();
+        if (in.bad()) {
+            error = "Failed to read file: " + source;
+            return false;
+        }
+        if (n == 0) break;
+        if (!out.write(buffer.data(), n)) {
+            error = "Failed to write file: " + destination;
+            return false;
+        }
+        if (progress) progress(static_cast<uint64_t>(n));
+    }
+    out.close();
+    if (out.fail()) {
+        error = "Failed to write file: " + destination;
+        return false;
+    }
+    std::error_code ec;
+    fs::permissions(fs::u8path(destination), fs::status(fs::u8path(source), ec).permissions(), ec);
+    return true;
+}
+
+#else
+
+static std::string lastError() {
+    return std::generic_category().message(errno);
+}
+
+// Closes both descriptors on every path out of copyFile
+struct Descriptors {
+    int in = -1;
+    int out = -1;
+    ~Descriptors() {
+        if (in >= 0) ::close(in);
+        if (out >= 0) ::close(out);
+    }
+};
+
+static bool writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+#if defined(__linux__) && defined(__NR_copy_file_range)
+// Errors meaning "not between these two files": fall back to read/write from the current offsets
+static bool rangeUnsupported(int err) {
+    return err == EXDEV || err == ENOSYS || err == EINVAL || err == EOPNOTSUPP || err == ENOTSUP || err == EPERM ||
+           err == EBADF;
+}
+
+// False (without error) to fall back to read/write; error is set on a real failure
+static bool copyRange(Descriptors& fds, uint64_t& copied, std::string& error, const Progress& progress,
+                      const std::atomic<bool>* cancel) {
+    while (true) {
+        if (cancelled(cancel, error)) return false;
+        ssize_t n = ::syscall(__NR_copy_file_range, fds.in, nullptr, fds.out, nullptr, kChunkSize, 0u);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (!rangeUnsupported(errno)) error = "Failed to copy data (" + lastError() + ")";
+            return false;
+        }
+        if (n == 0) {
+            // Pseudo filesystems (procfs, sysfs) copy nothing in-kernel; read/write finds out
+            // whether the file is really empty
+            return copied > 0;
+        }
+        copied += static_cast<uint64_t>(n);
+        if (progress) progress(static_cast<uint64_t>(n));
+    }
+}
+#endif
+
+bool copyFile(const std::string& source, const std::string& destination, Method& method, std::string& error,
+              const Progress& progress, const std::atomic<bool>* cancel) {
+    Descriptors fds;
+    fds.in = ::open(source.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fds.in < 0) {
+        error = "Failed to open file: " + source + " (" + lastError() + ")";
+        return false;
+    }
+    struct stat st;
+    if (::fstat(fds.in, &st) != 0 || !S_ISREG(st.st_mode)) {
+        error = "Not a regular file: " + source;
+        return false;
+    }
+    fds.out = ::open(destination.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fds.out < 0) {
+        error = "Failed to create file: " + destination + " (" + lastError() + ")";
+        return false;
+    }
+
+    bool done = false;
+#if defined(__linux__) && defined(FICLONE)
+    if (st.st_size > 0 && ::ioctl(fds.out, FICLONE, fds.in) == 0) {
+        method = Method::Clone;
+        if (progress) progress(static_cast<uint64_t>(st.st_size));
+        done = true;
+    }
+#endif
+#if defined(__linux__) && defined(__NR_copy_file_range)
+    if (!done) {
+        uint64_t copied = 0;
+        method = Method::CopyRange;
+        // On fallback both file offsets already sit past whatever was copied
+        done = copyRange(fds, copied, error, progress, cancel);
+        if (!error.empty()) return false;
+    }
+#endif
+    if (!done) {
+        method = Method::ReadWrite;
+        std::vector<char> buffer(kBufferSize);
+        while (true) {
+            if (cancelled(cancel, error)) return false;
+            ssize_t n = ::read(fds.in, buffer.data(), buffer.size());
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                error = "Failed to read file: " + source + " (" + lastError() + ")";
+                return false;
+            }
+            if (n == 0) break;
+            if (!writeAll(fds.out, buffer.data(), static_cast<size_t>(n))) {
+                error = "Failed to write file: " + destination + " (" + lastError() + ")";
+                return false;
+            }
+            if (progress) progress(static_cast<uint64_t>(n));
+        }
+    }
+
+    // Permission bits without setuid/setgid, which a copy should not carry
+    ::fchmod(fds.out, st.st_mode & 0777);
+    int out = fds.out;
+    fds.out = -1;
+    if (::close(out) != 0) {
+        error = "Failed to write file: " + destination + " (" + lastError() + ")";
+        return false;
+    }
+    return true;
+}
+
+#endif
+
+} // namespace file_copy
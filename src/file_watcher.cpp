@@ -0,0 +1,383 @@
+#include "../include/file_watcher.h"
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+// Past this many distinct pending names a watch reports overflow instead (rescan)
+static const size_t kMaxPendingChanges = 4096;
+// A continuous storm is still delivered every this many debounce intervals
+static const int kMaxLatencyIntervals = 10;
+#ifndef __linux__
+static const std::chrono::milliseconds kPollInterval(500);
+#endif
+
+FileWatcher& FileWatcher::getInstance() {
+    static FileWatcher instance;
+    return instance;
+}
+
+FileWatcher::FileWatcher() = default;
+
+FileWatcher::~FileWatcher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+#ifdef __linux__
+    if (wakeFds_[1] >= 0) {
+        char c = 0;
+        (void)::write(wakeFds_[1], &c, 1);
+    }
+#endif
+    wake_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+#ifdef __linux__
+    if (inotifyFd_ >= 0) ::close(inotifyFd_);
+    if (wakeFds_[0] >= 0) ::close(wakeFds_[0]);
+    if (wakeFds_[1] >= 0) ::close(wakeFds_[1]);
+#endif
+}
+
+const char* FileWatcher::kindName(ChangeKind kind) {
+    switch (kind) {
+        case ChangeKind::Created: return "created";
+        case ChangeKind::Modified: return "modified";
+        case ChangeKind::Deleted: return "deleted";
+    }
+    return "modified";
+}
+
+bool FileWatcher::isEventDriven() {
+#ifdef __linux__
+    return true;
+#else
+    return false;
+#endif
+}
+
+uint64_t FileWatcher::watch(const std::string& path, int debounceMs, Callback callback, std::string& error) {
+    std::error_code ec;
+    fs::path target = fs::canonical(path, ec);
+    if (ec) {
+        error = "Path does not exist";
+        return 0;
+    }
+    Watch watch;
+    if (fs::is_directory(target, ec)) {
+        watch.dir = target.string();
+    } else {
+        watch.dir = target.parent_path().string();
+        watch.fileName = target.filename().string();
+        watch.fileExists = true;
+    }
+    watch.debounce = std::chrono::milliseconds(std::max(0, debounceMs));
+    watch.callback = std::move(callback);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!thread_.joinable()) {
+        if (!startBackend(error)) {
+            return 0;
+        }
+        thread_ = std::thread([this]() { run(); });
+    }
+    if (!addBackendWatch(watch, error)) {
+        return 0;
+    }
+    uint64_t id = ++nextId_;
+    watches_.emplace(id, std::move(watch));
+    return id;
+}
+
+void FileWatcher::unwatch(uint64_t id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = watches_.find(id);
+    if (it == watches_.end()) return;
+    Watch removed = std::move(it->second);
+    watches_.erase(it);
+    if (removed.ended) return;  // Its backend watch is gone already
+    for (const auto& entry : watches_) {
+        if (entry.second.dir == removed.dir && !entry.second.ended) return;  // Still observed for another watch
+    }
+    removeBackendWatch(removed);
+}
+
+// Caller holds mutex_
+void FileWatcher::record(Watch& watch, const std::string& name, ChangeKind kind) {
+    if (!watch.fileName.empty()) {
+        if (kind == ChangeKind::Created && watch.fileExists) kind = ChangeKind::Modified;
+        watch.fileExists = kind != ChangeKind::Deleted;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (watch.pending.empty() && !watch.overflow) {
+        watch.firstEvent = now;
+    }
+    watch.lastEvent = now;
+    if (watch.overflow) return;
+
+    auto it = watch.pending.find(name);
+    if (it == watch.pending.end()) {
+        if (watch.pending.size() >= kMaxPendingChanges) {
+            watch.pending.clear();
+            watch.overflow = true;
+            return;
+        }
+        watch.pending.emplace(name, kind);
+        return;
+    }
+    ChangeKind previous = it->second;
+    if (previous == ChangeKind::Created) {
+        if (kind == ChangeKind::Deleted) watch.pending.erase(it);  // Came and went within the burst
+    } else if (previous == ChangeKind::Deleted) {
+        if (kind != ChangeKind::Deleted) it->second = ChangeKind::Modified;  // Replaced (atomic save)
+    } else if (kind == ChangeKind::Deleted) {
+        it->second = ChangeKind::Deleted;
+    }
+}
+
+// Caller holds mutex_
+void FileWatcher::collectDue(std::vector<std::pair<Callback, std::pair<std::vector<Change>, bool>>>& due) {
+    auto now = std::chrono::steady_clock::now();
+    for (auto& entry : watches_) {
+        Watch& watch = entry.second;
+        if (watch.pending.empty() && !watch.overflow) continue;
+        if (now - watch.lastEvent < watch.debounce && now - watch.firstEvent < watch.debounce * kMaxLatencyIntervals) {
+            continue;
+        }
+        std::vector<Change> changes;
+        for (const auto& p : watch.pending) {
+            changes.push_back({p.first, p.second});
+        }
+        due.push_back({watch.callback, {std::move(changes), watch.overflow}});
+        watch.pending.clear();
+        watch.overflow = false;
+    }
+}
+
+// Caller holds mutex_. -1 = nothing pending.
+int FileWatcher::nextTimeoutMs() const {
+    auto now = std::chrono::steady_clock::now();
+    int64_t best = -1;
+    for (const auto& entry : watches_) {
+        const Watch& watch = entry.second;
+        if (watch.pending.empty() && !watch.overflow) continue;
+        auto deadline = std::min(watch.lastEvent + watch.debounce, watch.firstEvent + watch.debounce * kMaxLatencyIntervals);
+        int64_t ms = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count() + 1;
+        ms = std::max<int64_t>(ms, 0);
+        if (best < 0 || ms < best) best = ms;
+    }
+    return static_cast<int>(best);
+}
+
+// Caller holds mutex_. The directory behind these watches is gone (or now elsewhere): tell
+// them once, then keep them quiet even if a new directory appears under the same path
+void FileWatcher::endWatches(const std::string& dir) {
+    for (auto& entry : watches_) {
+        Watch& watch = entry.second;
+        if (watch.dir != dir || watch.ended) continue;
+        if (!watch.fileName.empty()) {
+            record(watch, watch.fileName, ChangeKind::Deleted);
+        } else {
+            record(watch, "", ChangeKind::Modified);  // Starts the debounce clock
+            watch.pending.clear();
+            watch.overflow = true;
+        }
+        watch.ended = true;
+    }
+}
+
+void FileWatcher::run() {
+    while (true) {
+        int timeoutMs;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) return;
+            timeoutMs = nextTimeoutMs();
+        }
+        waitForEvents(timeoutMs);
+
+        std::vector<std::pair<Callback, std::pair<std::vector<Change>, bool>>> due;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) return;
+            collectDue(due);
+        }
+        for (auto& d : due) {
+            try {
+                d.first(d.second.first, d.second.second);
+            } catch (const std::exception& e) {
+                std::cerr << "[FileWatcher] Callback failed: " << e.what() << std::endl;
+            }
+        }
+    }
+}
+
+#ifdef __linux__
+
+static const uint32_t kInotifyMask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_MOVED_FROM |
+                                     IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_EXCL_UNLINK;
+
+bool FileWatcher::startBackend(std::string& error) {
+    inotifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd_ < 0) {
+        error = "inotify unavailable";
+        return false;
+    }
+    if (pipe2(wakeFds_, O_NONBLOCK | O_CLOEXEC) != 0) {
+        ::close(inotifyFd_);
+        inotifyFd_ = -1;
+        error = "Failed to create wake pipe";
+        return false;
+    }
+    return true;
+}
+
+bool FileWatcher::addBackendWatch(Watch& watch, std::string& error) {
+    int wd = inotify_add_watch(inotifyFd_, watch.dir.c_str(), kInotifyMask);
+    if (wd < 0) {
+        error = errno == ENOSPC ? "Watch limit reached (fs.inotify.max_user_watches)" : "Failed to watch path";
+        return false;
+    }
+    dirsByDescriptor_[wd] = watch.dir;
+    return true;
+}
+
+void FileWatcher::removeBackendWatch(const Watch& watch) {
+    for (auto it = dirsByDescriptor_.begin(); it != dirsByDescriptor_.end(); ++it) {
+        if (it->second == watch.dir) {
+            inotify_rm_watch(inotifyFd_, it->first);
+            dirsByDescriptor_.erase(it);
+            return;
+        }
+    }
+}
+
+void FileWatcher::waitForEvents(int timeoutMs) {
+    pollfd fds[2] = {{inotifyFd_, POLLIN, 0}, {wakeFds_[0], POLLIN, 0}};
+    if (::poll(fds, 2, timeoutMs) <= 0) return;
+    if (fds[1].revents & POLLIN) {
+        char drain[64];
+        while (::read(wakeFds_[0], drain, sizeof(drain)) > 0) {}
+    }
+    if (!(fds[0].revents & POLLIN)) return;
+
+    alignas(inotify_event) char buffer[16 * 1024];
+    while (true) {
+        ssize_t n = ::read(inotifyFd_, buffer, sizeof(buffer));
+        if (n <= 0) break;
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (char* p = buffer; p < buffer + n;) {
+            const inotify_event* ev = reinterpret_cast<const inotify_event*>(p);
+            p += sizeof(inotify_event) + ev->len;
+
+            if (ev->mask & IN_Q_OVERFLOW) {
+                for (auto& entry : watches_) {
+                    record(entry.second, "", ChangeKind::Modified);  // Starts the debounce clock
+                    entry.second.pending.clear();
+                    entry.second.overflow = true;
+                }
+                continue;
+            }
+            auto dirIt = dirsByDescriptor_.find(ev->wd);
+            if (dirIt == dirsByDescriptor_.end()) continue;
+            if (ev->mask & (IN_IGNORED | IN_DELETE_SELF | IN_MOVE_SELF)) {
+                // The directory was deleted (the kernel drops the watch) or moved (the watch
+                // would follow it to its new path, so drop it here)
+                endWatches(dirIt->second);
+                if (!(ev->mask & IN_IGNORED)) inotify_rm_watch(inotifyFd_, ev->wd);
+                dirsByDescriptor_.erase(dirIt);
+                continue;
+            }
+            std::string name = ev->len ? std::string(ev->name) : std::string();
+            ChangeKind kind = ChangeKind::Modified;
+            if (ev->mask & (IN_CREATE | IN_MOVED_TO)) kind = ChangeKind::Created;
+            if (ev->mask & (IN_DELETE | IN_MOVED_FROM)) kind = ChangeKind::Deleted;
+            for (auto& entry : watches_) {
+                Watch& watch = entry.second;
+                if (watch.dir != dirIt->second || watch.ended) continue;
+                if (!watch.fileName.empty()) {
+                    if (name == watch.fileName) record(watch, name, kind);
+                } else {
+                    record(watch, name, kind);
+                }
+            }
+        }
+    }
+}
+
+#else
+
+// Polling backend: stat snapshots of the watched entries, diffed every kPollInterval
+
+static std::map<std::string, std::pair<int64_t, int64_t>> takeSnapshot(const std::string& dir,
+                                                                       const std::string& fileName) {
+    std::map<std::string, std::pair<int64_t, int64_t>> snapshot;
+    auto add = [&snapshot](const fs::path& path, const std::string& name) {
+        std::error_code ec;
+        auto status = fs::status(path, ec);
+        if (ec || !fs::exists(status)) return;
+        int64_t size = fs::is_regular_file(status) ? static_cast<int64_t>(fs::file_size(path, ec)) : 0;
+        int64_t mtime = static_cast<int64_t>(fs::last_write_time(path, ec).time_since_epoch().count());
+        snapshot[name] = {size, mtime};
+    };
+    if (!fileName.empty()) {
+        add(fs::path(dir) / fileName, fileName);
+        return snapshot;
+    }
+    std::error_code ec;
+    for (fs::directory_iterator it(dir, fs::directory_options::skip_permission_denied, ec);
+         !ec && it != fs::directory_iterator(); it.increment(ec)) {
+        add(it->path(), it->path().filename().string());
+    }
+    return snapshot;
+}
+
+bool FileWatcher::startBackend(std::string& error) {
+    (void)error;
+    return true;
+}
+
+bool FileWatcher::addBackendWatch(Watch& watch, std::string& error) {
+    (void)error;
+    watch.snapshot = takeSnapshot(watch.dir, watch.fileName);
+    return true;
+}
+
+void FileWatcher::removeBackendWatch(const Watch& watch) {
+    (void)watch;
+}
+
+void FileWatcher::waitForEvents(int timeoutMs) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto wait = timeoutMs < 0 ? kPollInterval : std::min(kPollInterval, std::chrono::milliseconds(timeoutMs));
+    wake_.wait_for(lock, wait, [this]() { return stopping_; });
+    if (stopping_) return;
+    for (auto& entry : watches_) {
+        Watch& watch = entry.second;
+        auto current = takeSnapshot(watch.dir, watch.fileName);
+        for (const auto& item : current) {
+            auto old = watch.snapshot.find(item.first);
+            if (old == watch.snapshot.end()) {
+                record(watch, item.first, ChangeKind::Created);
+            } else if (old->second != item.second) {
+                record(watch, item.first, ChangeKind::Modified);
+            }
+        }
+        for (const auto& item : watch.snapshot) {
+            if (!current.count(item.first)) record(watch, item.first, ChangeKind::Deleted);
+        }
+        watch.snapshot = std::move(current);
+    }
+}
+
+#endif
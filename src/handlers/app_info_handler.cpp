@@ -1,4 +1,5 @@
 #include "../../include/message_handler.h"
+#include "../../include/handlers/handler_types.h"
 #include <nlohmann/json.hpp>
 #include <iostream>
 #include <vector>
@@ -89,7 +90,7 @@ public:
     }
     
     std::vector<std::string> getSupportedTypes() const override {
-        return {"getAppInfo"};
+        return handler_types::kAppInfo;
     }
 };
 
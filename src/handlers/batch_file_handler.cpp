@@ -0,0 +1,168 @@
+#include "../../include/handlers/batch_file_handler.h"
+#include "../../include/handlers/handler_types.h"
+#include "../../include/handlers/file_system_handler.h"
+#include "../../include/message_handler.h"
+#include "../../include/base64.h"
+#include "../../include/batch_io.h"
+#include "../../include/job_manager.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+static const size_t kMaxPathsPerBatch = 10000;
+// Same per-file limits as readFile; the batch as a whole gets the same again, since base64
+// and the JSON reply multiply it
+static const uint64_t kDefaultMaxBytes = 64ull * 1024 * 1024;
+static const uint64_t kMaxBytesLimit = 256ull * 1024 * 1024;
+
+static bool readLimit(const nlohmann::json& payload, const char* key, uint64_t& value, std::string& error) {
+    if (!payload.contains(key)) {
+        return true;
+    }
+    const nlohmann::json& v = payload[key];
+    if (v.is_number_unsigned() || (v.is_number_integer() && v.get<int64_t>() >= 0)) {
+        value = std::min(v.get<uint64_t>(), kMaxBytesLimit);
+        return true;
+    }
+    error = std::string("Invalid '") + key + "' in payload (expect a non-negative integer)";
+    return false;
+}
+
+// Handler for batched file access.
+//   readFiles: paths (array), maxBytes (per file, default 64 MiB), maxTotalBytes (whole batch,
+//              default 64 MiB)
+//              -> { backend, bytesRead, results: [ { path, data (base64), size } or
+//                   { path, error, rangeRequired?, totalSize? } ] }
+//   statMany:  paths (array)
+//              -> { backend, results: [ { path, exists, isDirectory, isFile, size, mtime } or
+//                   { path, exists: false } or { path, error } ] }
+// Paths are sandboxed like listDir/stat; results keep the request order. Files past
+// maxTotalBytes fail with "Batch byte limit reached" and can be requested again; files over
+// maxBytes get rangeRequired like readFile and must be paged with readFile.
+class BatchFileHandler : public MessageHandler {
+public:
+    bool canHandle(const std::string& messageType) const override {
+        return messageType == "readFiles" || messageType == "statMany";
+    }
+
+    nlohmann::json handle(const nlohmann::json& payload, const std::string& requestId) override {
+        (void)requestId;
+        nlohmann::json result;
+        std::string op;
+        if (payload.contains("_type") && payload["_type"].is_string()) {
+            op = payload["_type"].get<std::string>();
+        }
+
+        if (!payload.contains("paths") || !payload["paths"].is_array() || payload["paths"].empty() ||
+            payload["paths"].size() > kMaxPathsPerBatch) {
+            result["success"] = false;
+            result["error"] = "Missing or invalid 'paths' in payload (expect 1-" + std::to_string(kMaxPathsPerBatch) +
+                              " paths)";
+            return result;
+        }
+        uint64_t maxBytes = kDefaultMaxBytes;
+        uint64_t maxTotalBytes = kDefaultMaxBytes;
+        std::string error;
+        if (!readLimit(payload, "maxBytes", maxBytes, error) || !readLimit(payload, "maxTotalBytes", maxTotalBytes, error)) {
+            result["success"] = false;
+            result["error"] = error;
+            return result;
+        }
+
+        // Rejected paths keep their slot in the reply but are not handed to the backend
+        fs::path base = fs::current_path();
+        std::vector<std::string> resolved;
+        std::vector<size_t> slots;  // index into resolved per request path, or npos
+        for (const auto& p : payload["paths"]) {
+            if (!p.is_string()) {
+                result["success"] = false;
+                result["error"] = "Invalid 'paths' in payload (expect strings)";
+                return result;
+            }
+            std::string path = resolveSandboxedPath(p.get<std::string>(), base);
+            if (path.empty()) {
+                slots.push_back(std::string::npos);
+            } else {
+                slots.push_back(resolved.size());
+                resolved.push_back(std::move(path));
+            }
+        }
+
+        // Run through startJob, cancelJob stops the batch between files
+        JobContext* job = JobContext::current();
+        const std::atomic<bool>* cancelled = job ? job->cancelFlag() : nullptr;
+        auto cancelledReply = []() { return nlohmann::json{{"success", false}, {"error", "Cancelled"}}; };
+
+        result["results"] = nlohmann::json::array();
+        batch_io::Backend backend;
+        if (op == "statMany") {
+            std::vector<batch_io::StatResult> stats;
+            backend = batch_io::statMany(resolved, stats, cancelled);
+            if (job && job->cancelled()) return cancelledReply();
+            for (size_t i = 0; i < slots.size(); ++i) {
+                nlohmann::json item;
+                item["path"] = payload["paths"][i];
+                if (slots[i] == std::string::npos) {
+                    item["error"] = "Invalid or disallowed path";
+                } else if (!stats[slots[i]].error.empty()) {
+                    item["error"] = stats[slots[i]].error;
+                } else if (!stats[slots[i]].exists) {
+                    item["exists"] = false;
+                } else {
+                    const batch_io::StatResult& stat = stats[slots[i]];
+                    item["exists"] = true;
+                    item["isDirectory"] = stat.isDirectory;
+                    item["isFile"] = stat.isFile;
+                    if (stat.isFile) item["size"] = stat.size;
+                    item["mtime"] = stat.mtimeMs;
+                }
+                result["results"].push_back(std::move(item));
+            }
+        } else {
+            std::vector<batch_io::ReadResult> reads;
+            backend = batch_io::readFiles(resolved, maxBytes, maxTotalBytes, reads, cancelled);
+            uint64_t bytesRead = 0;
+            for (size_t i = 0; i < slots.size(); ++i) {
+                if (job && job->cancelled()) return cancelledReply();
+                nlohmann::json item;
+                item["path"] = payload["paths"][i];
+                if (slots[i] == std::string::npos) {
+                    item["error"] = "Invalid or disallowed path";
+                } else if (!reads[slots[i]].error.empty()) {
+                    item["error"] = reads[slots[i]].error;
+                    if (reads[slots[i]].overLimit) {
+                        item["rangeRequired"] = true;
+                        item["totalSize"] = reads[slots[i]].fileSize;
+                    }
+                } else {
+                    batch_io::ReadResult& read = reads[slots[i]];
+                    item["data"] = base64::encode(read.data);
+                    item["size"] = read.data.size();
+                    bytesRead += read.data.size();
+                    read.data = std::vector<unsigned char>();
+                }
+                result["results"].push_back(std::move(item));
+            }
+            result["bytesRead"] = bytesRead;
+        }
+        result["success"] = true;
+        result["backend"] = batch_io::backendName(backend);
+        return result;
+    }
+
+    std::vector<std::string> getSupportedTypes() const override {
+        return handler_types::kBatchFile;
+    }
+
+    // Stateless, and batch_io serializes its ring: large batches may run through startJob,
+    // and stop when the job is cancelled
+    bool canRunAsJob(const std::string& messageType) const override {
+        return canHandle(messageType);
+    }
+};
+
+std::shared_ptr<MessageHandler> createBatchFileHandler() {
+    return std::make_shared<BatchFileHandler>();
+}
@@ -1,4 +1,5 @@
 #include "../../include/message_handler.h"
+#include "../../include/handlers/handler_types.h"
 #include <nlohmann/json.hpp>
 #include <iostream>
 #include <vector>
@@ -67,7 +68,7 @@ public:
     }
     
     std::vector<std::string> getSupportedTypes() const override {
-        return {"calculate"};
+        return handler_types::kCalculator;
     }
 };
 
@@ -0,0 +1,612 @@
+#include "../../include/handlers/compression_handler.h"
+#include "../../include/handlers/handler_types.h"
+#include "../../include/handlers/file_system_handler.h"
+#include "../../include/message_handler.h"
+#include "../../include/base64.h"
+#include "../../include/compression.h"
+#include "../../include/file_content_cache.h"
+#include "../../include/job_manager.h"
+#include "../../include/thread_pool.h"
+#include "../../include/handler_jobs.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <set>
+
+namespace fs = std::filesystem;
+
+static const int64_t kProgressIntervalMs = 100;
+static const int kDefaultLevel = 6;
+// Inline data travels as base64 in both directions
+static const size_t kMaxInlineBytes = 32 * 1024 * 1024;
+static const size_t kMaxZipInputs = 65536;
+// Entries up to this size are read and deflated on the pool; larger ones are streamed by the
+// writer thread so they are never held in memory
+static const uint64_t kMaxPreparedEntrySize = 32 * 1024 * 1024;
+// Bounds on prepared entries waiting for the writer
+static const uint64_t kMaxInFlightBytes = 256 * 1024 * 1024;
+static const size_t kMaxInFlightEntries = 256;
+
+struct ZipInput {
+    std::string resolved;
+    std::string name;  // entry name, or prefix for a directory's contents
+    bool isDirectory = false;
+};
+
+struct ZipEntry {
+    std::string name;
+    std::string source;
+    uint64_t size = 0;
+    int64_t mtime = 0;  // seconds since the Unix epoch
+    bool isDirectory = false;
+    // filled by the pool task for prepared entries; guarded by CompressJob::mutex
+    bool ready = false;
+    compression::PreparedEntry prepared;
+    std::string error;
+};
+
+struct CompressJob {
+    std::string id;
+    std::string outputPath;  // as requested
+    std::string resolvedOutput;
+    std::shared_ptr<HandlerJobs<CompressJob>> jobs;
+    std::chrono::steady_clock::time_point started;
+    std::atomic<bool> cancelled{false};
+    int64_t lastProgressMs = 0;
+
+    // compress / decompress
+    bool compressing = true;
+    compression::Format format = compression::Format::Gzip;
+    int level = kDefaultLevel;
+    std::string source;
+    uint64_t inputSize = 0;
+    std::atomic<uint64_t> bytesDone{0};
+
+    // createZip
+    std::vector<ZipInput> inputs;
+    std::vector<ZipEntry> entries;
+    std::mutex mutex;
+    std::condition_variable readyChanged;
+
+    int64_t elapsedMs() const {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started).count();
+    }
+
+    // Called from the single thread running the job
+    bool progressDue() {
+        int64_t now = elapsedMs();
+        if (now - lastProgressMs < kProgressIntervalMs) return false;
+        lastProgressMs = now;
+        return true;
+    }
+};
+
+static void finishJob(const std::shared_ptr<CompressJob>& job, const std::string& eventName, nlohmann::json done) {
+    done["jobId"] = job->id;
+    done["outputPath"] = job->outputPath;
+    done["cancelled"] = job->cancelled.load();
+    done["elapsedMs"] = job->elapsedMs();
+    job->jobs->finish(*job, eventName, std::move(done));
+}
+
+static int64_t modifiedSeconds(const std::string& path) {
+    int64_t size = 0;
+    int64_t mtimeMs = 0;
+    std::error_code ec;
+    fs::directory_entry entry(fs::u8path(path), ec);
+    if (ec || !readEntryStat(entry, size, mtimeMs)) return 0;
+    return mtimeMs / 1000;
+}
+
+// Move the finished staging file into place, or drop it
+static bool commitOutput(const std::string& partPath, const std::string& target, bool ok, std::string& error) {
+    std::error_code ec;
+    if (ok) {
+        fs::rename(partPath, target, ec);
+        FileContentCache::getInstance().invalidate(target);
+        if (!ec) return true;
+        error = "Failed to move output into place: " + ec.message();
+    }
+    fs::remove(partPath, ec);
+    return false;
+}
+
+static void runCompressJob(const std::shared_ptr<CompressJob>& job) {
+    std::string partPath = hiddenSibling(fs::u8path(job->resolvedOutput), ".part").u8string();
+    CompressJob& j = *job;
+    auto progress = [&j](uint64_t bytes) {
+        j.bytesDone += bytes;
+        if (!j.progressDue()) return;
+        nlohmann::json event;
+        event["jobId"] = j.id;
+        event["bytesDone"] = j.bytesDone.load();
+        event["bytesTotal"] = j.inputSize;
+        j.jobs->emit("compress:progress", std::move(event));
+    };
+    uint64_t outputSize = 0;
+    std::string error;
+    bool ok = job->compressing
+                  ? compression::compressFile(job->source, partPath, job->format, job->level, outputSize, error,
+                                              progress, &job->cancelled)
+                  : compression::decompressFile(job->source, partPath, job->format, outputSize, error, progress,
+                                                &job->cancelled);
+    ok = commitOutput(partPath, job->resolvedOutput, ok, error);
+
+    nlohmann::json done;
+    done["inputSize"] = job->inputSize;
+    if (ok) {
+        done["outputSize"] = outputSize;
+    } else {
+        done["error"] = error;
+    }
+    finishJob(job, "compress:done", std::move(done));
+}
+
+// Expand directories into their contents (directory entries first, then children, sorted so
+// archives are reproducible). False on a duplicate entry name.
+static bool collectZipEntries(CompressJob& job, std::string& error) {
+    std::set<std::string> names;
+    auto add = [&](ZipEntry entry) {
+        if (!names.insert(entry.name).second) {
+            error = "Duplicate entry name: " + entry.name;
+            return false;
+        }
+        job.entries.push_back(std::move(entry));
+        return true;
+    };
+    for (const auto& input : job.inputs) {
+        if (job.cancelled) return true;
+        if (!input.isDirectory) {
+            ZipEntry entry;
+            entry.name = input.name;
+            entry.source = input.resolved;
+            std::error_code ec;
+            entry.size = fs::file_size(fs::u8path(input.resolved), ec);
+            entry.mtime = modifiedSeconds(input.resolved);
+            if (!add(std::move(entry))) return false;
+            continue;
+        }
+
+        ZipEntry root;
+        root.name = input.name + "/";
+        root.isDirectory = true;
+        root.mtime = modifiedSeconds(input.resolved);
+        if (!add(std::move(root))) return false;
+
+        std::vector<std::pair<std::string, fs::directory_entry>> children;
+        std::error_code ec;
+        fs::path base = fs::u8path(input.resolved);
+        fs::path sandbox = fs::current_path(ec);
+        for (fs::recursive_directory_iterator it(base, fs::directory_options::skip_permission_denied, ec), end;
+             !ec && it != end; it.increment(ec)) {
+            if (isSandboxTrash(it->path(), sandbox)) {
+                it.disable_recursion_pending();
+                continue;
+            }
+            std::error_code typeEc;
+            // symlinks could lead out of the sandbox; sockets, fifos etc. have no content
+            if (it->is_symlink(typeEc) || (!it->is_directory(typeEc) && !it->is_regular_file(typeEc))) continue;
+            children.emplace_back(it->path().lexically_relative(base).generic_u8string(), *it);
+        }
+        std::sort(children.begin(), children.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+        for (const auto& child : children) {
+            ZipEntry entry;
+            int64_t size = 0;
+            int64_t mtimeMs = 0;
+            if (!readEntryStat(child.second, size, mtimeMs)) continue;  // vanished meanwhile
+            std::error_code typeEc;
+            entry.isDirectory = child.second.is_directory(typeEc);
+            entry.name = input.name + "/" + child.first + (entry.isDirectory ? "/" : "");
+            entry.source = child.second.path().u8string();
+            entry.size = entry.isDirectory ? 0 : static_cast<uint64_t>(size);
+            entry.mtime = mtimeMs / 1000;
+            if (!add(std::move(entry))) return false;
+        }
+    }
+    return true;
+}
+
+static bool readWholeFile(const std::string& path, uint64_t size, std::vector<unsigned char>& content,
+                          std::string& error) {
+    std::ifstream file(fs::u8path(path), std::ios::binary);
+    if (!file.is_open()) {
+        error = "Failed to open file: " + path;
+        return false;
+    }
+    content.resize(static_cast<size_t>(size));
+    file.read(reinterpret_cast<char*>(content.data()), static_cast<std::streamsize>(content.size()));
+    content.resize(static_cast<size_t>(file.gcount()));
+    if (file.bad()) {
+        error = "Failed to read file: " + path;
+        return false;
+    }
+    return true;
+}
+
+// Pool task: read and deflate one small entry for the writer
+static void prepareZipEntry(const std::shared_ptr<CompressJob>& job, size_t index) {
+    ZipEntry& entry = job->entries[index];
+    compression::PreparedEntry prepared;
+    std::string error;
+    if (job->cancelled) {
+        error = "Cancelled";
+    } else {
+        std::vector<unsigned char> content;
+        if (readWholeFile(entry.source, entry.size, content, error)) {
+            compression::prepareEntry(std::move(content), job->level, prepared, error);
+        }
+    }
+    std::lock_guard<std::mutex> lock(job->mutex);
+    entry.prepared = std::move(prepared);
+    entry.error = error;
+    entry.ready = true;
+    job->readyChanged.notify_all();
+}
+
+static bool isPrepared(const ZipEntry& entry) {
+    return !entry.isDirectory && entry.size <= kMaxPreparedEntrySize;
+}
+
+// Writer: expands the inputs, keeps a bounded window of entries being prepared on the pool, and
+// appends them to the archive in order. Runs on a posted thread (JobManager::post) rather than
+// as a pool task because it blocks on pool work.
+static void runZipJob(const std::shared_ptr<CompressJob>& job) {
+    std::string partPath = hiddenSibling(fs::u8path(job->resolvedOutput), ".part").u8string();
+    std::string error;
+    uint64_t bytesTotal = 0;
+    uint64_t bytesDone = 0;
+    size_t entriesDone = 0;
+    uint64_t archiveSize = 0;
+
+    bool ok = collectZipEntries(*job, error);
+    for (const auto& entry : job->entries) bytesTotal += entry.size;
+
+    compression::ZipWriter writer;
+    ok = ok && !job->cancelled && writer.open(partPath, error, &job->cancelled);
+    ThreadPool& pool = ThreadPool::getInstance();
+    size_t submitted = 0;
+    uint64_t inFlightBytes = 0;
+    for (size_t i = 0; ok && i < job->entries.size(); ++i) {
+        if (job->cancelled) {
+            error = "Cancelled";
+            ok = false;
+            break;
+        }
+        for (; submitted < job->entries.size() && submitted - i < kMaxInFlightEntries; ++submitted) {
+            const ZipEntry& next = job->entries[submitted];
+            if (!isPrepared(next)) continue;
+            if (submitted > i && inFlightBytes + next.size > kMaxInFlightBytes) break;
+            inFlightBytes += next.size;
+            pool.submit([job, submitted]() { prepareZipEntry(job, submitted); });
+        }
+
+        ZipEntry& entry = job->entries[i];
+        if (entry.isDirectory) {
+            ok = writer.addDirectory(entry.name, entry.mtime, error);
+        } else if (!isPrepared(entry)) {
+            ok = writer.addFile(entry.name, entry.source, entry.size, entry.mtime, job->level, error);
+        } else {
+            std::unique_lock<std::mutex> lock(job->mutex);
+            job->readyChanged.wait(lock, [&entry]() { return entry.ready; });
+            lock.unlock();
+            inFlightBytes -= entry.size;
+            if (!entry.error.empty()) {
+                error = entry.error;
+                ok = false;
+            } else {
+                ok = writer.addPrepared(entry.name, entry.prepared, entry.mtime, error);
+            }
+            entry.prepared = compression::PreparedEntry();
+        }
+        if (!ok) break;
+        ++entriesDone;
+        bytesDone += entry.size;
+        if (job->progressDue()) {
+            nlohmann::json event;
+            event["jobId"] = job->id;
+            event["entriesDone"] = entriesDone;
+            event["entriesTotal"] = job->entries.size();
+            event["bytesDone"] = bytesDone;
+            event["bytesTotal"] = bytesTotal;
+            job->jobs->emit("zip:progress", std::move(event));
+        }
+    }
+    if (ok) {
+        ok = writer.finish(archiveSize, error);
+    }
+    if (!ok && job->cancelled) error = "Cancelled";
+
+    // Tasks still queued hold the job; wait for them so no pool thread touches the entries
+    // after the job is reported done
+    {
+        std::unique_lock<std::mutex> lock(job->mutex);
+        job->readyChanged.wait(lock, [&job, submitted]() {
+            for (size_t k = 0; k < submitted; ++k) {
+                if (isPrepared(job->entries[k]) && !job->entries[k].ready) return false;
+            }
+            return true;
+        });
+    }
+    ok = commitOutput(partPath, job->resolvedOutput, ok, error);
+
+    nlohmann::json done;
+    done["entries"] = ok ? job->entries.size() : entriesDone;
+    if (ok) {
+        done["compressedSize"] = archiveSize;
+    } else {
+        done["error"] = error;
+    }
+    finishJob(job, "zip:done", std::move(done));
+}
+
+static std::string base64Field(const nlohmann::json& payload) {
+    if (payload.contains("data")) {
+        if (payload["data"].is_string()) {
+            return payload["data"].get<std::string>();
+        } else if (payload["data"].contains("__base64") && payload["data"]["__base64"].is_string()) {
+            return payload["data"]["__base64"].get<std::string>();
+        }
+    }
+    return std::string();
+}
+
+// Entry name as given by the page: forward slashes, relative, no ".." segments. Empty if invalid.
+static std::string normalizeEntryName(std::string name) {
+    std::replace(name.begin(), name.end(), '\\', '/');
+    while (!name.empty() && name.front() == '/') name.erase(0, 1);
+    while (!name.empty() && name.back() == '/') name.pop_back();
+    size_t start = 0;
+    while (start <= name.size()) {
+        size_t end = name.find('/', start);
+        if (end == std::string::npos) end = name.size();
+        std::string segment = name.substr(start, end - start);
+        if (segment.empty() || segment == "." || segment == "..") return std::string();
+        start = end + 1;
+    }
+    return name;
+}
+
+// Handler for native compression.
+//   compress / decompress: format ("gzip" default, "zlib", "deflate"), level (0-9, default 6),
+//       and either data (base64, up to 32 MiB; replies { data }) or path + outputPath
+//       (replies { jobId } and streams the file on the pool)
+//   createZip: outputPath, files ([ path | { path, name } ]; directories are added
+//       recursively), level -> { jobId }
+//   cancelCompress: jobId
+// File jobs emit "compress:progress" { jobId, bytesDone, bytesTotal } and "compress:done"
+// { jobId, outputPath, inputSize, outputSize, cancelled, error?, elapsedMs }. Zip jobs emit
+// "zip:progress" { jobId, entriesDone, entriesTotal, bytesDone, bytesTotal } and "zip:done"
+// { jobId, outputPath, entries, compressedSize, cancelled, error?, elapsedMs }. Progress comes
+// at most every 100 ms. Output is written to a hidden ".<name>.<random>.part" next to outputPath
+// and renamed when complete; a failed or cancelled job removes only that file.
+class CompressionHandler : public MessageHandler {
+public:
+    explicit CompressionHandler(WebView* webView) : jobs_(std::make_shared<HandlerJobs<CompressJob>>(webView, "compress")) {}
+
+    ~CompressionHandler() override {
+        jobs_->close();
+    }
+
+    bool canHandle(const std::string& messageType) const override {
+        return messageType == "compress" || messageType == "decompress" || messageType == "createZip" ||
+               messageType == "cancelCompress";
+    }
+
+    nlohmann::json handle(const nlohmann::json& payload, const std::string& requestId) override {
+        (void)requestId;
+        nlohmann::json result;
+        std::string op;
+        if (payload.contains("_type") && payload["_type"].is_string()) {
+            op = payload["_type"].get<std::string>();
+        }
+
+        if (op == "cancelCompress") {
+            return jobs_->cancel(payload);
+        }
+
+        auto job = std::make_shared<CompressJob>();
+        if (payload.contains("level")) {
+            if (!payload["level"].is_number_integer() || payload["level"].get<int64_t>() < 0 ||
+                payload["level"].get<int64_t>() > 9) {
+                result["success"] = false;
+                result["error"] = "Invalid 'level' in payload (0-9)";
+                return result;
+            }
+            job->level = payload["level"].get<int>();
+        }
+        if (op == "createZip") {
+            return startZip(payload, job);
+        }
+
+        job->compressing = op == "compress";
+        if (payload.contains("format")) {
+            if (!payload["format"].is_string() ||
+                !compression::parseFormat(payload["format"].get<std::string>(), job->format)) {
+                result["success"] = false;
+                result["error"] = "Invalid 'format' in payload (expect \"gzip\", \"zlib\" or \"deflate\")";
+                return result;
+            }
+        }
+        if (payload.contains("data")) {
+            return transformInline(payload, *job);
+        }
+
+        if (!payload.contains("path") || !payload["path"].is_string()) {
+            result["success"] = false;
+            result["error"] = "Missing 'data' or 'path' in payload";
+            return result;
+        }
+        fs::path base = fs::current_path();
+        job->source = resolveSandboxedPath(payload["path"].get<std::string>(), base);
+        std::error_code ec;
+        if (job->source.empty()) {
+            result["success"] = false;
+            result["error"] = "Invalid or disallowed path";
+            return result;
+        }
+        if (!fs::is_regular_file(fs::u8path(job->source), ec)) {
+            result["success"] = false;
+            result["error"] = "Not a file";
+            return result;
+        }
+        if (!resolveOutput(payload, *job, result)) return result;
+        if (job->resolvedOutput == job->source) {
+            result["success"] = false;
+            result["error"] = "'outputPath' must differ from 'path'";
+            return result;
+        }
+        job->inputSize = fs::file_size(fs::u8path(job->source), ec);
+
+        startJob(job);
+        ThreadPool::getInstance().submit([job]() { runCompressJob(job); });
+        result["success"] = true;
+        result["jobId"] = job->id;
+        result["inputSize"] = job->inputSize;
+        return result;
+    }
+
+    std::vector<std::string> getSupportedTypes() const override {
+        return handler_types::kCompression;
+    }
+
+private:
+    nlohmann::json transformInline(const nlohmann::json& payload, const CompressJob& job) {
+        nlohmann::json result;
+        std::string base64Data = base64Field(payload);
+        if (base64Data.size() > base64::encodedSize(kMaxInlineBytes)) {
+            result["success"] = false;
+            result["error"] = "Inline data too large (use path / outputPath for files)";
+            return result;
+        }
+        std::vector<unsigned char> input = base64::decode(base64Data);
+        if (input.empty() && !base64Data.empty()) {
+            result["success"] = false;
+            result["error"] = "Invalid base64 data";
+            return result;
+        }
+        std::vector<unsigned char> output;
+        std::string error;
+        bool ok = job.compressing
+                      ? compression::compress(input.data(), input.size(), job.format, job.level, output, error)
+                      : compression::decompress(input.data(), input.size(), job.format, kMaxInlineBytes, output,
+                                                error);
+        if (!ok) {
+            result["success"] = false;
+            result["error"] = error;
+            return result;
+        }
+        result["success"] = true;
+        result["data"] = base64::encode(output);
+        result["size"] = output.size();
+        return result;
+    }
+
+    bool resolveOutput(const nlohmann::json& payload, CompressJob& job, nlohmann::json& result) {
+        if (!payload.contains("outputPath") || !payload["outputPath"].is_string()) {
+            result["success"] = false;
+            result["error"] = "Missing or invalid 'outputPath' in payload";
+            return false;
+        }
+        job.outputPath = payload["outputPath"].get<std::string>();
+        job.resolvedOutput = resolveSandboxedPath(job.outputPath, fs::current_path());
+        std::error_code ec;
+        if (job.resolvedOutput.empty()) {
+            result["success"] = false;
+            result["error"] = "Invalid or disallowed output path";
+            return false;
+        }
+        if (fs::is_directory(fs::u8path(job.resolvedOutput), ec)) {
+            result["success"] = false;
+            result["error"] = "'outputPath' is a directory";
+            return false;
+        }
+        return true;
+    }
+
+    nlohmann::json startZip(const nlohmann::json& payload, const std::shared_ptr<CompressJob>& job) {
+        nlohmann::json result;
+        if (!payload.contains("files") || !payload["files"].is_array() || payload["files"].empty() ||
+            payload["files"].size() > kMaxZipInputs) {
+            result["success"] = false;
+            result["error"] = "Missing or invalid 'files' in payload (expect 1-" + std::to_string(kMaxZipInputs) +
+                              " entries)";
+            return result;
+        }
+        if (!resolveOutput(payload, *job, result)) return result;
+
+        fs::path base = fs::current_path();
+        for (const auto& item : payload["files"]) {
+            std::string path;
+            std::string name;
+            if (item.is_string()) {
+                path = item.get<std::string>();
+            } else if (item.is_object() && item.contains("path") && item["path"].is_string()) {
+                path = item["path"].get<std::string>();
+                if (item.contains("name")) {
+                    if (!item["name"].is_string() || normalizeEntryName(item["name"].get<std::string>()).empty()) {
+                        result["success"] = false;
+                        result["error"] = "Invalid entry name in 'files'";
+                        return result;
+                    }
+                    name = normalizeEntryName(item["name"].get<std::string>());
+                }
+            } else {
+                result["success"] = false;
+                result["error"] = "Invalid 'files' in payload (expect paths or { path, name })";
+                return result;
+            }
+
+            ZipInput input;
+            input.resolved = resolveSandboxedPath(path, base);
+            std::error_code ec;
+            if (input.resolved.empty()) {
+                result["success"] = false;
+                result["error"] = "Invalid or disallowed path: " + path;
+                return result;
+            }
+            fs::path resolved = fs::u8path(input.resolved);
+            input.isDirectory = fs::is_directory(resolved, ec);
+            if (!input.isDirectory && !fs::is_regular_file(resolved, ec)) {
+                result["success"] = false;
+                result["error"] = "Not a file or directory: " + path;
+                return result;
+            }
+            if (input.resolved == job->resolvedOutput) {
+                result["success"] = false;
+                result["error"] = "'outputPath' is one of the inputs";
+                return result;
+            }
+            input.name = name.empty() ? normalizeEntryName(resolved.filename().u8string()) : name;
+            if (input.name.empty()) {
+                result["success"] = false;
+                result["error"] = "Cannot derive an entry name for: " + path;
+                return result;
+            }
+            job->inputs.push_back(std::move(input));
+        }
+
+        startJob(job);
+        JobManager::getInstance().post([job]() { runZipJob(job); });
+        result["success"] = true;
+        result["jobId"] = job->id;
+        return result;
+    }
+
+    void startJob(const std::shared_ptr<CompressJob>& job) {
+        job->jobs = jobs_;
+        job->started = std::chrono::steady_clock::now();
+        jobs_->add(job);
+    }
+
+    std::shared_ptr<HandlerJobs<CompressJob>> jobs_;
+};
+
+std::shared_ptr<MessageHandler> createCompressionHandler(WebView* webView) {
+    return std::make_shared<CompressionHandler>(webView);
+}
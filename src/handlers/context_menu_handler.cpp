@@ -1,4 +1,5 @@
 #include "../../include/handlers/context_menu_handler.h"
+#include "../../include/handlers/handler_types.h"
 #include "../../include/webview_window.h"
 #include "../../include/message_router.h"
 #include "../../include/native_event_bus.h"
@@ -85,7 +86,7 @@ public:
     }
 
     std::vector<std::string> getSupportedTypes() const override {
-        return {"showContextMenu"};
+        return handler_types::kContextMenu;
     }
 
 private:
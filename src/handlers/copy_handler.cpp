@@ -0,0 +1,397 @@
+#include "../../include/handlers/copy_handler.h"
+#include "../../include/handlers/handler_types.h"
+#include "../../include/handlers/file_system_handler.h"
+#include "../../include/message_handler.h"
+#include "../../include/file_content_cache.h"
+#include "../../include/file_copy.h"
+#include "../../include/job_manager.h"
+#include "../../include/thread_pool.h"
+#include "../../include/handler_jobs.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+
+namespace fs = std::filesystem;
+
+static const int64_t kProgressIntervalMs = 100;
+
+struct CopyFile {
+    fs::path source;
+    fs::path target;
+};
+
+struct CopyJob {
+    std::string id;
+    bool move = false;
+    bool overwrite = false;
+    std::string from, to;  // as requested
+    fs::path source, target;
+    std::shared_ptr<HandlerJobs<CopyJob>> jobs;
+    std::chrono::steady_clock::time_point started;
+    std::atomic<bool> cancelled{false};
+    int64_t lastProgressMs = 0;
+
+    std::vector<CopyFile> files;
+    uint64_t bytesTotal = 0;
+    std::atomic<uint64_t> bytesDone{0};
+    std::atomic<size_t> filesDone{0};
+    std::atomic<size_t> filesCloned{0};
+
+    // pool tasks still to finish, and the first error any of them hit
+    std::mutex mutex;
+    std::condition_variable finished;
+    size_t pending = 0;
+    std::atomic<bool> failed{false};
+    std::string error;
+
+    int64_t elapsedMs() const {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started).count();
+    }
+
+    // Called from the single thread running the job
+    bool progressDue() {
+        int64_t now = elapsedMs();
+        if (now - lastProgressMs < kProgressIntervalMs) return false;
+        lastProgressMs = now;
+        return true;
+    }
+};
+
+// Move the finished staging copy onto the target, replacing what is there when allowed
+static bool commitStaging(const fs::path& staging, const fs::path& target, bool overwrite, std::string& error) {
+    std::error_code ec;
+    fs::file_status existing = fs::symlink_status(target, ec);
+    if (fs::exists(existing)) {
+        if (!overwrite) {
+            error = "Target already exists";
+            return false;
+        }
+        // rename replaces a file in one step, but neither replaces nor is replaced by a directory:
+        // the old target steps aside first and is only removed once the copy is in its place
+        if (fs::is_directory(existing) || fs::is_directory(fs::symlink_status(staging, ec))) {
+            fs::path old = hiddenSibling(target, ".old");
+            fs::rename(target, old, ec);
+            if (ec) {
+                error = "Failed to replace target: " + ec.message();
+                return false;
+            }
+            fs::rename(staging, target, ec);
+            if (ec) {
+                error = "Failed to move copy into place: " + ec.message();
+                std::error_code restoreEc;
+                fs::rename(old, target, restoreEc);
+                return false;
+            }
+            fs::remove_all(old, ec);
+            return true;
+        }
+    }
+    fs::rename(staging, target, ec);
+    if (ec) {
+        error = "Failed to move copy into place: " + ec.message();
+        return false;
+    }
+    return true;
+}
+
+// Walk the source: directories and symlinks are recreated in staging right away (parents are
+// visited first), regular files are queued for the pool. Other file types are skipped.
+static bool collectTree(CopyJob& job, const fs::path& staging, std::vector<std::pair<fs::path, fs::perms>>& dirs,
+                        std::string& error) {
+    std::error_code ec;
+    if (!fs::create_directory(staging, ec)) {
+        error = "Failed to create directory: " + staging.u8string() + (ec ? " (" + ec.message() + ")" : "");
+        return false;
+    }
+    dirs.emplace_back(staging, fs::status(job.source, ec).permissions());
+    for (fs::recursive_directory_iterator it(job.source, ec), end; it != end; it.increment(ec)) {
+        if (job.cancelled) return false;
+        fs::path target = staging / it->path().lexically_relative(job.source);
+        std::error_code typeEc;
+        if (it->is_symlink(typeEc)) {
+            fs::copy_symlink(it->path(), target, ec);
+        } else if (it->is_directory(typeEc)) {
+            fs::create_directory(target, ec);
+            if (!ec) dirs.emplace_back(target, it->status(typeEc).permissions());
+        } else if (it->is_regular_file(typeEc)) {
+            int64_t size = 0;
+            int64_t mtimeMs = 0;
+            if (!readEntryStat(*it, size, mtimeMs)) continue;  // vanished meanwhile
+            job.files.push_back({it->path(), target});
+            job.bytesTotal += static_cast<uint64_t>(size);
+        }
+        if (ec) {
+            error = "Failed to copy " + it->path().u8string() + ": " + ec.message();
+            return false;
+        }
+    }
+    if (ec) {
+        error = "Failed to read directory: " + ec.message();
+        return false;
+    }
+    return true;
+}
+
+// Pool task: one file of the job
+static void copyOne(const std::shared_ptr<CopyJob>& job, size_t index) {
+    std::string error;
+    if (!job->cancelled && !job->failed) {
+        const CopyFile& file = job->files[index];
+        file_copy::Method method = file_copy::Method::ReadWrite;
+        CopyJob& j = *job;
+        bool ok = file_copy::copyFile(file.source.u8string(), file.target.u8string(), method, error,
+                                      [&j](uint64_t bytes) { j.bytesDone += bytes; }, &job->cancelled);
+        if (ok) {
+            ++job->filesDone;
+            if (method == file_copy::Method::Clone) ++job->filesCloned;
+        }
+    }
+    std::lock_guard<std::mutex> lock(job->mutex);
+    if (!error.empty() && !job->failed.exchange(true)) {
+        job->error = error;
+    }
+    --job->pending;
+    job->finished.notify_all();
+}
+
+static void emitProgress(CopyJob& job) {
+    nlohmann::json event;
+    event["jobId"] = job.id;
+    event["filesDone"] = job.filesDone.load();
+    event["filesTotal"] = job.files.size();
+    event["bytesDone"] = job.bytesDone.load();
+    event["bytesTotal"] = job.bytesTotal;
+    job.jobs->emit("copy:progress", std::move(event));
+}
+
+// Copy job.source into staging: a single file directly, a tree with its files spread over
+// the pool while this thread reports progress
+static bool copyToStaging(const std::shared_ptr<CopyJob>& job, const fs::path& staging, std::string& error) {
+    std::error_code ec;
+    std::vector<std::pair<fs::path, fs::perms>> dirs;
+    if (fs::is_directory(job->source, ec)) {
+        if (!collectTree(*job, staging, dirs, error)) {
+            if (job->cancelled) error = "Cancelled";
+            return false;
+        }
+    } else {
+        job->files.push_back({job->source, staging});
+        job->bytesTotal = fs::file_size(job->source, ec);
+    }
+
+    ThreadPool& pool = ThreadPool::getInstance();
+    {
+        std::lock_guard<std::mutex> lock(job->mutex);
+        job->pending = job->files.size();
+    }
+    for (size_t i = 0; i < job->files.size(); ++i) {
+        pool.submit([job, i]() { copyOne(job, i); });
+    }
+    {
+        std::unique_lock<std::mutex> lock(job->mutex);
+        while (job->pending > 0) {
+            job->finished.wait_for(lock, std::chrono::milliseconds(kProgressIntervalMs));
+            if (job->pending > 0 && job->progressDue()) {
+                lock.unlock();
+                emitProgress(*job);
+                lock.lock();
+            }
+        }
+        error = job->error;
+    }
+    if (job->cancelled) {
+        error = "Cancelled";
+        return false;
+    }
+    if (!error.empty()) return false;
+
+    // Directory permissions last (deepest first): a read-only directory would have refused its files
+    for (auto it = dirs.rbegin(); it != dirs.rend(); ++it) {
+        fs::permissions(it->first, it->second, ec);
+    }
+    return true;
+}
+
+static void runCopyJob(const std::shared_ptr<CopyJob>& job) {
+    fs::path staging = hiddenSibling(job->target, ".part");
+    std::string error;
+    bool renamed = false;
+    bool ok = true;
+
+    if (job->move) {
+        // Same filesystem: a rename, whatever the size of the tree
+        std::error_code ec;
+        fs::rename(job->source, staging, ec);
+        if (!ec) {
+            renamed = true;
+        } else if (ec != std::errc::cross_device_link) {
+            error = "Failed to move: " + ec.message();
+            ok = false;
+        }
+    }
+    if (ok && !renamed) {
+        ok = copyToStaging(job, staging, error);
+    }
+    if (ok) {
+        ok = commitStaging(staging, job->target, job->overwrite, error);
+    }
+    std::error_code ec;
+    if (!ok) {
+        if (renamed) {
+            fs::rename(staging, job->source, ec);  // put the source back
+        } else {
+            fs::remove_all(staging, ec);
+        }
+    } else if (job->move && !renamed) {
+        fs::remove_all(job->source, ec);
+        if (ec) error = "Copied, but failed to remove the source: " + ec.message();
+    }
+    FileContentCache::getInstance().invalidate(job->target.u8string());
+    if (job->move) FileContentCache::getInstance().invalidate(job->source.u8string());
+
+    nlohmann::json done;
+    done["jobId"] = job->id;
+    done["operation"] = job->move ? "move" : "copy";
+    done["from"] = job->from;
+    done["to"] = job->to;
+    done["renamed"] = renamed;
+    done["filesCopied"] = job->filesDone.load();
+    done["filesCloned"] = job->filesCloned.load();
+    done["bytesCopied"] = job->bytesDone.load();
+    done["cancelled"] = job->cancelled.load();
+    done["elapsedMs"] = job->elapsedMs();
+    if (!error.empty()) {
+        done["error"] = error;
+    }
+    job->jobs->finish(*job, "copy:done", std::move(done));
+}
+
+// Handler for native copies.
+//   copy / move: from, to, overwrite (default false) -> { jobId }
+//   cancelCopy: jobId
+// Trees are copied with their directories, files and symlinks (other file types are skipped);
+// files keep their permission bits. The copy is built in a hidden sibling of "to" and renamed
+// into place when complete, so "to" is never seen half-written; a cancelled or failed job
+// leaves nothing behind. A move within one filesystem is a rename; across filesystems it is a
+// copy, and the source is removed only once the copy is in place.
+// Jobs emit "copy:progress" { jobId, filesDone, filesTotal, bytesDone, bytesTotal } at most
+// every 100 ms, and "copy:done" { jobId, operation, from, to, renamed, filesCopied,
+// filesCloned, bytesCopied, cancelled, error?, elapsedMs }.
+class CopyHandler : public MessageHandler {
+public:
+    explicit CopyHandler(WebView* webView) : jobs_(std::make_shared<HandlerJobs<CopyJob>>(webView, "copy")) {}
+
+    ~CopyHandler() override {
+        jobs_->close();
+    }
+
+    bool canHandle(const std::string& messageType) const override {
+        return messageType == "copy" || messageType == "move" || messageType == "cancelCopy";
+    }
+
+    nlohmann::json handle(const nlohmann::json& payload, const std::string& requestId) override {
+        (void)requestId;
+        nlohmann::json result;
+        std::string op;
+        if (payload.contains("_type") && payload["_type"].is_string()) {
+            op = payload["_type"].get<std::string>();
+        }
+
+        if (op == "cancelCopy") {
+            return jobs_->cancel(payload);
+        }
+
+        if (!payload.contains("from") || !payload["from"].is_string() || !payload.contains("to") ||
+            !payload["to"].is_string()) {
+            result["success"] = false;
+            result["error"] = "Missing or invalid 'from' / 'to' in payload";
+            return result;
+        }
+        if (payload.contains("overwrite") && !payload["overwrite"].is_boolean()) {
+            result["success"] = false;
+            result["error"] = "Invalid 'overwrite' in payload (expect a boolean)";
+            return result;
+        }
+        auto job = std::make_shared<CopyJob>();
+        job->move = op == "move";
+        job->overwrite = payload.value("overwrite", false);
+        job->from = payload["from"].get<std::string>();
+        job->to = payload["to"].get<std::string>();
+
+        fs::path base = fs::absolute(fs::current_path()).lexically_normal();
+        std::string from = resolveSandboxedPath(job->from, base);
+        std::string to = resolveSandboxedPath(job->to, base);
+        if (from.empty() || to.empty()) {
+            result["success"] = false;
+            result["error"] = "Invalid or disallowed path";
+            return result;
+        }
+        job->source = fs::u8path(from);
+        job->target = fs::u8path(to);
+        // resolveSandboxedPath keeps a trailing separator ("dir/"); compare and rename without it
+        if (!job->source.has_filename()) job->source = job->source.parent_path();
+        if (!job->target.has_filename()) job->target = job->target.parent_path();
+
+        std::error_code ec;
+        fs::file_status sourceStatus = fs::status(job->source, ec);
+        if (!fs::exists(sourceStatus)) {
+            result["success"] = false;
+            result["error"] = "Source does not exist";
+            return result;
+        }
+        if (!fs::is_directory(sourceStatus) && !fs::is_regular_file(sourceStatus)) {
+            result["success"] = false;
+            result["error"] = "Source is not a file or directory";
+            return result;
+        }
+        if (isWithin(base, job->source)) {
+            result["success"] = false;
+            result["error"] = "Cannot copy or move the working directory or one of its parents";
+            return result;
+        }
+        if (isWithin(job->target, job->source)) {
+            result["success"] = false;
+            result["error"] = "'to' is inside 'from'";
+            return result;
+        }
+        if (isWithin(job->source, job->target)) {
+            result["success"] = false;
+            result["error"] = "'from' is inside 'to'";
+            return result;
+        }
+        if (fs::exists(fs::symlink_status(job->target, ec)) && !job->overwrite) {
+            result["success"] = false;
+            result["error"] = "Target already exists (set 'overwrite' to replace it)";
+            return result;
+        }
+        if (!fs::is_directory(job->target.parent_path(), ec)) {
+            result["success"] = false;
+            result["error"] = "Target directory does not exist";
+            return result;
+        }
+
+        job->jobs = jobs_;
+        job->started = std::chrono::steady_clock::now();
+        jobs_->add(job);
+        // A posted thread rather than a pool task: it blocks on the pool's copies
+        JobManager::getInstance().post([job]() { runCopyJob(job); });
+        result["success"] = true;
+        result["jobId"] = job->id;
+        return result;
+    }
+
+    std::vector<std::string> getSupportedTypes() const override {
+        return handler_types::kCopy;
+    }
+
+private:
+    std::shared_ptr<HandlerJobs<CopyJob>> jobs_;
+};
+
+std::shared_ptr<MessageHandler> createCopyHandler(WebView* webView) {
+    return std::make_shared<CopyHandler>(webView);
+}
@@ -1,4 +1,5 @@
 #include "../../include/handlers/create_window_handler.h"
+#include "../../include/handlers/handler_types.h"
 #include "../../include/message_handler.h"
 #include "../../include/window.h"
 #include "settings_embed.h"
@@ -166,7 +167,7 @@ public:
     }
     
     std::vector<std::string> getSupportedTypes() const override {
-        return {"createWindow"};
+        return handler_types::kCreateWindow;
     }
     
 private:
@@ -0,0 +1,387 @@
+#include "../../include/handlers/download_handler.h"
+#include "../../include/handlers/handler_types.h"
+#include "../../include/handlers/file_system_handler.h"
+#include "../../include/message_handler.h"
+#include "../../include/file_content_cache.h"
+#include "../../include/http_client.h"
+#include "../../include/job_manager.h"
+#include "../../include/handler_jobs.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+static const int64_t kProgressIntervalMs = 100;
+// Staging files, hidden next to the target: the body so far, and a meta file with the URL and
+// validator (ETag or Last-Modified) it was fetched with. The meta file's first line marks both
+// as ours; files by those names without it are never touched.
+static const char* const kPartSuffix = ".download";
+static const char* const kMetaSuffix = ".download.meta";
+static const char* const kMetaMark = "crossdev-download 1";
+
+struct DownloadJob {
+    std::string id;
+    std::string url;
+    std::string path;  // as requested
+    fs::path target;
+    bool resume = true;
+    std::vector<std::pair<std::string, std::string>> headers;
+    std::shared_ptr<HandlerJobs<DownloadJob>> jobs;
+    std::chrono::steady_clock::time_point started;
+    std::atomic<bool> cancelled{false};
+    int64_t lastProgressMs = 0;
+
+    // Written by the job's thread only
+    int status = 0;
+    uint64_t received = 0;  // bytes in the part file, resumed ones included
+    int64_t total = -1;     // -1 while unknown
+    uint64_t resumedFrom = 0;
+
+    fs::path part() const { return target.parent_path() / ("." + target.filename().u8string() + kPartSuffix); }
+    fs::path meta() const { return target.parent_path() / ("." + target.filename().u8string() + kMetaSuffix); }
+
+    int64_t elapsedMs() const {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started).count();
+    }
+
+    bool progressDue() {
+        int64_t now = elapsedMs();
+        if (now - lastProgressMs < kProgressIntervalMs) return false;
+        lastProgressMs = now;
+        return true;
+    }
+};
+
+static void emitProgress(DownloadJob& job) {
+    nlohmann::json event;
+    event["jobId"] = job.id;
+    event["received"] = job.received;
+    event["total"] = job.total >= 0 ? nlohmann::json(job.total) : nlohmann::json(nullptr);
+    job.jobs->emit("download:progress", std::move(event));
+}
+
+// A strong ETag, else Last-Modified: what If-Range can compare the resource against
+static std::string validatorOf(const http::Response& response) {
+    std::string etag = response.header("etag");
+    if (!etag.empty() && etag.compare(0, 2, "W/") != 0) return etag;
+    return response.header("last-modified");
+}
+
+// The URL and validator of the staging files, false unless an earlier download wrote them
+static bool readMeta(const DownloadJob& job, std::string& url, std::string& validator) {
+    std::ifstream in(job.meta());
+    std::string mark;
+    return std::getline(in, mark) && mark == kMetaMark && std::getline(in, url) && std::getline(in, validator);
+}
+
+// Offset to resume at: the size of a part file fetched from the same URL with a usable validator
+static uint64_t resumeOffset(const DownloadJob& job, std::string& validator) {
+    std::string url;
+    if (!readMeta(job, url, validator) || url != job.url || validator.empty()) {
+        return 0;
+    }
+    std::error_code ec;
+    uint64_t size = fs::file_size(job.part(), ec);
+    return ec ? 0 : size;
+}
+
+// Removes staging files left by an earlier download (of any URL) to start afresh; false if
+// files by those names are someone else's
+static bool clearStaging(const DownloadJob& job, std::string& error) {
+    std::error_code ec;
+    std::string url, validator;
+    bool ours = readMeta(job, url, validator);
+    for (const fs::path& path : {job.part(), job.meta()}) {
+        if (!ours && fs::exists(fs::symlink_status(path, ec))) {
+            error = "A file not written by a download is in the way: " + path.u8string();
+            return false;
+        }
+    }
+    fs::remove(job.part(), ec);
+    fs::remove(job.meta(), ec);
+    return true;
+}
+
+// "bytes <first>-<last>/<total or *>"; false unless it starts where the part file ends
+static bool parseContentRange(const std::string& value, uint64_t offset, int64_t& total) {
+    unsigned long long first = 0, last = 0;
+    char complete[24] = {0};
+    if (std::sscanf(value.c_str(), "bytes %llu-%llu/%23s", &first, &last, complete) != 3 || first != offset) {
+        return false;
+    }
+    total = std::isdigit(static_cast<unsigned char>(complete[0])) ? std::stoll(complete) : -1;
+    return true;
+}
+
+// Fetch job.url into the part file, resuming it when the server allows
+static bool fetchToPart(DownloadJob& job, std::string& error) {
+    std::string validator;
+    uint64_t offset = job.resume ? resumeOffset(job, validator) : 0;
+    if (offset == 0 && !clearStaging(job, error)) {
+        return false;
+    }
+
+    // Two rounds at most: a 416 (the part file no longer fits the resource) restarts from zero
+    for (int round = 0; round < 2; ++round) {
+        http::Request request;
+        request.url = job.url;
+        request.headers = job.headers;
+        request.cancelled = &job.cancelled;
+        if (offset > 0) {
+            request.headers.push_back({"Range", "bytes=" + std::to_string(offset) + "-"});
+            request.headers.push_back({"If-Range", validator});
+        }
+
+        std::ofstream out;
+        std::string failure;
+        bool rangeRejected = false;
+        auto onResponse = [&](const http::Response& response) {
+            job.status = response.status;
+            if (response.status == 416 && offset > 0) {
+                rangeRejected = true;
+                return false;
+            }
+            if (response.status == 206 && offset > 0) {
+                if (!parseContentRange(response.header("content-range"), offset, job.total)) {
+                    failure = "Server resumed at an unexpected offset";
+                    return false;
+                }
+                job.resumedFrom = offset;
+                out.open(job.part(), std::ios::binary | std::ios::app);
+            } else if (response.status >= 200 && response.status < 300 && response.status != 206) {
+                // The whole resource: a fresh download, or the file changed since the part file
+                offset = 0;
+                job.resumedFrom = 0;
+                job.total = response.contentLength;
+                std::ofstream meta(job.meta(), std::ios::trunc);
+                meta << kMetaMark << '\n' << job.url << '\n' << validatorOf(response) << '\n';
+                out.open(job.part(), std::ios::binary | std::ios::trunc);
+            } else {
+                failure = "HTTP " + std::to_string(response.status);
+                return false;
+            }
+            if (!out.is_open()) {
+                failure = "Failed to open file for writing";
+                return false;
+            }
+            job.received = offset;
+            return true;
+        };
+        auto onData = [&](const char* data, size_t size) {
+            if (!out.write(data, static_cast<std::streamsize>(size))) {
+                failure = "Failed to write file";
+                return false;
+            }
+            job.received += size;
+            if (job.progressDue()) emitProgress(job);
+            return true;
+        };
+
+        std::string networkError;
+        bool ok = http::Client::getInstance().get(request, onResponse, onData, networkError);
+        if (out.is_open()) {
+            out.close();
+            if (out.fail() && failure.empty()) failure = "Failed to write file";
+        }
+        if (rangeRejected && round == 0) {
+            offset = 0;
+            if (!clearStaging(job, error)) return false;
+            continue;
+        }
+        if (!ok || !failure.empty()) {
+            error = job.cancelled ? "Cancelled" : !failure.empty() ? failure : networkError;
+            return false;
+        }
+        break;
+    }
+
+    if (job.total >= 0 && job.received != static_cast<uint64_t>(job.total)) {
+        error = "Download incomplete: " + std::to_string(job.received) + " of " + std::to_string(job.total) + " bytes";
+        return false;
+    }
+    return true;
+}
+
+static void runDownloadJob(const std::shared_ptr<DownloadJob>& job) {
+    std::string error;
+    bool ok = fetchToPart(*job, error);
+    if (ok) {
+        std::error_code ec;
+        fs::rename(job->part(), job->target, ec);
+        if (ec) {
+            error = "Failed to move the download into place: " + ec.message();
+            ok = false;
+        } else {
+            fs::remove(job->meta(), ec);
+        }
+        FileContentCache::getInstance().invalidate(job->target.u8string());
+    }
+
+    nlohmann::json done;
+    done["jobId"] = job->id;
+    done["url"] = job->url;
+    done["path"] = job->path;
+    done["status"] = job->status;
+    done["size"] = job->received;
+    done["resumedFrom"] = job->resumedFrom;
+    done["cancelled"] = job->cancelled.load();
+    done["elapsedMs"] = job->elapsedMs();
+    if (!ok) {
+        done["error"] = error;
+    }
+    job->jobs->finish(*job, "download:done", std::move(done));
+}
+
+// Request headers the client manages itself
+static bool reservedHeader(std::string name) {
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return name == "host" || name == "range" || name == "if-range" || name == "accept-encoding" ||
+           name == "connection" || name == "transfer-encoding" || name == "content-length";
+}
+
+static bool validHeaderText(const std::string& text) {
+    return std::none_of(text.begin(), text.end(), [](unsigned char c) { return c == '\r' || c == '\n' || c == 0; });
+}
+
+// Handler for native downloads.
+//   download: url (http or https), path, resume (default true), overwrite (default false),
+//             headers (object of extra request headers) -> { jobId }
+//   cancelDownload: jobId
+// The body is streamed to a hidden ".<name>.download" next to path and renamed to path once
+// complete, so path never holds a partial file. A cancelled or failed download keeps that file
+// and its ".<name>.download.meta": the next download of the same URL to the same path
+// continues from there with a Range request (If-Range guards against a resource that changed;
+// the server may also answer with the whole file).
+// Jobs emit "download:progress" { jobId, received, total } at most every 100 ms (total is
+// null when the server does not send a length), and "download:done" { jobId, url, path,
+// status, size, resumedFrom, cancelled, error?, elapsedMs }. Downloads run on JobManager's
+// posted threads, so a stalled server holds up no job or pool task; past the posted thread
+// limit new downloads wait for a thread.
+class DownloadHandler : public MessageHandler {
+public:
+    explicit DownloadHandler(WebView* webView) : jobs_(std::make_shared<HandlerJobs<DownloadJob>>(webView, "download")) {}
+
+    ~DownloadHandler() override {
+        jobs_->close();
+    }
+
+    bool canHandle(const std::string& messageType) const override {
+        return messageType == "download" || messageType == "cancelDownload";
+    }
+
+    nlohmann::json handle(const nlohmann::json& payload, const std::string& requestId) override {
+        (void)requestId;
+        nlohmann::json result;
+        std::string op;
+        if (payload.contains("_type") && payload["_type"].is_string()) {
+            op = payload["_type"].get<std::string>();
+        }
+
+        if (op == "cancelDownload") {
+            return jobs_->cancel(payload);
+        }
+
+        if (!payload.contains("url") || !payload["url"].is_string() || !payload.contains("path") ||
+            !payload["path"].is_string()) {
+            result["success"] = false;
+            result["error"] = "Missing or invalid 'url' / 'path' in payload";
+            return result;
+        }
+        for (const char* flag : {"resume", "overwrite"}) {
+            if (payload.contains(flag) && !payload[flag].is_boolean()) {
+                result["success"] = false;
+                result["error"] = std::string("Invalid '") + flag + "' in payload (expect a boolean)";
+                return result;
+            }
+        }
+        auto job = std::make_shared<DownloadJob>();
+        job->url = payload["url"].get<std::string>();
+        job->path = payload["path"].get<std::string>();
+        job->resume = payload.value("resume", true);
+        bool overwrite = payload.value("overwrite", false);
+
+        if (payload.contains("headers")) {
+            const nlohmann::json& headers = payload["headers"];
+            bool valid = headers.is_object();
+            for (auto it = headers.begin(); valid && it != headers.end(); ++it) {
+                valid = it.value().is_string() && !it.key().empty() && validHeaderText(it.key()) &&
+                        it.key().find(':') == std::string::npos && validHeaderText(it.value().get<std::string>()) &&
+                        !reservedHeader(it.key());
+                if (valid) job->headers.push_back({it.key(), it.value().get<std::string>()});
+            }
+            if (!valid) {
+                result["success"] = false;
+                result["error"] = "Invalid 'headers' in payload (expect an object of strings; Host, Range and "
+                                  "connection headers are set natively)";
+                return result;
+            }
+        }
+
+        http::Url url;
+        std::string error;
+        if (!http::Url::parse(job->url, url, error)) {
+            result["success"] = false;
+            result["error"] = error;
+            return result;
+        }
+        if (url.scheme == "https" && !http::Client::httpsSupported()) {
+            result["success"] = false;
+            result["error"] = "HTTPS is not available in this build (it needs OpenSSL)";
+            return result;
+        }
+
+        std::string resolved = resolveSandboxedPath(job->path, fs::current_path());
+        if (resolved.empty()) {
+            result["success"] = false;
+            result["error"] = "Invalid or disallowed path";
+            return result;
+        }
+        job->target = fs::u8path(resolved);
+        std::error_code ec;
+        if (!job->target.has_filename() || fs::is_directory(job->target, ec)) {
+            result["success"] = false;
+            result["error"] = "Target is a directory";
+            return result;
+        }
+        if (fs::exists(fs::symlink_status(job->target, ec)) && !overwrite) {
+            result["success"] = false;
+            result["error"] = "Target already exists (set 'overwrite' to replace it)";
+            return result;
+        }
+        if (!fs::is_directory(job->target.parent_path(), ec)) {
+            result["success"] = false;
+            result["error"] = "Target directory does not exist";
+            return result;
+        }
+
+        job->jobs = jobs_;
+        job->started = std::chrono::steady_clock::now();
+        if (!jobs_->add(job, [&job](const DownloadJob& running) { return running.target == job->target; })) {
+            result["success"] = false;
+            result["error"] = "A download to this path is already running";
+            return result;
+        }
+        // A posted thread rather than a pool task: it spends its time waiting on the network
+        JobManager::getInstance().post([job]() { runDownloadJob(job); });
+        result["success"] = true;
+        result["jobId"] = job->id;
+        return result;
+    }
+
+    std::vector<std::string> getSupportedTypes() const override {
+        return handler_types::kDownload;
+    }
+
+private:
+    std::shared_ptr<HandlerJobs<DownloadJob>> jobs_;
+};
+
+std::shared_ptr<MessageHandler> createDownloadHandler(WebView* webView) {
+    return std::make_shared<DownloadHandler>(webView);
+}
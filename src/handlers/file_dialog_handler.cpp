@@ -1,4 +1,5 @@
 #include "../../include/message_handler.h"
+#include "../../include/handlers/handler_types.h"
 #include "../../include/window.h"
 #include "../platform/platform_impl.h"
 #include <nlohmann/json.hpp>
@@ -68,7 +69,7 @@ public:
     }
     
     std::vector<std::string> getSupportedTypes() const override {
-        return {"openFileDialog"};
+        return handler_types::kFileDialog;
     }
     
 private:
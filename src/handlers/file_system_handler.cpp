@@ -1,13 +1,38 @@
 #include "../../include/message_handler.h"
 #include "../../include/handlers/file_system_handler.h"
+#include "../../include/handlers/handler_types.h"
+#include "../../include/file_content_cache.h"
+#include "../../include/deferred_delete.h"
+#include "../../include/webview_event_sink.h"
 #include <nlohmann/json.hpp>
 #include <filesystem>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <random>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
 
 namespace fs = std::filesystem;
 
+// Names the DeferredDeleter's trash, in any case (case-insensitive file systems reach it so)
+static bool namesTrash(const fs::path& name) {
+    std::string s = name.u8string();
+    const std::string trash = DeferredDeleter::kTrashDirName;
+    return s.size() == trash.size() && std::equal(s.begin(), s.end(), trash.begin(), [](char a, char b) {
+        return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+    });
+}
+
 // Resolve path and ensure it doesn't escape the base (cwd).
 // Returns empty string on security violation.
-static std::string resolvePath(const std::string& path, const fs::path& base) {
+std::string resolveSandboxedPath(const std::string& path, const fs::path& base) {
     try {
         fs::path baseAbs = fs::absolute(base);
         fs::path p = path.empty() ? baseAbs : (baseAbs / path);
@@ -17,15 +42,173 @@ static std::string resolvePath(const std::string& path, const fs::path& base) {
         if (baseIt != baseAbs.end()) {
             return "";  // Path escaped base
         }
+        if (pathIt != normalized.end() && namesTrash(*pathIt)) {
+            return "";  // The DeferredDeleter's trash
+        }
         return normalized.string();
     } catch (...) {
         return "";
     }
 }
 
+bool isSandboxTrash(const fs::path& path, const fs::path& base) {
+    if (!namesTrash(path.filename())) return false;
+    std::error_code ec;
+    fs::path baseAbs = fs::absolute(base, ec);
+    fs::path parent = fs::absolute(path, ec).parent_path();
+    auto mismatch = std::mismatch(baseAbs.begin(), baseAbs.end(), parent.begin(), parent.end());
+    return mismatch.first == baseAbs.end() && mismatch.second == parent.end();
+}
+
+bool isWithin(const fs::path& path, const fs::path& base) {
+    auto mismatch = std::mismatch(base.begin(), base.end(), path.begin(), path.end());
+    return mismatch.first == base.end();
+}
+
+std::string randomNameId() {
+    static std::mt19937_64 rng(std::random_device{}());
+    static std::mutex rngMutex;
+    uint64_t value;
+    {
+        std::lock_guard<std::mutex> lock(rngMutex);
+        value = rng();
+    }
+    char id[17];
+    std::snprintf(id, sizeof(id), "%016llx", static_cast<unsigned long long>(value));
+    return id;
+}
+
+fs::path hiddenSibling(const fs::path& target, const std::string& suffix) {
+    std::error_code ec;
+    std::string prefix = "." + target.filename().u8string() + ".";
+    while (true) {
+        fs::path sibling = target.parent_path() / fs::u8path(prefix + randomNameId() + suffix);
+        if (!fs::exists(fs::symlink_status(sibling, ec))) return sibling;
+    }
+}
+
+// listDir entry fields. name/isDirectory/isFile/isSymlink come from the directory entry's cached
+// type (d_type on Linux, FindNextFile data on Windows); size/mtime cost a stat per entry on POSIX
+// and are only read when requested or sorted on.
+enum ListField : unsigned {
+    kFieldName = 1u << 0,
+    kFieldIsDirectory = 1u << 1,
+    kFieldIsFile = 1u << 2,
+    kFieldIsSymlink = 1u << 3,
+    kFieldSize = 1u << 4,
+    kFieldMtime = 1u << 5
+};
+static const unsigned kDefaultListFields = kFieldName | kFieldIsDirectory | kFieldIsFile | kFieldSize;
+
+struct ListEntry {
+    std::string name;
+    bool isDirectory = false;
+    bool isFile = false;
+    bool isSymlink = false;
+    int64_t size = -1;   // regular files only
+    int64_t mtime = -1;  // ms since the Unix epoch
+};
+
+static unsigned parseListField(const std::string& name) {
+    if (name == "name") return kFieldName;
+    if (name == "isDirectory") return kFieldIsDirectory;
+    if (name == "isFile") return kFieldIsFile;
+    if (name == "isSymlink") return kFieldIsSymlink;
+    if (name == "size") return kFieldSize;
+    if (name == "mtime") return kFieldMtime;
+    return 0;
+}
+
+bool readEntryStat(const fs::directory_entry& entry, int64_t& size, int64_t& mtimeMs) {
+#ifdef _WIN32
+    // Cached by the directory iterator
+    std::error_code ec;
+    std::uintmax_t bytes = entry.is_regular_file(ec) ? entry.file_size(ec) : 0;
+    if (ec) return false;
+    auto time = entry.last_write_time(ec);
+    if (ec) return false;
+    size = static_cast<int64_t>(bytes);
+    // file_clock counts 100 ns ticks since 1601-01-01
+    mtimeMs = (static_cast<int64_t>(time.time_since_epoch().count()) - 116444736000000000LL) / 10000;
+    return true;
+#else
+    // One stat for both (std::filesystem would issue one per attribute)
+    struct stat st;
+    if (::stat(entry.path().c_str(), &st) != 0) {
+        return false;
+    }
+    size = S_ISREG(st.st_mode) ? static_cast<int64_t>(st.st_size) : 0;
+#ifdef __APPLE__
+    mtimeMs = static_cast<int64_t>(st.st_mtimespec.tv_sec) * 1000 + st.st_mtimespec.tv_nsec / 1000000;
+#else
+    mtimeMs = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000 + st.st_mtim.tv_nsec / 1000000;
+#endif
+    return true;
+#endif
+}
+
+static ListEntry readListEntry(const fs::directory_entry& entry, bool needSize, bool needMtime) {
+    ListEntry e;
+    std::error_code ec;
+    e.name = entry.path().filename().string();
+    e.isSymlink = entry.is_symlink(ec);
+    e.isDirectory = entry.is_directory(ec);
+    e.isFile = entry.is_regular_file(ec);
+    if (!needSize && !needMtime) {
+        return e;
+    }
+    int64_t size = 0, mtime = -1;
+    if (readEntryStat(entry, size, mtime)) {
+        if (needMtime) e.mtime = mtime;
+    }
+    if (needSize && e.isFile) e.size = size;
+    return e;
+}
+
+static nlohmann::json listEntryToJson(const ListEntry& e, unsigned fields) {
+    nlohmann::json j = nlohmann::json::object();
+    if (fields & kFieldName) j["name"] = e.name;
+    if (fields & kFieldIsDirectory) j["isDirectory"] = e.isDirectory;
+    if (fields & kFieldIsFile) j["isFile"] = e.isFile;
+    if (fields & kFieldIsSymlink) j["isSymlink"] = e.isSymlink;
+    if ((fields & kFieldSize) && e.isFile) j["size"] = e.size;
+    if ((fields & kFieldMtime) && e.mtime >= 0) j["mtime"] = e.mtime;
+    return j;
+}
+
+// Remaining pages of a listDir call. Sorted listings are read once and kept; unsorted ones keep
+// the directory iterator open so later pages continue where the previous one stopped.
+struct ListCursor {
+    std::string path;
+    unsigned fields = kDefaultListFields;
+    std::vector<ListEntry> entries;  // sorted mode
+    size_t position = 0;
+    bool streaming = false;
+    fs::directory_iterator iterator;  // streaming mode
+    fs::path base;                    // listings of base leave its trash out
+    std::chrono::steady_clock::time_point lastUsed;
+};
+static const size_t kMaxListCursors = 16;
+static const std::chrono::minutes kListCursorIdle(5);
+
 // Handler for filesystem operations: exists, listDir, mkdir, deleteFile, rename, stat
+// deleteFile with deferred: true moves the target into the trash (see DeferredDeleter) and
+// replies at once with { deferred, jobId }; "delete:done" { jobId, path, removedCount, error?,
+// elapsedMs } follows when the tree is gone.
 class FileSystemHandler : public MessageHandler {
 public:
+    explicit FileSystemHandler(WebView* webView) {
+        if (webView) {
+            events_ = std::make_shared<WebViewEventSink>(webView);
+        }
+    }
+
+    ~FileSystemHandler() override {
+        if (events_) {
+            events_->detach();
+        }
+    }
+
     bool canHandle(const std::string& messageType) const override {
         return messageType == "exists" || messageType == "listDir" ||
                messageType == "mkdir" || messageType == "deleteFile" ||
@@ -64,7 +247,7 @@ public:
         }
 
         fs::path base = fs::current_path();
-        std::string resolved = resolvePath(path, base);
+        std::string resolved = resolveSandboxedPath(path, base);
         if (resolved.empty()) {
             result["success"] = false;
             result["error"] = "Invalid or disallowed path";
@@ -108,34 +291,7 @@ public:
 
         if (op == "listDir") {
             try {
-                if (!fs::exists(p)) {
-                    result["success"] = false;
-                    result["error"] = "Path does not exist";
-                    return result;
-                }
-                if (!fs::is_directory(p)) {
-                    result["success"] = false;
-                    result["error"] = "Path is not a directory";
-                    return result;
-                }
-                nlohmann::json entries = nlohmann::json::array();
-                for (const auto& entry : fs::directory_iterator(p)) {
-                    nlohmann::json e;
-                    e["name"] = entry.path().filename().string();
-                    e["isDirectory"] = entry.is_directory();
-                    e["isFile"] = entry.is_regular_file();
-                    if (entry.is_regular_file()) {
-                        try {
-                            e["size"] = static_cast<int64_t>(fs::file_size(entry.path()));
-                        } catch (...) {
-                            e["size"] = 0;
-                        }
-                    }
-                    entries.push_back(e);
-                }
-                result["success"] = true;
-                result["entries"] = entries;
-                return result;
+                return listDir(p, payload);
             } catch (const fs::filesystem_error& e) {
                 result["success"] = false;
                 result["error"] = std::string(e.what());
@@ -157,6 +313,14 @@ public:
         }
 
         if (op == "deleteFile") {
+            if (payload.contains("deferred") && !payload["deferred"].is_boolean()) {
+                result["success"] = false;
+                result["error"] = "Invalid 'deferred' in payload (expect a boolean)";
+                return result;
+            }
+            if (payload.value("deferred", false)) {
+                return deleteDeferred(p, path, base);
+            }
             try {
                 if (!fs::exists(p)) {
                     result["success"] = false;
@@ -164,6 +328,7 @@ public:
                     return result;
                 }
                 std::uintmax_t n = fs::remove_all(p);
+                FileContentCache::getInstance().invalidate(p.u8string());
                 result["success"] = true;
                 result["removedCount"] = static_cast<int64_t>(n);
                 return result;
@@ -186,7 +351,7 @@ public:
                 result["error"] = "'to' path cannot be empty";
                 return result;
             }
-            std::string toResolved = resolvePath(toPath, base);
+            std::string toResolved = resolveSandboxedPath(toPath, base);
             if (toResolved.empty()) {
                 result["success"] = false;
                 result["error"] = "Invalid or disallowed 'to' path";
@@ -194,6 +359,8 @@ public:
             }
             try {
                 fs::rename(p, fs::path(toResolved));
+                FileContentCache::getInstance().invalidate(p.u8string());
+                FileContentCache::getInstance().invalidate(toResolved);
                 result["success"] = true;
                 return result;
             } catch (const fs::filesystem_error& e) {
@@ -209,10 +376,247 @@ public:
     }
 
     std::vector<std::string> getSupportedTypes() const override {
-        return {"exists", "listDir", "mkdir", "deleteFile", "rename", "stat"};
+        return handler_types::kFileSystem;
+    }
+
+private:
+    // The target leaves its directory now; the tree is removed by the DeferredDeleter worker
+    nlohmann::json deleteDeferred(const fs::path& p, const std::string& path, const fs::path& base) {
+        nlohmann::json result;
+        std::string jobId = "delete-" + std::to_string(++nextDeleteId_);
+        std::shared_ptr<WebViewEventSink> events = events_;
+        auto done = [events, jobId, path](const DeferredDeleter::Result& r) {
+            if (!events) {
+                return;
+            }
+            nlohmann::json payload;
+            payload["jobId"] = jobId;
+            payload["path"] = path;
+            payload["removedCount"] = r.removedCount;
+            if (!r.error.empty()) {
+                payload["error"] = r.error;
+            }
+            payload["elapsedMs"] = r.elapsedMs;
+            events->emit("delete:done", std::move(payload));
+        };
+        std::string error;
+        if (!DeferredDeleter::getInstance().remove(p, fs::absolute(base), done, error)) {
+            result["success"] = false;
+            result["error"] = error;
+            return result;
+        }
+        FileContentCache::getInstance().invalidate(p.u8string());
+        result["success"] = true;
+        result["deferred"] = true;
+        result["jobId"] = jobId;
+        return result;
     }
+
+    // listDir options: fields (array of names), sortBy (name|size|mtime|type), descending,
+    // offset/limit (page), cursor (continuation token returned as nextCursor)
+    nlohmann::json listDir(const fs::path& p, const nlohmann::json& payload) {
+        nlohmann::json result;
+        pruneListCursors();
+
+        if (payload.contains("cursor")) {
+            if (!payload["cursor"].is_string()) {
+                result["success"] = false;
+                result["error"] = "Invalid 'cursor' in payload";
+                return result;
+            }
+            auto it = listCursors_.find(payload["cursor"].get<std::string>());
+            if (it == listCursors_.end() || it->second.path != p.string()) {
+                result["success"] = false;
+                result["error"] = "Unknown or expired listDir cursor";
+                result["cursorExpired"] = true;
+                return result;
+            }
+            size_t limit = 0;
+            if (!readCount(payload, "limit", limit, result)) {
+                return result;
+            }
+            std::string token = it->first;
+            return listPage(token, limit, result);
+        }
+
+        unsigned fields = kDefaultListFields;
+        if (payload.contains("fields")) {
+            if (!payload["fields"].is_array()) {
+                result["success"] = false;
+                result["error"] = "Invalid 'fields' in payload (expect an array of field names)";
+                return result;
+            }
+            fields = 0;
+            for (const auto& f : payload["fields"]) {
+                unsigned bit = f.is_string() ? parseListField(f.get<std::string>()) : 0;
+                if (!bit) {
+                    result["success"] = false;
+                    result["error"] = "Unknown listDir field: " + f.dump() +
+                                      " (expected: name|isDirectory|isFile|isSymlink|size|mtime)";
+                    return result;
+                }
+                fields |= bit;
+            }
+        }
+        std::string sortBy = "none";
+        if (payload.contains("sortBy") && payload["sortBy"].is_string()) {
+            sortBy = payload["sortBy"].get<std::string>();
+        }
+        if (sortBy != "none" && sortBy != "name" && sortBy != "size" && sortBy != "mtime" && sortBy != "type") {
+            result["success"] = false;
+            result["error"] = "Invalid 'sortBy' (expected: none|name|size|mtime|type)";
+            return result;
+        }
+        bool descending = payload.contains("descending") && payload["descending"].is_boolean() &&
+                          payload["descending"].get<bool>();
+        size_t offset = 0, limit = 0;
+        if (!readCount(payload, "offset", offset, result) || !readCount(payload, "limit", limit, result)) {
+            return result;
+        }
+
+        if (!fs::exists(p)) {
+            result["success"] = false;
+            result["error"] = "Path does not exist";
+            return result;
+        }
+        if (!fs::is_directory(p)) {
+            result["success"] = false;
+            result["error"] = "Path is not a directory";
+            return result;
+        }
+
+        ListCursor cursor;
+        cursor.path = p.string();
+        cursor.fields = fields;
+        cursor.base = fs::current_path();
+        bool needSize = (fields & kFieldSize) || sortBy == "size";
+        bool needMtime = (fields & kFieldMtime) || sortBy == "mtime";
+
+        if (sortBy == "none") {
+            // Read only what this page needs
+            cursor.streaming = true;
+            cursor.iterator = fs::directory_iterator(p, fs::directory_options::skip_permission_denied);
+            std::error_code ec;
+            for (size_t skipped = 0; skipped < offset && cursor.iterator != fs::directory_iterator();) {
+                if (!isSandboxTrash(cursor.iterator->path(), cursor.base)) ++skipped;
+                cursor.iterator.increment(ec);
+                if (ec) throw fs::filesystem_error("listDir", p, ec);
+            }
+        } else {
+            for (const auto& entry : fs::directory_iterator(p, fs::directory_options::skip_permission_denied)) {
+                if (isSandboxTrash(entry.path(), cursor.base)) continue;
+                cursor.entries.push_back(readListEntry(entry, needSize, needMtime));
+            }
+            sortListEntries(cursor.entries, sortBy, descending);
+            cursor.position = std::min(offset, cursor.entries.size());
+        }
+
+        std::string token = "ls" + std::to_string(++nextListCursorId_);
+        listCursors_.emplace(token, std::move(cursor));
+        return listPage(token, limit, result);
+    }
+
+    // Emit up to limit entries (0 = all) from the cursor; keep it only if entries remain
+    nlohmann::json listPage(const std::string& token, size_t limit, nlohmann::json& result) {
+        ListCursor& cursor = listCursors_.at(token);
+        bool needSize = (cursor.fields & kFieldSize) != 0;
+        bool needMtime = (cursor.fields & kFieldMtime) != 0;
+        nlohmann::json entries = nlohmann::json::array();
+        bool more = false;
+        if (cursor.streaming) {
+            std::error_code ec;
+            while (cursor.iterator != fs::directory_iterator()) {
+                if (limit && entries.size() == limit) {
+                    more = true;
+                    break;
+                }
+                if (!isSandboxTrash(cursor.iterator->path(), cursor.base)) {
+                    entries.push_back(listEntryToJson(readListEntry(*cursor.iterator, needSize, needMtime), cursor.fields));
+                }
+                cursor.iterator.increment(ec);
+                if (ec) {
+                    listCursors_.erase(token);
+                    throw fs::filesystem_error("listDir", ec);
+                }
+            }
+        } else {
+            size_t end = limit ? std::min(cursor.entries.size(), cursor.position + limit) : cursor.entries.size();
+            for (; cursor.position < end; ++cursor.position) {
+                entries.push_back(listEntryToJson(cursor.entries[cursor.position], cursor.fields));
+            }
+            more = cursor.position < cursor.entries.size();
+            result["total"] = cursor.entries.size();
+        }
+
+        result["success"] = true;
+        result["entries"] = std::move(entries);
+        if (more) {
+            cursor.lastUsed = std::chrono::steady_clock::now();
+            result["nextCursor"] = token;
+        } else {
+            listCursors_.erase(token);
+        }
+        return result;
+    }
+
+    static void sortListEntries(std::vector<ListEntry>& entries, const std::string& sortBy, bool descending) {
+        auto byName = [](const ListEntry& a, const ListEntry& b) { return a.name < b.name; };
+        std::function<bool(const ListEntry&, const ListEntry&)> less = byName;
+        if (sortBy == "size") {
+            less = [byName](const ListEntry& a, const ListEntry& b) {
+                return a.size != b.size ? a.size < b.size : byName(a, b);
+            };
+        } else if (sortBy == "mtime") {
+            less = [byName](const ListEntry& a, const ListEntry& b) {
+                return a.mtime != b.mtime ? a.mtime < b.mtime : byName(a, b);
+            };
+        } else if (sortBy == "type") {
+            // Directories first, then by name
+            less = [byName](const ListEntry& a, const ListEntry& b) {
+                return a.isDirectory != b.isDirectory ? a.isDirectory : byName(a, b);
+            };
+        }
+        if (descending) {
+            std::sort(entries.begin(), entries.end(), [&less](const ListEntry& a, const ListEntry& b) { return less(b, a); });
+        } else {
+            std::sort(entries.begin(), entries.end(), less);
+        }
+    }
+
+    static bool readCount(const nlohmann::json& payload, const char* key, size_t& value, nlohmann::json& result) {
+        if (!payload.contains(key)) {
+            return true;
+        }
+        const nlohmann::json& v = payload[key];
+        if (!v.is_number_integer() || v.get<int64_t>() < 0) {
+            result["success"] = false;
+            result["error"] = std::string("Invalid '") + key + "' in payload (expect a non-negative integer)";
+            return false;
+        }
+        value = static_cast<size_t>(v.get<int64_t>());
+        return true;
+    }
+
+    // Drop idle cursors, then the least recently used ones beyond the cap
+    void pruneListCursors() {
+        auto now = std::chrono::steady_clock::now();
+        for (auto it = listCursors_.begin(); it != listCursors_.end();) {
+            it = (now - it->second.lastUsed > kListCursorIdle) ? listCursors_.erase(it) : std::next(it);
+        }
+        while (listCursors_.size() >= kMaxListCursors) {
+            auto oldest = std::min_element(listCursors_.begin(), listCursors_.end(), [](const auto& a, const auto& b) {
+                return a.second.lastUsed < b.second.lastUsed;
+            });
+            listCursors_.erase(oldest);
+        }
+    }
+
+    std::map<std::string, ListCursor> listCursors_;
+    uint64_t nextListCursorId_ = 0;
+    std::shared_ptr<WebViewEventSink> events_;  // null without a WebView: deferred deletes run silently
+    uint64_t nextDeleteId_ = 0;
 };
 
-std::shared_ptr<MessageHandler> createFileSystemHandler() {
-    return std::make_shared<FileSystemHandler>();
+std::shared_ptr<MessageHandler> createFileSystemHandler(WebView* webView) {
+    return std::make_shared<FileSystemHandler>(webView);
 }
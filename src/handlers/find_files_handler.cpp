@@ -0,0 +1,455 @@
+#include "../../include/handlers/find_files_handler.h"
+#include "../../include/handlers/handler_types.h"
+#include "../../include/handlers/file_system_handler.h"
+#include "../../include/message_handler.h"
+#include "../../include/handler_jobs.h"
+#include "../../include/thread_pool.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <set>
+#include <vector>
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+namespace fs = std::filesystem;
+
+// Matches are sent in batches: whichever comes first of this many matches or this much time
+static const size_t kBatchSize = 256;
+static const std::chrono::milliseconds kBatchInterval(100);
+static const size_t kDefaultMaxResults = 10000;
+
+static bool charEquals(char a, char b, bool ignoreCase) {
+    if (ignoreCase) {
+        return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+    }
+    return a == b;
+}
+
+// Class at p (on '['): end is set past its ']', matched to whether c is in it. False if the
+// class is unterminated, in which case the '[' is a literal.
+static bool globClass(const char* p, char c, bool ignoreCase, const char*& end, bool& matched) {
+    const char* q = p + 1;
+    bool negate = *q == '!' || *q == '^';
+    if (negate) ++q;
+    bool in = false;
+    bool first = true;
+    if (ignoreCase) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    while (*q && (*q != ']' || first)) {
+        first = false;
+        char lo = *q, hi = *q;
+        if (q[1] == '-' && q[2] && q[2] != ']') {
+            hi = q[2];
+            q += 3;
+        } else {
+            ++q;
+        }
+        if (ignoreCase) {
+            lo = static_cast<char>(std::tolower(static_cast<unsigned char>(lo)));
+            hi = static_cast<char>(std::tolower(static_cast<unsigned char>(hi)));
+        }
+        if (c >= lo && c <= hi) in = true;
+    }
+    if (*q != ']') return false;
+    end = q + 1;
+    matched = in != negate;
+    return true;
+}
+
+// Glob match: '*' and '?' stay within one path segment, '**' spans segments ("**/" also matches
+// no directory), [abc] / [a-z] / [!x] classes. Patterns without '/' are matched against names.
+// Dynamic programming over (pattern position, subject position), filled from the ends, so the
+// cost is O(pattern x subject) however many stars there are.
+static bool globMatch(const std::string& pattern, const std::string& subject, bool ignoreCase) {
+    const char* p = pattern.c_str();
+    const char* s = subject.c_str();
+    const size_t plen = pattern.size();
+    const size_t slen = subject.size();
+    const size_t width = slen + 1;
+    thread_local std::vector<char> table;  // table[pi * width + si]: p + pi matches s + si
+    table.assign((plen + 1) * width, 0);
+    auto at = [&](size_t pi, size_t si) { return table[pi * width + si] != 0; };
+    table[plen * width + slen] = 1;
+    for (size_t pi = plen; pi-- > 0;) {
+        for (size_t si = slen + 1; si-- > 0;) {
+            bool more = si < slen;
+            bool result = false;
+            if (p[pi] == '*') {
+                bool anyDepth = p[pi + 1] == '*';
+                size_t next = pi + (anyDepth ? 2 : 1);
+                result = at(next, si) || (anyDepth && p[next] == '/' && at(next + 1, si)) ||
+                         (more && (anyDepth || s[si] != '/') && at(pi, si + 1));
+            } else if (!more) {
+                result = false;
+            } else if (p[pi] == '?') {
+                result = s[si] != '/' && at(pi + 1, si + 1);
+            } else {
+                const char* end = nullptr;
+                bool matched = false;
+                if (p[pi] == '[' && globClass(p + pi, s[si], ignoreCase, end, matched)) {
+                    result = matched && s[si] != '/' && at(static_cast<size_t>(end - p), si + 1);
+                } else {
+                    result = charEquals(p[pi], s[si], ignoreCase) && at(pi + 1, si + 1);
+                }
+            }
+            table[pi * width + si] = result;
+        }
+    }
+    return at(0, 0);
+}
+
+static bool matchesAny(const std::vector<std::string>& globs, const std::string& name, const std::string& relative,
+                       bool ignoreCase) {
+    for (const auto& glob : globs) {
+        const std::string& subject = glob.find('/') != std::string::npos ? relative : name;
+        if (globMatch(glob, subject, ignoreCase)) return true;
+    }
+    return false;
+}
+
+struct FindOptions {
+    fs::path root;
+    fs::path canonicalRoot;             // followed symlinks must resolve below this
+    fs::path sandbox;                   // the working directory; its trash is never reported
+    std::vector<std::string> globs;     // any must match (empty = all)
+    std::string nameContains;           // substring of the name
+    std::vector<std::string> exclude;   // globs; excluded directories are not entered
+    bool ignoreCase = false;
+    bool skipHidden = false;
+    bool includeFiles = true;
+    bool includeDirectories = false;
+    bool followSymlinks = false;
+    bool withStats = false;             // report size/mtime for every match
+    int64_t minSize = -1, maxSize = -1;
+    int64_t modifiedAfter = -1, modifiedBefore = -1;  // ms since the Unix epoch
+    int maxDepth = -1;                  // 1 = direct children of root; -1 = unlimited
+    size_t maxResults = kDefaultMaxResults;
+
+    bool needsStat() const {
+        return withStats || minSize >= 0 || maxSize >= 0 || modifiedAfter >= 0 || modifiedBefore >= 0;
+    }
+};
+
+struct Search {
+    std::string id;
+    FindOptions options;
+    std::shared_ptr<HandlerJobs<Search>> searches;
+    std::chrono::steady_clock::time_point started;
+    std::atomic<bool> cancelled{false};
+    std::atomic<bool> truncated{false};
+    std::atomic<size_t> pendingDirectories{0};
+    std::atomic<size_t> directoriesScanned{0};
+    std::atomic<size_t> errors{0};
+
+    // Directories entered so far, only kept when following symlinks: a link back up the tree
+    // would otherwise be walked again and again
+    std::mutex visitedMutex;
+    std::set<std::string> visited;
+
+    std::mutex batchMutex;
+    nlohmann::json batch = nlohmann::json::array();
+    size_t matchCount = 0;  // guarded by batchMutex
+    std::chrono::steady_clock::time_point lastFlush;
+};
+
+// Caller holds batchMutex
+static void flushBatch(Search& search) {
+    if (search.batch.empty()) return;
+    nlohmann::json payload;
+    payload["searchId"] = search.id;
+    payload["matches"] = std::move(search.batch);
+    search.batch = nlohmann::json::array();
+    search.lastFlush = std::chrono::steady_clock::now();
+    search.searches->emit("find:matches", std::move(payload));
+}
+
+static void addMatch(Search& search, nlohmann::json match) {
+    std::lock_guard<std::mutex> lock(search.batchMutex);
+    if (search.matchCount >= search.options.maxResults) {
+        search.truncated = true;
+        search.cancelled = true;
+        return;
+    }
+    ++search.matchCount;
+    search.batch.push_back(std::move(match));
+    if (search.batch.size() >= kBatchSize || std::chrono::steady_clock::now() - search.lastFlush >= kBatchInterval) {
+        flushBatch(search);
+    }
+}
+
+static void finishSearch(const std::shared_ptr<Search>& search) {
+    nlohmann::json done;
+    {
+        std::lock_guard<std::mutex> lock(search->batchMutex);
+        flushBatch(*search);
+        done["count"] = search->matchCount;
+    }
+    done["searchId"] = search->id;
+    done["directoriesScanned"] = search->directoriesScanned.load();
+    done["errors"] = search->errors.load();
+    done["truncated"] = search->truncated.load();
+    done["cancelled"] = search->cancelled.load() && !search->truncated.load();
+    done["elapsedMs"] = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - search->started).count();
+    search->searches->finish(*search, "find:done", std::move(done));
+}
+
+// Identity of a directory however it was reached: (device, inode) on POSIX, the canonical
+// path on Windows
+static bool directoryKey(const fs::path& dir, std::string& key) {
+#ifdef _WIN32
+    std::error_code ec;
+    fs::path canonical = fs::canonical(dir, ec);
+    if (ec) return false;
+    key = canonical.string();
+#else
+    struct stat st;
+    if (::stat(dir.c_str(), &st) != 0) return false;
+    key = std::to_string(static_cast<uint64_t>(st.st_dev)) + ":" + std::to_string(static_cast<uint64_t>(st.st_ino));
+#endif
+    return true;
+}
+
+// False if dir was entered before (or cannot be identified)
+static bool markVisited(Search& search, const fs::path& dir) {
+    std::string key;
+    if (!directoryKey(dir, key)) return false;
+    std::lock_guard<std::mutex> lock(search.visitedMutex);
+    return search.visited.insert(key).second;
+}
+
+// A followed link must not lead out of the searched tree
+static bool linkStaysInside(const FindOptions& opt, const fs::path& link) {
+    std::error_code ec;
+    fs::path target = fs::canonical(link, ec);
+    if (ec) return false;
+    auto mismatch = std::mismatch(opt.canonicalRoot.begin(), opt.canonicalRoot.end(), target.begin(), target.end());
+    return mismatch.first == opt.canonicalRoot.end();
+}
+
+static void scanDirectory(const std::shared_ptr<Search>& search, const fs::path& dir, const std::string& relativeDir,
+                          int depth) {
+    const FindOptions& opt = search->options;
+    if (!search->cancelled && (!opt.followSymlinks || markVisited(*search, dir))) {
+        search->directoriesScanned++;
+        std::error_code ec;
+        fs::directory_iterator it(dir, fs::directory_options::skip_permission_denied, ec);
+        if (ec) search->errors++;
+        for (; !ec && it != fs::directory_iterator(); it.increment(ec)) {
+            if (search->cancelled) break;
+            const fs::directory_entry& entry = *it;
+            std::string name = entry.path().filename().string();
+            if (opt.skipHidden && !name.empty() && name[0] == '.') continue;
+            if (relativeDir.empty() && isSandboxTrash(entry.path(), opt.sandbox)) continue;
+            std::string relative = relativeDir.empty() ? name : relativeDir + "/" + name;
+            if (!opt.exclude.empty() && matchesAny(opt.exclude, name, relative, opt.ignoreCase)) continue;
+
+            std::error_code typeEc;
+            bool isSymlink = entry.is_symlink(typeEc);
+            bool isDirectory = entry.is_directory(typeEc);
+            bool isFile = entry.is_regular_file(typeEc);
+
+            bool wanted = (isFile && opt.includeFiles) || (isDirectory && opt.includeDirectories);
+            if (wanted && !opt.globs.empty()) wanted = matchesAny(opt.globs, name, relative, opt.ignoreCase);
+            if (wanted && !opt.nameContains.empty()) {
+                auto hit = std::search(name.begin(), name.end(), opt.nameContains.begin(), opt.nameContains.end(),
+                                       [&opt](char a, char b) { return charEquals(a, b, opt.ignoreCase); });
+                wanted = hit != name.end();
+            }
+            int64_t size = -1, mtime = -1;
+            if (wanted && opt.needsStat()) {
+                if (!readEntryStat(entry, size, mtime)) {
+                    search->errors++;
+                    wanted = false;
+                } else {
+                    if (opt.minSize >= 0 && (!isFile || size < opt.minSize)) wanted = false;
+                    if (opt.maxSize >= 0 && (!isFile || size > opt.maxSize)) wanted = false;
+                    if (opt.modifiedAfter >= 0 && mtime < opt.modifiedAfter) wanted = false;
+                    if (opt.modifiedBefore >= 0 && mtime >= opt.modifiedBefore) wanted = false;
+                }
+            }
+            if (wanted) {
+                nlohmann::json match;
+                match["path"] = relative;
+                match["isDirectory"] = isDirectory;
+                if (opt.withStats) {
+                    if (isFile) match["size"] = size;
+                    match["mtime"] = mtime;
+                }
+                addMatch(*search, std::move(match));
+            }
+
+            bool descend = isDirectory && (!isSymlink || opt.followSymlinks) &&
+                           (opt.maxDepth < 0 || depth + 1 < opt.maxDepth);
+            if (descend && isSymlink && !linkStaysInside(opt, entry.path())) descend = false;
+            if (descend && !search->cancelled) {
+                // Subdirectories become separate tasks; idle workers steal them
+                search->pendingDirectories++;
+                fs::path child = entry.path();
+                ThreadPool::getInstance().submit([search, child, relative, depth]() {
+                    scanDirectory(search, child, relative, depth + 1);
+                });
+            }
+        }
+        if (ec) search->errors++;
+    }
+    if (--search->pendingDirectories == 0) {
+        finishSearch(search);
+    }
+}
+
+static bool readInt(const nlohmann::json& payload, const char* key, int64_t& value, nlohmann::json& result) {
+    if (!payload.contains(key)) return true;
+    if (!payload[key].is_number_integer() || payload[key].get<int64_t>() < 0) {
+        result["success"] = false;
+        result["error"] = std::string("Invalid '") + key + "' in payload (expect a non-negative integer)";
+        return false;
+    }
+    value = payload[key].get<int64_t>();
+    return true;
+}
+
+static bool readStrings(const nlohmann::json& payload, const char* key, std::vector<std::string>& values,
+                        nlohmann::json& result) {
+    if (!payload.contains(key)) return true;
+    const nlohmann::json& v = payload[key];
+    if (v.is_string()) {
+        values.push_back(v.get<std::string>());
+        return true;
+    }
+    if (v.is_array()) {
+        for (const auto& item : v) {
+            if (!item.is_string()) break;
+            values.push_back(item.get<std::string>());
+        }
+        if (values.size() == v.size()) return true;
+    }
+    result["success"] = false;
+    result["error"] = std::string("Invalid '") + key + "' in payload (expect a string or an array of strings)";
+    return false;
+}
+
+static bool readBool(const nlohmann::json& payload, const char* key, bool& value) {
+    if (payload.contains(key) && payload[key].is_boolean()) {
+        value = payload[key].get<bool>();
+    }
+    return true;
+}
+
+// Handler for findFiles / walk (recursive search under the sandbox root) and cancelFind.
+//   findFiles: path, glob (string or array), nameContains, exclude, ignoreCase, skipHidden,
+//              includeDirectories, includeFiles, followSymlinks, minSize, maxSize,
+//              modifiedAfter, modifiedBefore, maxDepth, maxResults, withStats
+//   walk:      same options; lists directories too and reports size/mtime by default
+// Replies at once with { searchId }; matches arrive as "find:matches" { searchId, matches: [
+// { path (relative to root), isDirectory, size?, mtime? } ] } and the end as "find:done".
+class FindFilesHandler : public MessageHandler {
+public:
+    explicit FindFilesHandler(WebView* webView) : searches_(std::make_shared<HandlerJobs<Search>>(webView, "find")) {}
+
+    ~FindFilesHandler() override {
+        searches_->close();
+    }
+
+    bool canHandle(const std::string& messageType) const override {
+        return messageType == "findFiles" || messageType == "walk" || messageType == "cancelFind";
+    }
+
+    nlohmann::json handle(const nlohmann::json& payload, const std::string& requestId) override {
+        (void)requestId;
+        nlohmann::json result;
+        std::string op;
+        if (payload.contains("_type") && payload["_type"].is_string()) {
+            op = payload["_type"].get<std::string>();
+        }
+
+        if (op == "cancelFind") {
+            return searches_->cancel(payload, "searchId");
+        }
+
+        if (!payload.contains("path") || !payload["path"].is_string()) {
+            result["success"] = false;
+            result["error"] = "Missing or invalid 'path' in payload";
+            return result;
+        }
+        std::string resolved = resolveSandboxedPath(payload["path"].get<std::string>(), fs::current_path());
+        if (resolved.empty()) {
+            result["success"] = false;
+            result["error"] = "Invalid or disallowed path";
+            return result;
+        }
+        std::error_code ec;
+        if (!fs::is_directory(resolved, ec)) {
+            result["success"] = false;
+            result["error"] = "Path is not a directory";
+            return result;
+        }
+
+        auto search = std::make_shared<Search>();
+        FindOptions& opt = search->options;
+        opt.root = resolved;
+        opt.sandbox = fs::current_path();
+        opt.canonicalRoot = fs::canonical(resolved, ec);
+        if (ec) {
+            result["success"] = false;
+            result["error"] = "Path is not a directory";
+            return result;
+        }
+        if (op == "walk") {
+            opt.includeDirectories = true;
+            opt.withStats = true;
+        }
+        int64_t maxDepth = -1, maxResults = static_cast<int64_t>(kDefaultMaxResults);
+        if (!readStrings(payload, "glob", opt.globs, result) || !readStrings(payload, "exclude", opt.exclude, result) ||
+            !readInt(payload, "minSize", opt.minSize, result) || !readInt(payload, "maxSize", opt.maxSize, result) ||
+            !readInt(payload, "modifiedAfter", opt.modifiedAfter, result) ||
+            !readInt(payload, "modifiedBefore", opt.modifiedBefore, result) ||
+            !readInt(payload, "maxDepth", maxDepth, result) || !readInt(payload, "maxResults", maxResults, result)) {
+            return result;
+        }
+        if (maxDepth == 0) {
+            result["success"] = false;
+            result["error"] = "'maxDepth' must be at least 1";
+            return result;
+        }
+        opt.maxDepth = static_cast<int>(maxDepth);
+        opt.maxResults = static_cast<size_t>(maxResults);
+        if (payload.contains("nameContains") && payload["nameContains"].is_string()) {
+            opt.nameContains = payload["nameContains"].get<std::string>();
+        }
+        readBool(payload, "ignoreCase", opt.ignoreCase);
+        readBool(payload, "skipHidden", opt.skipHidden);
+        readBool(payload, "includeFiles", opt.includeFiles);
+        readBool(payload, "includeDirectories", opt.includeDirectories);
+        readBool(payload, "followSymlinks", opt.followSymlinks);
+        readBool(payload, "withStats", opt.withStats);
+
+        search->searches = searches_;
+        search->started = std::chrono::steady_clock::now();
+        search->lastFlush = search->started;
+        search->pendingDirectories = 1;
+        searches_->add(search);
+        fs::path root = opt.root;
+        ThreadPool::getInstance().submit([search, root]() { scanDirectory(search, root, "", 0); });
+
+        result["success"] = true;
+        result["searchId"] = search->id;
+        return result;
+    }
+
+    std::vector<std::string> getSupportedTypes() const override {
+        return handler_types::kFindFiles;
+    }
+
+private:
+    std::shared_ptr<HandlerJobs<Search>> searches_;
+};
+
+std::shared_ptr<MessageHandler> createFindFilesHandler(WebView* webView) {
+    return std::make_shared<FindFilesHandler>(webView);
+}
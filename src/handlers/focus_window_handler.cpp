@@ -1,4 +1,5 @@
 #include "../../include/handlers/focus_window_handler.h"
+#include "../../include/handlers/handler_types.h"
 #include "../../include/singleton_webview_window_manager.h"
 #include <nlohmann/json.hpp>
 
@@ -26,7 +27,7 @@ public:
     }
 
     std::vector<std::string> getSupportedTypes() const override {
-        return {"focusWindow"};
+        return handler_types::kFocusWindow;
     }
 };
 
@@ -0,0 +1,214 @@
+#include "../../include/handlers/hash_file_handler.h"
+#include "../../include/handlers/handler_types.h"
+#include "../../include/handlers/file_system_handler.h"
+#include "../../include/message_handler.h"
+#include "../../include/hashing.h"
+#include "../../include/thread_pool.h"
+#include "../../include/handler_jobs.h"
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+static const int64_t kProgressIntervalMs = 100;
+static const size_t kMaxFilesPerJob = 65536;
+
+struct HashEntry {
+    std::string path;      // as requested
+    std::string resolved;  // empty: rejected by the sandbox
+    uint64_t size = 0;
+    std::string hash;
+    std::string error;
+};
+
+struct HashJob {
+    std::string id;
+    hashing::Algorithm algorithm = hashing::Algorithm::Xxh3;
+    std::vector<HashEntry> entries;  // each entry is written by exactly one task
+    uint64_t bytesTotal = 0;
+    std::shared_ptr<HandlerJobs<HashJob>> jobs;
+    std::chrono::steady_clock::time_point started;
+    std::atomic<bool> cancelled{false};
+    std::atomic<uint64_t> bytesDone{0};
+    std::atomic<size_t> filesDone{0};
+    std::atomic<int64_t> lastProgressMs{0};
+
+    int64_t elapsedMs() const {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started).count();
+    }
+};
+
+// At most one progress event per kProgressIntervalMs, from whichever worker gets there first
+static void maybeReportProgress(HashJob& job) {
+    int64_t now = job.elapsedMs();
+    int64_t last = job.lastProgressMs.load();
+    if (now - last < kProgressIntervalMs || !job.lastProgressMs.compare_exchange_strong(last, now)) {
+        return;
+    }
+    nlohmann::json progress;
+    progress["jobId"] = job.id;
+    progress["bytesDone"] = job.bytesDone.load();
+    progress["bytesTotal"] = job.bytesTotal;
+    progress["filesDone"] = job.filesDone.load();
+    progress["filesTotal"] = job.entries.size();
+    job.jobs->emit("hash:progress", std::move(progress));
+}
+
+static void finishJob(const std::shared_ptr<HashJob>& job) {
+    nlohmann::json done;
+    done["jobId"] = job->id;
+    done["algorithm"] = hashing::algorithmName(job->algorithm);
+    done["results"] = nlohmann::json::array();
+    for (const auto& entry : job->entries) {
+        nlohmann::json item;
+        item["path"] = entry.path;
+        if (entry.error.empty()) {
+            item["hash"] = entry.hash;
+            item["size"] = entry.size;
+        } else {
+            item["error"] = entry.error;
+        }
+        done["results"].push_back(std::move(item));
+    }
+    done["cancelled"] = job->cancelled.load();
+    done["elapsedMs"] = job->elapsedMs();
+    job->jobs->finish(*job, "hash:done", std::move(done));
+}
+
+static void hashEntry(const std::shared_ptr<HashJob>& job, size_t index) {
+    HashEntry& entry = job->entries[index];
+    if (entry.error.empty()) {
+        if (job->cancelled) {
+            entry.error = "Cancelled";
+        } else {
+            HashJob& j = *job;
+            auto progress = [&j](uint64_t bytes) {
+                j.bytesDone += bytes;
+                maybeReportProgress(j);
+            };
+            hashing::hashFile(entry.resolved, job->algorithm, entry.hash, entry.error, progress, &job->cancelled);
+        }
+    }
+    if (++job->filesDone == job->entries.size()) {
+        finishJob(job);
+    }
+}
+
+// Handler for native file hashing.
+//   hashFile:   path, algorithm ("xxh3" default, or "sha256")
+//   hashFiles:  paths (array), algorithm
+//   cancelHash: jobId
+// hashFile / hashFiles reply at once with { jobId }. Files are hashed in parallel, each read
+// in large chunks; "hash:progress" { jobId, bytesDone, bytesTotal, filesDone, filesTotal }
+// arrives at most every 100 ms and "hash:done" { jobId, algorithm, results: [ { path, hash,
+// size } or { path, error } ], cancelled, elapsedMs } ends the job.
+class HashFileHandler : public MessageHandler {
+public:
+    explicit HashFileHandler(WebView* webView) : jobs_(std::make_shared<HandlerJobs<HashJob>>(webView, "hash")) {}
+
+    ~HashFileHandler() override {
+        jobs_->close();
+    }
+
+    bool canHandle(const std::string& messageType) const override {
+        return messageType == "hashFile" || messageType == "hashFiles" || messageType == "cancelHash";
+    }
+
+    nlohmann::json handle(const nlohmann::json& payload, const std::string& requestId) override {
+        (void)requestId;
+        nlohmann::json result;
+        std::string op;
+        if (payload.contains("_type") && payload["_type"].is_string()) {
+            op = payload["_type"].get<std::string>();
+        }
+
+        if (op == "cancelHash") {
+            return jobs_->cancel(payload);
+        }
+
+        auto job = std::make_shared<HashJob>();
+        if (payload.contains("algorithm")) {
+            if (!payload["algorithm"].is_string() ||
+                !hashing::parseAlgorithm(payload["algorithm"].get<std::string>(), job->algorithm)) {
+                result["success"] = false;
+                result["error"] = "Invalid 'algorithm' in payload (expect \"xxh3\" or \"sha256\")";
+                return result;
+            }
+        }
+
+        std::vector<std::string> paths;
+        if (op == "hashFiles") {
+            if (!payload.contains("paths") || !payload["paths"].is_array() || payload["paths"].empty() ||
+                payload["paths"].size() > kMaxFilesPerJob) {
+                result["success"] = false;
+                result["error"] = "Missing or invalid 'paths' in payload (expect 1-" +
+                                  std::to_string(kMaxFilesPerJob) + " paths)";
+                return result;
+            }
+            for (const auto& p : payload["paths"]) {
+                if (!p.is_string()) {
+                    result["success"] = false;
+                    result["error"] = "Invalid 'paths' in payload (expect strings)";
+                    return result;
+                }
+                paths.push_back(p.get<std::string>());
+            }
+        } else {
+            if (!payload.contains("path") || !payload["path"].is_string()) {
+                result["success"] = false;
+                result["error"] = "Missing or invalid 'path' in payload";
+                return result;
+            }
+            paths.push_back(payload["path"].get<std::string>());
+        }
+
+        fs::path base = fs::current_path();
+        for (const auto& path : paths) {
+            HashEntry entry;
+            entry.path = path;
+            entry.resolved = resolveSandboxedPath(path, base);
+            std::error_code ec;
+            if (entry.resolved.empty()) {
+                entry.error = "Invalid or disallowed path";
+            } else if (!fs::is_regular_file(entry.resolved, ec)) {
+                entry.error = "Not a file";
+            } else {
+                entry.size = fs::file_size(entry.resolved, ec);
+                job->bytesTotal += entry.size;
+            }
+            job->entries.push_back(std::move(entry));
+        }
+        if (op == "hashFile" && !job->entries[0].error.empty()) {
+            result["success"] = false;
+            result["error"] = job->entries[0].error;
+            return result;
+        }
+
+        job->jobs = jobs_;
+        job->started = std::chrono::steady_clock::now();
+        jobs_->add(job);
+        ThreadPool& pool = ThreadPool::getInstance();
+        for (size_t i = 0; i < job->entries.size(); ++i) {
+            pool.submit([job, i]() { hashEntry(job, i); });
+        }
+
+        result["success"] = true;
+        result["jobId"] = job->id;
+        result["fileCount"] = job->entries.size();
+        result["bytesTotal"] = job->bytesTotal;
+        return result;
+    }
+
+    std::vector<std::string> getSupportedTypes() const override {
+        return handler_types::kHashFile;
+    }
+
+private:
+    std::shared_ptr<HandlerJobs<HashJob>> jobs_;
+};
+
+std::shared_ptr<MessageHandler> createHashFileHandler(WebView* webView) {
+    return std::make_shared<HashFileHandler>(webView);
+}
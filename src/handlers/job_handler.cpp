@@ -0,0 +1,122 @@
+#include "../../include/handlers/job_handler.h"
+#include "../../include/handlers/handler_types.h"
+#include "../../include/message_handler.h"
+#include "../../include/job_manager.h"
+#include "../../include/webview_event_sink.h"
+#include <nlohmann/json.hpp>
+
+// startJob {type, payload?, priority?: "high" | "normal" | "low"} -> {jobId}
+// jobStatus {jobId} -> {job}; without jobId -> {jobs} (queued, running and recently finished)
+// cancelJob {jobId} -> {found}
+// A window sees and cancels only the jobs it started, handler jobs ("copy-N", "hash-N", ...)
+// included.
+class JobHandler : public MessageHandler {
+public:
+    JobHandler(WebView* webView, JobHandlerLookup findHandler, JobManager& manager)
+        : events_(std::make_shared<WebViewEventSink>(webView)), webView_(webView), findHandler_(std::move(findHandler)),
+          manager_(manager) {}
+
+    ~JobHandler() override {
+        events_->detach();
+    }
+
+    bool canHandle(const std::string& messageType) const override {
+        return messageType == "startJob" || messageType == "jobStatus" || messageType == "cancelJob";
+    }
+
+    nlohmann::json handle(const nlohmann::json& payload, const std::string& requestId) override {
+        (void)requestId;
+        nlohmann::json result;
+        std::string op;
+        if (payload.contains("_type") && payload["_type"].is_string()) {
+            op = payload["_type"].get<std::string>();
+        }
+
+        if (op == "jobStatus") {
+            if (!payload.contains("jobId")) {
+                result["success"] = true;
+                result["jobs"] = manager_.list(webView_);
+                return result;
+            }
+            nlohmann::json job;
+            if (!payload["jobId"].is_string() || !manager_.status(payload["jobId"].get<std::string>(), job, webView_)) {
+                result["success"] = false;
+                result["error"] = "Unknown job";
+                return result;
+            }
+            result["success"] = true;
+            result["job"] = job;
+            return result;
+        }
+
+        if (op == "cancelJob") {
+            if (!payload.contains("jobId") || !payload["jobId"].is_string()) {
+                result["success"] = false;
+                result["error"] = "Missing or invalid 'jobId' in payload";
+                return result;
+            }
+            result["success"] = true;
+            result["found"] = manager_.cancel(payload["jobId"].get<std::string>(), webView_);
+            return result;
+        }
+
+        // startJob
+        if (!payload.contains("type") || !payload["type"].is_string()) {
+            result["success"] = false;
+            result["error"] = "Missing or invalid 'type' in payload";
+            return result;
+        }
+        std::string type = payload["type"].get<std::string>();
+        nlohmann::json request = nlohmann::json::object();
+        if (payload.contains("payload")) {
+            if (!payload["payload"].is_object()) {
+                result["success"] = false;
+                result["error"] = "Invalid 'payload' in payload (expect an object)";
+                return result;
+            }
+            request = payload["payload"];
+        }
+        JobManager::Priority priority = JobManager::Priority::Normal;
+        if (payload.contains("priority") &&
+            (!payload["priority"].is_string() || !JobManager::parsePriority(payload["priority"].get<std::string>(), priority))) {
+            result["success"] = false;
+            result["error"] = "Invalid 'priority' in payload (expect \"high\", \"normal\" or \"low\")";
+            return result;
+        }
+        std::shared_ptr<MessageHandler> handler = findHandler_ ? findHandler_(type) : nullptr;
+        if (!handler) {
+            result["success"] = false;
+            result["error"] = "Unknown message type: " + type;
+            return result;
+        }
+        if (!handler->canRunAsJob(type)) {
+            result["success"] = false;
+            result["error"] = "Message type cannot run as a job: " + type;
+            return result;
+        }
+        request["_type"] = type;
+        // The job holds the handler: it stays alive even if its window closes meanwhile.
+        // Its events, file contents included, go to this window alone.
+        std::shared_ptr<WebViewEventSink> events = events_;
+        std::string jobId = manager_.start(type, priority, [handler, request](JobContext& context) {
+            return handler->handle(request, context.id());
+        }, [events](const std::string& name, const nlohmann::json& event) { events->emit(name, event); }, webView_);
+        result["success"] = true;
+        result["jobId"] = jobId;
+        return result;
+    }
+
+    std::vector<std::string> getSupportedTypes() const override {
+        return handler_types::kJob;
+    }
+
+private:
+    std::shared_ptr<WebViewEventSink> events_;
+    WebView* const webView_;  // owner tag of the jobs this window starts
+    JobHandlerLookup findHandler_;
+    JobManager& manager_;
+};
+
+std::shared_ptr<MessageHandler> createJobHandler(WebView* webView, JobHandlerLookup findHandler, JobManager& manager) {
+    return std::make_shared<JobHandler>(webView, std::move(findHandler), manager);
+}
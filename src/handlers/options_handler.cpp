@@ -1,5 +1,7 @@
 #include "../../include/handlers/options_handler.h"
+#include "../../include/handlers/handler_types.h"
 #include "../../include/config_manager.h"
+#include "../../include/shared_state_store.h"
 #include "../../include/message_handler.h"
 #include <nlohmann/json.hpp>
 #include <fstream>
@@ -44,6 +46,15 @@ public:
     nlohmann::json handleReadOptions() const {
         nlohmann::json result;
         try {
+            // Served from the shared store (one copy for all windows); disk is only read on first use
+            SharedStateStore& store = SharedStateStore::getInstance();
+            SharedStateStore::Snapshot snap = store.get("options");
+            if (snap.version > 0) {
+                result["success"] = true;
+                result["options"] = snap.value;
+                result["version"] = snap.version;
+                return result;
+            }
             std::string path = ConfigManager::getOptionsFilePath();
             std::ifstream f(path);
             if (!f.is_open()) {
@@ -55,13 +66,11 @@ public:
             ss << f.rdbuf();
             std::string content = ss.str();
             f.close();
-            if (content.empty()) {
-                result["success"] = true;
-                result["options"] = ConfigManager::getInstance().getOptions();
-                return result;
-            }
+            nlohmann::json options = content.empty() ? ConfigManager::getInstance().getOptions()
+                                                     : nlohmann::json::parse(content);
             result["success"] = true;
-            result["options"] = nlohmann::json::parse(content);
+            result["version"] = store.set("options", options);
+            result["options"] = options;
         } catch (const std::exception& e) {
             result["success"] = false;
             result["error"] = e.what();
@@ -114,6 +123,8 @@ public:
             std::cout << "[OptionsHandler] Reloading ConfigManager..." << std::endl;
             ConfigManager::getInstance().loadOptions();
             std::cout << "[OptionsHandler] ConfigManager reloaded successfully" << std::endl;
+            // Publish to other windows subscribed to "options" (they receive only the delta)
+            result["version"] = SharedStateStore::getInstance().set("options", ConfigManager::getInstance().getOptions());
             result["success"] = true;
         } catch (const std::exception& e) {
             std::cout << "[OptionsHandler] EXCEPTION: " << e.what() << std::endl;
@@ -124,7 +135,7 @@ public:
     }
 
     std::vector<std::string> getSupportedTypes() const override {
-        return {"getOptionsPath", "readOptions", "writeOptions"};
+        return handler_types::kOptions;
     }
 };
 
@@ -1,12 +1,57 @@
 #include "../../include/message_handler.h"
+#include "../../include/handlers/handler_types.h"
 #include "../../include/base64.h"
+#include "../../include/file_content_cache.h"
 #include <nlohmann/json.hpp>
 #include <iostream>
+#include <filesystem>
 #include <fstream>
 #include <sstream>
 #include <vector>
+#include <algorithm>
 
-// Handler for reading files as binary (returns base64)
+// Largest range returned by one readFile call unless the request sets maxBytes.
+// Base64 adds a third and the JSON response copies it again, so 64 MiB of file is ~180 MiB peak.
+static const uint64_t kDefaultMaxBytes = 64ull * 1024 * 1024;
+// Upper bound for a request's maxBytes
+static const uint64_t kMaxBytesLimit = 256ull * 1024 * 1024;
+
+static bool readUnsigned(const nlohmann::json& payload, const char* key, uint64_t& value, std::string& error) {
+    if (!payload.contains(key)) {
+        return true;
+    }
+    const nlohmann::json& v = payload[key];
+    if (v.is_number_unsigned() || (v.is_number_integer() && v.get<int64_t>() >= 0)) {
+        value = v.get<uint64_t>();
+        return true;
+    }
+    error = std::string("Invalid '") + key + "' in payload (expect a non-negative integer)";
+    return false;
+}
+
+// Size of a regular file in bytes; false (with error) if it cannot be stat'ed or is not a file
+static bool regularFileSize(const std::string& path, uint64_t& size, std::string& error) {
+    std::error_code ec;
+    std::filesystem::path p = std::filesystem::u8path(path);
+    std::filesystem::file_status status = std::filesystem::status(p, ec);
+    if (ec || !std::filesystem::exists(status)) {
+        error = "Failed to open file: " + path + (ec ? " (" + ec.message() + ")" : "");
+        return false;
+    }
+    if (!std::filesystem::is_regular_file(status)) {
+        error = "Not a regular file: " + path;
+        return false;
+    }
+    size = std::filesystem::file_size(p, ec);
+    if (ec) {
+        error = "Failed to open file: " + path + " (" + ec.message() + ")";
+        return false;
+    }
+    return true;
+}
+
+// Handler for reading files as binary (returns base64).
+// Optional ranged access: offset/length, or chunkSize/chunkIndex to walk a file in fixed windows.
 class ReadFileHandler : public MessageHandler {
 public:
     bool canHandle(const std::string& messageType) const override {
@@ -30,34 +75,105 @@ public:
             return result;
         }
 
+        uint64_t offset = 0, length = 0, chunkSize = 0, chunkIndex = 0, maxBytes = kDefaultMaxBytes;
+        std::string error;
+        if (!readUnsigned(payload, "offset", offset, error) || !readUnsigned(payload, "length", length, error) ||
+            !readUnsigned(payload, "chunkSize", chunkSize, error) || !readUnsigned(payload, "chunkIndex", chunkIndex, error) ||
+            !readUnsigned(payload, "maxBytes", maxBytes, error)) {
+            result["success"] = false;
+            result["error"] = error;
+            return result;
+        }
+        bool chunked = payload.contains("chunkSize");
+        if (chunked && chunkSize == 0) {
+            result["success"] = false;
+            result["error"] = "'chunkSize' must be greater than 0";
+            return result;
+        }
+        maxBytes = std::min(maxBytes, kMaxBytesLimit);
+
         // Security: reject absolute paths outside current directory on first run
         // For demo we allow relative paths and simple absolute paths
-        std::ifstream file(path, std::ios::binary | std::ios::ate);
-        if (!file.is_open()) {
+        uint64_t totalSize = 0;
+        if (!regularFileSize(path, totalSize, error)) {
             result["success"] = false;
-            result["error"] = "Failed to open file: " + path;
+            result["error"] = error;
             return result;
         }
 
-        std::streamsize size = file.tellg();
-        file.seekg(0, std::ios::beg);
+        if (chunked) {
+            if (chunkIndex > totalSize / chunkSize) {
+                offset = totalSize;  // past the last chunk: empty, eof
+            } else {
+                offset = chunkIndex * chunkSize;
+            }
+            length = chunkSize;
+        } else if (offset > totalSize) {
+            result["success"] = false;
+            result["error"] = "Offset " + std::to_string(offset) + " is past the end of the file (" + std::to_string(totalSize) + " bytes)";
+            return result;
+        } else if (!payload.contains("length")) {
+            length = totalSize - offset;
+        }
 
-        std::vector<unsigned char> buffer(static_cast<size_t>(size));
-        if (!file.read(reinterpret_cast<char*>(buffer.data()), size)) {
+        if (length > maxBytes) {
+            // Refuse rather than allocate: the caller must page through the file
             result["success"] = false;
-            result["error"] = "Failed to read file: " + path;
+            result["error"] = "Requested " + std::to_string(length) + " bytes exceeds the readFile limit of " +
+                              std::to_string(maxBytes) + " bytes; use offset/length or chunkSize";
+            result["rangeRequired"] = true;
+            result["totalSize"] = totalSize;
             return result;
         }
+        length = std::min(length, totalSize - std::min(offset, totalSize));
+
+        std::string base64Data;
+        if (offset == 0 && length == totalSize && length > 0 && length <= FileContentCache::getInstance().maxEntryBytes()) {
+            // Whole small files come from the shared cache, base64 included
+            uint64_t size = 0;
+            std::shared_ptr<const std::string> cached = FileContentCache::getInstance().getBase64(path, size, error);
+            if (!cached) {
+                result["success"] = false;
+                result["error"] = error;
+                return result;
+            }
+            base64Data = *cached;
+            length = totalSize = size;
+        } else if (length > 0) {
+            // Read, not mapped: a mapping of a file that another process truncates meanwhile
+            // (log rotation, an editor rewriting it) faults with SIGBUS and takes the app down
+            std::ifstream file(path, std::ios::binary);
+            if (!file.is_open()) {
+                result["success"] = false;
+                result["error"] = "Failed to open file: " + path;
+                return result;
+            }
+            std::vector<unsigned char> buffer(static_cast<size_t>(length));
+            file.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+            file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(length));
+            if (static_cast<uint64_t>(file.gcount()) != length) {
+                result["success"] = false;
+                result["error"] = file.bad() ? "Failed to read file: " + path : "File changed while reading: " + path;
+                return result;
+            }
+            base64Data = base64::encode(buffer);
+        }
 
-        std::string base64Data = base64::encode(buffer);
         result["success"] = true;
-        result["data"] = base64Data;
-        result["size"] = static_cast<int64_t>(size);
+        result["data"] = std::move(base64Data);
+        result["size"] = static_cast<int64_t>(length);
+        result["offset"] = offset;
+        result["totalSize"] = totalSize;
+        result["eof"] = offset + length >= totalSize;
+        if (chunked) {
+            result["chunkIndex"] = chunkIndex;
+            result["chunkCount"] = (totalSize + chunkSize - 1) / chunkSize;
+        }
         return result;
     }
 
     std::vector<std::string> getSupportedTypes() const override {
-        return {"readFile"};
+        return handler_types::kReadFile;
     }
 };
 
@@ -1,7 +1,9 @@
 #include "../../include/message_handler.h"
+#include "../../include/handlers/handler_types.h"
 #include "../../include/webview_window.h"
 #include "../../include/config_manager.h"
 #include "../../include/singleton_webview_window_manager.h"
+#include "../../include/asset_bundle.h"
 #include "../platform/platform_impl.h"
 #include <nlohmann/json.hpp>
 #include <iostream>
@@ -83,6 +85,15 @@ public:
                 std::cout << "[ReloadMainContent] ERROR: File not found: " << filePath << std::endl;
                 mainWindow->loadHTMLString("<html><body><h1>File not found</h1><p>Check filePath in options.json: " + filePath + "</p></body></html>");
             }
+        } else if (method == "app") {
+            std::string entry = config.getHtmlAppEntry();
+            if (asset_bundle::find(entry)) {
+                std::cout << "[ReloadMainContent] Loading bundled app: " << asset_bundle::url(entry) << std::endl;
+                mainWindow->loadURL(asset_bundle::url(entry));
+            } else {
+                std::cout << "[ReloadMainContent] ERROR: Not bundled: " << entry << std::endl;
+                mainWindow->loadHTMLString("<html><body><h1>Error: " + entry + " is not bundled</h1><p>Build with -DCROSSDEV_WEB_ASSETS_DIR=&lt;web app dir&gt;</p></body></html>");
+            }
         } else {
             std::string content = ConfigManager::tryLoadFileContent("demo.html");
             if (content.empty()) {
@@ -98,7 +109,7 @@ public:
     }
 
     std::vector<std::string> getSupportedTypes() const override {
-        return {"reloadMainContent"};
+        return handler_types::kReloadMainContent;
     }
 
 private:
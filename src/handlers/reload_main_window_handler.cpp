@@ -1,6 +1,8 @@
 #include "../../include/message_handler.h"
+#include "../../include/handlers/handler_types.h"
 #include "../../include/webview_window.h"
 #include "../../include/config_manager.h"
+#include "../../include/asset_bundle.h"
 #include "../platform/platform_impl.h"
 #include <nlohmann/json.hpp>
 #include <iostream>
@@ -113,6 +115,16 @@ public:
                 std::cout << "[ReloadMainWindow] ERROR: File resolution failed for '" << filePath << "'" << std::endl;
                 mainWindow_->loadHTMLString("<html><body><h1>File not found</h1><p>" + filePath + "</p></body></html>");
             }
+        } else if (htmlMethod == "app") {
+            std::string entry = config.getHtmlAppEntry();
+            std::cout << "[ReloadMainWindow] APP loading, entry: '" << entry << "'" << std::endl;
+            if (asset_bundle::find(entry)) {
+                std::cout << "[ReloadMainWindow] Calling loadURL('" << asset_bundle::url(entry) << "')" << std::endl;
+                mainWindow_->loadURL(asset_bundle::url(entry));
+            } else {
+                std::cout << "[ReloadMainWindow] ERROR: '" << entry << "' is not bundled" << std::endl;
+                mainWindow_->loadHTMLString("<html><body><h1>Error: " + entry + " is not bundled</h1></body></html>");
+            }
         } else {
             std::cout << "[ReloadMainWindow] UNKNOWN method '" << htmlMethod << "', loading default content" << std::endl;
             std::string content = ConfigManager::tryLoadFileContent("demo.html");
@@ -128,7 +140,7 @@ public:
     }
 
     std::vector<std::string> getSupportedTypes() const override {
-        return {"reloadMainWindow"};
+        return handler_types::kReloadMainWindow;
     }
 
 private:
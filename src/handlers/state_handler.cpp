@@ -0,0 +1,90 @@
+#include "../../include/handlers/state_handler.h"
+#include "../../include/handlers/handler_types.h"
+#include "../../include/shared_state_store.h"
+#include "../../include/message_handler.h"
+#include <nlohmann/json.hpp>
+
+// Handler for the shared state store: stateGet, stateSet, stateSubscribe, stateUnsubscribe
+class StateHandler : public MessageHandler {
+public:
+    explicit StateHandler(WebView* webView) : webView_(webView) {}
+
+    bool canHandle(const std::string& messageType) const override {
+        return messageType == "stateGet" || messageType == "stateSet" ||
+               messageType == "stateSubscribe" || messageType == "stateUnsubscribe";
+    }
+
+    nlohmann::json handle(const nlohmann::json& payload, const std::string& requestId) override {
+        (void)requestId;
+        nlohmann::json result;
+
+        if (!payload.contains("key") || !payload["key"].is_string() || payload["key"].get<std::string>().empty()) {
+            result["success"] = false;
+            result["error"] = "Missing or invalid 'key' in payload";
+            return result;
+        }
+        std::string key = payload["key"].get<std::string>();
+
+        std::string op;
+        if (payload.contains("_type") && payload["_type"].is_string()) {
+            op = payload["_type"].get<std::string>();
+        }
+
+        SharedStateStore& store = SharedStateStore::getInstance();
+
+        if (op == "stateSet") {
+            if (!payload.contains("value")) {
+                result["success"] = false;
+                result["error"] = "Missing 'value' in payload for stateSet";
+                return result;
+            }
+            result["success"] = true;
+            result["version"] = store.set(key, payload["value"]);
+            return result;
+        }
+
+        if (op == "stateUnsubscribe") {
+            store.unsubscribe(webView_, key);
+            result["success"] = true;
+            return result;
+        }
+
+        uint64_t sinceVersion = 0;
+        if (payload.contains("sinceVersion") && payload["sinceVersion"].is_number_unsigned()) {
+            sinceVersion = payload["sinceVersion"].get<uint64_t>();
+        }
+
+        SharedStateStore::Delta delta;
+        if (op == "stateSubscribe") {
+            delta = store.subscribe(webView_, key, sinceVersion);
+        } else if (op == "stateGet") {
+            delta = store.getDelta(key, sinceVersion);
+        } else {
+            result["success"] = false;
+            result["error"] = "Unknown operation: " + op;
+            return result;
+        }
+
+        result["success"] = true;
+        result["key"] = key;
+        result["fromVersion"] = delta.fromVersion;
+        result["version"] = delta.version;
+        if (delta.isPatch) {
+            result["patch"] = delta.patch;
+        } else {
+            result["value"] = delta.value;
+        }
+        return result;
+    }
+
+    std::vector<std::string> getSupportedTypes() const override {
+        return handler_types::kState;
+    }
+
+private:
+    WebView* webView_;
+};
+
+std::shared_ptr<MessageHandler> createStateHandler(WebView* webView) {
+    return std::make_shared<StateHandler>(webView);
+}
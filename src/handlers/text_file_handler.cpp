@@ -0,0 +1,361 @@
+#include "../../include/handlers/text_file_handler.h"
+#include "../../include/handlers/handler_types.h"
+#include "../../include/handlers/file_system_handler.h"
+#include "../../include/message_handler.h"
+#include "../../include/file_content_cache.h"
+#include "../../include/line_index.h"
+#include "../../include/thread_pool.h"
+#include "../../include/webview_event_sink.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+// Largest file returned whole by readTextFile unless the request sets maxBytes
+static const uint64_t kDefaultTextBytes = 16ull * 1024 * 1024;
+// Upper bound for maxBytes (the text is copied into the JSON reply whole)
+static const uint64_t kMaxBytesLimit = 64ull * 1024 * 1024;
+// readLines defaults and bounds
+static const uint64_t kDefaultLineCount = 1000;
+static const uint64_t kMaxLineCount = 100000;
+static const uint64_t kDefaultLinesBytes = 4ull * 1024 * 1024;
+static const size_t kReadChunk = 256 * 1024;
+// Most readLines scans on the UI thread before leaving the rest of the index to the pool
+static const uint64_t kSyncScanBytes = 8ull * 1024 * 1024;
+
+// Shared between the handler (UI thread) and background indexing (pool threads)
+struct TextSink {
+    std::shared_ptr<WebViewEventSink> events;
+    std::atomic<bool> closed{false};
+};
+
+static bool readUnsigned(const nlohmann::json& payload, const char* key, uint64_t& value, std::string& error) {
+    if (!payload.contains(key)) {
+        return true;
+    }
+    const nlohmann::json& v = payload[key];
+    if (v.is_number_unsigned() || (v.is_number_integer() && v.get<int64_t>() >= 0)) {
+        value = v.get<uint64_t>();
+        return true;
+    }
+    error = std::string("Invalid '") + key + "' in payload (expect a non-negative integer)";
+    return false;
+}
+
+// Handler for text files.
+//   readTextFile: path, maxBytes (default 16 MiB). Whole file as a UTF-8 string: a UTF-8 BOM
+//                 is dropped, UTF-16/32 is refused, invalid sequences become U+FFFD (counted in
+//                 invalidUtf8). Larger files fail with rangeRequired and totalSize.
+//   readLines:    path, start (0-based line, default 0), count (default 1000), maxBytes (default
+//                 4 MiB of text). Replies { lines, start, nextLine, eof, truncated, invalidUtf8,
+//                 size, linesIndexed, complete, totalLines (once complete) }. Lines exclude
+//                 "\n" / "\r\n"; a single line longer than maxBytes is cut and truncated is set.
+// Lines are located through a sparse LineIndex (one offset per 256 lines) that is built by a
+// vectorized newline scan as far as a request needs and shared by later requests; appends to
+// the file only scan the new bytes. The rest of the file is indexed in the background, ending
+// with "lines:indexed" { path, totalLines, size } so a viewer can size its scrollbar.
+// A request scans at most 8 MiB itself: when start lies further in, it replies at once with no
+// lines and indexing: true, and the page asks again after "lines:indexed". Past a cut line it
+// reads at most as far, leaving the line's end to the index.
+class TextFileHandler : public MessageHandler {
+public:
+    explicit TextFileHandler(WebView* webView) : sink_(std::make_shared<TextSink>()) {
+        sink_->events = std::make_shared<WebViewEventSink>(webView);
+    }
+
+    ~TextFileHandler() override {
+        sink_->events->detach();
+        sink_->closed = true;
+    }
+
+    bool canHandle(const std::string& messageType) const override {
+        return messageType == "readTextFile" || messageType == "readLines";
+    }
+
+    nlohmann::json handle(const nlohmann::json& payload, const std::string& requestId) override {
+        (void)requestId;
+        nlohmann::json result;
+
+        if (!payload.contains("path") || !payload["path"].is_string()) {
+            result["success"] = false;
+            result["error"] = "Missing or invalid 'path' in payload";
+            return result;
+        }
+        std::string path = payload["path"].get<std::string>();
+        std::string resolved = resolveSandboxedPath(path, fs::current_path());
+        if (path.empty() || resolved.empty()) {
+            result["success"] = false;
+            result["error"] = "Invalid or disallowed path";
+            return result;
+        }
+
+        if (payload.contains("_type") && payload["_type"] == "readLines") {
+            return readLines(payload, path, resolved);
+        }
+        return readTextFile(payload, resolved);
+    }
+
+    std::vector<std::string> getSupportedTypes() const override {
+        return handler_types::kTextFile;
+    }
+
+private:
+    static nlohmann::json readTextFile(const nlohmann::json& payload, const std::string& resolved) {
+        nlohmann::json result;
+        uint64_t maxBytes = kDefaultTextBytes;
+        std::string error;
+        if (!readUnsigned(payload, "maxBytes", maxBytes, error)) {
+            result["success"] = false;
+            result["error"] = error;
+            return result;
+        }
+        maxBytes = std::min(maxBytes, kMaxBytesLimit);
+
+        std::error_code ec;
+        fs::path file = fs::u8path(resolved);
+        fs::file_status status = fs::status(file, ec);
+        if (ec || !fs::exists(status)) {
+            result["success"] = false;
+            result["error"] = "File does not exist";
+            return result;
+        }
+        if (!fs::is_regular_file(status)) {
+            result["success"] = false;
+            result["error"] = "Not a file";
+            return result;
+        }
+        uint64_t totalSize = fs::file_size(file, ec);
+        if (totalSize > maxBytes) {
+            result["success"] = false;
+            result["error"] = "File is " + std::to_string(totalSize) + " bytes, over the readTextFile limit of " +
+                              std::to_string(maxBytes) + " bytes; use readLines";
+            result["rangeRequired"] = true;
+            result["totalSize"] = totalSize;
+            return result;
+        }
+
+        // Small files come from the shared cache; others are read once into a string
+        FileContentCache::Bytes cached;
+        std::string content;
+        const char* data = nullptr;
+        size_t size = 0;
+        if (totalSize <= FileContentCache::getInstance().maxEntryBytes()) {
+            cached = FileContentCache::getInstance().get(resolved, error);
+            if (!cached) {
+                result["success"] = false;
+                result["error"] = error;
+                return result;
+            }
+            data = reinterpret_cast<const char*>(cached->data());
+            size = cached->size();
+        } else {
+            std::ifstream in(file, std::ios::binary);
+            content.resize(static_cast<size_t>(totalSize));
+            if (!in.is_open() || !in.read(&content[0], static_cast<std::streamsize>(content.size()))) {
+                result["success"] = false;
+                result["error"] = "Failed to read file: " + resolved;
+                return result;
+            }
+            data = content.data();
+            size = content.size();
+        }
+
+        size_t skip = 0;
+        if (size >= 3 && std::memcmp(data, "\xEF\xBB\xBF", 3) == 0) {
+            skip = 3;
+        } else if (size >= 2 && (std::memcmp(data, "\xFF\xFE", 2) == 0 || std::memcmp(data, "\xFE\xFF", 2) == 0)) {
+            result["success"] = false;
+            result["error"] = "UTF-16/UTF-32 text is not supported (expect UTF-8)";
+            return result;
+        }
+        std::string text;
+        size_t invalid = line_scan::sanitizeUtf8(data + skip, size - skip, text);
+
+        result["success"] = true;
+        result["text"] = std::move(text);
+        result["size"] = size;
+        result["invalidUtf8"] = invalid;
+        return result;
+    }
+
+    nlohmann::json readLines(const nlohmann::json& payload, const std::string& path, const std::string& resolved) {
+        nlohmann::json result;
+        uint64_t start = 0, count = kDefaultLineCount, maxBytes = kDefaultLinesBytes;
+        std::string error;
+        if (!readUnsigned(payload, "start", start, error) || !readUnsigned(payload, "count", count, error) ||
+            !readUnsigned(payload, "maxBytes", maxBytes, error)) {
+            result["success"] = false;
+            result["error"] = error;
+            return result;
+        }
+        if (count == 0 || count > kMaxLineCount) {
+            result["success"] = false;
+            result["error"] = "'count' must be between 1 and " + std::to_string(kMaxLineCount);
+            return result;
+        }
+        maxBytes = std::max<uint64_t>(1, std::min(maxBytes, kMaxBytesLimit));
+
+        std::shared_ptr<LineIndex> index = LineIndex::forFile(resolved, error);
+        uint64_t offset = 0;
+        bool found = false;
+        if (index && index->extendTo(start, error, nullptr, kSyncScanBytes)) {
+            found = index->lineOffset(start, offset, error);
+        }
+        if (!index || (!found && !error.empty())) {
+            result["success"] = false;
+            result["error"] = error;
+            return result;
+        }
+        LineIndex::Status status = index->status();
+        if (!found && !status.complete) {
+            // Too far in to scan on the UI thread
+            result["success"] = true;
+            result["lines"] = nlohmann::json::array();
+            result["start"] = start;
+            result["nextLine"] = start;
+            result["eof"] = false;
+            result["indexing"] = true;
+            result["size"] = status.size;
+            result["linesIndexed"] = status.linesIndexed;
+            result["complete"] = false;
+            indexInBackground(index, path);
+            return result;
+        }
+
+        nlohmann::json lines = nlohmann::json::array();
+        bool eof = true;
+        bool truncated = false;
+        size_t invalid = 0;
+        if (found) {
+            std::ifstream file(fs::u8path(resolved), std::ios::binary);
+            if (!file.is_open()) {
+                result["success"] = false;
+                result["error"] = "Failed to open file: " + resolved;
+                return result;
+            }
+            file.seekg(static_cast<std::streamoff>(offset));
+
+            std::vector<char> buffer(kReadChunk);
+            std::string current;
+            std::string sanitized;
+            uint64_t bytes = 0;        // text in lines so far
+            uint64_t pos = offset;     // file offset of buffer[0]
+            uint64_t next = offset;    // start of the first line not returned
+            bool skipping = false;     // dropping the rest of a cut line
+            uint64_t cutAt = 0;        // file offset where the dropping began
+            bool stop = false;
+            bool reachedEnd = false;
+            auto pushLine = [&]() {
+                if (!current.empty() && current.back() == '\r') current.pop_back();
+                invalid += line_scan::sanitizeUtf8(current.data(), current.size(), sanitized);
+                bytes += sanitized.size();
+                lines.push_back(std::move(sanitized));
+                current.clear();
+                skipping = false;
+            };
+            while (!stop) {
+                file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                size_t got = static_cast<size_t>(file.gcount());
+                if (got == 0) {
+                    reachedEnd = true;
+                    if (pos > next) {  // last line, without '\n'
+                        pushLine();
+                        next = pos;
+                    }
+                    break;
+                }
+                size_t i = 0;
+                while (i < got) {
+                    const char* nl = static_cast<const char*>(std::memchr(buffer.data() + i, '\n', got - i));
+                    size_t end = nl ? static_cast<size_t>(nl - buffer.data()) : got;
+                    if (!skipping) {
+                        uint64_t room = maxBytes - std::min(maxBytes, bytes + current.size());
+                        if (end - i > room) {
+                            if (!lines.empty()) {
+                                stop = true;  // the line does not fit: it starts the next page
+                                break;
+                            }
+                            current.append(buffer.data() + i, static_cast<size_t>(room));
+                            skipping = truncated = true;
+                            cutAt = pos + i + room;
+                        } else {
+                            current.append(buffer.data() + i, end - i);
+                        }
+                    }
+                    if (!nl && skipping && pos + got - cutAt >= kSyncScanBytes) {
+                        // The rest of the line is left to the index: the next request finds
+                        // the line after it through lineOffset
+                        pushLine();
+                        stop = true;
+                        break;
+                    }
+                    if (!nl) break;
+                    pushLine();
+                    i = end + 1;
+                    next = pos + i;
+                    if (lines.size() >= count || truncated) {
+                        stop = true;
+                        break;
+                    }
+                }
+                pos += got;
+            }
+            eof = reachedEnd || next >= status.size;
+            if (eof && !status.complete && status.size - status.bytesIndexed <= kSyncScanBytes) {
+                // Only the lines just read are left to scan
+                std::string ignored;
+                index->extendToEnd(ignored);
+                status = index->status();
+            }
+        }
+
+        result["success"] = true;
+        result["lines"] = std::move(lines);
+        result["start"] = start;
+        result["nextLine"] = start + result["lines"].size();
+        result["eof"] = eof;
+        result["truncated"] = truncated;
+        result["invalidUtf8"] = invalid;
+        result["size"] = status.size;
+        result["linesIndexed"] = status.linesIndexed;
+        result["complete"] = status.complete;
+        if (status.complete) {
+            result["totalLines"] = status.totalLines;
+        } else {
+            indexInBackground(index, path);
+        }
+        return result;
+    }
+
+    // Finish the index on the pool (one task per index) and announce the line count
+    void indexInBackground(const std::shared_ptr<LineIndex>& index, const std::string& path) {
+        if (!index->claimBackground()) {
+            return;
+        }
+        std::shared_ptr<TextSink> sink = sink_;
+        ThreadPool::getInstance().submit([index, sink, path]() {
+            std::string error;
+            bool ok = index->extendToEnd(error, &sink->closed);
+            index->releaseBackground();
+            if (!ok) {
+                return;
+            }
+            LineIndex::Status status = index->status();
+            nlohmann::json indexed;
+            indexed["path"] = path;
+            indexed["totalLines"] = status.totalLines;
+            indexed["size"] = status.size;
+            sink->events->emit("lines:indexed", std::move(indexed));
+        });
+    }
+
+    std::shared_ptr<TextSink> sink_;
+};
+
+std::shared_ptr<MessageHandler> createTextFileHandler(WebView* webView) {
+    return std::make_shared<TextFileHandler>(webView);
+}
@@ -0,0 +1,192 @@
+#include "../../include/handlers/thumbnail_handler.h"
+#include "../../include/handlers/handler_types.h"
+#include "../../include/handlers/file_system_handler.h"
+#include "../../include/message_handler.h"
+#include "../../include/thumbnail_cache.h"
+#include "../../include/base64.h"
+#include "../../include/thread_pool.h"
+#include "../../include/handler_jobs.h"
+#include "../platform/platform_impl.h"
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+static const int kDefaultSize = 256;
+static const int kMinSize = 16;
+static const int kMaxSize = 1024;
+static const size_t kMaxFilesPerJob = 4096;
+
+struct ThumbnailJob {
+    std::string id;
+    int size = kDefaultSize;
+    std::vector<std::string> paths;     // as requested
+    std::vector<std::string> resolved;  // empty: rejected by the sandbox
+    std::shared_ptr<HandlerJobs<ThumbnailJob>> jobs;
+    std::shared_ptr<ThumbnailCache> cache;
+    std::chrono::steady_clock::time_point started;
+    std::atomic<bool> cancelled{false};
+    std::atomic<size_t> filesDone{0};
+    std::atomic<size_t> cacheHits{0};
+    std::atomic<size_t> failures{0};
+
+    int64_t elapsedMs() const {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started).count();
+    }
+};
+
+static void finishJob(const std::shared_ptr<ThumbnailJob>& job) {
+    nlohmann::json done;
+    done["jobId"] = job->id;
+    done["count"] = job->paths.size();
+    done["cached"] = job->cacheHits.load();
+    done["failed"] = job->failures.load();
+    done["cancelled"] = job->cancelled.load();
+    done["elapsedMs"] = job->elapsedMs();
+    job->jobs->finish(*job, "thumbnail:done", std::move(done));
+}
+
+// Cache hit, or decode + store; one "thumbnail:ready" per file either way
+static void thumbnailEntry(const std::shared_ptr<ThumbnailJob>& job, size_t index) {
+    nlohmann::json ready;
+    ready["jobId"] = job->id;
+    ready["path"] = job->paths[index];
+    const std::string& resolved = job->resolved[index];
+    std::string error;
+    std::string key;
+    Thumbnail thumbnail;
+    bool cached = false;
+    if (job->cancelled) {
+        error = "Cancelled";
+    } else if (resolved.empty()) {
+        error = "Invalid or disallowed path";
+    } else if (ThumbnailCache::key(resolved, job->size, key, error)) {
+        cached = job->cache->lookup(key, thumbnail);
+        if (!cached && platform::createThumbnail(resolved, job->size, thumbnail.data, thumbnail.mimeType,
+                                                 thumbnail.width, thumbnail.height, error)) {
+            job->cache->store(key, thumbnail);
+        }
+    }
+
+    if (cached || error.empty()) {
+        ready["data"] = base64::encode(thumbnail.data);
+        ready["mimeType"] = thumbnail.mimeType;
+        ready["width"] = thumbnail.width;
+        ready["height"] = thumbnail.height;
+        ready["cached"] = cached;
+        if (cached) {
+            ++job->cacheHits;
+        }
+    } else {
+        ready["error"] = error;
+        ++job->failures;
+    }
+    job->jobs->emit("thumbnail:ready", std::move(ready));
+    if (++job->filesDone == job->paths.size()) {
+        finishJob(job);
+    }
+}
+
+// Handler for native image thumbnails.
+//   thumbnail:       path or paths (array), size (longest side in pixels, default 256)
+//   cancelThumbnail: jobId
+// thumbnail replies at once with { jobId, count }. Each file is decoded (scaled while
+// decoding where the format allows), re-encoded as JPEG (PNG when it has alpha) and cached
+// on disk, so the next request for an unchanged file costs one small read. Every file
+// produces "thumbnail:ready" { jobId, path, data (base64), mimeType, width, height, cached }
+// or { jobId, path, error }; "thumbnail:done" { jobId, count, cached, failed, cancelled,
+// elapsedMs } ends the job.
+class ThumbnailHandler : public MessageHandler {
+public:
+    ThumbnailHandler(WebView* webView, const std::string& cacheDirectory)
+        : jobs_(std::make_shared<HandlerJobs<ThumbnailJob>>(webView, "thumb")),
+          cache_(ThumbnailCache::forDirectory(cacheDirectory)) {}
+
+    ~ThumbnailHandler() override {
+        jobs_->close();
+    }
+
+    bool canHandle(const std::string& messageType) const override {
+        return messageType == "thumbnail" || messageType == "cancelThumbnail";
+    }
+
+    nlohmann::json handle(const nlohmann::json& payload, const std::string& requestId) override {
+        (void)requestId;
+        nlohmann::json result;
+        std::string op;
+        if (payload.contains("_type") && payload["_type"].is_string()) {
+            op = payload["_type"].get<std::string>();
+        }
+
+        if (op == "cancelThumbnail") {
+            return jobs_->cancel(payload);
+        }
+
+        auto job = std::make_shared<ThumbnailJob>();
+        if (payload.contains("size")) {
+            const nlohmann::json& size = payload["size"];
+            if (!size.is_number_integer() || size.get<int64_t>() < kMinSize || size.get<int64_t>() > kMaxSize) {
+                result["success"] = false;
+                result["error"] = "Invalid 'size' in payload (expect " + std::to_string(kMinSize) + "-" +
+                                  std::to_string(kMaxSize) + " pixels)";
+                return result;
+            }
+            job->size = size.get<int>();
+        }
+
+        if (payload.contains("paths")) {
+            if (!payload["paths"].is_array() || payload["paths"].empty() || payload["paths"].size() > kMaxFilesPerJob) {
+                result["success"] = false;
+                result["error"] = "Invalid 'paths' in payload (expect 1-" + std::to_string(kMaxFilesPerJob) + " paths)";
+                return result;
+            }
+            for (const auto& p : payload["paths"]) {
+                if (!p.is_string()) {
+                    result["success"] = false;
+                    result["error"] = "Invalid 'paths' in payload (expect strings)";
+                    return result;
+                }
+                job->paths.push_back(p.get<std::string>());
+            }
+        } else if (payload.contains("path") && payload["path"].is_string()) {
+            job->paths.push_back(payload["path"].get<std::string>());
+        } else {
+            result["success"] = false;
+            result["error"] = "Missing or invalid 'path' in payload";
+            return result;
+        }
+
+        fs::path base = fs::current_path();
+        for (const auto& path : job->paths) {
+            job->resolved.push_back(resolveSandboxedPath(path, base));
+        }
+
+        job->jobs = jobs_;
+        job->cache = cache_;
+        job->started = std::chrono::steady_clock::now();
+        jobs_->add(job);
+        ThreadPool& pool = ThreadPool::getInstance();
+        for (size_t i = 0; i < job->paths.size(); ++i) {
+            pool.submit([job, i]() { thumbnailEntry(job, i); });
+        }
+
+        result["success"] = true;
+        result["jobId"] = job->id;
+        result["count"] = job->paths.size();
+        return result;
+    }
+
+    std::vector<std::string> getSupportedTypes() const override {
+        return handler_types::kThumbnail;
+    }
+
+private:
+    std::shared_ptr<HandlerJobs<ThumbnailJob>> jobs_;
+    std::shared_ptr<ThumbnailCache> cache_;
+};
+
+std::shared_ptr<MessageHandler> createThumbnailHandler(WebView* webView, const std::string& cacheDirectory) {
+    return std::make_shared<ThumbnailHandler>(webView, cacheDirectory);
+}
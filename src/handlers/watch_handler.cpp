@@ -0,0 +1,139 @@
+#include "../../include/handlers/watch_handler.h"
+#include "../../include/handlers/handler_types.h"
+#include "../../include/handlers/file_system_handler.h"
+#include "../../include/message_handler.h"
+#include "../../include/file_watcher.h"
+#include "../../include/webview_event_sink.h"
+#include <nlohmann/json.hpp>
+#include <filesystem>
+#include <map>
+
+namespace fs = std::filesystem;
+
+static const int kDefaultDebounceMs = 100;
+static const int kMaxDebounceMs = 10000;
+static const size_t kMaxWatchesPerWindow = 256;
+
+// Handler for watchPath / unwatch.
+//   watchPath: path (file or directory, sandboxed like listDir), debounceMs (default 100)
+//              -> { watchId }
+//   unwatch:   watchId
+// Changes arrive as "file:changed" { watchId, path, changes: [ { path, kind } ], overflow? }.
+// A directory watch reports its direct children; kind is created, modified or deleted.
+// overflow means events were lost and the page should re-read the path.
+class WatchHandler : public MessageHandler {
+public:
+    explicit WatchHandler(WebView* webView) : events_(std::make_shared<WebViewEventSink>(webView)) {}
+
+    ~WatchHandler() override {
+        events_->detach();
+        for (const auto& entry : watches_) {
+            FileWatcher::getInstance().unwatch(entry.second);
+        }
+    }
+
+    bool canHandle(const std::string& messageType) const override {
+        return messageType == "watchPath" || messageType == "unwatch";
+    }
+
+    nlohmann::json handle(const nlohmann::json& payload, const std::string& requestId) override {
+        (void)requestId;
+        nlohmann::json result;
+        std::string op;
+        if (payload.contains("_type") && payload["_type"].is_string()) {
+            op = payload["_type"].get<std::string>();
+        }
+
+        if (op == "unwatch") {
+            if (!payload.contains("watchId") || !payload["watchId"].is_string()) {
+                result["success"] = false;
+                result["error"] = "Missing or invalid 'watchId' in payload";
+                return result;
+            }
+            auto it = watches_.find(payload["watchId"].get<std::string>());
+            if (it == watches_.end()) {
+                result["success"] = false;
+                result["error"] = "Unknown watchId";
+                return result;
+            }
+            FileWatcher::getInstance().unwatch(it->second);
+            watches_.erase(it);
+            result["success"] = true;
+            return result;
+        }
+
+        if (!payload.contains("path") || !payload["path"].is_string()) {
+            result["success"] = false;
+            result["error"] = "Missing or invalid 'path' in payload";
+            return result;
+        }
+        std::string path = payload["path"].get<std::string>();
+        std::string resolved = resolveSandboxedPath(path, fs::current_path());
+        if (resolved.empty()) {
+            result["success"] = false;
+            result["error"] = "Invalid or disallowed path";
+            return result;
+        }
+        int debounceMs = kDefaultDebounceMs;
+        if (payload.contains("debounceMs")) {
+            if (!payload["debounceMs"].is_number_integer() || payload["debounceMs"].get<int64_t>() < 0 ||
+                payload["debounceMs"].get<int64_t>() > kMaxDebounceMs) {
+                result["success"] = false;
+                result["error"] = "Invalid 'debounceMs' in payload (0-" + std::to_string(kMaxDebounceMs) + ")";
+                return result;
+            }
+            debounceMs = payload["debounceMs"].get<int>();
+        }
+        if (watches_.size() >= kMaxWatchesPerWindow) {
+            result["success"] = false;
+            result["error"] = "Too many watches";
+            return result;
+        }
+
+        std::string watchId = "watch-" + std::to_string(++nextWatchId_);
+        std::error_code ec;
+        bool isDirectory = fs::is_directory(resolved, ec);
+        std::shared_ptr<WebViewEventSink> events = events_;
+        auto callback = [events, watchId, path, isDirectory](const std::vector<FileWatcher::Change>& changes,
+                                                           bool overflow) {
+            nlohmann::json event;
+            event["watchId"] = watchId;
+            event["path"] = path;
+            event["changes"] = nlohmann::json::array();
+            for (const auto& change : changes) {
+                std::string changed = path;
+                if (isDirectory && !change.name.empty()) {
+                    changed += (changed.empty() || changed.back() == '/') ? change.name : "/" + change.name;
+                }
+                event["changes"].push_back({{"path", changed}, {"kind", FileWatcher::kindName(change.kind)}});
+            }
+            if (overflow) event["overflow"] = true;
+            events->emit("file:changed", std::move(event));
+        };
+
+        std::string error;
+        uint64_t id = FileWatcher::getInstance().watch(resolved, debounceMs, callback, error);
+        if (id == 0) {
+            result["success"] = false;
+            result["error"] = error;
+            return result;
+        }
+        watches_[watchId] = id;
+        result["success"] = true;
+        result["watchId"] = watchId;
+        return result;
+    }
+
+    std::vector<std::string> getSupportedTypes() const override {
+        return handler_types::kWatch;
+    }
+
+private:
+    std::shared_ptr<WebViewEventSink> events_;
+    std::map<std::string, uint64_t> watches_;  // watchId -> FileWatcher id
+    uint64_t nextWatchId_ = 0;
+};
+
+std::shared_ptr<MessageHandler> createWatchHandler(WebView* webView) {
+    return std::make_shared<WatchHandler>(webView);
+}
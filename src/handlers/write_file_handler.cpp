@@ -1,76 +1,420 @@
 #include "../../include/message_handler.h"
+#include "../../include/handlers/handler_types.h"
+#include "../../include/handlers/file_system_handler.h"
 #include "../../include/base64.h"
+#include "../../include/file_content_cache.h"
 #include <nlohmann/json.hpp>
 #include <iostream>
-#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <map>
 #include <vector>
 
-// Handler for writing binary data to files
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+// Temp file next to the target, so the final rename never crosses filesystems.
+// Opened exclusively; a crash leaves only a dot-file behind, never a truncated target.
+// A symlinked target is written through (the temp file goes next to the file it points to),
+// and a hard-linked one is rewritten in place at commit so its other names see the data.
+struct PendingWrite {
+    fs::path requested;  // as named by the caller
+    fs::path target;     // the file written: requested with symlinks followed
+    fs::path temp;
+    bool inPlace = false;
+    int fd = -1;
+    uint64_t bytesWritten = 0;
+    bool fsync = false;
+};
+
+static std::string lastError() {
+    return std::strerror(errno);
+}
+
+// Follows symlinks, dangling ones included (the write creates the file they point to)
+static fs::path resolveTarget(const fs::path& requested) {
+    fs::path current = requested;
+    for (int hop = 0; hop < 40; ++hop) {
+        std::error_code ec;
+        if (!fs::is_symlink(fs::symlink_status(current, ec))) break;
+        fs::path link = fs::read_symlink(current, ec);
+        if (ec) break;
+        current = link.is_absolute() ? link : current.parent_path() / link;
+    }
+    return current.lexically_normal();
+}
+
+static bool openTemp(const std::string& path, bool fsync, PendingWrite& pending, std::string& error) {
+    fs::path requested = fs::u8path(path);
+    if (!requested.has_filename()) {
+        error = "Path must name a file: " + path;
+        return false;
+    }
+    fs::path target = resolveTarget(requested);
+    bool inPlace = false;
+    for (int attempt = 0; attempt < 8; ++attempt) {
+        fs::path temp = hiddenSibling(target, ".tmp");
+#ifdef _WIN32
+        int fd = _wopen(temp.c_str(), _O_WRONLY | _O_CREAT | _O_EXCL | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+        int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+#endif
+        if (fd < 0) {
+            if (errno == EEXIST) continue;
+            error = "Failed to open file for writing: " + path + " (" + lastError() + ")";
+            return false;
+        }
+#ifndef _WIN32
+        // Replacing a file keeps its permissions; renaming over a hard link would split it
+        struct stat st;
+        if (::stat(target.c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
+            ::fchmod(fd, st.st_mode & 07777);
+            inPlace = st.st_nlink > 1;
+        }
+#endif
+        pending.requested = requested;
+        pending.target = target;
+        pending.inPlace = inPlace;
+        pending.temp = temp;
+        pending.fd = fd;
+        pending.bytesWritten = 0;
+        pending.fsync = fsync;
+        return true;
+    }
+    error = "Failed to create a temporary file for: " + path;
+    return false;
+}
+
+static bool writeAll(PendingWrite& pending, const unsigned char* data, size_t size, std::string& error) {
+    while (size > 0) {
+#ifdef _WIN32
+        unsigned int n = static_cast<unsigned int>(std::min<size_t>(size, 1u << 30));
+        int written = _write(pending.fd, data, n);
+#else
+        ssize_t written = ::write(pending.fd, data, size);
+        if (written < 0 && errno == EINTR) continue;
+#endif
+        if (written <= 0) {
+            error = "Failed to write file: " + pending.target.u8string() + " (" + lastError() + ")";
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+        pending.bytesWritten += static_cast<uint64_t>(written);
+    }
+    return true;
+}
+
+static void discard(PendingWrite& pending) {
+    if (pending.fd >= 0) {
+#ifdef _WIN32
+        _close(pending.fd);
+#else
+        ::close(pending.fd);
+#endif
+        pending.fd = -1;
+    }
+    std::error_code ec;
+    fs::remove(pending.temp, ec);
+}
+
+#ifndef _WIN32
+// Copies the finished temp file over the target's own inode, for targets with other names
+static bool copyInto(const PendingWrite& pending, std::string& error) {
+    int in = ::open(pending.temp.c_str(), O_RDONLY | O_CLOEXEC);
+    int out = in < 0 ? -1 : ::open(pending.target.c_str(), O_WRONLY | O_TRUNC | O_CLOEXEC);
+    bool ok = in >= 0 && out >= 0;
+    char buffer[64 * 1024];
+    while (ok) {
+        ssize_t n = ::read(in, buffer, sizeof(buffer));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            ok = n == 0;
+            break;
+        }
+        for (ssize_t done = 0; ok && done < n;) {
+            ssize_t written = ::write(out, buffer + done, static_cast<size_t>(n - done));
+            if (written < 0 && errno == EINTR) continue;
+            ok = written > 0;
+            if (ok) done += written;
+        }
+    }
+    if (ok && pending.fsync && ::fsync(out) != 0) ok = false;
+    if (!ok) error = "Failed to replace file: " + pending.target.u8string() + " (" + lastError() + ")";
+    if (out >= 0 && ::close(out) != 0 && ok) {
+        error = "Failed to replace file: " + pending.target.u8string() + " (" + lastError() + ")";
+        ok = false;
+    }
+    if (in >= 0) ::close(in);
+    return ok;
+}
+#endif
+
+// Flush (optionally to disk), close and rename over the target. On failure the temp file is removed.
+static bool commitTemp(PendingWrite& pending, std::string& error) {
+    bool ok = true;
+#ifdef _WIN32
+    if (pending.fsync && _commit(pending.fd) != 0) ok = false;
+    if (_close(pending.fd) != 0) ok = false;
+#else
+    if (pending.fsync && ::fsync(pending.fd) != 0) ok = false;
+    if (::close(pending.fd) != 0) ok = false;
+#endif
+    pending.fd = -1;
+    if (!ok) {
+        error = "Failed to flush file: " + pending.target.u8string() + " (" + lastError() + ")";
+        discard(pending);
+        return false;
+    }
+    std::error_code ec;
+#ifndef _WIN32
+    if (pending.inPlace) {
+        ok = copyInto(pending, error);
+        FileContentCache::getInstance().invalidate(pending.target.u8string());
+        FileContentCache::getInstance().invalidate(pending.requested.u8string());
+        discard(pending);
+        return ok;
+    }
+#endif
+    fs::rename(pending.temp, pending.target, ec);
+    FileContentCache::getInstance().invalidate(pending.target.u8string());
+    FileContentCache::getInstance().invalidate(pending.requested.u8string());
+    if (ec) {
+        error = "Failed to replace file: " + pending.target.u8string() + " (" + ec.message() + ")";
+        discard(pending);
+        return false;
+    }
+#ifndef _WIN32
+    if (pending.fsync) {
+        // Persist the rename itself
+        fs::path dir = pending.target.parent_path();
+        int dirFd = ::open(dir.empty() ? "." : dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (dirFd >= 0) {
+            ::fsync(dirFd);
+            ::close(dirFd);
+        }
+    }
+#endif
+    return true;
+}
+
+static bool wantsFsync(const nlohmann::json& payload) {
+    return payload.contains("fsync") && payload["fsync"].is_boolean() && payload["fsync"].get<bool>();
+}
+
+static std::string base64Field(const nlohmann::json& payload) {
+    if (payload.contains("data")) {
+        if (payload["data"].is_string()) {
+            return payload["data"].get<std::string>();
+        } else if (payload["data"].contains("__base64") && payload["data"]["__base64"].is_string()) {
+            return payload["data"]["__base64"].get<std::string>();
+        }
+    }
+    return std::string();
+}
+
+// Handler for writing binary data to files. Writes are atomic: data goes to a temp file in the
+// target directory that is renamed over the target only once complete. Symlinks are written
+// through; a file with several hard links is overwritten in place at commit instead.
+//   writeFile                     - whole file in one base64 payload
+//   openWrite / appendChunk /
+//   commitWrite / abortWrite      - streamed session; memory is bounded by the chunk size
 class WriteFileHandler : public MessageHandler {
 public:
+    ~WriteFileHandler() override {
+        // Sessions die with the WebView that opened them
+        for (auto& entry : sessions_) {
+            discard(entry.second);
+        }
+    }
+
     bool canHandle(const std::string& messageType) const override {
-        return messageType == "writeFile";
+        return messageType == "writeFile" || messageType == "openWrite" || messageType == "appendChunk" ||
+               messageType == "commitWrite" || messageType == "abortWrite";
     }
 
     nlohmann::json handle(const nlohmann::json& payload, const std::string& requestId) override {
         (void)requestId;
+        std::string op = "writeFile";
+        if (payload.contains("_type") && payload["_type"].is_string()) {
+            op = payload["_type"].get<std::string>();
+        }
+        if (op == "openWrite") return openWrite(payload);
+        if (op == "appendChunk") return appendChunk(payload);
+        if (op == "commitWrite" || op == "abortWrite") return finishWrite(payload, op == "commitWrite");
+        return writeFile(payload);
+    }
+
+    std::vector<std::string> getSupportedTypes() const override {
+        return handler_types::kWriteFile;
+    }
+
+private:
+    nlohmann::json writeFile(const nlohmann::json& payload) {
         nlohmann::json result;
+        std::string path;
+        if (!readPath(payload, path, result)) {
+            return result;
+        }
 
-        if (!payload.contains("path") || !payload["path"].is_string()) {
+        std::string base64Data = base64Field(payload);
+        if (base64Data.empty()) {
             result["success"] = false;
-            result["error"] = "Missing or invalid 'path' in payload";
+            result["error"] = "Missing or invalid 'data' in payload (expect base64 string or { __base64: '...' })";
             return result;
         }
 
-        std::string path = payload["path"].get<std::string>();
-        if (path.empty()) {
+        std::vector<unsigned char> buffer = base64::decode(base64Data);
+        if (buffer.empty() && !base64Data.empty()) {
             result["success"] = false;
-            result["error"] = "Path cannot be empty";
+            result["error"] = "Invalid base64 data";
             return result;
         }
 
-        std::string base64Data;
-        if (payload.contains("data")) {
-            if (payload["data"].is_string()) {
-                base64Data = payload["data"].get<std::string>();
-            } else if (payload["data"].contains("__base64") && payload["data"]["__base64"].is_string()) {
-                base64Data = payload["data"]["__base64"].get<std::string>();
-            }
+        PendingWrite pending;
+        std::string error;
+        if (!openTemp(path, wantsFsync(payload), pending, error) ||
+            !writeAll(pending, buffer.data(), buffer.size(), error) || !commitTemp(pending, error)) {
+            discard(pending);
+            result["success"] = false;
+            result["error"] = error;
+            return result;
         }
-        if (base64Data.empty()) {
+
+        result["success"] = true;
+        result["bytesWritten"] = static_cast<int64_t>(buffer.size());
+        return result;
+    }
+
+    nlohmann::json openWrite(const nlohmann::json& payload) {
+        nlohmann::json result;
+        std::string path;
+        if (!readPath(payload, path, result)) {
+            return result;
+        }
+
+        PendingWrite pending;
+        std::string error;
+        if (!openTemp(path, wantsFsync(payload), pending, error)) {
             result["success"] = false;
-            result["error"] = "Missing or invalid 'data' in payload (expect base64 string or { __base64: '...' })";
+            result["error"] = error;
+            return result;
+        }
+        std::string sessionId = "write-" + std::to_string(++nextSessionId_);
+        sessions_.emplace(sessionId, std::move(pending));
+
+        result["success"] = true;
+        result["sessionId"] = sessionId;
+        return result;
+    }
+
+    nlohmann::json appendChunk(const nlohmann::json& payload) {
+        nlohmann::json result;
+        PendingWrite* pending = findSession(payload, result);
+        if (!pending) {
             return result;
         }
 
+        std::string base64Data = base64Field(payload);
         std::vector<unsigned char> buffer = base64::decode(base64Data);
         if (buffer.empty() && !base64Data.empty()) {
             result["success"] = false;
             result["error"] = "Invalid base64 data";
             return result;
         }
-
-        std::ofstream file(path, std::ios::binary);
-        if (!file.is_open()) {
+        // Optional offset guards against lost or reordered chunks
+        if (payload.contains("offset") && payload["offset"].is_number_integer() &&
+            payload["offset"].get<int64_t>() != static_cast<int64_t>(pending->bytesWritten)) {
             result["success"] = false;
-            result["error"] = "Failed to open file for writing: " + path;
+            result["error"] = "Chunk offset " + payload["offset"].dump() + " does not match bytes written (" +
+                              std::to_string(pending->bytesWritten) + ")";
             return result;
         }
 
-        if (!file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()))) {
+        std::string error;
+        if (!writeAll(*pending, buffer.data(), buffer.size(), error)) {
+            // The session is unusable after a partial write
+            discard(*pending);
+            sessions_.erase(payload["sessionId"].get<std::string>());
             result["success"] = false;
-            result["error"] = "Failed to write file: " + path;
+            result["error"] = error;
             return result;
         }
 
         result["success"] = true;
-        result["bytesWritten"] = static_cast<int64_t>(buffer.size());
+        result["bytesWritten"] = static_cast<int64_t>(pending->bytesWritten);
         return result;
     }
 
-    std::vector<std::string> getSupportedTypes() const override {
-        return {"writeFile"};
+    nlohmann::json finishWrite(const nlohmann::json& payload, bool commit) {
+        nlohmann::json result;
+        PendingWrite* pending = findSession(payload, result);
+        if (!pending) {
+            return result;
+        }
+        PendingWrite session = std::move(*pending);
+        sessions_.erase(payload["sessionId"].get<std::string>());
+
+        if (!commit) {
+            discard(session);
+            result["success"] = true;
+            return result;
+        }
+        std::string error;
+        if (!commitTemp(session, error)) {
+            result["success"] = false;
+            result["error"] = error;
+            return result;
+        }
+        result["success"] = true;
+        result["bytesWritten"] = static_cast<int64_t>(session.bytesWritten);
+        return result;
+    }
+
+    static bool readPath(const nlohmann::json& payload, std::string& path, nlohmann::json& result) {
+        if (!payload.contains("path") || !payload["path"].is_string()) {
+            result["success"] = false;
+            result["error"] = "Missing or invalid 'path' in payload";
+            return false;
+        }
+        path = payload["path"].get<std::string>();
+        if (path.empty()) {
+            result["success"] = false;
+            result["error"] = "Path cannot be empty";
+            return false;
+        }
+        return true;
     }
+
+    PendingWrite* findSession(const nlohmann::json& payload, nlohmann::json& result) {
+        if (!payload.contains("sessionId") || !payload["sessionId"].is_string()) {
+            result["success"] = false;
+            result["error"] = "Missing or invalid 'sessionId' in payload";
+            return nullptr;
+        }
+        auto it = sessions_.find(payload["sessionId"].get<std::string>());
+        if (it == sessions_.end()) {
+            result["success"] = false;
+            result["error"] = "Unknown write session: " + payload["sessionId"].get<std::string>();
+            return nullptr;
+        }
+        return &it->second;
+    }
+
+    std::map<std::string, PendingWrite> sessions_;
+    uint64_t nextSessionId_ = 0;
 };
 
 std::shared_ptr<MessageHandler> createWriteFileHandler() {
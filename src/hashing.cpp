@@ -0,0 +1,447 @@
+#include "../include/hashing.h"
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace hashing {
+
+namespace {
+
+// Both digests read input words little-endian (XXH3) / big-endian (SHA-256) explicitly
+// through these helpers, so the code is independent of the host byte order.
+inline uint64_t readLE64(const unsigned char* p) {
+    return static_cast<uint64_t>(p[0]) | (static_cast<uint64_t>(p[1]) << 8) | (static_cast<uint64_t>(p[2]) << 16) |
+           (static_cast<uint64_t>(p[3]) << 24) | (static_cast<uint64_t>(p[4]) << 32) |
+           (static_cast<uint64_t>(p[5]) << 40) | (static_cast<uint64_t>(p[6]) << 48) |
+           (static_cast<uint64_t>(p[7]) << 56);
+}
+
+inline uint32_t readLE32(const unsigned char* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline uint32_t readBE32(const unsigned char* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+inline uint64_t rotl64(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+inline uint32_t rotr32(uint32_t x, int r) { return (x >> r) | (x << (32 - r)); }
+
+inline uint64_t swap64(uint64_t x) {
+    x = ((x & 0x00000000FFFFFFFFULL) << 32) | (x >> 32);
+    x = ((x & 0x0000FFFF0000FFFFULL) << 16) | ((x >> 16) & 0x0000FFFF0000FFFFULL);
+    return ((x & 0x00FF00FF00FF00FFULL) << 8) | ((x >> 8) & 0x00FF00FF00FF00FFULL);
+}
+
+// 64x64 -> 128 multiply, folded (lo ^ hi)
+inline uint64_t mul128Fold64(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+    __uint128_t product = static_cast<__uint128_t>(a) * b;
+    return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#else
+    uint64_t aLo = a & 0xFFFFFFFF, aHi = a >> 32, bLo = b & 0xFFFFFFFF, bHi = b >> 32;
+    uint64_t loLo = aLo * bLo, hiLo = aHi * bLo, loHi = aLo * bHi, hiHi = aHi * bHi;
+    uint64_t cross = (loLo >> 32) + (hiLo & 0xFFFFFFFF) + loHi;
+    uint64_t upper = (hiLo >> 32) + (cross >> 32) + hiHi;
+    uint64_t lower = (cross << 32) | (loLo & 0xFFFFFFFF);
+    return lower ^ upper;
+#endif
+}
+
+// ---- XXH3 ----
+
+const uint64_t kPrime32_1 = 0x9E3779B1ULL;
+const uint64_t kPrime32_2 = 0x85EBCA77ULL;
+const uint64_t kPrime32_3 = 0xC2B2AE3DULL;
+const uint64_t kPrime64_1 = 0x9E3779B185EBCA87ULL;
+const uint64_t kPrime64_2 = 0xC2B2AE3D27D4EB4FULL;
+const uint64_t kPrime64_3 = 0x165667B19E3779F9ULL;
+const uint64_t kPrime64_4 = 0x85EBCA77C2B2AE63ULL;
+const uint64_t kPrime64_5 = 0x27D4EB2F165667C5ULL;
+const uint64_t kPrimeMx1 = 0x165667919E3779F9ULL;
+const uint64_t kPrimeMx2 = 0x9FB21C651E98DF25ULL;
+
+const size_t kSecretSize = 192;
+const size_t kStripeLen = 64;
+const size_t kStripesPerBlock = (kSecretSize - kStripeLen) / 8;
+const size_t kLastStripeSecretOffset = kSecretSize - kStripeLen - 7;
+const size_t kMergeSecretOffset = 11;
+
+const unsigned char kSecret[kSecretSize] = {
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+    0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+    0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+    0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+    0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+    0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+    0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+    0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+    0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
+
+inline uint64_t xxh64Avalanche(uint64_t h) {
+    h ^= h >> 33;
+    h *= kPrime64_2;
+    h ^= h >> 29;
+    h *= kPrime64_3;
+    return h ^ (h >> 32);
+}
+
+inline uint64_t xxh3Avalanche(uint64_t h) {
+    h ^= h >> 37;
+    h *= kPrimeMx1;
+    return h ^ (h >> 32);
+}
+
+inline uint64_t rrmxmx(uint64_t h, uint64_t len) {
+    h ^= rotl64(h, 49) ^ rotl64(h, 24);
+    h *= kPrimeMx2;
+    h ^= (h >> 35) + len;
+    h *= kPrimeMx2;
+    return h ^ (h >> 28);
+}
+
+inline uint64_t mix16(const unsigned char* input, const unsigned char* secret) {
+    return mul128Fold64(readLE64(input) ^ readLE64(secret), readLE64(input + 8) ^ readLE64(secret + 8));
+}
+
+// Inputs of at most 240 bytes are hashed in one pass, without the stripe accumulators
+uint64_t xxh3Short(const unsigned char* input, size_t len) {
+    const unsigned char* s = kSecret;
+    if (len == 0) {
+        return xxh64Avalanche(readLE64(s + 56) ^ readLE64(s + 64));
+    }
+    if (len <= 3) {
+        uint32_t combined = (static_cast<uint32_t>(input[0]) << 16) | (static_cast<uint32_t>(input[len >> 1]) << 24) |
+                            static_cast<uint32_t>(input[len - 1]) | (static_cast<uint32_t>(len) << 8);
+        uint64_t bitflip = readLE32(s) ^ readLE32(s + 4);
+        return xxh64Avalanche(static_cast<uint64_t>(combined) ^ bitflip);
+    }
+    if (len <= 8) {
+        uint64_t bitflip = readLE64(s + 8) ^ readLE64(s + 16);
+        uint64_t input64 = readLE32(input + len - 4) + (static_cast<uint64_t>(readLE32(input)) << 32);
+        return rrmxmx(input64 ^ bitflip, len);
+    }
+    if (len <= 16) {
+        uint64_t lo = readLE64(input) ^ (readLE64(s + 24) ^ readLE64(s + 32));
+        uint64_t hi = readLE64(input + len - 8) ^ (readLE64(s + 40) ^ readLE64(s + 48));
+        return xxh3Avalanche(len + swap64(lo) + hi + mul128Fold64(lo, hi));
+    }
+    uint64_t acc = len * kPrime64_1;
+    if (len <= 128) {
+        if (len > 32) {
+            if (len > 64) {
+                if (len > 96) {
+                    acc += mix16(input + 48, s + 96);
+                    acc += mix16(input + len - 64, s + 112);
+                }
+                acc += mix16(input + 32, s + 64);
+                acc += mix16(input + len - 48, s + 80);
+            }
+            acc += mix16(input + 16, s + 32);
+            acc += mix16(input + len - 32, s + 48);
+        }
+        acc += mix16(input, s);
+        acc += mix16(input + len - 16, s + 16);
+        return xxh3Avalanche(acc);
+    }
+    for (size_t i = 0; i < 8; ++i) {
+        acc += mix16(input + 16 * i, s + 16 * i);
+    }
+    uint64_t accEnd = mix16(input + len - 16, s + 136 - 17);
+    acc = xxh3Avalanche(acc);
+    size_t rounds = len / 16;
+    for (size_t i = 8; i < rounds; ++i) {
+        accEnd += mix16(input + 16 * i, s + 16 * (i - 8) + 3);
+    }
+    return xxh3Avalanche(acc + accEnd);
+}
+
+inline void accumulateStripe(uint64_t* acc, const unsigned char* input, const unsigned char* secret) {
+    for (size_t i = 0; i < 8; ++i) {
+        uint64_t value = readLE64(input + 8 * i);
+        uint64_t key = value ^ readLE64(secret + 8 * i);
+        acc[i ^ 1] += value;
+        acc[i] += (key & 0xFFFFFFFF) * (key >> 32);
+    }
+}
+
+inline void scrambleAccumulators(uint64_t* acc) {
+    const unsigned char* secret = kSecret + kSecretSize - kStripeLen;
+    for (size_t i = 0; i < 8; ++i) {
+        uint64_t a = acc[i];
+        a ^= a >> 47;
+        a ^= readLE64(secret + 8 * i);
+        acc[i] = a * kPrime32_1;
+    }
+}
+
+// ---- SHA-256 ----
+
+const uint32_t kSha256K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+void sha256Block(uint32_t* state, const unsigned char* block) {
+    uint32_t w[64];
+    for (int i = 0; i < 16; ++i) {
+        w[i] = readBE32(block + 4 * i);
+    }
+    for (int i = 16; i < 64; ++i) {
+        uint32_t s0 = rotr32(w[i - 15], 7) ^ rotr32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = rotr32(w[i - 2], 17) ^ rotr32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int i = 0; i < 64; ++i) {
+        uint32_t t1 = h + (rotr32(e, 6) ^ rotr32(e, 11) ^ rotr32(e, 25)) + ((e & f) ^ (~e & g)) + kSha256K[i] + w[i];
+        uint32_t t2 = (rotr32(a, 2) ^ rotr32(a, 13) ^ rotr32(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+std::string toHex(const unsigned char* bytes, size_t len) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out(len * 2, '0');
+    for (size_t i = 0; i < len; ++i) {
+        out[2 * i] = digits[bytes[i] >> 4];
+        out[2 * i + 1] = digits[bytes[i] & 0x0F];
+    }
+    return out;
+}
+
+std::string toHex(uint64_t value) {
+    unsigned char bytes[8];
+    for (int i = 0; i < 8; ++i) {
+        bytes[i] = static_cast<unsigned char>(value >> (56 - 8 * i));
+    }
+    return toHex(bytes, 8);
+}
+
+} // namespace
+
+Xxh3::Xxh3()
+    : acc_{kPrime32_3, kPrime64_1, kPrime64_2, kPrime64_3, kPrime64_4, kPrime32_2, kPrime64_5, kPrime32_1} {}
+
+void Xxh3::consumeStripes(const unsigned char* data, size_t stripes) {
+    for (size_t i = 0; i < stripes; ++i) {
+        accumulateStripe(acc_, data + i * kStripeLen, kSecret + stripesInBlock_ * 8);
+        if (++stripesInBlock_ == kStripesPerBlock) {
+            scrambleAccumulators(acc_);
+            stripesInBlock_ = 0;
+        }
+    }
+    if (stripes > 0) {
+        std::memcpy(lastStripe_, data + (stripes - 1) * kStripeLen, kStripeLen);
+    }
+}
+
+// A stripe is only consumed once input beyond it has arrived: the stripe holding the final
+// byte is hashed differently by digest().
+void Xxh3::update(const void* data, size_t len) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    totalLen_ += len;
+    if (buffered_ + len <= sizeof(buffer_)) {
+        if (len > 0) std::memcpy(buffer_ + buffered_, p, len);
+        buffered_ += len;
+        return;
+    }
+    if (buffered_ > 0) {
+        size_t fill = sizeof(buffer_) - buffered_;
+        std::memcpy(buffer_ + buffered_, p, fill);
+        p += fill;
+        len -= fill;
+        consumeStripes(buffer_, sizeof(buffer_) / kStripeLen);
+        buffered_ = 0;
+    }
+    if (len > sizeof(buffer_)) {
+        size_t stripes = (len - 1) / kStripeLen;
+        consumeStripes(p, stripes);
+        p += stripes * kStripeLen;
+        len -= stripes * kStripeLen;
+    }
+    std::memcpy(buffer_, p, len);
+    buffered_ = len;
+}
+
+uint64_t Xxh3::digest() const {
+    if (totalLen_ <= 240) {
+        return xxh3Short(buffer_, static_cast<size_t>(totalLen_));  // Never consumed: all in buffer_
+    }
+    uint64_t acc[8];
+    std::memcpy(acc, acc_, sizeof(acc));
+    size_t stripesInBlock = stripesInBlock_;
+    size_t stripes = (buffered_ - 1) / kStripeLen;
+    for (size_t i = 0; i < stripes; ++i) {
+        accumulateStripe(acc, buffer_ + i * kStripeLen, kSecret + stripesInBlock * 8);
+        if (++stripesInBlock == kStripesPerBlock) {
+            scrambleAccumulators(acc);
+            stripesInBlock = 0;
+        }
+    }
+    unsigned char last[kStripeLen];
+    if (buffered_ >= kStripeLen) {
+        std::memcpy(last, buffer_ + buffered_ - kStripeLen, kStripeLen);
+    } else {
+        size_t carried = kStripeLen - buffered_;
+        std::memcpy(last, lastStripe_ + kStripeLen - carried, carried);
+        std::memcpy(last + carried, buffer_, buffered_);
+    }
+    accumulateStripe(acc, last, kSecret + kLastStripeSecretOffset);
+
+    uint64_t result = totalLen_ * kPrime64_1;
+    const unsigned char* secret = kSecret + kMergeSecretOffset;
+    for (size_t i = 0; i < 4; ++i) {
+        result += mul128Fold64(acc[2 * i] ^ readLE64(secret + 16 * i), acc[2 * i + 1] ^ readLE64(secret + 16 * i + 8));
+    }
+    return xxh3Avalanche(result);
+}
+
+Sha256::Sha256()
+    : state_{0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19} {}
+
+void Sha256::update(const void* data, size_t len) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    totalLen_ += len;
+    if (buffered_ > 0) {
+        size_t fill = sizeof(buffer_) - buffered_;
+        if (len < fill) {
+            std::memcpy(buffer_ + buffered_, p, len);
+            buffered_ += len;
+            return;
+        }
+        std::memcpy(buffer_ + buffered_, p, fill);
+        sha256Block(state_, buffer_);
+        p += fill;
+        len -= fill;
+        buffered_ = 0;
+    }
+    for (; len >= 64; p += 64, len -= 64) {
+        sha256Block(state_, p);
+    }
+    if (len > 0) std::memcpy(buffer_, p, len);
+    buffered_ = len;
+}
+
+void Sha256::digest(unsigned char out[32]) const {
+    uint32_t state[8];
+    std::memcpy(state, state_, sizeof(state));
+    unsigned char block[128] = {};
+    std::memcpy(block, buffer_, buffered_);
+    block[buffered_] = 0x80;
+    size_t blocks = buffered_ + 1 + 8 <= 64 ? 1 : 2;
+    uint64_t bits = totalLen_ * 8;
+    for (int i = 0; i < 8; ++i) {
+        block[blocks * 64 - 1 - i] = static_cast<unsigned char>(bits >> (8 * i));
+    }
+    for (size_t i = 0; i < blocks; ++i) {
+        sha256Block(state, block + 64 * i);
+    }
+    for (int i = 0; i < 8; ++i) {
+        out[4 * i] = static_cast<unsigned char>(state[i] >> 24);
+        out[4 * i + 1] = static_cast<unsigned char>(state[i] >> 16);
+        out[4 * i + 2] = static_cast<unsigned char>(state[i] >> 8);
+        out[4 * i + 3] = static_cast<unsigned char>(state[i]);
+    }
+}
+
+bool parseAlgorithm(const std::string& name, Algorithm& algorithm) {
+    if (name == "xxh3") {
+        algorithm = Algorithm::Xxh3;
+        return true;
+    }
+    if (name == "sha256") {
+        algorithm = Algorithm::Sha256;
+        return true;
+    }
+    return false;
+}
+
+const char* algorithmName(Algorithm algorithm) {
+    return algorithm == Algorithm::Sha256 ? "sha256" : "xxh3";
+}
+
+std::string hashBuffer(Algorithm algorithm, const void* data, size_t len) {
+    if (algorithm == Algorithm::Sha256) {
+        Sha256 sha;
+        sha.update(data, len);
+        unsigned char digest[32];
+        sha.digest(digest);
+        return toHex(digest, sizeof(digest));
+    }
+    Xxh3 xxh;
+    xxh.update(data, len);
+    return toHex(xxh.digest());
+}
+
+// Read size per chunk: large enough that per-call overhead vanishes, small enough to stay in L2/L3
+static const size_t kReadChunkSize = 1024 * 1024;
+
+bool hashFile(const std::string& path, Algorithm algorithm, std::string& hexDigest, std::string& error,
+              const std::function<void(uint64_t)>& progress, const std::atomic<bool>* cancel) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        error = "Failed to open file";
+        return false;
+    }
+    std::vector<unsigned char> chunk(kReadChunkSize);
+    Xxh3 xxh;
+    Sha256 sha;
+    while (file) {
+        if (cancel && cancel->load()) {
+            error = "Cancelled";
+            return false;
+        }
+        file.read(reinterpret_cast<char*>(chunk.data()), static_cast<std::streamsize>(chunk.size()));
+        size_t got = static_cast<size_t>(file.gcount());
+        if (got == 0) break;
+        if (algorithm == Algorithm::Sha256) {
+            sha.update(chunk.data(), got);
+        } else {
+            xxh.update(chunk.data(), got);
+        }
+        if (progress) progress(got);
+    }
+    if (file.bad()) {
+        error = "Failed to read file";
+        return false;
+    }
+    if (algorithm == Algorithm::Sha256) {
+        unsigned char digest[32];
+        sha.digest(digest);
+        hexDigest = toHex(digest, sizeof(digest));
+    } else {
+        hexDigest = toHex(xxh.digest());
+    }
+    return true;
+}
+
+} // namespace hashing
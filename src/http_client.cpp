@@ -0,0 +1,835 @@
+#include "../include/http_client.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <system_error>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+#ifdef CROSSDEV_HAVE_OPENSSL
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+#include <openssl/x509v3.h>
+#endif
+
+namespace http {
+
+static const size_t kReadBufferSize = 64 * 1024;
+static const size_t kMaxLineBytes = 16 * 1024;
+static const size_t kMaxHeaderBytes = 256 * 1024;
+// Wait for the network in slices this long, so cancellation is noticed promptly
+static const int kPollSliceMs = 100;
+static const size_t kMaxIdlePerOrigin = 4;
+static const std::chrono::seconds kIdleTimeout(30);
+// A redirect's body is read and dropped to keep its connection, when it is this small
+static const int64_t kMaxDrainBytes = 64 * 1024;
+
+#ifdef _WIN32
+using SocketHandle = SOCKET;
+static const SocketHandle kInvalidSocket = INVALID_SOCKET;
+
+static void closeSocket(SocketHandle s) {
+    closesocket(s);
+}
+
+static std::string socketError() {
+    return std::system_category().message(WSAGetLastError());
+}
+
+static bool interrupted() {
+    return false;
+}
+
+static void setNonBlocking(SocketHandle s, bool on) {
+    u_long mode = on ? 1 : 0;
+    ioctlsocket(s, FIONBIO, &mode);
+}
+
+static bool connectPending() {
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+}
+
+static int pollOne(SocketHandle s, short events, int timeoutMs) {
+    WSAPOLLFD p = {};
+    p.fd = s;
+    p.events = events;
+    return WSAPoll(&p, 1, timeoutMs);
+}
+
+static void startSockets() {
+    static std::once_flag once;
+    std::call_once(once, []() {
+        WSADATA data;
+        WSAStartup(MAKEWORD(2, 2), &data);
+    });
+}
+#else
+using SocketHandle = int;
+static const SocketHandle kInvalidSocket = -1;
+
+static void closeSocket(SocketHandle s) {
+    ::close(s);
+}
+
+static std::string socketError() {
+    return std::generic_category().message(errno);
+}
+
+static bool interrupted() {
+    return errno == EINTR;
+}
+
+static void setNonBlocking(SocketHandle s, bool on) {
+    int flags = fcntl(s, F_GETFL, 0);
+    fcntl(s, F_SETFL, on ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK));
+}
+
+static bool connectPending() {
+    return errno == EINPROGRESS;
+}
+
+static int pollOne(SocketHandle s, short events, int timeoutMs) {
+    pollfd p = {};
+    p.fd = s;
+    p.events = events;
+    return ::poll(&p, 1, timeoutMs);
+}
+
+static void startSockets() {
+}
+#endif
+
+#if defined(CROSSDEV_HAVE_OPENSSL) && !defined(_WIN32) && !defined(__APPLE__)
+// SSL_write writes through write(2), which raises SIGPIPE on a connection the server has
+// closed. Block it on this thread for the call and swallow a signal it left pending.
+class SigpipeGuard {
+public:
+    SigpipeGuard() {
+        sigemptyset(&pipe_);
+        sigaddset(&pipe_, SIGPIPE);
+        sigset_t pending;
+        sigpending(&pending);
+        pendingBefore_ = sigismember(&pending, SIGPIPE) == 1;
+        pthread_sigmask(SIG_BLOCK, &pipe_, &old_);
+    }
+    ~SigpipeGuard() {
+        if (!pendingBefore_) {
+            sigset_t pending;
+            sigpending(&pending);
+            if (sigismember(&pending, SIGPIPE) == 1) {
+                timespec zero = {0, 0};
+                sigtimedwait(&pipe_, nullptr, &zero);
+            }
+        }
+        pthread_sigmask(SIG_SETMASK, &old_, nullptr);
+    }
+
+private:
+    sigset_t pipe_;
+    sigset_t old_;
+    bool pendingBefore_ = false;
+};
+#else
+struct SigpipeGuard {};
+#endif
+
+#ifdef CROSSDEV_HAVE_OPENSSL
+// Peers are verified against the system trust store; TLS 1.2 at least
+static SSL_CTX* tlsContext() {
+    static SSL_CTX* context = []() {
+        SSL_CTX* ctx = SSL_CTX_new(TLS_client_method());
+        if (ctx) {
+            SSL_CTX_set_min_proto_version(ctx, TLS1_2_VERSION);
+            SSL_CTX_set_default_verify_paths(ctx);
+            SSL_CTX_set_verify(ctx, SSL_VERIFY_PEER, nullptr);
+        }
+        return ctx;
+    }();
+    return context;
+}
+
+static std::string tlsError() {
+    unsigned long code = ERR_get_error();
+    ERR_clear_error();
+    if (code == 0) return socketError();
+    char text[256];
+    ERR_error_string_n(code, text, sizeof(text));
+    return text;
+}
+#endif
+
+static std::string lowercase(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+static std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t");
+    if (begin == std::string::npos) return "";
+    size_t end = text.find_last_not_of(" \t");
+    return text.substr(begin, end - begin + 1);
+}
+
+static bool isCancelled(const std::atomic<bool>* cancelled, std::string& error) {
+    if (cancelled && cancelled->load()) {
+        error = "Cancelled";
+        return true;
+    }
+    return false;
+}
+
+// Wait until the socket is readable (or writable); false on timeout or cancellation
+static bool waitSocket(SocketHandle s, bool write, int timeoutMs, const std::atomic<bool>* cancelled,
+                       std::string& error) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (true) {
+        if (isCancelled(cancelled, error)) return false;
+        int64_t remaining =
+            std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+        if (remaining <= 0) {
+            error = "Timed out waiting for the server";
+            return false;
+        }
+        int ready = pollOne(s, write ? POLLOUT : POLLIN, static_cast<int>(std::min<int64_t>(remaining, kPollSliceMs)));
+        if (ready > 0) return true;  // errors and hangups too: the next call reports them
+        if (ready < 0 && !interrupted()) {
+            error = "poll failed: " + socketError();
+            return false;
+        }
+    }
+}
+
+// One TCP (or TLS) connection plus its read-ahead buffer
+class Connection {
+public:
+    Connection() : buffer_(kReadBufferSize) {}
+
+    ~Connection() {
+#ifdef CROSSDEV_HAVE_OPENSSL
+        if (ssl_) SSL_free(ssl_);
+#endif
+        if (fd_ != kInvalidSocket) closeSocket(fd_);
+    }
+
+    bool open(const Url& url, int timeoutMs, const std::atomic<bool>* cancelled, std::string& error) {
+        origin = url.origin();
+#ifndef CROSSDEV_HAVE_OPENSSL
+        if (url.scheme == "https") {
+            error = "HTTPS is not available in this build (it needs OpenSSL)";
+            return false;
+        }
+#endif
+        startSockets();
+        addrinfo hints = {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* addresses = nullptr;
+        int rc = getaddrinfo(url.host.c_str(), std::to_string(url.port).c_str(), &hints, &addresses);
+        if (rc != 0) {
+            error = "Cannot resolve " + url.host + ": " + gai_strerror(rc);
+            return false;
+        }
+        // Addresses in resolver order; the first that accepts in time wins
+        error = "Cannot connect to " + url.host;
+        for (addrinfo* a = addresses; a && fd_ == kInvalidSocket; a = a->ai_next) {
+            SocketHandle s = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+            if (s == kInvalidSocket) continue;
+            setNonBlocking(s, true);
+            bool connected = ::connect(s, a->ai_addr, static_cast<int>(a->ai_addrlen)) == 0;
+            if (!connected && connectPending() && waitSocket(s, true, timeoutMs, cancelled, error)) {
+                int soError = 0;
+                socklen_t length = sizeof(soError);
+                getsockopt(s, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&soError), &length);
+                connected = soError == 0;
+                if (!connected) {
+                    error = "Cannot connect to " + url.host + ": " + std::generic_category().message(soError);
+                }
+            }
+            if (connected) {
+                fd_ = s;
+            } else {
+                closeSocket(s);
+                if (isCancelled(cancelled, error)) break;
+            }
+        }
+        freeaddrinfo(addresses);
+        if (fd_ == kInvalidSocket) return false;
+        error.clear();
+
+        setNonBlocking(fd_, false);
+        int on = 1;
+        setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&on), sizeof(on));
+#ifdef __APPLE__
+        setsockopt(fd_, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+        // Reads and writes wait in poll(); these only bound a blocking call that poll let through
+#ifdef _WIN32
+        DWORD timeout = static_cast<DWORD>(timeoutMs);
+#else
+        timeval timeout = {timeoutMs / 1000, (timeoutMs % 1000) * 1000};
+#endif
+        setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+        setsockopt(fd_, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+
+#ifdef CROSSDEV_HAVE_OPENSSL
+        if (url.scheme == "https") {
+            SSL_CTX* context = tlsContext();
+            ssl_ = context ? SSL_new(context) : nullptr;
+            if (!ssl_) {
+                error = "TLS setup failed: " + tlsError();
+                return false;
+            }
+            SSL_set_fd(ssl_, static_cast<int>(fd_));
+            unsigned char address[16];
+            bool literal = inet_pton(AF_INET, url.host.c_str(), address) == 1 ||
+                           inet_pton(AF_INET6, url.host.c_str(), address) == 1;
+            if (literal) {
+                X509_VERIFY_PARAM_set1_ip_asc(SSL_get0_param(ssl_), url.host.c_str());
+            } else {
+                SSL_set_tlsext_host_name(ssl_, url.host.c_str());
+                SSL_set1_host(ssl_, url.host.c_str());
+            }
+            SigpipeGuard guard;
+            if (SSL_connect(ssl_) != 1) {
+                long verify = SSL_get_verify_result(ssl_);
+                error = verify != X509_V_OK
+                    ? "Certificate verification failed: " + std::string(X509_verify_cert_error_string(verify))
+                    : "TLS handshake failed: " + tlsError();
+                return false;
+            }
+        }
+#endif
+        return true;
+    }
+
+    bool sendAll(const std::string& data, int timeoutMs, const std::atomic<bool>* cancelled, std::string& error) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            if (!waitSocket(fd_, true, timeoutMs, cancelled, error)) return false;
+            long n;
+#ifdef CROSSDEV_HAVE_OPENSSL
+            if (ssl_) {
+                SigpipeGuard guard;
+                n = SSL_write(ssl_, data.data() + sent, static_cast<int>(std::min<size_t>(data.size() - sent, INT_MAX)));
+                if (n <= 0) {
+                    error = "Failed to send request: " + tlsError();
+                    return false;
+                }
+                sent += static_cast<size_t>(n);
+                continue;
+            }
+#endif
+#if defined(MSG_NOSIGNAL)
+            n = ::send(fd_, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+#else
+            n = ::send(fd_, data.data() + sent, static_cast<int>(data.size() - sent), 0);
+#endif
+            if (n < 0) {
+                if (interrupted()) continue;
+                error = "Failed to send request: " + socketError();
+                return false;
+            }
+            sent += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    // The next bytes of the stream, at most max, read-ahead first. size 0 at the end of the
+    // stream; false on errors.
+    bool read(size_t max, const char*& data, size_t& size, int timeoutMs, const std::atomic<bool>* cancelled,
+              std::string& error) {
+        if (begin_ == end_) {
+            begin_ = end_ = 0;
+            long got = receive(buffer_.data(), buffer_.size(), timeoutMs, cancelled, error);
+            if (got < 0) return false;
+            end_ = static_cast<size_t>(got);
+        }
+        size = std::min(max, end_ - begin_);
+        data = buffer_.data() + begin_;
+        begin_ += size;
+        return true;
+    }
+
+    // One CRLF- (or LF-) terminated line, without the terminator
+    bool readLine(std::string& line, int timeoutMs, const std::atomic<bool>* cancelled, std::string& error) {
+        line.clear();
+        while (true) {
+            const char* start = buffer_.data() + begin_;
+            const char* newline = static_cast<const char*>(std::memchr(start, '\n', end_ - begin_));
+            if (newline) {
+                line.append(start, newline);
+                begin_ += static_cast<size_t>(newline - start) + 1;
+                if (!line.empty() && line.back() == '\r') line.pop_back();
+                return true;
+            }
+            line.append(start, end_ - begin_);
+            begin_ = end_ = 0;
+            if (line.size() > kMaxLineBytes) {
+                error = "Response line too long";
+                return false;
+            }
+            long got = receive(buffer_.data(), buffer_.size(), timeoutMs, cancelled, error);
+            if (got < 0) return false;
+            if (got == 0) {
+                error = "Connection closed by the server";
+                return false;
+            }
+            end_ = static_cast<size_t>(got);
+        }
+    }
+
+    // A pooled connection is usable only while it is quiet: readable means the server closed
+    // it (or sent bytes nobody asked for)
+    bool stale() {
+        if (begin_ != end_) return true;
+#ifdef CROSSDEV_HAVE_OPENSSL
+        if (ssl_ && SSL_pending(ssl_) > 0) return true;
+#endif
+        return pollOne(fd_, POLLIN, 0) != 0;
+    }
+
+    bool hasReadAhead() const { return begin_ != end_; }
+    uint64_t received() const { return received_; }
+    void resetReceived() { received_ = 0; }
+
+    std::string origin;
+    std::chrono::steady_clock::time_point idleSince;
+
+private:
+    long receive(char* out, size_t size, int timeoutMs, const std::atomic<bool>* cancelled, std::string& error) {
+#ifdef CROSSDEV_HAVE_OPENSSL
+        if (ssl_) {
+            if (SSL_pending(ssl_) == 0 && !waitSocket(fd_, false, timeoutMs, cancelled, error)) return -1;
+            int n = SSL_read(ssl_, out, static_cast<int>(std::min<size_t>(size, INT_MAX)));
+            if (n > 0) {
+                received_ += static_cast<uint64_t>(n);
+                return n;
+            }
+            int reason = SSL_get_error(ssl_, n);
+            // Many servers close without close_notify; bodies are length-checked by the caller
+            if (reason == SSL_ERROR_ZERO_RETURN || (reason == SSL_ERROR_SYSCALL && ERR_peek_error() == 0 && n == 0)) {
+                return 0;
+            }
+            error = "Failed to read response: " + tlsError();
+            return -1;
+        }
+#endif
+        while (true) {
+            if (!waitSocket(fd_, false, timeoutMs, cancelled, error)) return -1;
+            long n = static_cast<long>(::recv(fd_, out, static_cast<int>(std::min<size_t>(size, INT_MAX)), 0));
+            if (n >= 0) {
+                received_ += static_cast<uint64_t>(n);
+                return n;
+            }
+            if (interrupted()) continue;
+            error = "Failed to read response: " + socketError();
+            return -1;
+        }
+    }
+
+    SocketHandle fd_ = kInvalidSocket;
+#ifdef CROSSDEV_HAVE_OPENSSL
+    SSL* ssl_ = nullptr;
+#endif
+    std::vector<char> buffer_;
+    size_t begin_ = 0;
+    size_t end_ = 0;
+    uint64_t received_ = 0;
+};
+
+static int defaultPort(const std::string& scheme) {
+    return scheme == "https" ? 443 : 80;
+}
+
+bool Url::parse(const std::string& text, Url& url, std::string& error) {
+    for (unsigned char c : text) {
+        if (c <= 0x20 || c == 0x7f) {
+            error = "Invalid URL (spaces and control characters must be percent-encoded)";
+            return false;
+        }
+    }
+    size_t schemeEnd = text.find("://");
+    if (schemeEnd == std::string::npos) {
+        error = "Invalid URL (expect http:// or https://)";
+        return false;
+    }
+    Url parsed;
+    parsed.scheme = lowercase(text.substr(0, schemeEnd));
+    if (parsed.scheme != "http" && parsed.scheme != "https") {
+        error = "Unsupported URL scheme '" + parsed.scheme + "' (expect http or https)";
+        return false;
+    }
+    size_t authorityStart = schemeEnd + 3;
+    size_t authorityEnd = text.find_first_of("/?#", authorityStart);
+    if (authorityEnd == std::string::npos) authorityEnd = text.size();
+    std::string authority = text.substr(authorityStart, authorityEnd - authorityStart);
+    if (authority.find('@') != std::string::npos) {
+        error = "Credentials in URLs are not supported";
+        return false;
+    }
+
+    std::string port;
+    if (!authority.empty() && authority[0] == '[') {
+        size_t close = authority.find(']');
+        if (close == std::string::npos) {
+            error = "Invalid URL host";
+            return false;
+        }
+        parsed.host = authority.substr(1, close - 1);
+        if (close + 1 < authority.size()) {
+            if (authority[close + 1] != ':') {
+                error = "Invalid URL host";
+                return false;
+            }
+            port = authority.substr(close + 2);
+        }
+    } else {
+        size_t colon = authority.find(':');
+        parsed.host = authority.substr(0, colon);
+        if (colon != std::string::npos) port = authority.substr(colon + 1);
+    }
+    if (parsed.host.empty()) {
+        error = "Invalid URL (missing host)";
+        return false;
+    }
+    parsed.host = lowercase(parsed.host);
+    parsed.port = defaultPort(parsed.scheme);
+    if (!port.empty()) {
+        if (port.size() > 5 || !std::all_of(port.begin(), port.end(), [](unsigned char c) { return std::isdigit(c); }) ||
+            std::stoi(port) < 1 || std::stoi(port) > 65535) {
+            error = "Invalid URL port";
+            return false;
+        }
+        parsed.port = std::stoi(port);
+    }
+
+    parsed.target = text.substr(authorityEnd);
+    size_t fragment = parsed.target.find('#');
+    if (fragment != std::string::npos) parsed.target.erase(fragment);
+    if (parsed.target.empty() || parsed.target[0] != '/') parsed.target = "/" + parsed.target;
+    url = std::move(parsed);
+    return true;
+}
+
+std::string Url::hostHeader() const {
+    std::string name = host.find(':') != std::string::npos ? "[" + host + "]" : host;
+    return port == defaultPort(scheme) ? name : name + ":" + std::to_string(port);
+}
+
+std::string Url::origin() const {
+    std::string name = host.find(':') != std::string::npos ? "[" + host + "]" : host;
+    return scheme + "://" + name + ":" + std::to_string(port);
+}
+
+std::string Url::toString() const {
+    return scheme + "://" + hostHeader() + target;
+}
+
+std::string Url::resolve(const std::string& location) const {
+    if (location.find("://") != std::string::npos) return location;
+    if (location.compare(0, 2, "//") == 0) return scheme + ":" + location;
+    if (!location.empty() && location[0] == '/') return scheme + "://" + hostHeader() + location;
+    // Relative to the directory of the current path
+    std::string path = target.substr(0, target.find('?'));
+    return scheme + "://" + hostHeader() + path.substr(0, path.rfind('/') + 1) + location;
+}
+
+std::string Response::header(const std::string& name) const {
+    auto it = headers.find(lowercase(name));
+    return it != headers.end() ? it->second : std::string();
+}
+
+Client& Client::getInstance() {
+    static Client instance;
+    return instance;
+}
+
+bool Client::httpsSupported() {
+#ifdef CROSSDEV_HAVE_OPENSSL
+    return true;
+#else
+    return false;
+#endif
+}
+
+Client::~Client() = default;
+
+size_t Client::idleConnections() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return idle_.size();
+}
+
+std::unique_ptr<Connection> Client::acquire(const Url& url, const Request& request, bool& reused, std::string& error) {
+    std::string origin = url.origin();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto now = std::chrono::steady_clock::now();
+        for (auto it = idle_.begin(); it != idle_.end();) {
+            it = now - it->second->idleSince > kIdleTimeout ? idle_.erase(it) : std::next(it);
+        }
+        auto it = idle_.find(origin);
+        while (it != idle_.end() && it->first == origin) {
+            std::unique_ptr<Connection> connection = std::move(it->second);
+            it = idle_.erase(it);
+            if (!connection->stale()) {
+                reused = true;
+                return connection;
+            }
+        }
+    }
+    reused = false;
+    auto connection = std::make_unique<Connection>();
+    if (!connection->open(url, request.timeoutMs, request.cancelled, error)) {
+        return nullptr;
+    }
+    ++connectionsOpened_;
+    return connection;
+}
+
+void Client::release(std::unique_ptr<Connection> connection) {
+    if (connection->hasReadAhead()) return;  // bytes past the response: not a clean state to reuse
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (idle_.count(connection->origin) >= kMaxIdlePerOrigin) return;
+    connection->idleSince = std::chrono::steady_clock::now();
+    std::string origin = connection->origin;
+    idle_.emplace(origin, std::move(connection));
+}
+
+// Body framed by length (>= 0), by chunks, or by the end of the stream (length -1)
+static bool readBody(Connection& connection, int64_t length, bool chunked, const Request& request,
+                     const DataCallback& onData, std::string& error) {
+    auto readSpan = [&](int64_t remaining) {
+        while (remaining != 0) {
+            const char* data = nullptr;
+            size_t size = 0;
+            size_t max = remaining < 0 ? kReadBufferSize : static_cast<size_t>(std::min<int64_t>(remaining, kReadBufferSize));
+            if (!connection.read(max, data, size, request.timeoutMs, request.cancelled, error)) return false;
+            if (size == 0) {
+                if (remaining < 0) return true;
+                error = "Connection closed before the response was complete";
+                return false;
+            }
+            if (!onData(data, size)) {
+                if (error.empty()) error = "Transfer aborted";
+                return false;
+            }
+            if (remaining > 0) remaining -= static_cast<int64_t>(size);
+        }
+        return true;
+    };
+    if (!chunked) {
+        return readSpan(length);
+    }
+
+    std::string line;
+    while (true) {
+        if (!connection.readLine(line, request.timeoutMs, request.cancelled, error)) return false;
+        std::string digits = trim(line.substr(0, line.find(';')));
+        if (digits.empty() || digits.size() > 15 ||
+            !std::all_of(digits.begin(), digits.end(), [](unsigned char c) { return std::isxdigit(c); })) {
+            error = "Invalid chunk size in response";
+            return false;
+        }
+        int64_t size = std::stoll(digits, nullptr, 16);
+        if (size == 0) break;
+        if (!readSpan(size)) return false;
+        if (!connection.readLine(line, request.timeoutMs, request.cancelled, error)) return false;
+        if (!line.empty()) {
+            error = "Invalid chunk terminator in response";
+            return false;
+        }
+    }
+    // Trailer fields, up to the blank line
+    do {
+        if (!connection.readLine(line, request.timeoutMs, request.cancelled, error)) return false;
+    } while (!line.empty());
+    return true;
+}
+
+Client::Attempt Client::attempt(const Url& url, const Request& request, bool lastRedirect,
+                                const ResponseCallback& onResponse, const DataCallback& onData, std::string& location,
+                                std::string& error) {
+    std::string head = "GET " + url.target + " HTTP/1.1\r\nHost: " + url.hostHeader() + "\r\n";
+    bool userAgent = false;
+    for (const auto& header : request.headers) {
+        head += header.first + ": " + header.second + "\r\n";
+        userAgent = userAgent || lowercase(header.first) == "user-agent";
+    }
+    if (!userAgent) head += "User-Agent: CrossDev\r\n";
+    // Bytes on disk must be the resource itself, never a compressed transfer of it
+    head += "Accept-Encoding: identity\r\n\r\n";
+
+    // A kept-alive connection may have been closed by the server since it was pooled; a
+    // request that got no response byte on one is safe to retry once on a fresh connection
+    for (int tries = 0;; ++tries) {
+        bool reused = false;
+        std::unique_ptr<Connection> connection = acquire(url, request, reused, error);
+        if (!connection) return Attempt::Failed;
+        connection->resetReceived();
+        auto retryable = [&]() {
+            return reused && tries == 0 && connection->received() == 0 && !isCancelled(request.cancelled, error);
+        };
+
+        if (!connection->sendAll(head, request.timeoutMs, request.cancelled, error)) {
+            if (retryable()) continue;
+            return Attempt::Failed;
+        }
+
+        Response response;
+        response.url = url.toString();
+        bool http10 = false;
+        std::string line;
+        do {
+            if (!connection->readLine(line, request.timeoutMs, request.cancelled, error)) {
+                if (retryable()) break;
+                return Attempt::Failed;
+            }
+            // "HTTP/1.1 200 OK"; 1xx interim responses are skipped
+            if (line.size() < 12 || line.compare(0, 7, "HTTP/1.") != 0 || line[8] != ' ' ||
+                !std::isdigit(static_cast<unsigned char>(line[9])) ||
+                !std::isdigit(static_cast<unsigned char>(line[10])) ||
+                !std::isdigit(static_cast<unsigned char>(line[11]))) {
+                error = "Invalid HTTP response from " + url.host;
+                return Attempt::Failed;
+            }
+            http10 = line[7] == '0';
+            response.status = std::stoi(line.substr(9, 3));
+            response.headers.clear();
+            size_t headerBytes = 0;
+            while (true) {
+                if (!connection->readLine(line, request.timeoutMs, request.cancelled, error)) return Attempt::Failed;
+                if (line.empty()) break;
+                headerBytes += line.size();
+                size_t colon = line.find(':');
+                if (headerBytes > kMaxHeaderBytes || colon == std::string::npos || colon == 0) {
+                    error = "Invalid HTTP response headers from " + url.host;
+                    return Attempt::Failed;
+                }
+                std::string name = lowercase(line.substr(0, colon));
+                std::string value = trim(line.substr(colon + 1));
+                auto it = response.headers.find(name);
+                if (it == response.headers.end()) {
+                    response.headers[name] = value;
+                } else {
+                    it->second += ", " + value;
+                }
+            }
+        } while (response.status >= 100 && response.status < 200 && response.status != 101);
+        if (response.status == 0) continue;  // the read above failed on a stale connection
+
+        std::string connectionHeader = lowercase(response.header("connection"));
+        bool keepAlive = http10 ? connectionHeader.find("keep-alive") != std::string::npos
+                                : connectionHeader.find("close") == std::string::npos;
+        bool chunked = lowercase(response.header("transfer-encoding")).find("chunked") != std::string::npos;
+        int64_t length = -1;
+        if (response.status == 204 || response.status == 304 || response.status < 200) {
+            length = 0;
+        } else if (!chunked && response.headers.count("content-length")) {
+            std::string value = response.header("content-length");
+            if (value.empty() || value.size() > 18 ||
+                !std::all_of(value.begin(), value.end(), [](unsigned char c) { return std::isdigit(c); })) {
+                error = "Invalid Content-Length in response";
+                return Attempt::Failed;
+            }
+            length = std::stoll(value);
+        }
+        if (length == 0) chunked = false;
+        if (!chunked && length < 0) keepAlive = false;  // the body ends when the server closes
+        response.contentLength = chunked ? -1 : length;
+
+        bool redirect = response.status == 301 || response.status == 302 || response.status == 303 ||
+                        response.status == 307 || response.status == 308;
+        if (redirect && !lastRedirect && !response.header("location").empty()) {
+            location = response.header("location");
+            if (keepAlive && (chunked || length <= kMaxDrainBytes) &&
+                readBody(*connection, length, chunked, request, [](const char*, size_t) { return true; }, error)) {
+                release(std::move(connection));
+            }
+            error.clear();
+            return Attempt::Redirect;
+        }
+
+        if (!onResponse(response)) {
+            if (error.empty()) error = "Transfer aborted";
+            return Attempt::Failed;
+        }
+        if (!readBody(*connection, length, chunked, request, onData, error)) {
+            return Attempt::Failed;
+        }
+        if (keepAlive) {
+            release(std::move(connection));
+        }
+        return Attempt::Done;
+    }
+}
+
+// Caller headers that say nothing about who is asking (credentials, cookies, API keys stay with
+// the origin they were written for)
+static bool forwardedAcrossOrigins(const std::string& name) {
+    static const char* const kSafe[] = {"accept", "accept-language", "user-agent", "range",
+                                        "if-range", "if-none-match", "if-modified-since"};
+    std::string lower = lowercase(name);
+    for (const char* safe : kSafe) {
+        if (lower == safe) return true;
+    }
+    return false;
+}
+
+bool Client::get(const Request& request, const ResponseCallback& onResponse, const DataCallback& onData,
+                 std::string& error) {
+    Url url;
+    if (!Url::parse(request.url, url, error)) {
+        return false;
+    }
+    const std::string origin = url.origin();
+    const Request* current = &request;
+    Request elsewhere;  // request with only the headers another origin may see, once one is reached
+    for (int redirects = 0;; ++redirects) {
+        std::string location;
+        Attempt result = attempt(url, *current, redirects >= request.maxRedirects, onResponse, onData, location, error);
+        if (result != Attempt::Redirect) {
+            return result == Attempt::Done;
+        }
+        Url next;
+        if (!Url::parse(url.resolve(location), next, error)) {
+            error = "Invalid redirect: " + error;
+            return false;
+        }
+        if (url.scheme == "https" && next.scheme == "http") {
+            error = "Refusing redirect from https to http: " + next.origin();
+            return false;
+        }
+        if (current == &request && next.origin() != origin) {
+            elsewhere = request;
+            elsewhere.headers.clear();
+            for (const auto& header : request.headers) {
+                if (forwardedAcrossOrigins(header.first)) elsewhere.headers.push_back(header);
+            }
+            current = &elsewhere;
+        }
+        url = std::move(next);
+    }
+}
+
+} // namespace http
@@ -0,0 +1,353 @@
+#include "../include/job_manager.h"
+#include <algorithm>
+#include <exception>
+
+static thread_local JobContext* t_current = nullptr;
+
+static int64_t msBetween(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(to - from).count();
+}
+
+void JobContext::progress(nlohmann::json progress) {
+    int64_t now = msBetween(started_, std::chrono::steady_clock::now());
+    int64_t last = lastProgressMs_.load();
+    bool due = now - last >= JobManager::kProgressIntervalMs && lastProgressMs_.compare_exchange_strong(last, now);
+    manager_->reportProgress(*this, std::move(progress), due);
+}
+
+JobContext* JobContext::current() {
+    return t_current;
+}
+
+JobManager& JobManager::getInstance() {
+    static JobManager instance(kDefaultWorkers);
+    return instance;
+}
+
+JobManager::JobManager(size_t workerCount, size_t postedThreadLimit)
+    : postedThreadLimit_(postedThreadLimit == 0 ? 1 : postedThreadLimit) {
+    if (workerCount == 0) workerCount = 1;
+    for (size_t i = 0; i < workerCount; ++i) {
+        workers_.emplace_back([this]() { run(); });
+    }
+}
+
+JobManager::~JobManager() {
+    shutdown();
+}
+
+void JobManager::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        for (auto& queue : queues_) {
+            queue.clear();
+        }
+        for (auto& entry : jobs_) {
+            entry.second->context->cancelled_ = true;
+        }
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) worker.join();
+    }
+    std::vector<std::thread> posted;
+    {
+        std::lock_guard<std::mutex> lock(postedMutex_);
+        postedClosed_ = true;
+        postedQueue_.clear();
+        posted.swap(postedThreads_);
+    }
+    postedWake_.notify_all();
+    for (auto& thread : posted) {
+        thread.join();
+    }
+}
+
+std::string JobManager::start(const std::string& kind, Priority priority, Work work, EventSink events,
+                              const void* owner) {
+    auto job = std::make_shared<Job>();
+    std::string id;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job->sequence = nextSequence_++;
+        id = "job-" + std::to_string(nextId_++);
+        job->context.reset(new JobContext(this, id, kind));
+        job->priority = priority;
+        job->work = std::move(work);
+        job->events = std::move(events);
+        job->owner = owner;
+        job->queued = std::chrono::steady_clock::now();
+        jobs_[id] = job;
+        queues_[static_cast<int>(priority)].push_back(job);
+    }
+    wake_.notify_one();
+    return id;
+}
+
+void JobManager::post(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(postedMutex_);
+        if (postedClosed_) return;
+        postedQueue_.push_back(std::move(task));
+        if (postedIdle_ < postedQueue_.size() && postedThreads_.size() < postedThreadLimit_) {
+            postedThreads_.emplace_back([this]() { runPosted(); });
+        }
+    }
+    postedWake_.notify_one();
+}
+
+void JobManager::runPosted() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(postedMutex_);
+            ++postedIdle_;
+            postedWake_.wait(lock, [this]() { return postedClosed_ || !postedQueue_.empty(); });
+            --postedIdle_;
+            if (postedClosed_) return;
+            task = std::move(postedQueue_.front());
+            postedQueue_.pop_front();
+        }
+        try {
+            task();
+        } catch (...) {
+            // Nothing to report to: the owner's own events carry its errors
+        }
+    }
+}
+
+void JobManager::addExternal(const std::string& id, const std::string& kind, const void* owner,
+                             std::function<void()> cancel) {
+    auto job = std::make_shared<Job>();
+    job->context.reset(new JobContext(this, id, kind));
+    job->cancelExternal = std::move(cancel);
+    job->external = true;
+    job->owner = owner;
+    job->state = State::Running;
+    job->queued = job->started = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    job->sequence = nextSequence_++;
+    jobs_[id] = job;
+}
+
+void JobManager::finishExternal(const std::string& id, State state, std::string error) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = jobs_.find(id);
+    if (it == jobs_.end() || !it->second->external || it->second->state != State::Running) return;
+    Job& job = *it->second;
+    job.state = state;
+    job.finished = std::chrono::steady_clock::now();
+    job.error = std::move(error);
+    job.cancelExternal = nullptr;
+    finished_.push_back(id);
+    forgetOldJobs();
+}
+
+bool JobManager::cancel(const std::string& id, const void* owner) {
+    std::shared_ptr<Job> job;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto it = jobs_.find(id);
+        if (it == jobs_.end() || !visible(*it->second, owner)) return false;
+        job = it->second;
+        if (job->state == State::Running) {
+            job->context->cancelled_ = true;
+            std::function<void()> cancelExternal = job->cancelExternal;
+            lock.unlock();
+            if (cancelExternal) cancelExternal();  // the operation's own flag
+            return true;
+        }
+        if (job->state != State::Queued) return false;
+        auto& queue = queues_[static_cast<int>(job->priority)];
+        queue.erase(std::remove(queue.begin(), queue.end(), job), queue.end());
+        job->context->cancelled_ = true;
+    }
+    finish(job, State::Cancelled, nullptr, "");
+    return true;
+}
+
+bool JobManager::status(const std::string& id, nlohmann::json& out, const void* owner) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = jobs_.find(id);
+    if (it == jobs_.end() || !visible(*it->second, owner)) return false;
+    out = describe(*it->second);
+    return true;
+}
+
+nlohmann::json JobManager::list(const void* owner) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<const Job*> jobs;
+    for (const auto& entry : jobs_) {
+        if (visible(*entry.second, owner)) jobs.push_back(entry.second.get());
+    }
+    std::sort(jobs.begin(), jobs.end(), [](const Job* a, const Job* b) { return a->sequence < b->sequence; });
+    nlohmann::json all = nlohmann::json::array();
+    for (const Job* job : jobs) {
+        all.push_back(describe(*job));
+    }
+    return all;
+}
+
+bool JobManager::parsePriority(const std::string& name, Priority& out) {
+    if (name == "high") {
+        out = Priority::High;
+    } else if (name == "normal") {
+        out = Priority::Normal;
+    } else if (name == "low") {
+        out = Priority::Low;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* JobManager::priorityName(Priority priority) {
+    switch (priority) {
+        case Priority::High: return "high";
+        case Priority::Normal: return "normal";
+        case Priority::Low: return "low";
+    }
+    return "normal";
+}
+
+const char* JobManager::stateName(State state) {
+    switch (state) {
+        case State::Queued: return "queued";
+        case State::Running: return "running";
+        case State::Done: return "done";
+        case State::Failed: return "failed";
+        case State::Cancelled: return "cancelled";
+    }
+    return "failed";
+}
+
+void JobManager::setEventSink(EventSink sink) {
+    std::lock_guard<std::mutex> lock(sinkMutex_);
+    sink_ = std::move(sink);
+}
+
+void JobManager::run() {
+    while (true) {
+        std::shared_ptr<Job> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this]() {
+                return stopping_ || std::any_of(std::begin(queues_), std::end(queues_),
+                                                [](const std::deque<std::shared_ptr<Job>>& q) { return !q.empty(); });
+            });
+            if (stopping_) return;
+            for (auto& queue : queues_) {
+                if (!queue.empty()) {
+                    job = queue.front();
+                    queue.pop_front();
+                    break;
+                }
+            }
+            job->state = State::Running;
+            job->started = std::chrono::steady_clock::now();
+            job->context->started_ = job->started;
+        }
+
+        JobContext& context = *job->context;
+        nlohmann::json result;
+        std::string error;
+        bool threw = false;
+        t_current = &context;
+        try {
+            result = job->work(context);
+        } catch (const std::exception& e) {
+            error = e.what();
+            threw = true;
+        } catch (...) {
+            error = "Unknown error";
+            threw = true;
+        }
+        t_current = nullptr;
+        job->work = nullptr;  // release captures (payload copies, handler references) now
+
+        State state = State::Done;
+        if (context.cancelled()) {
+            state = State::Cancelled;
+        } else if (threw) {
+            state = State::Failed;
+        } else if (result.is_object() && result.value("success", true) == false) {
+            state = State::Failed;
+            auto it = result.find("error");
+            error = (it != result.end() && it->is_string()) ? it->get<std::string>() : "Failed";
+        }
+        finish(job, state, std::move(result), std::move(error));
+    }
+}
+
+void JobManager::finish(const std::shared_ptr<Job>& job, State state, nlohmann::json result, std::string error) {
+    nlohmann::json done;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job->state = state;
+        job->finished = std::chrono::steady_clock::now();
+        job->error = std::move(error);
+        done["jobId"] = job->context->id();
+        done["kind"] = job->context->kind();
+        done["state"] = stateName(state);
+        if (!result.is_null()) done["result"] = std::move(result);
+        if (!job->error.empty()) done["error"] = job->error;
+        done["elapsedMs"] = job->started.time_since_epoch().count() ? msBetween(job->started, job->finished) : 0;
+        finished_.push_back(job->context->id());
+        forgetOldJobs();
+    }
+    emit(*job, "job:done", done);
+}
+
+void JobManager::reportProgress(JobContext& context, nlohmann::json progress, bool emitEvent) {
+    nlohmann::json event;
+    std::shared_ptr<Job> job;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = jobs_.find(context.id());
+        if (it == jobs_.end() || it->second->state != State::Running) return;
+        job = it->second;
+        job->progress = progress;
+    }
+    if (!emitEvent) return;
+    event["jobId"] = context.id();
+    event["kind"] = context.kind();
+    event["progress"] = std::move(progress);
+    emit(*job, "job:progress", event);
+}
+
+void JobManager::emit(const Job& job, const std::string& name, const nlohmann::json& payload) {
+    if (job.events) {
+        job.events(name, payload);
+        return;
+    }
+    EventSink sink;
+    {
+        std::lock_guard<std::mutex> lock(sinkMutex_);
+        sink = sink_;
+    }
+    if (sink) sink(name, payload);
+}
+
+nlohmann::json JobManager::describe(const Job& job) const {
+    auto now = std::chrono::steady_clock::now();
+    nlohmann::json d;
+    d["jobId"] = job.context->id();
+    d["kind"] = job.context->kind();
+    d["priority"] = priorityName(job.priority);
+    d["state"] = stateName(job.state);
+    bool started = job.state != State::Queued && job.started.time_since_epoch().count() != 0;
+    bool finished = job.state != State::Queued && job.state != State::Running;
+    d["queuedMs"] = msBetween(job.queued, started ? job.started : (finished ? job.finished : now));
+    d["elapsedMs"] = started ? msBetween(job.started, finished ? job.finished : now) : 0;
+    if (!job.progress.is_null()) d["progress"] = job.progress;
+    if (!job.error.empty()) d["error"] = job.error;
+    return d;
+}
+
+void JobManager::forgetOldJobs() {
+    while (finished_.size() > kKeepFinished) {
+        jobs_.erase(finished_.front());
+        finished_.pop_front();
+    }
+}
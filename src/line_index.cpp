@@ -0,0 +1,467 @@
+#include "../include/line_index.h"
+#include "../include/cpu_features.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <list>
+#include <system_error>
+#include <sys/stat.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define LINE_SCAN_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define LINE_SCAN_NEON 1
+#include <arm_neon.h>
+#endif
+
+// GCC/Clang compile each x86 kernel for its own ISA; MSVC accepts the intrinsics anywhere
+#if defined(__GNUC__) || defined(__clang__)
+#define LINE_SCAN_TARGET(isa) __attribute__((target(isa)))
+#else
+#define LINE_SCAN_TARGET(isa)
+#endif
+
+namespace fs = std::filesystem;
+
+namespace line_scan {
+
+// ---- Kernels ----
+// Each kernel skips whole 64-byte blocks holding fewer than the remaining n newlines and
+// returns where it stopped; the scalar loop then finds the exact newline (within one block)
+// and handles the tail.
+
+static size_t skipScalar(const unsigned char* data, size_t len, uint64_t& n) {
+    for (size_t i = 0; i < len && n > 0; ++i) {
+        if (data[i] == '\n' && --n == 0) return i + 1;
+    }
+    return len;
+}
+
+#ifdef LINE_SCAN_X86
+
+static unsigned popcount64(uint64_t x) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    // __popcnt64 needs the POPCNT instruction, which SSE2-only CPUs lack
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<unsigned>((x * 0x0101010101010101ULL) >> 56);
+#else
+    return static_cast<unsigned>(__builtin_popcountll(x));
+#endif
+}
+
+LINE_SCAN_TARGET("sse2")
+static size_t skipSse2(const unsigned char* data, size_t len, uint64_t& n) {
+    const __m128i newline = _mm_set1_epi8('\n');
+    size_t i = 0;
+    for (; i + 64 <= len; i += 64) {
+        uint64_t mask = 0;
+        for (int k = 0; k < 4; ++k) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + k * 16));
+            mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline))))
+                    << (k * 16);
+        }
+        unsigned count = popcount64(mask);
+        if (count >= n) break;
+        n -= count;
+    }
+    return i;
+}
+
+LINE_SCAN_TARGET("avx2")
+static size_t skipAvx2(const unsigned char* data, size_t len, uint64_t& n) {
+    const __m256i newline = _mm256_set1_epi8('\n');
+    size_t i = 0;
+    for (; i + 64 <= len; i += 64) {
+        __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 32));
+        uint64_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, newline))) |
+                        (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, newline)))) << 32);
+        unsigned count = popcount64(mask);
+        if (count >= n) break;
+        n -= count;
+    }
+    return i;
+}
+
+#endif // LINE_SCAN_X86
+
+#ifdef LINE_SCAN_NEON
+
+static size_t skipNeon(const unsigned char* data, size_t len, uint64_t& n) {
+    const uint8x16_t newline = vdupq_n_u8('\n');
+    size_t i = 0;
+    for (; i + 64 <= len; i += 64) {
+        // Matching lanes are 0xFF; subtracting them counts up to 4 per lane
+        uint8x16_t counts = vdupq_n_u8(0);
+        for (int k = 0; k < 4; ++k) {
+            counts = vsubq_u8(counts, vceqq_u8(vld1q_u8(data + i + k * 16), newline));
+        }
+        unsigned count = vaddvq_u8(counts);
+        if (count >= n) break;
+        n -= count;
+    }
+    return i;
+}
+
+#endif // LINE_SCAN_NEON
+
+// ---- Dispatch ----
+
+static bool cpuSupports(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::Scalar:
+            return true;
+#ifdef LINE_SCAN_X86
+        case Kernel::Sse2:
+            return true;  // baseline on x86-64, and on every x86 CPU still running a WebView
+        case Kernel::Avx2:
+            return cpu_features::hasAvx2();
+#endif
+#ifdef LINE_SCAN_NEON
+        case Kernel::Neon:
+            return true;  // baseline on arm64
+#endif
+        default:
+            return false;
+    }
+}
+
+static cpu_features::KernelDispatch<Kernel>& dispatch() {
+    static cpu_features::KernelDispatch<Kernel> instance(
+        {Kernel::Scalar, Kernel::Sse2, Kernel::Avx2, Kernel::Neon}, cpuSupports);
+    return instance;
+}
+
+const char* kernelName(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::Scalar: return "scalar";
+        case Kernel::Sse2: return "sse2";
+        case Kernel::Avx2: return "avx2";
+        case Kernel::Neon: return "neon";
+    }
+    return "unknown";
+}
+
+Kernel activeKernel() {
+    return dispatch().active();
+}
+
+std::vector<Kernel> supportedKernels() {
+    return dispatch().supported();
+}
+
+bool setKernel(Kernel kernel) {
+    return dispatch().select(kernel);
+}
+
+size_t skipNewlines(const unsigned char* data, size_t len, uint64_t& n) {
+    if (n == 0) return 0;
+    size_t done = 0;
+    switch (activeKernel()) {
+#ifdef LINE_SCAN_X86
+        case Kernel::Avx2:
+            done = skipAvx2(data, len, n);
+            break;
+        case Kernel::Sse2:
+            done = skipSse2(data, len, n);
+            break;
+#endif
+#ifdef LINE_SCAN_NEON
+        case Kernel::Neon:
+            done = skipNeon(data, len, n);
+            break;
+#endif
+        default:
+            break;
+    }
+    return done + skipScalar(data + done, len - done, n);
+}
+
+// Length of the valid UTF-8 sequence starting at s (lead byte >= 0x80), or 0
+static size_t sequenceLength(const unsigned char* s, size_t len) {
+    unsigned char c = s[0];
+    size_t need;
+    unsigned char lo = 0x80;
+    unsigned char hi = 0xBF;
+    if (c >= 0xC2 && c <= 0xDF) {
+        need = 1;
+    } else if (c >= 0xE0 && c <= 0xEF) {
+        need = 2;
+        if (c == 0xE0) lo = 0xA0;  // overlong
+        if (c == 0xED) hi = 0x9F;  // surrogates
+    } else if (c >= 0xF0 && c <= 0xF4) {
+        need = 3;
+        if (c == 0xF0) lo = 0x90;  // overlong
+        if (c == 0xF4) hi = 0x8F;  // past U+10FFFF
+    } else {
+        return 0;
+    }
+    if (len < need + 1 || s[1] < lo || s[1] > hi) return 0;
+    for (size_t k = 2; k <= need; ++k) {
+        if ((s[k] & 0xC0) != 0x80) return 0;
+    }
+    return need + 1;
+}
+
+size_t sanitizeUtf8(const char* text, size_t len, std::string& out) {
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(text);
+    out.clear();
+    size_t replaced = 0;
+    size_t copied = 0;  // bytes of text already in out
+    size_t i = 0;
+    while (i < len) {
+        if (i + 8 <= len) {
+            uint64_t word;
+            std::memcpy(&word, s + i, 8);
+            if ((word & 0x8080808080808080ULL) == 0) {
+                i += 8;
+                continue;
+            }
+        }
+        if (s[i] < 0x80) {
+            ++i;
+            continue;
+        }
+        size_t length = sequenceLength(s + i, len - i);
+        if (length > 0) {
+            i += length;
+            continue;
+        }
+        if (replaced == 0) out.reserve(len + 16);
+        out.append(text + copied, i - copied);
+        out += "\xEF\xBF\xBD";
+        ++replaced;
+        copied = ++i;
+    }
+    out.append(text + copied, len - copied);
+    return replaced;
+}
+
+} // namespace line_scan
+
+// ---- LineIndex ----
+
+// Bytes scanned per chunk; the index lock is held for one chunk at a time
+static const size_t kScanChunk = 4 * 1024 * 1024;
+// Bytes remembered before the indexed end: an append leaves them untouched
+static const size_t kTailBytes = 64;
+// Indexes kept alive for reuse
+static const size_t kMaxIndexes = 16;
+
+struct FileVersion {
+    uint64_t size = 0;
+    uint64_t inode = 0;
+    int64_t mtimeNs = 0;
+};
+
+static bool statFile(const std::string& path, FileVersion& version, std::string& error) {
+#ifdef _WIN32
+    std::error_code ec;
+    fs::path p = fs::u8path(path);
+    fs::file_status status = fs::status(p, ec);
+    if (ec || !fs::exists(status)) {
+        error = "File does not exist: " + path;
+        return false;
+    }
+    if (!fs::is_regular_file(status)) {
+        error = "Not a regular file: " + path;
+        return false;
+    }
+    version.size = fs::file_size(p, ec);
+    version.mtimeNs = static_cast<int64_t>(fs::last_write_time(p, ec).time_since_epoch().count()) * 100;
+#else
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0) {
+        error = (errno == ENOENT || errno == ENOTDIR) ? "File does not exist: " + path
+                                                      : "Failed to stat file: " + path;
+        return false;
+    }
+    if (!S_ISREG(st.st_mode)) {
+        error = "Not a regular file: " + path;
+        return false;
+    }
+    version.size = static_cast<uint64_t>(st.st_size);
+    version.inode = static_cast<uint64_t>(st.st_ino);
+#ifdef __APPLE__
+    version.mtimeNs = static_cast<int64_t>(st.st_mtimespec.tv_sec) * 1000000000LL + st.st_mtimespec.tv_nsec;
+#else
+    version.mtimeNs = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+#endif
+#endif
+    return true;
+}
+
+std::shared_ptr<LineIndex> LineIndex::forFile(const std::string& path, std::string& error) {
+    static std::mutex registryMutex;
+    static std::list<std::shared_ptr<LineIndex>> registry;  // most recently used first
+
+    std::error_code ec;
+    fs::path absolute = fs::absolute(fs::u8path(path), ec);
+    std::string key = ec ? path : absolute.lexically_normal().u8string();
+    std::shared_ptr<LineIndex> index;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        auto it = std::find_if(registry.begin(), registry.end(),
+                               [&key](const std::shared_ptr<LineIndex>& entry) { return entry->path() == key; });
+        if (it != registry.end()) {
+            index = *it;
+            registry.erase(it);
+        } else {
+            index = std::make_shared<LineIndex>(key);
+        }
+        registry.push_front(index);
+        if (registry.size() > kMaxIndexes) registry.pop_back();
+    }
+    std::lock_guard<std::mutex> lock(index->mutex_);
+    if (!index->refresh(error)) return nullptr;
+    return index;
+}
+
+LineIndex::LineIndex(std::string path) : path_(std::move(path)) {
+    reset();
+}
+
+void LineIndex::reset() {
+    checkpoints_.assign(1, 0);
+    bytesIndexed_ = 0;
+    linesIndexed_ = 0;
+    endsWithNewline_ = false;
+    tail_.clear();
+}
+
+bool LineIndex::refresh(std::string& error) {
+    FileVersion version;
+    if (!statFile(path_, version, error)) {
+        reset();
+        size_ = 0;
+        return false;
+    }
+    if (version.inode != inode_ || version.size < bytesIndexed_) {
+        reset();  // replaced or truncated
+    } else if (version.size <= size_ && version.mtimeNs != mtimeNs_) {
+        reset();  // rewritten in place
+    } else if (version.size > size_ && !tail_.empty()) {
+        // Grown or touched: an append leaves the indexed bytes as they were
+        std::ifstream file(fs::u8path(path_), std::ios::binary);
+        std::string current(tail_.size(), '\0');
+        file.seekg(static_cast<std::streamoff>(bytesIndexed_ - tail_.size()));
+        if (!file.read(&current[0], static_cast<std::streamsize>(current.size())) || current != tail_) {
+            reset();
+        }
+    }
+    size_ = version.size;
+    inode_ = version.inode;
+    mtimeNs_ = version.mtimeNs;
+    return true;
+}
+
+bool LineIndex::scanChunk(std::string& error) {
+    std::ifstream file(fs::u8path(path_), std::ios::binary);
+    if (!file.is_open()) {
+        error = "Failed to open file: " + path_;
+        return false;
+    }
+    size_t want = static_cast<size_t>(std::min<uint64_t>(kScanChunk, size_ - bytesIndexed_));
+    std::vector<unsigned char> buffer(want);
+    file.seekg(static_cast<std::streamoff>(bytesIndexed_));
+    file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(want));
+    size_t got = static_cast<size_t>(file.gcount());
+    if (file.bad()) {
+        error = "Failed to read file: " + path_;
+        return false;
+    }
+    if (got == 0) {
+        size_ = bytesIndexed_;  // shrank since it was validated; the next refresh sorts it out
+        return true;
+    }
+
+    size_t pos = 0;
+    while (pos < got) {
+        uint64_t n = kCheckpointInterval - linesIndexed_ % kCheckpointInterval;
+        uint64_t wanted = n;
+        pos += line_scan::skipNewlines(buffer.data() + pos, got - pos, n);
+        linesIndexed_ += wanted - n;
+        if (n == 0) checkpoints_.push_back(bytesIndexed_ + pos);
+    }
+    bytesIndexed_ += got;
+    endsWithNewline_ = buffer[got - 1] == '\n';
+    size_t keep = std::min(got, kTailBytes);
+    tail_.append(reinterpret_cast<const char*>(buffer.data() + got - keep), keep);
+    if (tail_.size() > kTailBytes) tail_.erase(0, tail_.size() - kTailBytes);
+    return true;
+}
+
+bool LineIndex::extendTo(uint64_t line, std::string& error, const std::atomic<bool>* cancel,
+                         uint64_t maxScanBytes) {
+    uint64_t scanned = 0;
+    while (true) {
+        if (cancel && cancel->load()) return false;
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (linesIndexed_ >= line || bytesIndexed_ >= size_ || scanned >= maxScanBytes) return true;
+        uint64_t before = bytesIndexed_;
+        if (!scanChunk(error)) return false;
+        scanned += bytesIndexed_ - before;
+    }
+}
+
+bool LineIndex::extendToEnd(std::string& error, const std::atomic<bool>* cancel) {
+    return extendTo(UINT64_MAX, error, cancel);
+}
+
+bool LineIndex::lineOffset(uint64_t line, uint64_t& offset, std::string& error) {
+    uint64_t start;
+    uint64_t skip = line % kCheckpointInterval;
+    uint64_t size;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (line > linesIndexed_) return false;
+        start = checkpoints_[static_cast<size_t>(line / kCheckpointInterval)];
+        size = size_;
+    }
+    // Walk forward from the checkpoint (fewer than kCheckpointInterval lines)
+    if (skip > 0) {
+        std::ifstream file(fs::u8path(path_), std::ios::binary);
+        if (!file.is_open()) {
+            error = "Failed to open file: " + path_;
+            return false;
+        }
+        file.seekg(static_cast<std::streamoff>(start));
+        std::vector<unsigned char> buffer(64 * 1024);
+        while (skip > 0) {
+            file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+            size_t got = static_cast<size_t>(file.gcount());
+            if (got == 0) return false;
+            start += line_scan::skipNewlines(buffer.data(), got, skip);
+        }
+    }
+    offset = start;
+    return start < size;
+}
+
+LineIndex::Status LineIndex::status() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Status status;
+    status.size = size_;
+    status.bytesIndexed = bytesIndexed_;
+    status.linesIndexed = linesIndexed_;
+    status.complete = bytesIndexed_ >= size_;
+    status.totalLines = linesIndexed_ + (bytesIndexed_ > 0 && !endsWithNewline_ ? 1 : 0);
+    return status;
+}
+
+bool LineIndex::claimBackground() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (backgroundRunning_) return false;
+    backgroundRunning_ = true;
+    return true;
+}
+
+void LineIndex::releaseBackground() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    backgroundRunning_ = false;
+}
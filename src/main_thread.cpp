@@ -0,0 +1,12 @@
+#include "../include/main_thread.h"
+#include "platform/platform_impl.h"
+#include <memory>
+
+static void runBoxedTask(void* userData) {
+    std::unique_ptr<std::function<void()>> fn(static_cast<std::function<void()>*>(userData));
+    (*fn)();
+}
+
+void runOnMainThread(std::function<void()> fn) {
+    platform::postToMainThread(runBoxedTask, new std::function<void()>(std::move(fn)));
+}
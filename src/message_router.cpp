@@ -26,6 +26,7 @@ MessageRouter::MessageRouter(WebView* webView) : webView_(webView) {
 
 MessageRouter::~MessageRouter() {
     handlers_.clear();
+    factories_.clear();
 }
 
 void MessageRouter::registerHandler(const std::string& messageType, std::shared_ptr<MessageHandler> handler) {
@@ -33,6 +34,8 @@ void MessageRouter::registerHandler(const std::string& messageType, std::shared_
         return;
     }
     handlers_[messageType] = handler;
+    factories_.erase(messageType);
+    failedTypes_.erase(messageType);
 }
 
 void MessageRouter::registerHandler(std::shared_ptr<MessageHandler> handler) {
@@ -42,9 +45,71 @@ void MessageRouter::registerHandler(std::shared_ptr<MessageHandler> handler) {
     // Register for all types this handler supports
     for (const auto& type : handler->getSupportedTypes()) {
         handlers_[type] = handler;
+        factories_.erase(type);
+        failedTypes_.erase(type);
     }
 }
 
+void MessageRouter::registerHandlerFactory(const std::vector<std::string>& messageTypes, HandlerFactory factory) {
+    if (!factory) {
+        return;
+    }
+    auto shared = std::make_shared<HandlerFactory>(std::move(factory));
+    for (const auto& type : messageTypes) {
+        factories_[type] = shared;
+        handlers_.erase(type);
+        failedTypes_.erase(type);
+    }
+}
+
+void MessageRouter::registerHandlerFactory(LazyHandler lazy) {
+    registerHandlerFactory(lazy.types, std::move(lazy.factory));
+}
+
+std::shared_ptr<MessageHandler> MessageRouter::findHandler(const std::string& type) {
+    auto it = handlers_.find(type);
+    if (it != handlers_.end()) {
+        return it->second;
+    }
+    auto fit = factories_.find(type);
+    if (fit == factories_.end()) {
+        return nullptr;
+    }
+    std::shared_ptr<HandlerFactory> factory = fit->second;
+    std::shared_ptr<MessageHandler> handler;
+    std::string error = "no handler created";
+    try {
+        handler = (*factory)();
+    } catch (const std::exception& e) {
+        error = e.what();
+    }
+    if (!handler) {
+        // A failed plugin load or scan would fail the same way on every message: do not retry
+        std::cerr << "[MessageRouter] Failed to create handler for type " << type << ": " << error << std::endl;
+        for (auto f = factories_.begin(); f != factories_.end();) {
+            if (f->second == factory) {
+                failedTypes_[f->first] = error;
+                f = factories_.erase(f);
+            } else {
+                ++f;
+            }
+        }
+        return nullptr;
+    }
+    MSG_LOG(("  Instantiated lazy handler for type: " + type + "\n").c_str());
+    // The new instance serves every type still bound to this factory
+    for (auto f = factories_.begin(); f != factories_.end();) {
+        if (f->second == factory) {
+            handlers_[f->first] = handler;
+            f = factories_.erase(f);
+        } else {
+            ++f;
+        }
+    }
+    handlers_[type] = handler;
+    return handler;
+}
+
 void MessageRouter::routeMessage(const std::string& jsonMessage) {
     MSG_LOG("=== MessageRouter::routeMessage called ===\n");
     MSG_LOG(("  jsonMessage: " + jsonMessage.substr(0, 200) + (jsonMessage.length() > 200 ? "..." : "") + "\n").c_str());
@@ -66,14 +131,24 @@ void MessageRouter::routeMessage(const std::string& jsonMessage) {
     MSG_LOG(("  Parsed - type: " + type + ", requestId: " + requestId + "\n").c_str());
     std::cout << "[MessageRouter] Received message type: " << type << " (requestId: " << requestId << ")" << std::endl;
     
-    // Find handler for this message type
-    auto it = handlers_.find(type);
-    if (it == handlers_.end()) {
+    // Find handler for this message type (built on first use if registered lazily)
+    std::shared_ptr<MessageHandler> handler = findHandler(type);
+    auto failed = failedTypes_.find(type);
+    if (!handler && failed != failedTypes_.end()) {
+        if (!requestId.empty()) {
+            sendResponse(requestId, "", "Handler for " + type + " is unavailable: " + failed->second);
+        }
+        return;
+    }
+    if (!handler) {
         std::cerr << "[MessageRouter] ERROR: No handler registered for message type: " << type << std::endl;
         std::cerr << "[MessageRouter] Registered handlers: ";
         for (const auto& pair : handlers_) {
             std::cerr << pair.first << " ";
         }
+        for (const auto& pair : factories_) {
+            std::cerr << pair.first << " ";
+        }
         std::cerr << std::endl;
         if (!requestId.empty()) {
             sendResponse(requestId, "", "Unknown message type: " + type);
@@ -100,7 +175,7 @@ void MessageRouter::routeMessage(const std::string& jsonMessage) {
     MSG_LOG(("Calling handler for type: " + type + "\n").c_str());
     std::cout << "[MessageRouter] Calling handler for type: " << type << std::endl;
     try {
-        nlohmann::json result = it->second->handle(payloadJson, requestId);
+        nlohmann::json result = handler->handle(payloadJson, requestId);
         MSG_LOG(("Handler returned result: " + result.dump().substr(0, 150) + "\n").c_str());
         std::cout << "[MessageRouter] Handler returned successfully" << std::endl;
         
@@ -29,6 +29,10 @@ void runApplication() {
     }
 }
 
+void postToMainThread(void (*task)(void*), void* userData) {
+    dispatch_async_f(dispatch_get_main_queue(), userData, task);
+}
+
 void quitApplication() {
     @autoreleasepool {
         // On iOS, apps don't typically quit programmatically
@@ -46,6 +50,12 @@ void setKeyShortcutCallback(void (*)(const std::string&, void*), void*) {}
 void setAppOpenFileCallback(void (*)(const std::string&, void*), void*) {}
 void deliverOpenFilePaths(int, const char**) {}
 
+// Thumbnails are only decoded natively on Linux for now
+bool createThumbnail(const std::string&, int, std::vector<unsigned char>&, std::string&, int&, int&, std::string& error) {
+    error = "Thumbnails are not supported on this platform yet";
+    return false;
+}
+
 UIApplication* getApplication() {
     return g_app;
 }
@@ -59,6 +59,23 @@ void quitApplication() {
     }
 }
 
+struct MainThreadTask {
+    void (*task)(void*);
+    void* userData;
+};
+
+static gboolean runMainThreadTask(gpointer data) {
+    MainThreadTask* t = static_cast<MainThreadTask*>(data);
+    t->task(t->userData);
+    delete t;
+    return G_SOURCE_REMOVE;
+}
+
+void postToMainThread(void (*task)(void*), void* userData) {
+    // g_idle_add is thread-safe and dispatches on the default (GTK) main context
+    g_idle_add(runMainThreadTask, new MainThreadTask{task, userData});
+}
+
 static void (*s_activateCb)(void*) = nullptr;
 static void (*s_deactivateCb)(void*) = nullptr;
 static void* s_activateUd = nullptr;
@@ -0,0 +1,61 @@
+// Linux image thumbnails (GdkPixbuf)
+#include "../../../include/platform.h"
+#include "../platform_impl.h"
+#include <string>
+#include <vector>
+#include <gdk-pixbuf/gdk-pixbuf.h>
+
+#ifdef PLATFORM_LINUX
+
+namespace platform {
+
+bool createThumbnail(const std::string& path, int maxSize, std::vector<unsigned char>& data, std::string& mimeType,
+                     int& width, int& height, std::string& error) {
+    GError* err = nullptr;
+    int fullWidth = 0;
+    int fullHeight = 0;
+    if (!gdk_pixbuf_get_file_info(path.c_str(), &fullWidth, &fullHeight)) {
+        error = "Not a supported image";
+        return false;
+    }
+    // The loader scales while decoding (libjpeg decodes at 1/2, 1/4 or 1/8 where it can),
+    // so a large JPEG is never expanded to full size in memory. Small images are not enlarged.
+    GdkPixbuf* scaled = (fullWidth <= maxSize && fullHeight <= maxSize)
+        ? gdk_pixbuf_new_from_file(path.c_str(), &err)
+        : gdk_pixbuf_new_from_file_at_scale(path.c_str(), maxSize, maxSize, TRUE, &err);
+    if (!scaled) {
+        error = err ? err->message : "Failed to decode image";
+        if (err) g_error_free(err);
+        return false;
+    }
+    // Camera photos are stored sideways with an EXIF orientation tag
+    GdkPixbuf* oriented = gdk_pixbuf_apply_embedded_orientation(scaled);
+    g_object_unref(scaled);
+    if (!oriented) {
+        error = "Failed to rotate image";
+        return false;
+    }
+
+    bool alpha = gdk_pixbuf_get_has_alpha(oriented);
+    gchar* buffer = nullptr;
+    gsize size = 0;
+    gboolean saved = alpha
+        ? gdk_pixbuf_save_to_buffer(oriented, &buffer, &size, "png", &err, "compression", "6", nullptr)
+        : gdk_pixbuf_save_to_buffer(oriented, &buffer, &size, "jpeg", &err, "quality", "80", nullptr);
+    width = gdk_pixbuf_get_width(oriented);
+    height = gdk_pixbuf_get_height(oriented);
+    g_object_unref(oriented);
+    if (!saved) {
+        error = err ? err->message : "Failed to encode thumbnail";
+        if (err) g_error_free(err);
+        return false;
+    }
+    data.assign(reinterpret_cast<unsigned char*>(buffer), reinterpret_cast<unsigned char*>(buffer) + size);
+    g_free(buffer);
+    mimeType = alpha ? "image/png" : "image/jpeg";
+    return true;
+}
+
+} // namespace platform
+
+#endif // PLATFORM_LINUX
@@ -1,12 +1,13 @@
 // Linux web view implementation
 #include "../../../include/platform.h"
 #include "../platform_impl.h"
+#include "../../../include/asset_bundle.h"
 #include <string>
 #include <gtk/gtk.h>
 #include <webkit2/webkit2.h>
-#include <fstream>
-#include <sstream>
+#include <chrono>
 #include <cstring>
+#include <iostream>
 
 #ifdef PLATFORM_LINUX
 
@@ -23,6 +24,8 @@ struct WindowData {
 // Callback type for window creation
 typedef void (*CreateWindowCallback)(const std::string& title, void* userData);
 
+typedef void (*FirstPaintCallback)(double ms, void* userData);
+
 struct WebViewData {
     WebKitWebView* webView;
     GtkWidget* container;
@@ -31,8 +34,150 @@ struct WebViewData {
     MessageCallback messageCallback;
     void* messageUserData;
     std::string customPreloadScript;
+    std::chrono::steady_clock::time_point loadStart;  // last load*() call, for time-to-first-paint
+    FirstPaintCallback firstPaintCallback;
+    void* firstPaintUserData;
+    bool firstPaintPending;
+    double firstPaintMs;  // last measurement, < 0 until the first document painted
 };
 
+// Reset the first-paint clock; called by every load*() entry point
+static void markLoadStart(WebViewData* data) {
+    data->loadStart = std::chrono::steady_clock::now();
+    data->firstPaintPending = true;
+}
+
+// Paint timing from the page: first-contentful-paint when the engine reports it, else the frame
+// after DOMContentLoaded. Posted once per document to the "firstPaint" script message handler.
+static const char* kFirstPaintScript = R"(
+    (function(){
+        var sent=false;
+        function send(){if(sent)return;sent=true;try{window.webkit.messageHandlers.firstPaint.postMessage(1);}catch(_){}}
+        try{
+            var po=new PerformanceObserver(function(list){list.getEntries().forEach(function(e){if(e.name==='first-contentful-paint'){po.disconnect();send();}});});
+            po.observe({type:'paint',buffered:true});
+        }catch(_){}
+        document.addEventListener('DOMContentLoaded',function(){requestAnimationFrame(function(){requestAnimationFrame(send);});});
+    })();
+)";
+
+static void onFirstPaintReceived(WebKitUserContentManager*, WebKitJavascriptResult*, gpointer userData) {
+    WebViewData* data = static_cast<WebViewData*>(userData);
+    if (!data || !data->firstPaintPending) {
+        return;
+    }
+    data->firstPaintPending = false;
+    data->firstPaintMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - data->loadStart).count();
+    std::cout << "[WebView] Time to first paint: " << static_cast<long>(data->firstPaintMs) << " ms" << std::endl;
+    if (data->firstPaintCallback) {
+        data->firstPaintCallback(data->firstPaintMs, data->firstPaintUserData);
+    }
+}
+
+// Installed on every WebView at creation so the first document is measured even when the
+// callback is set after the initial load started (WebViewWindow loads in its constructor).
+static void installFirstPaintProbe(WebViewData* data) {
+    WebKitUserContentManager* manager = webkit_web_view_get_user_content_manager(data->webView);
+    webkit_user_content_manager_register_script_message_handler(manager, "firstPaint");
+    g_signal_connect(manager, "script-message-received::firstPaint", G_CALLBACK(onFirstPaintReceived), data);
+    WebKitUserScript* userScript = webkit_user_script_new(kFirstPaintScript,
+        WEBKIT_USER_CONTENT_INJECT_TOP_FRAME,
+        WEBKIT_USER_SCRIPT_INJECT_AT_DOCUMENT_START,
+        nullptr, nullptr);
+    webkit_user_content_manager_add_script(manager, userScript);
+    g_object_unref(userScript);
+}
+
+// All WebViews share one context so the app scheme and the persistent cache apply everywhere
+static std::string g_webCacheDirectory;
+static WebKitWebContext* g_webContext = nullptr;
+
+static WebKitWebContext* appWebContext() {
+    if (g_webContext) {
+        return g_webContext;
+    }
+    if (g_webCacheDirectory.empty()) {
+        g_webContext = webkit_web_context_get_default();
+    } else {
+        // Only the cache moves; localStorage/IndexedDB stay in the default data directory
+        WebKitWebsiteDataManager* manager = webkit_website_data_manager_new(
+            "base-cache-directory", g_webCacheDirectory.c_str(), nullptr);
+        g_webContext = webkit_web_context_new_with_website_data_manager(manager);
+        g_object_unref(manager);
+    }
+    // Largest memory + disk cache; cached responses are revalidated (ETag / Last-Modified) on reuse
+    webkit_web_context_set_cache_model(g_webContext, WEBKIT_CACHE_MODEL_DOCUMENT_BROWSER);
+    return g_webContext;
+}
+
+bool setWebCacheDirectory(const std::string& directory) {
+    if (g_webContext) {
+        std::cerr << "[WebView] setWebCacheDirectory must be called before the first WebView" << std::endl;
+        return false;
+    }
+    g_webCacheDirectory = directory;
+    return true;
+}
+
+// crossdev://app/<path>: serve the compiled-in asset bundle. The stream reads the static
+// arrays directly (no copy); gzip assets are inflated while WebKit reads.
+static void onAppSchemeRequest(WebKitURISchemeRequest* request, gpointer) {
+    std::string path;
+    const gchar* uri = webkit_uri_scheme_request_get_uri(request);
+    const asset_bundle::Asset* asset = nullptr;
+    if (uri && asset_bundle::pathFromUrl(uri, path)) {
+        asset = asset_bundle::find(path);
+    }
+    if (!asset) {
+        GError* error = g_error_new(G_IO_ERROR, G_IO_ERROR_NOT_FOUND, "Not in asset bundle: %s", uri ? uri : "");
+        webkit_uri_scheme_request_finish_error(request, error);
+        g_error_free(error);
+        return;
+    }
+
+    GInputStream* stream = g_memory_input_stream_new_from_data(asset->data, static_cast<gssize>(asset->size), nullptr);
+    if (asset->encoding == asset_bundle::Encoding::Gzip) {
+        GZlibDecompressor* decompressor = g_zlib_decompressor_new(G_ZLIB_COMPRESSOR_FORMAT_GZIP);
+        GInputStream* inflated = g_converter_input_stream_new(stream, G_CONVERTER(decompressor));
+        g_object_unref(decompressor);
+        g_object_unref(stream);
+        stream = inflated;
+    }
+    gint64 length = static_cast<gint64>(asset->originalSize);
+
+#if WEBKIT_CHECK_VERSION(2, 36, 0)
+    WebKitURISchemeResponse* response = webkit_uri_scheme_response_new(stream, length);
+    webkit_uri_scheme_response_set_content_type(response, asset->mimeType);
+    SoupMessageHeaders* headers = soup_message_headers_new(SOUP_MESSAGE_HEADERS_RESPONSE);
+    soup_message_headers_append(headers, "Cache-Control", asset_bundle::CACHE_CONTROL);
+    soup_message_headers_append(headers, "ETag", ("\"" + std::string(asset->hash) + "\"").c_str());
+    webkit_uri_scheme_response_set_http_headers(response, headers);  // takes ownership
+    webkit_uri_scheme_request_finish_with_response(request, response);
+    g_object_unref(response);
+#else
+    webkit_uri_scheme_request_finish(request, stream, length, asset->mimeType);
+#endif
+    g_object_unref(stream);
+}
+
+bool registerAppScheme() {
+    static bool registered = false;
+    if (registered) {
+        return true;
+    }
+    size_t count = 0;
+    asset_bundle::entries(count);
+    WebKitWebContext* context = appWebContext();
+    webkit_web_context_register_uri_scheme(context, asset_bundle::SCHEME, onAppSchemeRequest, nullptr, nullptr);
+    // Treat bundled pages like https: secure context, fetch()/XHR allowed between bundled files
+    WebKitSecurityManager* security = webkit_web_context_get_security_manager(context);
+    webkit_security_manager_register_uri_scheme_as_secure(security, asset_bundle::SCHEME);
+    webkit_security_manager_register_uri_scheme_as_cors_enabled(security, asset_bundle::SCHEME);
+    registered = true;
+    std::cout << "[WebView] Serving " << count << " bundled asset(s) at " << asset_bundle::url("") << std::endl;
+    return true;
+}
+
 void* createWebView(void* parentHandle, int x, int y, int width, int height) {
     if (!parentHandle) {
         return nullptr;
@@ -59,12 +204,18 @@ void* createWebView(void* parentHandle, int x, int y, int width, int height) {
     }
     
     WebViewData* webViewData = new WebViewData;
-    webViewData->webView = WEBKIT_WEB_VIEW(webkit_web_view_new());
+    webViewData->webView = WEBKIT_WEB_VIEW(webkit_web_view_new_with_context(appWebContext()));
     webViewData->container = GTK_WIDGET(webViewData->webView);
     webViewData->createWindowCallback = nullptr;
     webViewData->createWindowUserData = nullptr;
     webViewData->messageCallback = nullptr;
     webViewData->messageUserData = nullptr;
+    webViewData->loadStart = std::chrono::steady_clock::now();
+    webViewData->firstPaintCallback = nullptr;
+    webViewData->firstPaintUserData = nullptr;
+    webViewData->firstPaintPending = false;
+    webViewData->firstPaintMs = -1;
+    installFirstPaintProbe(webViewData);
     
     gtk_widget_set_size_request(webViewData->container, width, height);
     
@@ -100,27 +251,20 @@ void loadHTMLFile(void* webViewHandle, const std::string& filePath) {
     
     WebViewData* data = static_cast<WebViewData*>(webViewHandle);
     
-    std::ifstream file(filePath);
-    if (file.is_open()) {
-        std::stringstream buffer;
-        buffer << file.rdbuf();
-        std::string htmlContent = buffer.str();
-        file.close();
-        
-        // IMPORTANT: baseURL should be the DIRECTORY containing the HTML file
-        // This allows relative paths in HTML (like <script src="assets/file.js">) to resolve correctly
-        std::string dirPath = filePath;
-        size_t lastSlash = dirPath.find_last_of("/\\");
-        if (lastSlash != std::string::npos) {
-            dirPath = dirPath.substr(0, lastSlash + 1);  // Include the trailing slash
-        }
-        std::string baseURL = "file://" + dirPath;
-        
-        std::cout << "loadHTMLFile: filePath=" << filePath << std::endl;
-        std::cout << "loadHTMLFile: baseURL=" << baseURL << std::endl;
-        
-        webkit_web_view_load_html(data->webView, htmlContent.c_str(), baseURL.c_str());
+    // Load by URI instead of reading the file into a string: WebKit streams and parses from the
+    // first bytes, caches the document like any other resource, and the document base is the
+    // file's directory so relative paths (e.g. <script src="assets/file.js">) resolve.
+    GError* error = nullptr;
+    gchar* uri = g_filename_to_uri(filePath.c_str(), nullptr, &error);
+    if (!uri) {
+        std::cerr << "loadHTMLFile: invalid path " << filePath << ": " << (error ? error->message : "") << std::endl;
+        if (error) g_error_free(error);
+        return;
     }
+    std::cout << "loadHTMLFile: uri=" << uri << std::endl;
+    markLoadStart(data);
+    webkit_web_view_load_uri(data->webView, uri);
+    g_free(uri);
 }
 
 void loadHTMLString(void* webViewHandle, const std::string& html) {
@@ -129,6 +273,7 @@ void loadHTMLString(void* webViewHandle, const std::string& html) {
     }
     
     WebViewData* data = static_cast<WebViewData*>(webViewHandle);
+    markLoadStart(data);
     webkit_web_view_load_html(data->webView, html.c_str(), nullptr);
 }
 
@@ -138,6 +283,7 @@ void loadURL(void* webViewHandle, const std::string& url) {
     }
     
     WebViewData* data = static_cast<WebViewData*>(webViewHandle);
+    markLoadStart(data);
     webkit_web_view_load_uri(data->webView, url.c_str());
 }
 
@@ -290,6 +436,11 @@ void setWebViewMessageCallback(void* webViewHandle, void (*callback)(const std::
                         window.webkit.messageHandlers.nativeMessage.postMessage(msg);
                     }
                 }
+                var _state={};
+                function _stEntry(k){return _state[k]||(_state[k]={version:0,value:null,listeners:[]});}
+                function _stApply(doc,patch){for(var i=0;i<patch.length;i++){var op=patch[i];var ks=op.path===''?[]:op.path.slice(1).split('/').map(function(s){return s.replace(/~1/g,'/').replace(/~0/g,'~');});if(!ks.length){doc=op.op==='remove'?null:op.value;continue;}var p=doc;for(var j=0;j<ks.length-1;j++)p=p[ks[j]];var l=ks[ks.length-1];if(Array.isArray(p)){var x=l==='-'?p.length:parseInt(l,10);if(op.op==='add')p.splice(x,0,op.value);else if(op.op==='remove')p.splice(x,1);else p[x]=op.value;}else if(op.op==='remove')delete p[l];else p[l]=op.value;}return doc;}
+                function _stDelta(d,quiet){var s=_stEntry(d.key);if('value' in d)s.value=d.value;else if(d.fromVersion===s.version)s.value=_stApply(s.value,d.patch);else return CrossDev.invoke('stateGet',{key:d.key,sinceVersion:s.version}).then(function(r){return _stDelta(r,quiet);});var ch=d.version!==s.version;s.version=d.version;if(ch&&!quiet)s.listeners.forEach(function(fn){try{fn(s.value,s.version)}catch(err){console.error(err)}});return s.value;}
+                _eventListeners['state:changed']=[function(d){_stDelta(d);}];
                 var CrossDev={
                     invoke:function(type,payload,opts){
                         var opt=opts||{};
@@ -306,9 +457,15 @@ void setWebViewMessageCallback(void* webViewHandle, void (*callback)(const std::
                             _eventListeners[name].push(fn);
                             return function(){var i=_eventListeners[name].indexOf(fn);if(i>=0)_eventListeners[name].splice(i,1);};
                         }
+                    },
+                    state:{
+                        get:function(k){return CrossDev.invoke('stateGet',{key:k,sinceVersion:_stEntry(k).version}).then(function(d){return _stDelta(d);});},
+                        set:function(k,v){return CrossDev.invoke('stateSet',{key:k,value:v}).then(function(r){return r.version;});},
+                        subscribe:function(k,fn){var s=_stEntry(k);s.listeners.push(fn);var p=s.listeners.length===1?CrossDev.invoke('stateSubscribe',{key:k,sinceVersion:s.version}).then(function(d){return _stDelta(d,true);}):Promise.resolve(s.value);p.then(function(v){fn(v,s.version);});return function(){var i=s.listeners.indexOf(fn);if(i>=0)s.listeners.splice(i,1);if(!s.listeners.length)CrossDev.invoke('stateUnsubscribe',{key:k});};}
                     }
                 };
                 Object.freeze(CrossDev.events);
+                Object.freeze(CrossDev.state);
                 Object.freeze(CrossDev);
                 try{Object.defineProperty(window,'CrossDev',{value:CrossDev,configurable:false,writable:false});}catch(_){window.CrossDev=CrossDev;}
                 window.chrome=window.chrome||{};
@@ -327,6 +484,19 @@ void setWebViewMessageCallback(void* webViewHandle, void (*callback)(const std::
     }
 }
 
+void setWebViewFirstPaintCallback(void* webViewHandle, void (*callback)(double ms, void* userData), void* userData) {
+    if (!webViewHandle) {
+        return;
+    }
+    WebViewData* data = static_cast<WebViewData*>(webViewHandle);
+    data->firstPaintCallback = callback;
+    data->firstPaintUserData = userData;
+    // Current document already painted: report it now
+    if (callback && !data->firstPaintPending && data->firstPaintMs >= 0) {
+        callback(data->firstPaintMs, userData);
+    }
+}
+
 void setWebViewPreloadScript(void* webViewHandle, const std::string& scriptContent) {
     if (!webViewHandle) return;
     WebViewData* data = static_cast<WebViewData*>(webViewHandle);
@@ -115,6 +115,10 @@ void quitApplication() {
     }
 }
 
+void postToMainThread(void (*task)(void*), void* userData) {
+    dispatch_async_f(dispatch_get_main_queue(), userData, task);
+}
+
 void setKeyShortcutCallback(void (*callback)(const std::string& payloadJson, void* userData), void* userData) {
     g_keyShortcutCallback = callback;
     g_keyShortcutUserData = userData;
@@ -141,6 +145,12 @@ void deliverOpenFilePaths(int argc, const char* argv[]) {
     }
 }
 
+// Thumbnails are only decoded natively on Linux for now
+bool createThumbnail(const std::string&, int, std::vector<unsigned char>&, std::string&, int&, int&, std::string& error) {
+    error = "Thumbnails are not supported on this platform yet";
+    return false;
+}
+
 NSApplication* getApplication() {
     return g_app;
 }
@@ -93,6 +93,11 @@ typedef void (*MessageCallback)(const std::string& jsonMessage, void* userData);
         "window.webkit.messageHandlers.nativeMessage.postMessage(msg);"
         "}"
         "}"
+        "var _state={};"
+        "function _stEntry(k){return _state[k]||(_state[k]={version:0,value:null,listeners:[]});}"
+        "function _stApply(doc,patch){for(var i=0;i<patch.length;i++){var op=patch[i];var ks=op.path===''?[]:op.path.slice(1).split('/').map(function(s){return s.replace(/~1/g,'/').replace(/~0/g,'~');});if(!ks.length){doc=op.op==='remove'?null:op.value;continue;}var p=doc;for(var j=0;j<ks.length-1;j++)p=p[ks[j]];var l=ks[ks.length-1];if(Array.isArray(p)){var x=l==='-'?p.length:parseInt(l,10);if(op.op==='add')p.splice(x,0,op.value);else if(op.op==='remove')p.splice(x,1);else p[x]=op.value;}else if(op.op==='remove')delete p[l];else p[l]=op.value;}return doc;}"
+        "function _stDelta(d,quiet){var s=_stEntry(d.key);if('value' in d)s.value=d.value;else if(d.fromVersion===s.version)s.value=_stApply(s.value,d.patch);else return CrossDev.invoke('stateGet',{key:d.key,sinceVersion:s.version}).then(function(r){return _stDelta(r,quiet);});var ch=d.version!==s.version;s.version=d.version;if(ch&&!quiet)s.listeners.forEach(function(fn){try{fn(s.value,s.version)}catch(err){console.error(err)}});return s.value;}"
+        "_eventListeners['state:changed']=[function(d){_stDelta(d);}];"
         "var CrossDev={"
         "invoke:function(type,payload,opts){"
         "var opt=opts||{};"
@@ -110,9 +115,15 @@ typedef void (*MessageCallback)(const std::string& jsonMessage, void* userData);
         "_eventListeners[name].push(fn);"
         "return function(){var i=_eventListeners[name].indexOf(fn);if(i>=0)_eventListeners[name].splice(i,1);};"
         "}"
+        "},"
+        "state:{"
+        "get:function(k){return CrossDev.invoke('stateGet',{key:k,sinceVersion:_stEntry(k).version}).then(function(d){return _stDelta(d);});},"
+        "set:function(k,v){return CrossDev.invoke('stateSet',{key:k,value:v}).then(function(r){return r.version;});},"
+        "subscribe:function(k,fn){var s=_stEntry(k);s.listeners.push(fn);var p=s.listeners.length===1?CrossDev.invoke('stateSubscribe',{key:k,sinceVersion:s.version}).then(function(d){return _stDelta(d,true);}):Promise.resolve(s.value);p.then(function(v){fn(v,s.version);});return function(){var i=s.listeners.indexOf(fn);if(i>=0)s.listeners.splice(i,1);if(!s.listeners.length)CrossDev.invoke('stateUnsubscribe',{key:k});};}"
         "}"
         "};"
         "Object.freeze(CrossDev.events);"
+        "Object.freeze(CrossDev.state);"
         "Object.freeze(CrossDev);"
         "Object.defineProperty(window,'CrossDev',{value:CrossDev,configurable:false,writable:false});"
         "window.chrome=window.chrome||{};"
@@ -482,6 +493,16 @@ void printWebView(void* webViewHandle) {
     });
 }
 
+// WKWebView / WebView2 already keep a persistent disk cache in their default data store
+bool setWebCacheDirectory(const std::string&) { return false; }
+
+// App scheme (crossdev://app/) is only served on Linux for now
+bool registerAppScheme() { return false; }
+
+// Time-to-first-paint is only measured on Linux for now; the htmlLoading.precache fetches
+// start from this hook, so they do not run here either
+void setWebViewFirstPaintCallback(void*, void (*)(double, void*), void*) {}
+
 void openInspector(void* webViewHandle) {
     @autoreleasepool {
         if (!webViewHandle) return;
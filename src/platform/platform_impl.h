@@ -27,6 +27,15 @@ namespace platform {
     void loadURL(void* webViewHandle, const std::string& url);
     void setWebViewCreateWindowCallback(void* webViewHandle, void (*callback)(const std::string& title, void* userData), void* userData);
     void setWebViewMessageCallback(void* webViewHandle, void (*callback)(const std::string& jsonMessage, void* userData), void* userData);
+    // Persistent HTTP disk cache for all WebViews (kept across launches, revalidated on reuse).
+    // Call before the first WebView is created. Returns false if unsupported or too late.
+    bool setWebCacheDirectory(const std::string& directory);
+    // Serve the compiled-in asset bundle (asset_bundle.h) as crossdev://app/... in all WebViews.
+    // Call before the first WebView loads. Returns false where no scheme handler exists yet.
+    bool registerAppScheme();
+    // Time-to-first-paint hook: ms from the last load*() call to the document's first paint.
+    // Called once per loaded document (immediately if the current one already painted).
+    void setWebViewFirstPaintCallback(void* webViewHandle, void (*callback)(double ms, void* userData), void* userData);
     // Optional: set custom preload script before message callback. Empty = use built-in bridge.
     void setWebViewPreloadScript(void* webViewHandle, const std::string& scriptContent);
     void postMessageToJavaScript(void* webViewHandle, const std::string& jsonMessage);
@@ -99,6 +108,8 @@ namespace platform {
     void initApplication();
     void runApplication();
     void quitApplication();
+    // Run task(userData) on the UI thread; callable from any thread. Tasks run in post order.
+    void postToMainThread(void (*task)(void* userData), void* userData);
     // App activate/deactivate (macOS: become/resign key; Windows/Linux: optional)
     void setAppActivateCallback(void (*callback)(void*), void* userData);
     void setAppDeactivateCallback(void (*callback)(void*), void* userData);
@@ -115,6 +126,12 @@ namespace platform {
     void setAppOpenFileCallback(void (*callback)(const std::string& path, void* userData), void* userData);
     // Deliver file paths from argv to the callback (call after window is ready). Skips argv[0].
     void deliverOpenFilePaths(int argc, const char* argv[]);
+
+    // Image thumbnail: the image at path decoded and scaled to fit maxSize x maxSize (aspect
+    // kept, never enlarged, EXIF orientation applied), encoded as JPEG, or PNG if it has alpha.
+    // Callable from any thread. Linux: GdkPixbuf; other platforms return false for now.
+    bool createThumbnail(const std::string& path, int maxSize, std::vector<unsigned char>& data,
+                         std::string& mimeType, int& width, int& height, std::string& error);
 }
 
 #endif // PLATFORM_IMPL_H
@@ -5,6 +5,9 @@
 #include <windows.h>
 #include <string>
 #include <iostream>
+#include <deque>
+#include <mutex>
+#include <utility>
 #include <io.h>
 #include <fcntl.h>
 #include <objbase.h>
@@ -30,6 +33,38 @@ static bool g_comInitialized = false;
 
 LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
 
+// Message-only window that runs postToMainThread tasks (thread messages would be lost in modal loops)
+static const UINT WM_CROSSDEV_MAIN_THREAD_TASK = WM_APP + 0x40;
+static const UINT WM_CROSSDEV_DRAIN_TASKS = WM_APP + 0x41;
+static HWND g_taskWindow = nullptr;
+
+// Tasks posted before the task window exists or while PostMessageW fails (full message queue);
+// run in order the next time the task window handles a message
+static std::mutex g_pendingTasksMutex;
+static std::deque<std::pair<void (*)(void*), void*>> g_pendingTasks;
+
+static void runPendingTasks() {
+    std::deque<std::pair<void (*)(void*), void*>> tasks;
+    {
+        std::lock_guard<std::mutex> lock(g_pendingTasksMutex);
+        tasks.swap(g_pendingTasks);
+    }
+    for (const auto& task : tasks) task.first(task.second);
+}
+
+static LRESULT CALLBACK TaskWindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam) {
+    if (uMsg == WM_CROSSDEV_MAIN_THREAD_TASK) {
+        reinterpret_cast<void (*)(void*)>(wParam)(reinterpret_cast<void*>(lParam));
+        runPendingTasks();
+        return 0;
+    }
+    if (uMsg == WM_CROSSDEV_DRAIN_TASKS) {
+        runPendingTasks();
+        return 0;
+    }
+    return DefWindowProcW(hwnd, uMsg, wParam, lParam);
+}
+
 void initApplication() {
     if (!g_hInstance) {
         g_hInstance = GetModuleHandle(nullptr);
@@ -68,9 +103,37 @@ void initApplication() {
         wc.hCursor = LoadCursor(nullptr, IDC_ARROW);
         
         RegisterClassW(&wc);
+
+        WNDCLASSW taskClass = {};
+        taskClass.lpfnWndProc = TaskWindowProc;
+        taskClass.hInstance = g_hInstance;
+        taskClass.lpszClassName = L"CrossDevMainThreadTasks";
+        RegisterClassW(&taskClass);
+        HWND taskWindow = CreateWindowExW(0, taskClass.lpszClassName, L"", 0, 0, 0, 0, 0,
+                                          HWND_MESSAGE, nullptr, g_hInstance, nullptr);
+        if (taskWindow) {
+            std::lock_guard<std::mutex> lock(g_pendingTasksMutex);
+            g_taskWindow = taskWindow;
+            // Run whatever was posted before the window existed
+            PostMessageW(g_taskWindow, WM_CROSSDEV_DRAIN_TASKS, 0, 0);
+        } else {
+            std::cerr << "[Platform] Failed to create the main-thread task window" << std::endl;
+        }
     }
 }
 
+void postToMainThread(void (*task)(void*), void* userData) {
+    std::lock_guard<std::mutex> lock(g_pendingTasksMutex);
+    // Post straight through only when nothing is queued, so later tasks never overtake queued ones
+    if (g_pendingTasks.empty() && g_taskWindow &&
+        PostMessageW(g_taskWindow, WM_CROSSDEV_MAIN_THREAD_TASK,
+                     reinterpret_cast<WPARAM>(task), reinterpret_cast<LPARAM>(userData))) {
+        return;
+    }
+    g_pendingTasks.emplace_back(task, userData);
+    if (g_taskWindow) PostMessageW(g_taskWindow, WM_CROSSDEV_DRAIN_TASKS, 0, 0);
+}
+
 void runApplication() {
     MSG msg = {};
     while (GetMessage(&msg, nullptr, 0, 0)) {
@@ -152,6 +215,12 @@ void deliverOpenFilePaths(int argc, const char* argv[]) {
     }
 }
 
+// Thumbnails are only decoded natively on Linux for now
+bool createThumbnail(const std::string&, int, std::vector<unsigned char>&, std::string&, int&, int&, std::string& error) {
+    error = "Thumbnails are not supported on this platform yet";
+    return false;
+}
+
 HINSTANCE getInstance() {
     return g_hInstance;
 }
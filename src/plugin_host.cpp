@@ -0,0 +1,231 @@
+#include "../include/plugin_host.h"
+#include "../include/message_router.h"
+#include "../include/message_handler.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+namespace {
+
+// Adapts a plugin's C entry point to MessageHandler: payload JSON bytes in, result JSON bytes out.
+class PluginMessageHandler : public MessageHandler {
+public:
+    PluginMessageHandler(const CrossDevPluginApi* api, std::vector<std::string> types, std::vector<std::string> jobTypes)
+        : api_(api), types_(std::move(types)), jobTypes_(std::move(jobTypes)) {}
+
+    bool canHandle(const std::string& messageType) const override {
+        return std::find(types_.begin(), types_.end(), messageType) != types_.end();
+    }
+
+    // The plugin vouched for these in its manifest; a running call cannot be interrupted
+    bool canRunAsJob(const std::string& messageType) const override {
+        return std::find(jobTypes_.begin(), jobTypes_.end(), messageType) != jobTypes_.end();
+    }
+
+    nlohmann::json handle(const nlohmann::json& payload, const std::string& requestId) override {
+        (void)requestId;
+        std::string type = payload.value("_type", "");
+        std::string request = payload.dump();
+        char* response = nullptr;
+        size_t responseLen = 0;
+        int status = api_->handle(type.c_str(), request.data(), request.size(), &response, &responseLen);
+        std::string body = response ? std::string(response, responseLen) : std::string();
+        if (response && api_->freeBuffer) {
+            api_->freeBuffer(response);
+        }
+        if (status != 0) {
+            throw std::runtime_error(body.empty() ? "Plugin " + std::string(api_->name ? api_->name : "") + " failed" : body);
+        }
+        if (body.empty()) {
+            return nullptr;
+        }
+        return nlohmann::json::parse(body);
+    }
+
+    std::vector<std::string> getSupportedTypes() const override {
+        return types_;
+    }
+
+private:
+    const CrossDevPluginApi* api_;
+    std::vector<std::string> types_;
+    std::vector<std::string> jobTypes_;
+};
+
+} // namespace
+
+PluginHost& PluginHost::getInstance() {
+    static PluginHost instance;
+    return instance;
+}
+
+bool PluginHost::parseManifest(const std::string& path, Manifest& out, std::string& error) {
+    namespace fs = std::filesystem;
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        error = "Cannot open " + path;
+        return false;
+    }
+    nlohmann::json j;
+    try {
+        file >> j;
+    } catch (const nlohmann::json::exception& e) {
+        error = "Invalid JSON in " + path + ": " + e.what();
+        return false;
+    }
+    // Fields are type-checked before they are read: a third-party manifest must not throw
+    if (!j.is_object() || !j.contains("abi") || !j["abi"].is_number_integer() ||
+        j["abi"].get<int64_t>() != CROSSDEV_PLUGIN_ABI_VERSION) {
+        error = path + ": unsupported plugin ABI (expected " + std::to_string(CROSSDEV_PLUGIN_ABI_VERSION) + ")";
+        return false;
+    }
+    if (!j.contains("library") || !j["library"].is_string() ||
+        !j.contains("messageTypes") || !j["messageTypes"].is_array()) {
+        error = path + ": manifest needs \"library\" and \"messageTypes\"";
+        return false;
+    }
+    Manifest m;
+    fs::path manifestPath(path);
+    if (j.contains("name") && !j["name"].is_string()) {
+        error = path + ": \"name\" must be a string";
+        return false;
+    }
+    m.name = j.contains("name") ? j["name"].get<std::string>() : manifestPath.stem().string();
+    fs::path lib(j["library"].get<std::string>());
+    if (lib.is_relative()) {
+        lib = manifestPath.parent_path() / lib;
+    }
+    m.libraryPath = lib.lexically_normal().string();
+    for (const auto& t : j["messageTypes"]) {
+        if (t.is_string() && !t.get<std::string>().empty()) {
+            m.messageTypes.push_back(t.get<std::string>());
+        }
+    }
+    if (m.messageTypes.empty()) {
+        error = path + ": no message types declared";
+        return false;
+    }
+    if (j.contains("jobTypes") && j["jobTypes"].is_array()) {
+        for (const auto& t : j["jobTypes"]) {
+            if (t.is_string() &&
+                std::find(m.messageTypes.begin(), m.messageTypes.end(), t.get<std::string>()) != m.messageTypes.end()) {
+                m.jobTypes.push_back(t.get<std::string>());
+            }
+        }
+    }
+    out = std::move(m);
+    return true;
+}
+
+size_t PluginHost::scanDirectory(const std::string& dir) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    if (dir.empty() || !fs::is_directory(dir, ec)) {
+        return 0;
+    }
+    std::vector<std::string> paths;
+    for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->path().extension() == ".json" && it->is_regular_file(ec)) {
+            paths.push_back(it->path().string());
+        }
+    }
+    std::sort(paths.begin(), paths.end());  // Deterministic: later manifests override earlier types
+
+    size_t count = 0;
+    for (const auto& path : paths) {
+        Manifest m;
+        std::string error;
+        if (!parseManifest(path, m, error)) {
+            std::cerr << "[PluginHost] Skipping " << error << std::endl;
+            continue;
+        }
+        addManifest(m);
+        ++count;
+    }
+    return count;
+}
+
+void PluginHost::addManifest(const Manifest& manifest) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    manifests_.push_back(manifest);
+}
+
+std::vector<PluginHost::Manifest> PluginHost::getManifests() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return manifests_;
+}
+
+void PluginHost::registerHandlers(MessageRouter* router) {
+    if (!router) return;
+    for (const auto& manifest : getManifests()) {
+        router->registerHandlerFactory(manifest.messageTypes, [manifest]() -> std::shared_ptr<MessageHandler> {
+            std::string error;
+            const CrossDevPluginApi* api = PluginHost::getInstance().load(manifest, error);
+            if (!api) {
+                throw std::runtime_error(error);
+            }
+            return std::make_shared<PluginMessageHandler>(api, manifest.messageTypes, manifest.jobTypes);
+        });
+    }
+}
+
+const CrossDevPluginApi* PluginHost::load(const Manifest& manifest, std::string& error) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = loaded_.find(manifest.libraryPath);
+    if (it != loaded_.end()) {
+        return it->second;
+    }
+
+#if defined(_WIN32)
+    HMODULE h = LoadLibraryA(manifest.libraryPath.c_str());
+    if (!h) {
+        error = "Cannot load plugin library " + manifest.libraryPath;
+        return nullptr;
+    }
+    auto getApi = reinterpret_cast<CrossDevPluginGetApiFn>(GetProcAddress(h, CROSSDEV_PLUGIN_ENTRY_SYMBOL));
+#else
+    void* h = dlopen(manifest.libraryPath.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!h) {
+        const char* msg = dlerror();
+        error = "Cannot load plugin library " + manifest.libraryPath + (msg ? std::string(": ") + msg : "");
+        return nullptr;
+    }
+    auto getApi = reinterpret_cast<CrossDevPluginGetApiFn>(dlsym(h, CROSSDEV_PLUGIN_ENTRY_SYMBOL));
+#endif
+    const CrossDevPluginApi* api = getApi ? getApi() : nullptr;
+    if (!api || api->abiVersion != CROSSDEV_PLUGIN_ABI_VERSION || !api->handle) {
+        error = "Plugin " + manifest.name + " does not export a v" + std::to_string(CROSSDEV_PLUGIN_ABI_VERSION) +
+                " " + CROSSDEV_PLUGIN_ENTRY_SYMBOL;
+#if defined(_WIN32)
+        FreeLibrary(h);
+#else
+        dlclose(h);
+#endif
+        return nullptr;
+    }
+    // The manifest is what routes messages here; warn when it promises more than the library serves
+    for (const auto& type : manifest.messageTypes) {
+        bool found = false;
+        for (const char* const* t = api->messageTypes; t && *t; ++t) {
+            if (type == *t) {
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            std::cerr << "[PluginHost] Warning: " << manifest.name << " manifest declares " << type
+                      << " but the library does not list it" << std::endl;
+        }
+    }
+    std::cout << "[PluginHost] Loaded plugin " << manifest.name << " (" << manifest.libraryPath << ")" << std::endl;
+    loaded_[manifest.libraryPath] = api;
+    return api;
+}
@@ -0,0 +1,126 @@
+#include "../include/shared_state_store.h"
+#include "../include/native_event_bus.h"
+#include <utility>
+#include <vector>
+
+SharedStateStore& SharedStateStore::getInstance() {
+    static SharedStateStore instance;
+    return instance;
+}
+
+SharedStateStore::Snapshot SharedStateStore::get(const std::string& key) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Snapshot snap;
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+        snap.value = it->second.value;
+        snap.version = it->second.version;
+    }
+    return snap;
+}
+
+SharedStateStore::Delta SharedStateStore::getDelta(const std::string& key, uint64_t sinceVersion) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return makeDeltaLocked(key, sinceVersion);
+}
+
+SharedStateStore::Delta SharedStateStore::makeDeltaLocked(const std::string& key, uint64_t sinceVersion) const {
+    Delta delta;
+    delta.fromVersion = sinceVersion;
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        delta.isPatch = (sinceVersion == 0);
+        return delta;
+    }
+    const Entry& e = it->second;
+    delta.version = e.version;
+    if (sinceVersion == e.version) {
+        delta.isPatch = true;  // Up to date: empty patch
+        return delta;
+    }
+    // history holds consecutive versions; it covers sinceVersion if the oldest patch starts there
+    bool covered = sinceVersion > 0 && sinceVersion < e.version &&
+                   !e.history.empty() && e.history.front().version <= sinceVersion + 1;
+    if (!covered) {
+        delta.value = e.value;
+        return delta;
+    }
+    delta.isPatch = true;
+    for (const auto& p : e.history) {
+        if (p.version <= sinceVersion) continue;
+        for (const auto& op : p.patch) {
+            delta.patch.push_back(op);
+        }
+    }
+    return delta;
+}
+
+static nlohmann::json deltaToJson(const std::string& key, const SharedStateStore::Delta& delta) {
+    nlohmann::json j;
+    j["key"] = key;
+    j["fromVersion"] = delta.fromVersion;
+    j["version"] = delta.version;
+    if (delta.isPatch) {
+        j["patch"] = delta.patch;
+    } else {
+        j["value"] = delta.value;
+    }
+    return j;
+}
+
+uint64_t SharedStateStore::set(const std::string& key, const nlohmann::json& value) {
+    std::vector<std::pair<WebView*, std::string>> notifications;
+    uint64_t version = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Entry& e = entries_[key];
+        if (e.version > 0 && e.value == value) {
+            return e.version;  // Unchanged: no version bump, nothing on the bridge
+        }
+        nlohmann::json patch = nlohmann::json::diff(e.value, value);
+        e.value = value;
+        e.version++;
+        e.history.push_back({e.version, std::move(patch)});
+        while (e.history.size() > MAX_HISTORY) {
+            e.history.pop_front();
+        }
+        version = e.version;
+
+        for (auto& sub : subscribers_) {
+            auto keyIt = sub.second.find(key);
+            if (keyIt == sub.second.end()) continue;
+            Delta delta = makeDeltaLocked(key, keyIt->second);
+            keyIt->second = version;
+            notifications.emplace_back(sub.first, deltaToJson(key, delta).dump());
+        }
+    }
+    // Emit outside the lock: emitTo posts into the WebView and may re-enter the store
+    for (const auto& n : notifications) {
+        NativeEventBus::getInstance().emitTo(n.first, "state:changed", n.second);
+    }
+    return version;
+}
+
+SharedStateStore::Delta SharedStateStore::subscribe(WebView* webView, const std::string& key, uint64_t knownVersion) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Delta delta = makeDeltaLocked(key, knownVersion);
+    if (webView) {
+        subscribers_[webView][key] = delta.version;
+    }
+    return delta;
+}
+
+void SharedStateStore::unsubscribe(WebView* webView, const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = subscribers_.find(webView);
+    if (it == subscribers_.end()) return;
+    it->second.erase(key);
+    if (it->second.empty()) {
+        subscribers_.erase(it);
+    }
+}
+
+void SharedStateStore::unsubscribeAll(WebView* webView) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    subscribers_.erase(webView);
+}
@@ -0,0 +1,315 @@
+#include "../include/single_instance.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/file.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+// Launch -> primary: magic, then each path NUL-terminated; primary -> launch: kAck
+static const char kMagic[] = "CDOPEN1\n";
+static const char kAck[] = "ok\n";
+static const size_t kMaxMessageBytes = 1024 * 1024;
+static const int kPollSliceMs = 100;
+// The primary takes the lock a moment before it listens; a launch in between retries this long
+static const int kConnectRetryMs = 2000;
+// A forwarding launch that connects and then stalls cannot hold up the listener longer than this
+static const int kReceiveTimeoutMs = 1000;
+
+SingleInstance::SingleInstance(std::string socketPath) : socketPath_(std::move(socketPath)) {
+}
+
+SingleInstance::~SingleInstance() {
+    stop_ = true;
+    if (listener_.joinable()) {
+        listener_.join();
+    }
+#ifndef _WIN32
+    if (listenFd_ >= 0) {
+        close(listenFd_);
+        unlink(socketPath_.c_str());
+    }
+    if (lockFd_ >= 0) {
+        close(lockFd_);  // releases the lock: the next launch becomes the primary
+    }
+#endif
+}
+
+std::string SingleInstance::defaultSocketPath(const std::string& appName, const std::string& configDirectory) {
+#ifdef __linux__
+    const char* runtime = std::getenv("XDG_RUNTIME_DIR");
+    if (runtime && *runtime) {
+        return std::string(runtime) + "/" + appName + ".instance";
+    }
+#else
+    (void)appName;
+#endif
+    return configDirectory + "/instance.sock";
+}
+
+std::vector<std::string> SingleInstance::openPaths(int argc, const char* argv[]) {
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc && argv[i]; ++i) {
+        std::string arg = argv[i];
+        if (arg.empty() || arg[0] == '-') continue;
+        // The primary runs in another directory; URLs (file://, custom schemes) pass unchanged
+        std::error_code ec;
+        fs::path path = fs::u8path(arg);
+        if (arg.find("://") == std::string::npos && path.is_relative()) {
+            fs::path absolute = fs::absolute(path, ec);
+            if (!ec) arg = absolute.lexically_normal().u8string();
+        }
+        paths.push_back(arg);
+    }
+    return paths;
+}
+
+#ifdef _WIN32
+
+SingleInstance::Role SingleInstance::acquire(const std::vector<std::string>&, std::string& error, int) {
+    error = "Single-instance mode is not supported on this platform yet";
+    return Role::Standalone;
+}
+
+void SingleInstance::setHandler(PathsHandler) {
+}
+
+bool SingleInstance::forward(const std::vector<std::string>&, int, std::string&) {
+    return false;
+}
+
+bool SingleInstance::listen(std::string&) {
+    return false;
+}
+
+void SingleInstance::acceptLoop() {
+}
+
+void SingleInstance::receive(int) {
+}
+
+#else
+
+static std::string lastError() {
+    return std::strerror(errno);
+}
+
+static int unixSocket() {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0) {
+        fcntl(fd, F_SETFD, FD_CLOEXEC);  // never inherited by helpers the app spawns
+#ifdef SO_NOSIGPIPE
+        int on = 1;
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+    }
+    return fd;
+}
+
+static sockaddr_un socketAddress(const std::string& path) {
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return address;
+}
+
+static bool sendAll(int fd, const char* data, size_t size) {
+#ifdef MSG_NOSIGNAL
+    const int flags = MSG_NOSIGNAL;
+#else
+    const int flags = 0;
+#endif
+    while (size > 0) {
+        ssize_t n = send(fd, data, size, flags);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+static int remainingMs(std::chrono::steady_clock::time_point deadline) {
+    auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+    return static_cast<int>(std::max<int64_t>(left, 0));
+}
+
+SingleInstance::Role SingleInstance::acquire(const std::vector<std::string>& paths, std::string& error, int timeoutMs) {
+    if (socketPath_.size() >= sizeof(sockaddr_un::sun_path)) {
+        error = "Socket path is too long: " + socketPath_;
+        return Role::Standalone;
+    }
+    std::error_code ec;
+    fs::create_directories(fs::u8path(socketPath_).parent_path(), ec);
+    std::string lockPath = socketPath_ + ".lock";
+    lockFd_ = open(lockPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (lockFd_ < 0) {
+        error = "Cannot open " + lockPath + ": " + lastError();
+        return Role::Standalone;
+    }
+    if (flock(lockFd_, LOCK_EX | LOCK_NB) == 0) {
+        if (!listen(error)) {
+            close(lockFd_);
+            lockFd_ = -1;
+            return Role::Standalone;
+        }
+        return Role::Primary;
+    }
+    int lockError = errno;
+    close(lockFd_);
+    lockFd_ = -1;
+    if (lockError != EWOULDBLOCK) {
+        error = "Cannot lock " + lockPath + ": " + std::strerror(lockError);
+        return Role::Standalone;
+    }
+    return forward(paths, timeoutMs, error) ? Role::Forwarded : Role::Standalone;
+}
+
+bool SingleInstance::listen(std::string& error) {
+    // Holding the lock: whatever is at the path was left by an instance that is gone
+    unlink(socketPath_.c_str());
+    listenFd_ = unixSocket();
+    if (listenFd_ < 0) {
+        error = "Cannot create socket: " + lastError();
+        return false;
+    }
+    sockaddr_un address = socketAddress(socketPath_);
+    if (bind(listenFd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        chmod(socketPath_.c_str(), 0600) != 0 || ::listen(listenFd_, 16) != 0) {
+        error = "Cannot listen on " + socketPath_ + ": " + lastError();
+        close(listenFd_);
+        listenFd_ = -1;
+        unlink(socketPath_.c_str());
+        return false;
+    }
+    listener_ = std::thread([this]() { acceptLoop(); });
+    return true;
+}
+
+void SingleInstance::acceptLoop() {
+    while (!stop_) {
+        pollfd p = {listenFd_, POLLIN, 0};
+        if (poll(&p, 1, kPollSliceMs) <= 0) continue;
+        int fd = accept(listenFd_, nullptr, nullptr);
+        if (fd < 0) continue;
+        receive(fd);
+        close(fd);
+    }
+}
+
+void SingleInstance::receive(int fd) {
+    std::string message;
+    char buffer[4096];
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(kReceiveTimeoutMs);
+    while (message.size() <= kMaxMessageBytes) {
+        pollfd p = {fd, POLLIN, 0};
+        int ready = poll(&p, 1, remainingMs(deadline));
+        if (ready < 0 && errno == EINTR) continue;
+        if (ready <= 0) return;
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) return;
+        if (n == 0) break;
+        message.append(buffer, static_cast<size_t>(n));
+    }
+    const size_t magicSize = sizeof(kMagic) - 1;
+    if (message.size() > kMaxMessageBytes || message.compare(0, magicSize, kMagic) != 0) {
+        return;
+    }
+    std::vector<std::string> paths;
+    for (size_t start = magicSize; start < message.size();) {
+        size_t end = message.find('\0', start);
+        if (end == std::string::npos) return;  // truncated
+        paths.push_back(message.substr(start, end - start));
+        start = end + 1;
+    }
+    // Acknowledge first: the launch exits as soon as it reads this
+    sendAll(fd, kAck, sizeof(kAck) - 1);
+
+    PathsHandler handler;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!handler_) {
+            pending_.push_back(std::move(paths));
+            return;
+        }
+        handler = handler_;
+    }
+    handler(paths);
+}
+
+void SingleInstance::setHandler(PathsHandler handler) {
+    std::vector<std::vector<std::string>> pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        handler_ = handler;
+        pending.swap(pending_);
+    }
+    for (const auto& paths : pending) {
+        handler(paths);
+    }
+}
+
+bool SingleInstance::forward(const std::vector<std::string>& paths, int timeoutMs, std::string& error) {
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::milliseconds(timeoutMs);
+    auto connectDeadline = std::min(deadline, start + std::chrono::milliseconds(kConnectRetryMs));
+    sockaddr_un address = socketAddress(socketPath_);
+    int fd = -1;
+    while (true) {
+        fd = unixSocket();
+        if (fd < 0) {
+            error = "Cannot create socket: " + lastError();
+            return false;
+        }
+        if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0) break;
+        int connectError = errno;
+        close(fd);
+        bool notYetListening = connectError == ENOENT || connectError == ECONNREFUSED;
+        if (!notYetListening || std::chrono::steady_clock::now() >= connectDeadline) {
+            error = "Cannot reach the running instance: " + std::string(std::strerror(connectError));
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    std::string message = kMagic;
+    for (const auto& path : paths) {
+        message += path;
+        message += '\0';
+    }
+    bool sent = sendAll(fd, message.data(), message.size());
+    shutdown(fd, SHUT_WR);
+    std::string reply;
+    while (sent && reply.size() < sizeof(kAck) - 1) {
+        pollfd p = {fd, POLLIN, 0};
+        int ready = poll(&p, 1, remainingMs(deadline));
+        if (ready < 0 && errno == EINTR) continue;
+        if (ready <= 0) break;
+        char buffer[8];
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        reply.append(buffer, static_cast<size_t>(n));
+    }
+    close(fd);
+    if (reply != kAck) {
+        error = "The running instance did not respond";
+        return false;
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,97 @@
+#include "../include/thread_pool.h"
+#include <algorithm>
+#include <exception>
+#include <iostream>
+
+namespace {
+// Pool and worker index of the current thread (nullptr on non-worker threads)
+thread_local ThreadPool* t_pool = nullptr;
+thread_local size_t t_workerIndex = 0;
+}
+
+ThreadPool& ThreadPool::getInstance() {
+    static ThreadPool instance(std::max<size_t>(2, std::thread::hardware_concurrency()));
+    return instance;
+}
+
+ThreadPool::ThreadPool(size_t threadCount) {
+    if (threadCount == 0) threadCount = 1;
+    for (size_t i = 0; i < threadCount; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    for (size_t i = 0; i < threadCount; ++i) {
+        workers_[i]->thread = std::thread([this, i]() { run(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) worker->thread.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    size_t index = (t_pool == this) ? t_workerIndex : nextWorker_.fetch_add(1) % workers_.size();
+    queued_.fetch_add(1);  // before the push, so a pop never runs the count below zero
+    {
+        std::lock_guard<std::mutex> lock(workers_[index]->mutex);
+        workers_[index]->tasks.push_back(std::move(task));
+    }
+    {
+        // Pairs with the predicate check in run(): a worker about to sleep sees the new task
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+    }
+    wake_.notify_one();
+}
+
+bool ThreadPool::popLocal(size_t index, std::function<void()>& task) {
+    Worker& worker = *workers_[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty()) return false;
+    task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    return true;
+}
+
+bool ThreadPool::steal(size_t thief, std::function<void()>& task) {
+    for (size_t n = 1; n < workers_.size(); ++n) {
+        Worker& victim = *workers_[(thief + n) % workers_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::run(size_t index) {
+    t_pool = this;
+    t_workerIndex = index;
+    std::function<void()> task;
+    while (true) {
+        if (popLocal(index, task) || steal(index, task)) {
+            queued_.fetch_sub(1);
+            try {
+                task();
+            } catch (const std::exception& e) {
+                std::cerr << "[ThreadPool] Task failed: " << e.what() << std::endl;
+            } catch (...) {
+                std::cerr << "[ThreadPool] Task failed" << std::endl;
+            }
+            task = nullptr;
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        wake_.wait(lock, [this]() { return stopping_ || queued_.load() > 0; });
+        if (stopping_ && queued_.load() == 0) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,139 @@
+#include "../include/thumbnail_cache.h"
+#include "../include/hashing.h"
+#include "../include/handlers/file_system_handler.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+// First line of every entry: magic, width, height, MIME type
+static const char* const kMagic = "CDTHUMB1";
+static const char* const kEntrySuffix = ".thumb";
+// Prune after this many stores (and once per cache object, on the first store)
+static const unsigned kStoresPerPrune = 256;
+
+std::shared_ptr<ThumbnailCache> ThumbnailCache::forDirectory(const std::string& directory) {
+    static std::mutex registryMutex;
+    static std::map<std::string, std::shared_ptr<ThumbnailCache>> registry;
+
+    std::error_code ec;
+    fs::path normal = fs::absolute(fs::u8path(directory), ec).lexically_normal();
+    if (!normal.has_filename()) normal = normal.parent_path();  // "dir/" names dir
+    std::string key = ec ? directory : normal.u8string();
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::shared_ptr<ThumbnailCache>& cache = registry[key];
+    if (!cache) cache = std::make_shared<ThumbnailCache>(directory);
+    return cache;
+}
+
+ThumbnailCache::ThumbnailCache(std::string directory, uint64_t budget)
+    : directory_(std::move(directory)), budget_(budget) {
+}
+
+bool ThumbnailCache::key(const std::string& path, int maxSize, std::string& key, std::string& error) {
+    std::error_code ec;
+    fs::path p = fs::u8path(path);
+    fs::file_status status = fs::status(p, ec);
+    if (!fs::exists(status)) {
+        error = "File does not exist";
+        return false;
+    }
+    if (!fs::is_regular_file(status)) {
+        error = "Not a file";
+        return false;
+    }
+    uint64_t size = fs::file_size(p, ec);
+    auto mtime = fs::last_write_time(p, ec).time_since_epoch().count();
+    if (ec) {
+        error = "Failed to stat file: " + ec.message();
+        return false;
+    }
+    std::string identity = path + '\n' + std::to_string(size) + '\n' + std::to_string(mtime) + '\n' + std::to_string(maxSize);
+    key = hashing::hashBuffer(hashing::Algorithm::Xxh3, identity.data(), identity.size());
+    return true;
+}
+
+std::string ThumbnailCache::entryPath(const std::string& key) const {
+    return (fs::u8path(directory_) / (key + kEntrySuffix)).u8string();
+}
+
+bool ThumbnailCache::lookup(const std::string& key, Thumbnail& thumbnail) {
+    fs::path path = fs::u8path(entryPath(key));
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        return false;
+    }
+    std::string header;
+    std::getline(in, header);
+    std::istringstream fields(header);
+    std::string magic;
+    if (!(fields >> magic >> thumbnail.width >> thumbnail.height >> thumbnail.mimeType) || magic != kMagic) {
+        return false;
+    }
+    thumbnail.data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    if (thumbnail.data.empty()) {
+        return false;
+    }
+    // Recency for prune(); a failure only makes the entry look older
+    std::error_code ec;
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+    return true;
+}
+
+void ThumbnailCache::store(const std::string& key, const Thumbnail& thumbnail) {
+    std::error_code ec;
+    fs::create_directories(fs::u8path(directory_), ec);
+    fs::path target = fs::u8path(entryPath(key));
+    fs::path temp = hiddenSibling(target, ".tmp");
+    {
+        std::ofstream out(temp, std::ios::binary);
+        out << kMagic << ' ' << thumbnail.width << ' ' << thumbnail.height << ' ' << thumbnail.mimeType << '\n';
+        out.write(reinterpret_cast<const char*>(thumbnail.data.data()), static_cast<std::streamsize>(thumbnail.data.size()));
+        if (!out.flush()) {
+            out.close();
+            fs::remove(temp, ec);
+            return;  // a cache that cannot be written only costs a decode next time
+        }
+    }
+    fs::rename(temp, target, ec);
+    if (ec) {
+        fs::remove(temp, ec);
+        return;
+    }
+    if (storesSincePrune_++ % kStoresPerPrune == 0) {
+        prune();
+    }
+}
+
+void ThumbnailCache::prune() {
+    std::lock_guard<std::mutex> lock(pruneMutex_);
+    struct Entry {
+        fs::file_time_type used;
+        uint64_t size;
+        fs::path path;
+    };
+    std::vector<Entry> entries;
+    uint64_t total = 0;
+    std::error_code ec;
+    for (fs::directory_iterator it(fs::u8path(directory_), ec), end; !ec && it != end; it.increment(ec)) {
+        std::error_code entryEc;
+        Entry entry{it->last_write_time(entryEc), it->file_size(entryEc), it->path()};
+        if (entryEc || !it->is_regular_file(entryEc)) continue;
+        total += entry.size;
+        entries.push_back(std::move(entry));
+    }
+    if (total <= budget_) {
+        return;
+    }
+    // Trim to 3/4 of the budget so the next few stores do not prune again
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.used < b.used; });
+    for (const auto& entry : entries) {
+        if (total <= budget_ / 4 * 3) break;
+        if (fs::remove(entry.path, ec)) total -= entry.size;
+    }
+}
@@ -0,0 +1,70 @@
+#include "../include/web_precache.h"
+#include "../include/http_client.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+
+namespace web_precache {
+
+// RFC 3986 5.2.4 on the path; the query is kept as is
+static std::string removeDotSegments(const std::string& target) {
+    size_t queryStart = target.find('?');
+    std::string path = target.substr(0, queryStart);
+    std::string query = queryStart == std::string::npos ? std::string() : target.substr(queryStart);
+    std::vector<std::string> segments;
+    size_t start = 1;  // targets start with '/'
+    while (start <= path.size()) {
+        size_t end = path.find('/', start);
+        if (end == std::string::npos) end = path.size();
+        std::string segment = path.substr(start, end - start);
+        bool last = end == path.size();
+        if (segment == "..") {
+            if (!segments.empty()) segments.pop_back();
+            if (last) segments.push_back("");
+        } else if (segment == ".") {
+            if (last) segments.push_back("");
+        } else {
+            segments.push_back(segment);
+        }
+        start = end + 1;
+    }
+    std::string result;
+    for (const auto& segment : segments) {
+        result += "/" + segment;
+    }
+    return (result.empty() ? "/" : result) + query;
+}
+
+std::vector<std::string> resolve(const std::string& pageUrl, const std::vector<std::string>& entries) {
+    std::vector<std::string> urls;
+    http::Url page;
+    std::string error;
+    if (!http::Url::parse(pageUrl, page, error)) {
+        return urls;
+    }
+    for (const auto& entry : entries) {
+        size_t colon = entry.find(':');
+        bool otherScheme = colon != std::string::npos && colon < entry.find('/') && entry.compare(colon, 3, "://") != 0;
+        if (entry.empty() || otherScheme) continue;  // data:, blob:, javascript:, ...
+        std::string absolute = page.resolve(entry.substr(0, entry.find('#')));
+        http::Url url;
+        if (!http::Url::parse(absolute, url, error) || url.origin() != page.origin()) continue;
+        url.target = removeDotSegments(url.target);
+        std::string text = url.toString();
+        if (std::find(urls.begin(), urls.end(), text) == urls.end()) {
+            urls.push_back(text);
+        }
+    }
+    return urls;
+}
+
+// cache:'no-cache' revalidates entries that are already cached (304, no body)
+std::string script(const std::vector<std::string>& urls) {
+    return "(function(urls){if(!window.fetch)return;var i=0,ok=0;"
+           "function next(){if(i>=urls.length){console.log('[CrossDev] precache: '+ok+'/'+urls.length+' asset(s) cached');return;}"
+           "var u=urls[i++];"
+           "fetch(u,{cache:'no-cache',credentials:'same-origin'}).then(function(r){if(r.ok)ok++;return r.arrayBuffer();})"
+           ".catch(function(e){console.warn('[CrossDev] precache failed: '+u,e);}).then(next);}"
+           "(window.requestIdleCallback||setTimeout)(next);})(" + nlohmann::json(urls).dump() + ");";
+}
+
+} // namespace web_precache
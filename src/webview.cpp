@@ -28,7 +28,8 @@ WebView::WebView(WebView&& other) noexcept
     : Control(std::move(other)),
       nativeHandle_(other.nativeHandle_),
       createWindowCallback_(std::move(other.createWindowCallback_)),
-      messageCallback_(std::move(other.messageCallback_)) {
+      messageCallback_(std::move(other.messageCallback_)),
+      firstPaintCallback_(std::move(other.firstPaintCallback_)) {
     other.nativeHandle_ = nullptr;
 }
 
@@ -42,6 +43,7 @@ WebView& WebView::operator=(WebView&& other) noexcept {
         nativeHandle_ = other.nativeHandle_;
         createWindowCallback_ = std::move(other.createWindowCallback_);
         messageCallback_ = std::move(other.messageCallback_);
+        firstPaintCallback_ = std::move(other.firstPaintCallback_);
         
         other.nativeHandle_ = nullptr;
     }
@@ -109,6 +111,9 @@ void WebView::OnParentChanged(Control* oldParent, Control* newParent) {
         if (messageCallback_) {
             setMessageCallback(messageCallback_);
         }
+        if (firstPaintCallback_) {
+            setFirstPaintCallback(firstPaintCallback_);
+        }
     }
 }
 
@@ -144,6 +149,15 @@ void WebView::setMessageCallback(std::function<void(const std::string& jsonMessa
         messageCallbackWrapper, this);
 }
 
+void WebView::setFirstPaintCallback(std::function<void(double ms)> callback) {
+    if (!nativeHandle_) {
+        return;
+    }
+    firstPaintCallback_ = callback;
+    platform::setWebViewFirstPaintCallback(nativeHandle_,
+        firstPaintCallbackWrapper, this);
+}
+
 void WebView::postMessageToJavaScript(const std::string& jsonMessage) {
     if (!nativeHandle_) {
         return;
@@ -164,3 +178,10 @@ void WebView::messageCallbackWrapper(const std::string& jsonMessage, void* userD
         webview->messageCallback_(jsonMessage);
     }
 }
+
+void WebView::firstPaintCallbackWrapper(double ms, void* userData) {
+    WebView* webview = static_cast<WebView*>(userData);
+    if (webview && webview->firstPaintCallback_) {
+        webview->firstPaintCallback_(ms);
+    }
+}
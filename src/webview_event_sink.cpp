@@ -0,0 +1,22 @@
+#include "../include/webview_event_sink.h"
+#include "../include/main_thread.h"
+#include "../include/native_event_bus.h"
+
+void WebViewEventSink::emit(const std::string& eventName, nlohmann::json payload) {
+    std::shared_ptr<WebViewEventSink> self = shared_from_this();
+    runOnMainThread([self, eventName, payload = std::move(payload)]() {
+        WebView* webView = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(self->mutex_);
+            webView = self->webView_;
+        }
+        if (webView) {
+            NativeEventBus::getInstance().emitTo(webView, eventName, payload.dump());
+        }
+    });
+}
+
+void WebViewEventSink::detach() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    webView_ = nullptr;
+}
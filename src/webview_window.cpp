@@ -2,6 +2,7 @@
 #include "../include/application.h"
 #include "../include/config_manager.h"
 #include "../include/native_event_bus.h"
+#include "../include/shared_state_store.h"
 #include "../include/platform.h"
 #include "platform/platform_impl.h"
 #include <nlohmann/json.hpp>
@@ -146,6 +147,7 @@ WebViewWindow::~WebViewWindow() {
     }
     if (webView_) {
         NativeEventBus::getInstance().unsubscribe(webView_.get());
+        SharedStateStore::getInstance().unsubscribeAll(webView_.get());
     }
     // Unique pointers and Component will clean up owned components
 }
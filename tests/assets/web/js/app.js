@@ -0,0 +1,41 @@
+// Fixture for test_asset_bundle: repetitive so gzip always wins
+function handler0(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler1(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler2(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler3(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler4(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler5(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler6(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler7(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler8(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler9(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler10(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler11(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler12(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler13(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler14(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler15(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler16(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler17(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler18(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler19(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler20(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler21(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler22(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler23(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler24(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler25(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler26(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler27(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler28(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler29(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler30(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler31(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler32(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler33(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler34(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler35(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler36(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler37(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler38(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
+function handler39(payload) { return CrossDev.invoke('calculate', { a: payload.a, b: payload.b, op: 'add' }); }
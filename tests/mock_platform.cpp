@@ -4,9 +4,16 @@
 
 #include "../include/platform.h"
 #include "../src/platform/platform_impl.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
 #include <string>
 #include <map>
+#include <set>
 #include <cstdint>
+#include <mutex>
+#include <vector>
+#include <utility>
 
 namespace platform {
 
@@ -26,7 +33,7 @@ void* createWindow(int x, int y, int width, int height, const std::string& title
     data->handle = (void*)g_nextHandleValue++;
     data->visible = false;
     data->title = title;
-    g_mockWindows[data->handle] = data;
+    g_mockWindows[data] = data;  // Keyed by the returned handle
     return data;
 }
 
@@ -103,29 +110,58 @@ void showContextMenu(void*, int, int, const std::string&, void (*)(const std::st
 
 void setMenuItemEnabled(void*, const std::string&, bool) {}
 
+static std::set<void*> g_mockWebViews;
+struct MockMessageCallback {
+    void (*callback)(const std::string&, void*);
+    void* userData;
+};
+static std::map<void*, MockMessageCallback> g_mockMessageCallbacks;
+
+// Native handles created and not yet destroyed (leak checks in soak tests)
+size_t mockLiveHandleCount() {
+    return g_mockWindows.size() + g_mockWebViews.size();
+}
+
 // WebView functions
 void* createWebView(void* parentHandle, int x, int y, int width, int height) {
-    return (void*)g_nextHandleValue++;
+    void* handle = (void*)g_nextHandleValue++;
+    g_mockWebViews.insert(handle);
+    return handle;
 }
 
+// Last load request per WebView: "file:<path>", "html:<markup>" or "url:<url>"
+static std::map<void*, std::string> g_mockLoads;
+
+static std::mutex g_mockPostedMutex;
+static std::map<void*, std::vector<std::string>> g_mockPostedMessages;
+
 void destroyWebView(void* webViewHandle) {
-    // Mock implementation
+    g_mockWebViews.erase(webViewHandle);
+    g_mockMessageCallbacks.erase(webViewHandle);
+    g_mockLoads.erase(webViewHandle);
+    std::lock_guard<std::mutex> lock(g_mockPostedMutex);
+    g_mockPostedMessages.erase(webViewHandle);
 }
 
 void resizeWebView(void* webViewHandle, int width, int height) {
     // Mock implementation
 }
 
+std::string mockLastLoad(void* webViewHandle) {
+    auto it = g_mockLoads.find(webViewHandle);
+    return it != g_mockLoads.end() ? it->second : std::string();
+}
+
 void loadHTMLFile(void* webViewHandle, const std::string& filePath) {
-    // Mock implementation
+    g_mockLoads[webViewHandle] = "file:" + filePath;
 }
 
 void loadHTMLString(void* webViewHandle, const std::string& html) {
-    // Mock implementation
+    g_mockLoads[webViewHandle] = "html:" + html;
 }
 
 void loadURL(void* webViewHandle, const std::string& url) {
-    // Mock implementation
+    g_mockLoads[webViewHandle] = "url:" + url;
 }
 
 void setWebViewCreateWindowCallback(void* webViewHandle, void (*callback)(const std::string& title, void* userData), void* userData) {
@@ -133,13 +169,34 @@ void setWebViewCreateWindowCallback(void* webViewHandle, void (*callback)(const
 }
 
 void setWebViewMessageCallback(void* webViewHandle, void (*callback)(const std::string& jsonMessage, void* userData), void* userData) {
-    // Mock implementation
+    g_mockMessageCallbacks[webViewHandle] = {callback, userData};
+}
+
+// Simulate a message posted by JavaScript in the given WebView
+void mockDeliverMessage(void* webViewHandle, const std::string& jsonMessage) {
+    auto it = g_mockMessageCallbacks.find(webViewHandle);
+    if (it != g_mockMessageCallbacks.end() && it->second.callback) {
+        it->second.callback(jsonMessage, it->second.userData);
+    }
 }
 
 void setWebViewPreloadScript(void*, const std::string&) {}
+void openInspector(void*) {}
+void setWebViewFirstPaintCallback(void*, void (*)(double, void*), void*) {}
+bool registerAppScheme() { return false; }
+bool setWebCacheDirectory(const std::string&) { return false; }
 
 void postMessageToJavaScript(void* webViewHandle, const std::string& jsonMessage) {
-    // Mock implementation
+    std::lock_guard<std::mutex> lock(g_mockPostedMutex);
+    g_mockPostedMessages[webViewHandle].push_back(jsonMessage);
+}
+
+// Messages posted to JavaScript in the given WebView since the last call
+std::vector<std::string> mockTakePostedMessages(void* webViewHandle) {
+    std::lock_guard<std::mutex> lock(g_mockPostedMutex);
+    std::vector<std::string> messages;
+    messages.swap(g_mockPostedMessages[webViewHandle]);
+    return messages;
 }
 
 void executeWebViewScript(void* webViewHandle, const std::string& script) {
@@ -232,6 +289,28 @@ void quitApplication() {
     // Mock implementation
 }
 
+// Main-thread tasks are queued until the test drains them (the test thread acts as the UI thread)
+static std::mutex g_mockTaskMutex;
+static std::vector<std::pair<void (*)(void*), void*>> g_mockMainThreadTasks;
+
+void postToMainThread(void (*task)(void*), void* userData) {
+    std::lock_guard<std::mutex> lock(g_mockTaskMutex);
+    g_mockMainThreadTasks.emplace_back(task, userData);
+}
+
+// Run the queued main-thread tasks; returns how many ran
+size_t mockRunMainThreadTasks() {
+    std::vector<std::pair<void (*)(void*), void*>> tasks;
+    {
+        std::lock_guard<std::mutex> lock(g_mockTaskMutex);
+        tasks.swap(g_mockMainThreadTasks);
+    }
+    for (auto& t : tasks) {
+        t.first(t.second);
+    }
+    return tasks.size();
+}
+
 void setAppActivateCallback(void (*)(void*), void*) {}
 void setAppDeactivateCallback(void (*)(void*), void*) {}
 void setThemeChangeCallback(void (*)(const char*, void*), void*) {}
@@ -239,4 +318,31 @@ void setKeyShortcutCallback(void (*)(const std::string&, void*), void*) {}
 void setAppOpenFileCallback(void (*)(const std::string&, void*), void*) {}
 void deliverOpenFilePaths(int, const char**) {}
 
+// Thumbnails of binary PPM (P6) images: the "encoded" data names the scaled size
+static std::atomic<size_t> g_mockThumbnailDecodes{0};
+
+bool createThumbnail(const std::string& path, int maxSize, std::vector<unsigned char>& data, std::string& mimeType,
+                     int& width, int& height, std::string& error) {
+    ++g_mockThumbnailDecodes;
+    std::ifstream in(path, std::ios::binary);
+    std::string magic;
+    int w = 0, h = 0;
+    if (!(in >> magic >> w >> h) || magic != "P6" || w <= 0 || h <= 0) {
+        error = "Not a supported image";
+        return false;
+    }
+    double scale = std::min(1.0, static_cast<double>(maxSize) / std::max(w, h));
+    width = std::max(1, static_cast<int>(w * scale + 0.5));
+    height = std::max(1, static_cast<int>(h * scale + 0.5));
+    std::string encoded = "mock-jpeg " + std::to_string(width) + "x" + std::to_string(height);
+    data.assign(encoded.begin(), encoded.end());
+    mimeType = "image/jpeg";
+    return true;
+}
+
+// createThumbnail calls so far
+size_t mockThumbnailDecodes() {
+    return g_mockThumbnailDecodes.load();
+}
+
 } // namespace platform
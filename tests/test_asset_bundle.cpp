@@ -0,0 +1,79 @@
+#include "../include/asset_bundle.h"
+#include "../include/settings_embed.h"
+#include <iostream>
+#include <cassert>
+#include <cstring>
+
+// Built against the fixture bundle: settings.html + tests/assets/web
+
+// Test 1: Index is sorted and lookups are exact
+void test_find() {
+    std::cout << "Test 1: Find...\n";
+
+    size_t count = 0;
+    const asset_bundle::Asset* assets = asset_bundle::entries(count);
+    assert(count == 3);
+    for (size_t i = 1; i < count; ++i) {
+        assert(std::strcmp(assets[i - 1].path, assets[i].path) < 0);
+    }
+
+    const asset_bundle::Asset* index = asset_bundle::find("index.html");
+    assert(index && std::strcmp(index->mimeType, "text/html; charset=utf-8") == 0);
+    assert(asset_bundle::find("/index.html") == index);
+    assert(asset_bundle::find("js/app.js") != nullptr);
+    assert(asset_bundle::find("js/missing.js") == nullptr);
+    assert(asset_bundle::find("") == nullptr);
+    assert(std::strlen(index->hash) == 16);
+
+    std::cout << "✓ Test 1 passed\n\n";
+}
+
+// Test 2: Compressible assets are gzip streams; raw files and small files are stored as-is
+void test_encoding() {
+    std::cout << "Test 2: Encoding...\n";
+
+    const asset_bundle::Asset* js = asset_bundle::find("js/app.js");
+    assert(js->encoding == asset_bundle::Encoding::Gzip);
+    assert(js->size < js->originalSize);
+    assert(js->data[0] == 0x1f && js->data[1] == 0x8b);  // gzip magic
+    assert(std::strcmp(js->mimeType, "text/javascript; charset=utf-8") == 0);
+
+    const asset_bundle::Asset* settings = asset_bundle::find("settings.html");
+    assert(settings->encoding == asset_bundle::Encoding::Identity);
+    assert(settings->size == settings->originalSize);
+    assert(getEmbeddedSettingsHtml().size() == settings->size);
+    assert(getEmbeddedSettingsHtml().find("<html") != std::string::npos);
+
+    std::cout << "✓ Test 2 passed\n\n";
+}
+
+// Test 3: App-scheme URLs map to bundle paths
+void test_urls() {
+    std::cout << "Test 3: URLs...\n";
+
+    std::string path;
+    assert(asset_bundle::url("index.html") == "crossdev://app/index.html");
+    bool resolved = asset_bundle::pathFromUrl("crossdev://app/js/app.js?v=1#x", path);
+    assert(resolved && path == "js/app.js");
+    resolved = asset_bundle::pathFromUrl("crossdev://app/", path);
+    assert(resolved && path == "index.html");
+    resolved = asset_bundle::pathFromUrl("crossdev://app", path);
+    assert(resolved && path == "index.html");
+    resolved = asset_bundle::pathFromUrl("crossdev://application/index.html", path);
+    assert(!resolved);
+    resolved = asset_bundle::pathFromUrl("https://app/index.html", path);
+    assert(!resolved);
+
+    std::cout << "✓ Test 3 passed\n\n";
+}
+
+int main() {
+    std::cout << "=== AssetBundle Tests ===\n\n";
+
+    test_find();
+    test_encoding();
+    test_urls();
+
+    std::cout << "=== All tests passed! ===\n";
+    return 0;
+}
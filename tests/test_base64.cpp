@@ -0,0 +1,136 @@
+#include "../include/base64.h"
+#include <iostream>
+#include <cassert>
+#include <cstring>
+#include <random>
+
+// Independent reference: RFC 4648 one group at a time
+static std::string referenceEncode(const std::vector<unsigned char>& data) {
+    static const char* chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    for (size_t i = 0; i < data.size(); i += 3) {
+        unsigned int n = data[i] << 16;
+        if (i + 1 < data.size()) n |= data[i + 1] << 8;
+        if (i + 2 < data.size()) n |= data[i + 2];
+        out += chars[(n >> 18) & 63];
+        out += chars[(n >> 12) & 63];
+        out += i + 1 < data.size() ? chars[(n >> 6) & 63] : '=';
+        out += i + 2 < data.size() ? chars[n & 63] : '=';
+    }
+    return out;
+}
+
+static std::vector<unsigned char> randomBytes(std::mt19937& rng, size_t len) {
+    std::vector<unsigned char> data(len);
+    for (auto& b : data) b = static_cast<unsigned char>(rng());
+    return data;
+}
+
+// Lengths around every kernel's block and margin boundaries, plus a few large ones
+static std::vector<size_t> fuzzLengths(std::mt19937& rng) {
+    std::vector<size_t> lengths;
+    for (size_t len = 0; len <= 260; ++len) lengths.push_back(len);
+    for (int i = 0; i < 200; ++i) lengths.push_back(rng() % 20000);
+    lengths.push_back(1 << 20);
+    lengths.push_back((1 << 20) + 1);
+    return lengths;
+}
+
+// Test 1: Every kernel matches the reference, writes exactly encodedSize/decodedSize bytes
+void test_round_trip() {
+    std::cout << "Test 1: Round trip against the reference...\n";
+
+    std::mt19937 rng(1234);
+    std::vector<size_t> lengths = fuzzLengths(rng);
+    for (base64::Kernel kernel : base64::supportedKernels()) {
+        bool selected = base64::setKernel(kernel);
+        assert(selected);
+        for (size_t len : lengths) {
+            std::vector<unsigned char> data = randomBytes(rng, len);
+            std::string expected = referenceEncode(data);
+
+            // Caller-provided buffers with guard bytes
+            std::string encoded(base64::encodedSize(len) + 8, '#');
+            size_t encodedLength = base64::encode(data.data(), len, &encoded[0]);
+            assert(encodedLength == expected.size());
+            assert(encoded.compare(0, expected.size(), expected) == 0);
+            assert(encoded.compare(expected.size(), 8, "########") == 0);
+
+            size_t size = base64::decodedSize(expected.data(), expected.size());
+            assert(size == len);
+            std::vector<unsigned char> decoded(size + 8, 0xAB);
+            size_t written = 0;
+            bool valid = base64::decode(expected.data(), expected.size(), decoded.data(), written);
+            assert(valid && written == len);
+            assert(std::memcmp(decoded.data(), data.data(), len) == 0);
+            for (size_t g = 0; g < 8; ++g) assert(decoded[len + g] == 0xAB);
+
+            assert(base64::encode(data) == expected);
+            assert(base64::decode(expected) == data);
+        }
+        std::cout << "  " << base64::kernelName(kernel) << " ok\n";
+    }
+
+    std::cout << "✓ Test 1 passed\n\n";
+}
+
+// Test 2: Corrupted input is rejected by every kernel, wherever the bad char lands
+void test_invalid_input() {
+    std::cout << "Test 2: Invalid input...\n";
+
+    const char bad[] = {'=', '-', '_', ' ', '\n', '\0', '@', '[', '`', '{', '\x7f', '\x80', '\xff'};
+    std::mt19937 rng(99);
+    for (base64::Kernel kernel : base64::supportedKernels()) {
+        base64::setKernel(kernel);
+        for (int round = 0; round < 3000; ++round) {
+            std::string encoded = referenceEncode(randomBytes(rng, 1 + rng() % 300));
+            size_t limit = encoded.size();
+            while (limit > 0 && encoded[limit - 1] == '=') --limit;
+            if (limit == 0) continue;
+            size_t pos = rng() % limit;
+            char c = bad[rng() % sizeof(bad)];
+            if (c == '=' && pos >= encoded.size() - 2 && pos + 1 == limit) continue;  // still valid padding
+            encoded[pos] = c;
+            assert(base64::decode(encoded).empty());
+        }
+        assert(base64::decode("YQ=a").empty());
+        assert(base64::decode("Y===").empty());
+        assert(base64::decode("====").empty());
+        assert(base64::decode("YQ==YQ==").empty());
+        assert(base64::decode("YWJj").size() == 3);
+        assert(base64::decode("YWJ").empty());
+    }
+
+    std::cout << "✓ Test 2 passed\n\n";
+}
+
+// Test 3: Dispatch picks the fastest supported kernel and refuses unsupported ones
+void test_dispatch() {
+    std::cout << "Test 3: Dispatch...\n";
+
+    std::vector<base64::Kernel> kernels = base64::supportedKernels();
+    assert(!kernels.empty() && kernels.front() == base64::Kernel::Scalar);
+    for (base64::Kernel kernel : {base64::Kernel::Ssse3, base64::Kernel::Avx2, base64::Kernel::Neon}) {
+        bool supported = false;
+        for (base64::Kernel k : kernels) supported = supported || k == kernel;
+        bool selected = base64::setKernel(kernel);
+        assert(selected == supported);
+    }
+    bool selected = base64::setKernel(kernels.back());
+    assert(selected);
+    assert(base64::activeKernel() == kernels.back());
+    std::cout << "  active: " << base64::kernelName(base64::activeKernel()) << "\n";
+
+    std::cout << "✓ Test 3 passed\n\n";
+}
+
+int main() {
+    std::cout << "=== Base64 Tests ===\n\n";
+
+    test_round_trip();
+    test_invalid_input();
+    test_dispatch();
+
+    std::cout << "=== All tests passed! ===\n";
+    return 0;
+}
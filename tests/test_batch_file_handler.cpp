@@ -0,0 +1,292 @@
+#include "../include/handlers/batch_file_handler.h"
+#include "../include/batch_io.h"
+#include "../include/base64.h"
+#include "../include/thread_pool.h"
+#include "test_support.h"
+#include <nlohmann/json.hpp>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <cassert>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+static std::string content(size_t index, size_t len) {
+    std::string data(len, '\0');
+    for (size_t i = 0; i < len; ++i) data[i] = static_cast<char>((i * 31 + index * 7) & 255);
+    return data;
+}
+
+static std::string decoded(const nlohmann::json& item) {
+    std::vector<unsigned char> bytes = base64::decode(item["data"].get<std::string>());
+    return std::string(bytes.begin(), bytes.end());
+}
+
+// Test 1: readFiles returns every file in request order, with per-file errors in place
+void test_read_files(MessageHandler& handler) {
+    std::cout << "Test 1: readFiles...\n";
+
+    const size_t count = 1000;  // more than one ring's worth of operations
+    nlohmann::json paths = nlohmann::json::array();
+    for (size_t i = 0; i < count; ++i) {
+        std::string name = "img" + std::to_string(i) + ".bin";
+        writeFile(name, content(i, i * 37 % 5000));
+        paths.push_back(name);
+    }
+    std::filesystem::create_directory("folder");
+    paths.push_back("missing.bin");
+    paths.push_back("folder");
+    paths.push_back("../escape");
+
+    nlohmann::json r = handler.handle({{"_type", "readFiles"}, {"paths", paths}}, "1");
+    assert(r["success"] == true);
+    std::cout << "  backend: " << r["backend"].get<std::string>() << "\n";
+    const nlohmann::json& results = r["results"];
+    assert(results.size() == paths.size());
+    uint64_t total = 0;
+    for (size_t i = 0; i < count; ++i) {
+        assert(results[i]["path"] == paths[i] && !results[i].contains("error"));
+        assert(decoded(results[i]) == content(i, i * 37 % 5000));
+        assert(results[i]["size"] == i * 37 % 5000);
+        total += i * 37 % 5000;
+    }
+    assert(r["bytesRead"] == total);
+    assert(results[count]["error"] == "File does not exist");
+    assert(results[count + 1]["error"] == "Not a file");
+    assert(results[count + 2]["error"] == "Invalid or disallowed path");
+
+    std::cout << "✓ Test 1 passed\n\n";
+}
+
+// Test 2: Per-file and per-batch byte limits
+void test_limits(MessageHandler& handler) {
+    std::cout << "Test 2: Limits...\n";
+
+    writeFile("big.bin", content(1, 300000));
+    writeFile("small.bin", content(2, 1000));
+    writeFile("empty.bin", "");
+    nlohmann::json r = handler.handle(
+        {{"_type", "readFiles"}, {"paths", {"big.bin", "small.bin", "empty.bin"}}, {"maxBytes", 100000}}, "1");
+    assert(r["results"][0]["rangeRequired"] == true && r["results"][0]["totalSize"] == 300000);
+    assert(!r["results"][0].contains("data"));
+    assert(decoded(r["results"][1]) == content(2, 1000));
+    assert(r["results"][2]["size"] == 0 && decoded(r["results"][2]).empty());
+
+    // The batch stops admitting files once the budget is used; later small files still fit
+    r = handler.handle({{"_type", "readFiles"}, {"paths", {"small.bin", "big.bin", "small.bin"}}, {"maxTotalBytes", 200000}}, "2");
+    assert(r["results"][0]["size"] == 1000);
+    assert(r["results"][1]["error"] == "Batch byte limit reached" && !r["results"][1].contains("rangeRequired"));
+    assert(r["results"][2]["size"] == 1000);
+
+#ifdef __linux__
+    // procfs files report size 0 and are read until end of file (through the backend: the
+    // handler's sandbox rejects /proc)
+    r = handler.handle({{"_type", "readFiles"}, {"paths", {"/proc/self/status"}}}, "3");
+    assert(r["results"][0]["error"] == "Invalid or disallowed path");
+    std::vector<batch_io::ReadResult> reads;
+    batch_io::readFiles({"/proc/self/status"}, 1 << 20, 1 << 20, reads);
+    assert(reads[0].error.empty() && reads[0].data.size() > 0);
+    std::string status(reads[0].data.begin(), reads[0].data.end());
+    assert(status.find("Name:") == 0 && status.find("VmRSS") != std::string::npos);
+#endif
+
+    r = handler.handle({{"_type", "readFiles"}, {"paths", nlohmann::json::array()}}, "4");
+    assert(r["success"] == false);
+    r = handler.handle({{"_type", "readFiles"}, {"paths", {1}}}, "5");
+    assert(r["success"] == false);
+    r = handler.handle({{"_type", "readFiles"}, {"paths", {"a"}}, {"maxBytes", -1}}, "6");
+    assert(r["success"] == false);
+
+    std::cout << "✓ Test 2 passed\n\n";
+}
+
+// Test 3: statMany
+void test_stat_many(MessageHandler& handler) {
+    std::cout << "Test 3: statMany...\n";
+
+    nlohmann::json r = handler.handle({{"_type", "statMany"}, {"paths", {"small.bin", "folder", "missing.bin", "small.bin/x", "/etc"}}}, "1");
+    assert(r["success"] == true);
+    const nlohmann::json& results = r["results"];
+    assert(results[0]["exists"] == true && results[0]["isFile"] == true && results[0]["size"] == 1000);
+    assert(results[0]["mtime"].get<int64_t>() > 1500000000000LL);
+    assert(results[1]["exists"] == true && results[1]["isDirectory"] == true && !results[1].contains("size"));
+    assert(results[2]["exists"] == false && !results[2].contains("error"));
+    assert(results[3]["exists"] == false);
+    assert(results[4]["error"] == "Invalid or disallowed path");
+
+    std::cout << "✓ Test 3 passed\n\n";
+}
+
+// Test 4: Concurrent batches (one may take the pool while the other holds the ring)
+void test_concurrent() {
+    std::cout << "Test 4: Concurrent batches...\n";
+
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < 200; ++i) paths.push_back("img" + std::to_string(i) + ".bin");
+    bool ringAvailable = batch_io::activeBackend() == batch_io::Backend::IoUring;
+    std::atomic<int> onRing{0}, onPool{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&]() {
+            for (int round = 0; round < 5; ++round) {
+                std::vector<batch_io::ReadResult> reads;
+                // Each call reports the backend that actually ran it
+                batch_io::Backend used = batch_io::readFiles(paths, 1 << 20, 64 << 20, reads);
+                ++(used == batch_io::Backend::IoUring ? onRing : onPool);
+                for (size_t i = 0; i < paths.size(); ++i) {
+                    std::string data(reads[i].data.begin(), reads[i].data.end());
+                    assert(data == content(i, i * 37 % 5000));
+                }
+                std::vector<batch_io::StatResult> stats;
+                batch_io::statMany(paths, stats);
+                assert(stats[1].size == 37);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    assert(onRing + onPool == 20);
+    if (!ringAvailable) assert(onRing == 0);
+    std::cout << "  " << onRing << " batches on io_uring, " << onPool << " on the pool\n";
+
+    std::cout << "✓ Test 4 passed\n\n";
+}
+
+// Test 5: A cancelled batch stops between files and reads nothing more
+void test_cancelled() {
+    std::cout << "Test 5: Cancelled batches...\n";
+
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < 200; ++i) paths.push_back("img" + std::to_string(i) + ".bin");
+    std::atomic<bool> cancelled{true};
+
+    std::vector<batch_io::ReadResult> reads;
+    batch_io::readFiles(paths, 1 << 20, 64 << 20, reads, &cancelled);
+    assert(reads.size() == paths.size());
+    for (const auto& read : reads) assert(read.data.empty());
+
+    std::vector<batch_io::StatResult> stats;
+    batch_io::statMany(paths, stats, &cancelled);
+    assert(stats.size() == paths.size());
+    for (const auto& stat : stats) assert(!stat.exists);
+
+    // Not cancelled, the same flag changes nothing
+    cancelled = false;
+    batch_io::readFiles(paths, 1 << 20, 64 << 20, reads, &cancelled);
+    assert(std::string(reads[1].data.begin(), reads[1].data.end()) == content(1, 37));
+
+    std::cout << "✓ Test 5 passed\n\n";
+}
+
+// Test 6: Batches finish while long tasks hold every pool worker (the caller takes items too)
+void test_busy_pool() {
+    std::cout << "Test 6: Busy pool...\n";
+
+    ThreadPool& pool = ThreadPool::getInstance();
+    std::mutex mutex;
+    std::condition_variable changed;
+    size_t blocked = 0;
+    bool release = false;
+    for (size_t i = 0; i < pool.size(); ++i) {
+        pool.submit([&]() {
+            std::unique_lock<std::mutex> lock(mutex);
+            ++blocked;
+            changed.notify_all();
+            changed.wait(lock, [&]() { return release; });
+        });
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&]() { return blocked == pool.size(); });
+    }
+
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < 200; ++i) paths.push_back("img" + std::to_string(i) + ".bin");
+    std::atomic<int> onPool{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&]() {
+            for (int round = 0; round < 5; ++round) {
+                std::vector<batch_io::ReadResult> reads;
+                batch_io::Backend used = batch_io::readFiles(paths, 1 << 20, 64 << 20, reads);
+                if (used == batch_io::Backend::ThreadPool) ++onPool;
+                assert(std::string(reads[7].data.begin(), reads[7].data.end()) == content(7, 7 * 37));
+                std::vector<batch_io::StatResult> stats;
+                batch_io::statMany(paths, stats);
+                assert(stats[1].size == 37);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    std::cout << "  " << onPool << " of 20 batches on the blocked pool\n";
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        release = true;
+    }
+    changed.notify_all();
+
+    std::cout << "✓ Test 6 passed\n\n";
+}
+
+#ifndef _WIN32
+// Test 7: A batch larger than the descriptor limit is read in full (the ring opens files in windows)
+void test_descriptor_limit(MessageHandler& handler) {
+    std::cout << "Test 7: More files than descriptors...\n";
+
+    struct rlimit saved;
+    int got = getrlimit(RLIMIT_NOFILE, &saved);
+    assert(got == 0);
+    struct rlimit lowered = saved;
+    lowered.rlim_cur = 256;
+    int set = setrlimit(RLIMIT_NOFILE, &lowered);
+    assert(set == 0);
+
+    const size_t count = 1500;
+    std::filesystem::create_directory("many");
+    nlohmann::json paths = nlohmann::json::array();
+    for (size_t i = 0; i < count; ++i) {
+        std::string name = "many/f" + std::to_string(i);
+        writeFile(name, content(i, i % 300));
+        paths.push_back(name);
+    }
+    nlohmann::json r = handler.handle({{"_type", "readFiles"}, {"paths", paths}}, "1");
+    assert(r["success"] == true && r["results"].size() == count);
+    for (size_t i = 0; i < count; ++i) {
+        assert(!r["results"][i].contains("error") && decoded(r["results"][i]) == content(i, i % 300));
+    }
+    std::cout << "  backend: " << r["backend"].get<std::string>() << "\n";
+
+    set = setrlimit(RLIMIT_NOFILE, &saved);
+    assert(set == 0);
+
+    std::cout << "✓ Test 7 passed\n\n";
+}
+#endif
+
+int main() {
+    std::cout << "Running BatchFileHandler tests...\n\n";
+
+    std::filesystem::path dir = enterTempDir("crossdev_batch_file_test");
+    auto handler = createBatchFileHandler();
+
+    test_read_files(*handler);
+    test_limits(*handler);
+    test_stat_many(*handler);
+    test_concurrent();
+    test_cancelled();
+    test_busy_pool();
+#ifndef _WIN32
+    test_descriptor_limit(*handler);
+#endif
+
+    std::filesystem::current_path(std::filesystem::temp_directory_path());
+    std::filesystem::remove_all(dir);
+
+    std::cout << "All BatchFileHandler tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,319 @@
+#include "../include/handlers/compression_handler.h"
+#include "../include/compression.h"
+#include "../include/base64.h"
+#include "../include/window.h"
+#include "../include/webview.h"
+#include "test_support.h"
+#include <nlohmann/json.hpp>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <iterator>
+#include <map>
+#include <thread>
+#include <cassert>
+
+// Compressible but not trivial: words picked by a small LCG
+static std::string text(size_t len, uint32_t seed = 1) {
+    static const char* kWords[] = {"alpha ", "beta ", "gamma ", "delta ", "epsilon\n", "zeta ", "eta ", "theta "};
+    std::string data;
+    while (data.size() < len) {
+        seed = seed * 1103515245 + 12345;
+        data += kWords[(seed >> 16) & 7];
+    }
+    data.resize(len);
+    return data;
+}
+
+static const unsigned char* bytes(const std::string& s) {
+    return reinterpret_cast<const unsigned char*>(s.data());
+}
+
+// Minimal central-directory reader: entry name -> (method, uncompressed size)
+static std::map<std::string, std::pair<int, uint64_t>> zipDirectory(const std::string& archive) {
+    auto le16 = [&](size_t at) { return static_cast<uint32_t>(static_cast<unsigned char>(archive[at]) |
+                                                              (static_cast<unsigned char>(archive[at + 1]) << 8)); };
+    auto le32 = [&](size_t at) { return le16(at) | (le16(at + 2) << 16); };
+    size_t eocd = archive.rfind(std::string("PK\x05\x06", 4));
+    assert(eocd != std::string::npos);
+    std::map<std::string, std::pair<int, uint64_t>> entries;
+    size_t at = le32(eocd + 16);
+    for (uint32_t i = 0; i < le16(eocd + 10); ++i) {
+        assert(le32(at) == 0x02014b50);
+        size_t nameLen = le16(at + 28);
+        entries[archive.substr(at + 46, nameLen)] = {static_cast<int>(le16(at + 10)), le32(at + 24)};
+        at += 46 + nameLen + le16(at + 30) + le16(at + 32);
+    }
+    return entries;
+}
+
+// True if no hidden ".<name>.<random>.part" staging file is left in dir
+static bool noStaging(const std::filesystem::path& dir) {
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+        std::string name = entry.path().filename().string();
+        if (name[0] == '.' && name.size() > 5 && name.compare(name.size() - 5, 5, ".part") == 0) return false;
+    }
+    return true;
+}
+
+// Test 1: In-memory round trips for every format, including multi-member gzip and header fields
+void test_codec() {
+    std::cout << "Test 1: Codec round trips...\n";
+
+    for (const std::string& data : {std::string(), std::string("x"), text(100000), noise(3 * 1024 * 1024 + 5)}) {
+        for (auto format : {compression::Format::Gzip, compression::Format::Zlib, compression::Format::Deflate}) {
+            for (int level : {0, 1, 6, 9}) {
+                std::vector<unsigned char> packed;
+                std::vector<unsigned char> unpacked;
+                std::string error;
+                bool ok = compression::compress(bytes(data), data.size(), format, level, packed, error);
+                assert(ok);
+                ok = compression::decompress(packed.data(), packed.size(), format, data.size(), unpacked, error);
+                assert(ok);
+                assert(std::string(unpacked.begin(), unpacked.end()) == data);
+            }
+        }
+    }
+
+    std::vector<unsigned char> a;
+    std::vector<unsigned char> b;
+    std::vector<unsigned char> out;
+    std::string error;
+    std::string big = text(200000);
+    bool ok = compression::compress(bytes(big), big.size(), compression::Format::Gzip, 6, a, error);
+    assert(ok);
+    assert(a.size() < big.size() / 3);
+    assert(a[0] == 0x1f && a[1] == 0x8b && a[2] == 8);
+
+    // Second member carries FNAME and FCOMMENT, as gzip(1) writes them
+    std::string tail = "tail\n";
+    ok = compression::compress(bytes(tail), tail.size(), compression::Format::Gzip, 6, b, error);
+    assert(ok);
+    b[3] = 0x08 | 0x10;
+    const char fields[] = "name.txt\0comment";
+    b.insert(b.begin() + 10, fields, fields + sizeof(fields));
+    a.insert(a.end(), b.begin(), b.end());
+    ok = compression::decompress(a.data(), a.size(), compression::Format::Gzip, SIZE_MAX, out, error);
+    assert(ok);
+    assert(std::string(out.begin(), out.end()) == big + tail);
+
+    // Corruption, truncation and the output limit are errors
+    std::vector<unsigned char> corrupt = a;
+    corrupt[corrupt.size() - b.size() - 6] ^= 0xff;  // first member's CRC
+    ok = compression::decompress(corrupt.data(), corrupt.size(), compression::Format::Gzip, SIZE_MAX, out, error);
+    assert(!ok);
+    ok = compression::decompress(a.data(), 40, compression::Format::Gzip, SIZE_MAX, out, error);
+    assert(!ok);
+    ok = compression::decompress(a.data(), a.size(), compression::Format::Gzip, 1000, out, error);
+    assert(!ok);
+    ok = compression::decompress(bytes(big), 100, compression::Format::Gzip, SIZE_MAX, out, error);
+    assert(!ok);
+
+    std::cout << "✓ Test 1 passed\n\n";
+}
+
+// Test 2: compress / decompress with inline base64 data
+void test_inline(MessageHandler& handler) {
+    std::cout << "Test 2: Inline data...\n";
+
+    std::string data = text(50000);
+    std::string encoded = base64::encode(bytes(data), data.size());
+    nlohmann::json r = handler.handle({{"_type", "compress"}, {"data", encoded}, {"format", "zlib"}, {"level", 9}}, "1");
+    assert(r["success"] == true && r["size"] < data.size());
+    nlohmann::json d = handler.handle({{"_type", "decompress"}, {"data", {{"__base64", r["data"]}}}, {"format", "zlib"}}, "2");
+    assert(d["success"] == true && d["size"] == data.size());
+    std::vector<unsigned char> plain = base64::decode(d["data"].get<std::string>());
+    assert(std::string(plain.begin(), plain.end()) == data);
+
+    r = handler.handle({{"_type", "decompress"}, {"data", encoded}}, "3");
+    assert(r["success"] == false);
+    r = handler.handle({{"_type", "compress"}, {"data", "***"}}, "4");
+    assert(r["success"] == false);
+    r = handler.handle({{"_type", "compress"}, {"data", encoded}, {"format", "brotli"}}, "5");
+    assert(r["success"] == false);
+    r = handler.handle({{"_type", "compress"}, {"data", encoded}, {"level", 10}}, "6");
+    assert(r["success"] == false);
+
+    std::cout << "✓ Test 2 passed\n\n";
+}
+
+// Test 3: File jobs stream through staging files and report sizes
+void test_files(MessageHandler& handler, WebView& webView) {
+    std::cout << "Test 3: File jobs...\n";
+
+    std::string data = text(6 * 1024 * 1024 + 3);
+    writeFile("doc.txt", data);
+    nlohmann::json r = handler.handle({{"_type", "compress"}, {"path", "doc.txt"}, {"outputPath", "doc.txt.gz"}}, "1");
+    assert(r["success"] == true && r["inputSize"] == data.size());
+    nlohmann::json done = waitDone(webView, "compress", r["jobId"]).done;
+    assert(!done.contains("error") && done["cancelled"] == false && done["outputPath"] == "doc.txt.gz");
+    std::string packed = readFile("doc.txt.gz");
+    assert(done["outputSize"] == packed.size() && packed.size() < data.size() / 3);
+    assert(noStaging("."));
+
+    r = handler.handle({{"_type", "decompress"}, {"path", "doc.txt.gz"}, {"outputPath", "copy.txt"}}, "2");
+    done = waitDone(webView, "compress", r["jobId"]).done;
+    assert(done["outputSize"] == data.size() && readFile("copy.txt") == data);
+
+    // A failed job leaves nothing behind
+    r = handler.handle({{"_type", "decompress"}, {"path", "doc.txt"}, {"outputPath", "bad.txt"}}, "3");
+    done = waitDone(webView, "compress", r["jobId"]).done;
+    assert(done.contains("error") && !std::filesystem::exists("bad.txt") && noStaging("."));
+
+    r = handler.handle({{"_type", "compress"}, {"path", "missing"}, {"outputPath", "x.gz"}}, "4");
+    assert(r["success"] == false);
+    r = handler.handle({{"_type", "compress"}, {"path", "doc.txt"}, {"outputPath", "../x.gz"}}, "5");
+    assert(r["success"] == false);
+    r = handler.handle({{"_type", "compress"}, {"path", "doc.txt"}, {"outputPath", "doc.txt"}}, "6");
+    assert(r["success"] == false);
+    r = handler.handle({{"_type", "compress"}, {"path", "doc.txt"}}, "7");
+    assert(r["success"] == false);
+
+    std::cout << "✓ Test 3 passed\n\n";
+}
+
+// Test 4: createZip expands directories, names entries and stores incompressible data
+void test_create_zip(MessageHandler& handler, WebView& webView) {
+    std::cout << "Test 4: createZip...\n";
+
+    std::filesystem::create_directories("docs/sub/empty");
+    std::map<std::string, std::string> files = {
+        {"docs/a.txt", text(300000, 2)},
+        {"docs/sub/b.txt", text(10, 3)},
+        {"docs/sub/noise.bin", noise(200000)},
+        {"docs/empty.txt", ""},
+    };
+    for (const auto& file : files) writeFile(file.first, file.second);
+    std::string large = text(40 * 1024 * 1024, 4);  // above the in-memory entry limit: streamed
+    writeFile("large.log", large);
+
+    nlohmann::json list = {"docs", {{"path", "large.log"}, {"name", "logs\\today.log"}}};
+    nlohmann::json r = handler.handle({{"_type", "createZip"}, {"outputPath", "bundle.zip"}, {"files", list}}, "1");
+    assert(r["success"] == true);
+    nlohmann::json done = waitDone(webView, "zip", r["jobId"]).done;
+    assert(!done.contains("error") && done["cancelled"] == false);
+    assert(done["entries"] == 8);
+
+    std::string archive = readFile("bundle.zip");
+    assert(done["compressedSize"] == archive.size() && archive.size() < large.size() / 3);
+    auto entries = zipDirectory(archive);
+    assert(entries.size() == 8);
+    assert(entries.count("docs/") && entries.count("docs/sub/") && entries.count("docs/sub/empty/"));
+    assert(entries["docs/a.txt"] == std::make_pair(8, uint64_t(300000)));
+    assert(entries["docs/sub/noise.bin"] == std::make_pair(0, uint64_t(200000)));
+    assert(entries["docs/empty.txt"].second == 0);
+    assert(entries["logs/today.log"] == std::make_pair(8, uint64_t(large.size())));
+    assert(noStaging("."));
+
+    // Invalid requests
+    r = handler.handle({{"_type", "createZip"}, {"outputPath", "x.zip"}, {"files", {"missing"}}}, "2");
+    assert(r["success"] == false);
+    r = handler.handle({{"_type", "createZip"}, {"outputPath", "x.zip"}, {"files", {"../etc"}}}, "3");
+    assert(r["success"] == false);
+    r = handler.handle({{"_type", "createZip"}, {"outputPath", "x.zip"}, {"files", nlohmann::json::array()}}, "4");
+    assert(r["success"] == false);
+    nlohmann::json escaping = {{{"path", "large.log"}, {"name", "../x"}}};
+    r = handler.handle({{"_type", "createZip"}, {"outputPath", "x.zip"}, {"files", escaping}}, "5");
+    assert(r["success"] == false);
+
+    // Duplicate names fail the job
+    nlohmann::json dup = {"large.log", {{"path", "docs/a.txt"}, {"name", "large.log"}}};
+    r = handler.handle({{"_type", "createZip"}, {"outputPath", "dup.zip"}, {"files", dup}}, "6");
+    done = waitDone(webView, "zip", r["jobId"]).done;
+    assert(done["error"].get<std::string>().find("Duplicate") == 0 && !std::filesystem::exists("dup.zip"));
+
+    std::cout << "✓ Test 4 passed\n\n";
+}
+
+// Test 5: Cancelling a zip job removes the partial archive
+void test_cancel(MessageHandler& handler, WebView& webView) {
+    std::cout << "Test 5: Cancel...\n";
+
+    nlohmann::json list = nlohmann::json::array();
+    for (int i = 0; i < 50; ++i) list.push_back({{"path", "large.log"}, {"name", "copy" + std::to_string(i)}});
+    nlohmann::json r = handler.handle({{"_type", "createZip"}, {"outputPath", "big.zip"}, {"files", list}}, "1");
+    nlohmann::json c = handler.handle({{"_type", "cancelCompress"}, {"jobId", r["jobId"]}}, "2");
+    assert(c["success"] == true && c["found"] == true);
+    nlohmann::json done = waitDone(webView, "zip", r["jobId"]).done;
+    assert(done["cancelled"] == true && done["error"] == "Cancelled");
+    assert(!std::filesystem::exists("big.zip") && noStaging("."));
+
+    c = handler.handle({{"_type", "cancelCompress"}, {"jobId", r["jobId"]}}, "3");
+    assert(c["success"] == true && c["found"] == false);
+    r = handler.handle({{"_type", "cancelCompress"}}, "4");
+    assert(r["success"] == false);
+
+    std::cout << "✓ Test 5 passed\n\n";
+}
+
+// Test 6: Jobs never touch the user's own "<output>.part" and never share a staging file
+void test_staging(MessageHandler& handler, WebView& webView) {
+    std::cout << "Test 6: Staging files...\n";
+
+    std::string data = text(2 * 1024 * 1024, 5);
+    writeFile("in.txt", data);
+    writeFile("out.gz.part", "mine");
+    writeFile("out.zip.part", "mine too");
+
+    // Success and failure both leave the user's files alone
+    nlohmann::json done = run(handler, webView, "compress", {{"path", "in.txt"}, {"outputPath", "out.gz"}}).done;
+    assert(!done.contains("error") && readFile("out.gz.part") == "mine");
+    nlohmann::json bad = {{"_type", "decompress"}, {"path", "in.txt"}, {"outputPath", "out.gz"}};
+    done = run(handler, webView, "compress", bad).done;
+    assert(done.contains("error") && readFile("out.gz.part") == "mine");
+    nlohmann::json dup = {"in.txt", {{"path", "out.gz"}, {"name", "in.txt"}}};
+    done = run(handler, webView, "zip", {{"_type", "createZip"}, {"outputPath", "out.zip"}, {"files", dup}}).done;
+    assert(done.contains("error") && !std::filesystem::exists("out.zip") && readFile("out.zip.part") == "mine too");
+
+    // Two jobs writing the same output each finish with a complete file of their own
+    nlohmann::json r1 = handler.handle({{"_type", "compress"}, {"path", "in.txt"}, {"outputPath", "same.gz"}}, "1");
+    nlohmann::json r2 = handler.handle({{"_type", "compress"}, {"path", "in.txt"}, {"outputPath", "same.gz"}}, "2");
+    std::map<std::string, nlohmann::json> dones;  // waitDone would drop the other job's events
+    auto deadline = std::chrono::steady_clock::now() + kJobTimeout;
+    while (dones.size() < 2) {
+        assert(std::chrono::steady_clock::now() < deadline);
+        platform::mockRunMainThreadTasks();
+        for (const auto& raw : platform::mockTakePostedMessages(webView.getNativeHandle())) {
+            nlohmann::json msg = nlohmann::json::parse(raw);
+            if (msg["name"] == "compress:done") dones[msg["payload"]["jobId"]] = msg["payload"];
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    nlohmann::json done1 = dones[r1["jobId"]];
+    nlohmann::json done2 = dones[r2["jobId"]];
+    assert(!done1.contains("error") && !done2.contains("error"));
+    assert(done1["outputSize"] == done2["outputSize"] && readFile("same.gz").size() == done1["outputSize"]);
+    std::vector<unsigned char> unpacked;
+    std::string error;
+    std::string packed = readFile("same.gz");
+    assert(compression::decompress(bytes(packed), packed.size(), compression::Format::Gzip, data.size(), unpacked,
+                                   error));
+    assert(std::string(unpacked.begin(), unpacked.end()) == data);
+    assert(noStaging("."));
+
+    std::cout << "✓ Test 6 passed\n\n";
+}
+
+int main() {
+    std::cout << "Running CompressionHandler tests...\n\n";
+
+    test_codec();
+
+    std::filesystem::path dir = enterTempDir("crossdev_compression_test");
+    Window window(nullptr, nullptr, 0, 0, 100, 100, "Compression Test");
+    WebView webView(&window, &window, 0, 0, 100, 100);
+    auto handler = createCompressionHandler(&webView);
+
+    test_inline(*handler);
+    test_files(*handler, webView);
+    test_create_zip(*handler, webView);
+    test_cancel(*handler, webView);
+    test_staging(*handler, webView);
+
+    handler.reset();
+    std::filesystem::current_path(std::filesystem::temp_directory_path());
+    std::filesystem::remove_all(dir);
+
+    std::cout << "All CompressionHandler tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,230 @@
+#include "../include/handlers/copy_handler.h"
+#include "../include/file_copy.h"
+#include "../include/window.h"
+#include "../include/webview.h"
+#include "test_support.h"
+#include <nlohmann/json.hpp>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <iterator>
+#include <map>
+#include <atomic>
+#include <thread>
+#include <cassert>
+
+namespace fs = std::filesystem;
+
+// Relative path -> contents ("<dir>" for directories, "-> target" for symlinks)
+static std::map<std::string, std::string> snapshot(const fs::path& root) {
+    std::map<std::string, std::string> tree;
+    for (fs::recursive_directory_iterator it(root), end; it != end; ++it) {
+        std::string rel = it->path().lexically_relative(root).generic_string();
+        if (it->is_symlink()) {
+            tree[rel] = "-> " + fs::read_symlink(it->path()).string();
+        } else if (it->is_directory()) {
+            tree[rel] = "<dir>";
+        } else {
+            tree[rel] = readFile(it->path());
+        }
+    }
+    return tree;
+}
+
+// No hidden staging copies or set-aside old targets left next to the targets
+static bool noStaging(const fs::path& dir) {
+    for (const auto& entry : fs::directory_iterator(dir)) {
+        std::string name = entry.path().filename().string();
+        for (const std::string suffix : {".part", ".old"}) {
+            if (name.size() > suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Test 1: Single-file copies of every size class, with permissions and cancellation
+void test_copy_file() {
+    std::cout << "Test 1: copyFile...\n";
+
+    for (size_t size : {size_t(0), size_t(1), size_t(3 * 1024 * 1024 + 5), size_t(20 * 1024 * 1024 + 3)}) {
+        writeFile("src.bin", noise(size, static_cast<uint32_t>(size) + 1));
+        file_copy::Method method;
+        std::string error;
+        uint64_t reported = 0;
+        bool copied = file_copy::copyFile("src.bin", "dst.bin", method, error, [&](uint64_t n) { reported += n; });
+        assert(copied);
+        assert(readFile("dst.bin") == readFile("src.bin") && reported == size);
+        std::cout << "  " << size << " bytes: " << file_copy::methodName(method) << "\n";
+    }
+
+    file_copy::Method method;
+    std::string error;
+    bool copied = false;
+#ifndef _WIN32
+    fs::permissions("src.bin", fs::perms::owner_read | fs::perms::owner_write | fs::perms::group_read);
+    writeFile("dst.bin", "old content that is longer than nothing");
+    copied = file_copy::copyFile("src.bin", "dst.bin", method, error);
+    assert(copied);
+    assert(fs::status("dst.bin").permissions() == fs::status("src.bin").permissions());
+    assert(fs::file_size("dst.bin") == fs::file_size("src.bin"));
+#endif
+
+    std::atomic<bool> cancel{true};
+    copied = file_copy::copyFile("src.bin", "cancelled.bin", method, error, nullptr, &cancel);
+    assert(!copied || method == file_copy::Method::Clone);
+    copied = file_copy::copyFile("missing.bin", "x.bin", method, error);
+    assert(!copied && error.find("Failed to open") == 0);
+    fs::remove("cancelled.bin");
+
+    std::cout << "✓ Test 1 passed\n\n";
+}
+
+// Test 2: copy of a file, and replacing an existing target only when asked
+void test_copy(MessageHandler& handler, WebView& webView) {
+    std::cout << "Test 2: copy...\n";
+
+    writeFile("a.txt", "alpha");
+    nlohmann::json done = run(handler, webView, "copy", {{"from", "a.txt"}, {"to", "b.txt"}}).done;
+    assert(!done.contains("error") && done["operation"] == "copy" && done["filesCopied"] == 1 && done["bytesCopied"] == 5);
+    assert(readFile("b.txt") == "alpha" && readFile("a.txt") == "alpha");
+
+    nlohmann::json r = handler.handle({{"_type", "copy"}, {"from", "a.txt"}, {"to", "b.txt"}}, "2");
+    assert(r["success"] == false && r["error"].get<std::string>().find("already exists") != std::string::npos);
+
+    writeFile("a.txt", "alpha 2");
+    done = run(handler, webView, "copy", {{"from", "a.txt"}, {"to", "b.txt"}, {"overwrite", true}}).done;
+    assert(!done.contains("error") && readFile("b.txt") == "alpha 2");
+    assert(noStaging("."));
+
+    std::cout << "✓ Test 2 passed\n\n";
+}
+
+// Test 3: Trees: nested directories, many small files, empty directories and symlinks
+void test_copy_tree(MessageHandler& handler, WebView& webView) {
+    std::cout << "Test 3: Tree copy...\n";
+
+    fs::create_directories("tree/empty");
+    for (int d = 0; d < 10; ++d) {
+        fs::create_directories("tree/dir" + std::to_string(d) + "/sub");
+        for (int f = 0; f < 30; ++f) {
+            writeFile("tree/dir" + std::to_string(d) + "/f" + std::to_string(f), noise(f * 101, d * 100 + f + 1));
+        }
+        writeFile("tree/dir" + std::to_string(d) + "/sub/big", noise(300000, d + 7));
+    }
+#ifndef _WIN32
+    fs::create_symlink("dir0/f1", "tree/link");
+#endif
+
+    JobEvents copied = run(handler, webView, "copy", {{"from", "tree/"}, {"to", "copied"}});
+    nlohmann::json done = copied.done;
+    assert(!done.contains("error") && done["cancelled"] == false);
+    assert(done["filesCopied"] == 310 && done["filesCopied"].get<int>() >= done["filesCloned"].get<int>());
+    assert(snapshot("tree") == snapshot("copied"));
+    assert(noStaging("."));
+
+    // Replacing a tree with a file and back
+    writeFile("single", "one");
+    done = run(handler, webView, "copy", {{"from", "single"}, {"to", "copied"}, {"overwrite", true}}).done;
+    assert(!done.contains("error") && readFile("copied") == "one");
+    done = run(handler, webView, "copy", {{"from", "tree"}, {"to", "copied"}, {"overwrite", true}}).done;
+    assert(!done.contains("error") && snapshot("tree") == snapshot("copied"));
+    // and a tree with a tree: the old one steps aside and is removed once the new one is in place
+    writeFile("copied/stale", "old");
+    done = run(handler, webView, "copy", {{"from", "tree"}, {"to", "copied"}, {"overwrite", true}}).done;
+    assert(!done.contains("error") && snapshot("tree") == snapshot("copied"));
+    assert(noStaging("."));
+
+    std::cout << "✓ Test 3 passed (" << copied.progress << " progress events)\n\n";
+}
+
+// Test 4: move (a rename on one filesystem)
+void test_move(MessageHandler& handler, WebView& webView) {
+    std::cout << "Test 4: move...\n";
+
+    auto before = snapshot("copied");
+    nlohmann::json done = run(handler, webView, "copy", {{"_type", "move"}, {"from", "copied"}, {"to", "moved"}}).done;
+    assert(!done.contains("error") && done["operation"] == "move" && done["renamed"] == true);
+    assert(!fs::exists("copied") && snapshot("moved") == before);
+
+    writeFile("m.txt", "move me");
+    done = run(handler, webView, "copy", {{"_type", "move"}, {"from", "m.txt"}, {"to", "moved/m.txt"}}).done;
+    assert(!done.contains("error") && !fs::exists("m.txt") && readFile("moved/m.txt") == "move me");
+    assert(noStaging(".") && noStaging("moved"));
+
+    std::cout << "✓ Test 4 passed\n\n";
+}
+
+// Test 5: Requests that would escape the sandbox, loop or destroy their own source
+void test_validation(MessageHandler& handler) {
+    std::cout << "Test 5: Validation...\n";
+
+    auto error = [&handler](nlohmann::json request) {
+        nlohmann::json r = handler.handle(request, "1");
+        assert(r["success"] == false);
+        return r["error"].get<std::string>();
+    };
+    std::string message = error({{"_type", "copy"}, {"from", "tree"}});
+    assert(message.find("Missing") == 0);
+    message = error({{"_type", "copy"}, {"from", "missing"}, {"to", "x"}});
+    assert(message == "Source does not exist");
+    message = error({{"_type", "copy"}, {"from", "../escape"}, {"to", "x"}});
+    assert(message == "Invalid or disallowed path");
+    message = error({{"_type", "copy"}, {"from", "tree"}, {"to", "/tmp/elsewhere"}});
+    assert(message == "Invalid or disallowed path");
+    message = error({{"_type", "copy"}, {"from", "tree"}, {"to", "tree/dir0/inner"}});
+    assert(message == "'to' is inside 'from'");
+    message = error({{"_type", "copy"}, {"from", "tree/dir0"}, {"to", "tree"}, {"overwrite", true}});
+    assert(message == "'from' is inside 'to'");
+    message = error({{"_type", "move"}, {"from", "."}, {"to", "x"}});
+    assert(message.find("working directory") != std::string::npos);
+    message = error({{"_type", "copy"}, {"from", "tree"}, {"to", "nowhere/x"}});
+    assert(message == "Target directory does not exist");
+    message = error({{"_type", "copy"}, {"from", "tree"}, {"to", "x"}, {"overwrite", "yes"}});
+    assert(message.find("overwrite") != std::string::npos);
+
+    std::cout << "✓ Test 5 passed\n\n";
+}
+
+// Test 6: Cancel leaves neither the target nor a staging copy behind
+void test_cancel(MessageHandler& handler, WebView& webView) {
+    std::cout << "Test 6: Cancel...\n";
+
+    nlohmann::json r = handler.handle({{"_type", "copy"}, {"from", "tree"}, {"to", "cancelled"}}, "1");
+    nlohmann::json c = handler.handle({{"_type", "cancelCopy"}, {"jobId", r["jobId"]}}, "2");
+    assert(c["success"] == true && c["found"] == true);
+    nlohmann::json done = waitDone(webView, "copy", r["jobId"]).done;
+    assert(done["cancelled"] == true && done["error"] == "Cancelled");
+    assert(!fs::exists("cancelled") && noStaging("."));
+
+    c = handler.handle({{"_type", "cancelCopy"}, {"jobId", r["jobId"]}}, "3");
+    assert(c["success"] == true && c["found"] == false);
+    r = handler.handle({{"_type", "cancelCopy"}}, "4");
+    assert(r["success"] == false);
+
+    std::cout << "✓ Test 6 passed\n\n";
+}
+
+int main() {
+    std::cout << "Running CopyHandler tests...\n\n";
+
+    fs::path dir = enterTempDir("crossdev_copy_test");
+    Window window(nullptr, nullptr, 0, 0, 100, 100, "Copy Test");
+    WebView webView(&window, &window, 0, 0, 100, 100);
+    auto handler = createCopyHandler(&webView);
+
+    test_copy_file();
+    test_copy(*handler, webView);
+    test_copy_tree(*handler, webView);
+    test_move(*handler, webView);
+    test_validation(*handler);
+    test_cancel(*handler, webView);
+
+    handler.reset();
+    fs::current_path(fs::temp_directory_path());
+    fs::remove_all(dir);
+
+    std::cout << "All CopyHandler tests passed!\n";
+    return 0;
+}
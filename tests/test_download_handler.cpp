@@ -0,0 +1,328 @@
+#include "../include/handlers/download_handler.h"
+#include "../include/http_client.h"
+#include "../include/window.h"
+#include "../include/webview.h"
+#include "test_support.h"
+#include <nlohmann/json.hpp>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <cassert>
+#include <cstring>
+
+namespace fs = std::filesystem;
+
+// Loopback server (tests/test_support.h) with Range / If-Range and a few test routes:
+//   /file      the payload, Content-Length framed, resumable (ETag = etag)
+//   /chunked   the payload in chunks
+//   /redirect  302 to /file
+//   /away      302 to awayTarget
+//   /auth      the request's Authorization header (empty if none)
+//   /slow      the payload, trickled (for cancellation)
+//   anything else: 404
+class TestServer {
+public:
+    std::string payload;
+    std::atomic<size_t> rangeRequests{0};
+    std::mutex mutex;
+    std::string etag = "\"v1\"";
+    size_t dropAfter = 0;  // next /file response: close after this many body bytes
+    std::string awayTarget;
+
+    TestServer() {
+        for (size_t i = 0; i < 3 * 1024 * 1024 + 123; ++i) payload.push_back(static_cast<char>((i * 31 + i / 4096) & 0xff));
+    }
+
+    std::string url(const std::string& path) const {
+        return server_.url(path);
+    }
+
+    size_t connections() const {
+        return server_.connections;
+    }
+
+private:
+    bool respond(int fd, const std::string& head) {
+        std::string path = LoopbackServer::requestPath(head);
+        std::string etag;
+        std::string awayTarget;
+        size_t dropAfter = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            etag = this->etag;
+            if (path == "/file") std::swap(dropAfter, this->dropAfter);
+            if (path == "/away") awayTarget = this->awayTarget;
+        }
+
+        if (path == "/redirect") {
+            std::string r = "HTTP/1.1 302 Found\r\nLocation: /file\r\nContent-Length: 5\r\n\r\nmoved";
+            return LoopbackServer::sendAll(fd, r.data(), r.size());
+        }
+        if (path == "/away") {
+            std::string r = "HTTP/1.1 302 Found\r\nLocation: " + awayTarget + "\r\nContent-Length: 0\r\n\r\n";
+            return LoopbackServer::sendAll(fd, r.data(), r.size());
+        }
+        if (path == "/auth") {
+            std::string auth = LoopbackServer::headerValue(head, "authorization");
+            std::string r = "HTTP/1.1 200 OK\r\nContent-Length: " + std::to_string(auth.size()) + "\r\n\r\n" + auth;
+            return LoopbackServer::sendAll(fd, r.data(), r.size());
+        }
+        if (path == "/chunked") {
+            std::string r = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n";
+            for (size_t at = 0; at < payload.size(); at += 10000) {
+                size_t n = std::min<size_t>(10000, payload.size() - at);
+                char size[32];
+                std::snprintf(size, sizeof(size), "%zx;ext=1\r\n", n);
+                r += size + payload.substr(at, n) + "\r\n";
+            }
+            r += "0\r\nX-Trailer: yes\r\n\r\n";
+            return LoopbackServer::sendAll(fd, r.data(), r.size());
+        }
+        if (path != "/file" && path != "/slow") {
+            std::string r = "HTTP/1.1 404 Not Found\r\nContent-Length: 9\r\n\r\nnot found";
+            return LoopbackServer::sendAll(fd, r.data(), r.size());
+        }
+
+        size_t from = 0;
+        std::string range = LoopbackServer::headerValue(head, "range");
+        std::string ifRange = LoopbackServer::headerValue(head, "if-range");
+        if (!range.empty() && (ifRange.empty() || ifRange == etag)) {
+            ++rangeRequests;
+            from = std::stoul(range.substr(6));
+            if (from >= payload.size()) {
+                std::string r = "HTTP/1.1 416 Range Not Satisfiable\r\nContent-Range: bytes */" +
+                                std::to_string(payload.size()) + "\r\nContent-Length: 0\r\n\r\n";
+                return LoopbackServer::sendAll(fd, r.data(), r.size());
+            }
+        }
+        std::string r = from > 0 ? "HTTP/1.1 206 Partial Content\r\nContent-Range: bytes " + std::to_string(from) + "-" +
+                                       std::to_string(payload.size() - 1) + "/" + std::to_string(payload.size()) + "\r\n"
+                                 : "HTTP/1.1 200 OK\r\n";
+        r += "ETag: " + etag + "\r\nContent-Length: " + std::to_string(payload.size() - from) + "\r\n\r\n";
+        if (!LoopbackServer::sendAll(fd, r.data(), r.size())) return false;
+        if (dropAfter > 0) {
+            LoopbackServer::sendAll(fd, payload.data() + from, dropAfter);
+            return false;
+        }
+        if (path == "/slow") {
+            for (size_t at = from; at < payload.size() && !server_.stopping(); at += 16 * 1024) {
+                if (!LoopbackServer::sendAll(fd, payload.data() + at, std::min<size_t>(16 * 1024, payload.size() - at))) return false;
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            }
+            return true;
+        }
+        return LoopbackServer::sendAll(fd, payload.data() + from, payload.size() - from);
+    }
+
+    // Last, so it stops serving before the fields above go away
+    LoopbackServer server_{[this](int fd, const std::string& head) { return respond(fd, head); }};
+};
+
+// Test 1: Stream to disk over one kept-alive connection; chunked bodies and redirects
+void test_download(MessageHandler& handler, WebView& webView, TestServer& server) {
+    std::cout << "Test 1: Download, keep-alive, chunked, redirect...\n";
+
+    size_t connections = server.connections();
+    JobEvents e = run(handler, webView, "download", {{"url", server.url("/file")}, {"path", "a.bin"}});
+    assert(e.done["status"] == 200 && e.done["size"] == server.payload.size() && !e.done.contains("error"));
+    assert(e.done["resumedFrom"] == 0 && e.done["cancelled"] == false && e.done["path"] == "a.bin");
+    assert(readFile("a.bin") == server.payload);
+    assert(!fs::exists(".a.bin.download") && !fs::exists(".a.bin.download.meta"));
+
+    e = run(handler, webView, "download", {{"url", server.url("/chunked")}, {"path", "b.bin"}});
+    assert(e.done["status"] == 200 && readFile("b.bin") == server.payload);
+    e = run(handler, webView, "download", {{"url", server.url("/redirect")}, {"path", "c.bin"}});
+    assert(e.done["status"] == 200 && readFile("c.bin") == server.payload);
+    // Three downloads and a redirect, one connection
+    assert(server.connections() == connections + 1);
+    assert(http::Client::getInstance().idleConnections() == 1);
+
+    // An existing file needs overwrite
+    nlohmann::json r = handler.handle({{"_type", "download"}, {"url", server.url("/file")}, {"path", "a.bin"}}, "2");
+    assert(r["success"] == false);
+    e = run(handler, webView, "download", {{"url", server.url("/chunked")}, {"path", "a.bin"}, {"overwrite", true}});
+    assert(e.done["status"] == 200 && readFile("a.bin") == server.payload);
+
+    std::cout << "✓ Test 1 passed\n\n";
+}
+
+// Test 2: An interrupted download continues with a Range request, unless the file changed
+void test_resume(MessageHandler& handler, WebView& webView, TestServer& server) {
+    std::cout << "Test 2: Resume...\n";
+
+    {
+        std::lock_guard<std::mutex> lock(server.mutex);
+        server.dropAfter = 1000000;
+    }
+    JobEvents e = run(handler, webView, "download", {{"url", server.url("/file")}, {"path", "r.bin"}});
+    assert(e.done.contains("error") && e.done["cancelled"] == false);
+    assert(!fs::exists("r.bin") && fs::file_size(".r.bin.download") == 1000000);
+
+    size_t ranges = server.rangeRequests;
+    e = run(handler, webView, "download", {{"url", server.url("/file")}, {"path", "r.bin"}});
+    assert(e.done["status"] == 206 && e.done["resumedFrom"] == 1000000 && e.done["size"] == server.payload.size());
+    assert(server.rangeRequests == ranges + 1 && readFile("r.bin") == server.payload);
+
+    // A changed ETag fails If-Range: the server sends the whole new file
+    {
+        std::lock_guard<std::mutex> lock(server.mutex);
+        server.dropAfter = 500000;
+    }
+    e = run(handler, webView, "download", {{"url", server.url("/file")}, {"path", "s.bin"}});
+    assert(fs::file_size(".s.bin.download") == 500000);
+    {
+        std::lock_guard<std::mutex> lock(server.mutex);
+        server.etag = "\"v2\"";
+    }
+    e = run(handler, webView, "download", {{"url", server.url("/file")}, {"path", "s.bin"}});
+    assert(e.done["status"] == 200 && e.done["resumedFrom"] == 0 && readFile("s.bin") == server.payload);
+
+    // resume: false starts over
+    {
+        std::lock_guard<std::mutex> lock(server.mutex);
+        server.dropAfter = 500000;
+    }
+    run(handler, webView, "download", {{"url", server.url("/file")}, {"path", "t.bin"}});
+    e = run(handler, webView, "download", {{"url", server.url("/file")}, {"path", "t.bin"}, {"resume", false}});
+    assert(e.done["status"] == 200 && e.done["resumedFrom"] == 0 && readFile("t.bin") == server.payload);
+
+    std::cout << "✓ Test 2 passed\n\n";
+}
+
+// Test 3: Progress and cancellation keep the part file for a later resume
+void test_cancel(MessageHandler& handler, WebView& webView, TestServer& server) {
+    std::cout << "Test 3: Progress and cancel...\n";
+
+    nlohmann::json r = handler.handle({{"_type", "download"}, {"url", server.url("/slow")}, {"path", "slow.bin"}}, "1");
+    assert(r["success"] == true);
+    std::string jobId = r["jobId"];
+    JobEvents e = waitDone(webView, "download", jobId, [&](const nlohmann::json& progress) {
+        assert(progress["total"] == server.payload.size() && progress["received"] > 0);
+        nlohmann::json c = handler.handle({{"_type", "cancelDownload"}, {"jobId", jobId}}, "2");
+        assert(c["success"] == true);
+    });
+    assert(e.progress >= 1 && e.done["cancelled"] == true && e.done["error"] == "Cancelled");
+    assert(!fs::exists("slow.bin") && fs::exists(".slow.bin.download"));
+    r = handler.handle({{"_type", "cancelDownload"}, {"jobId", jobId}}, "3");
+    assert(r["found"] == false);
+
+    std::cout << "✓ Test 3 passed\n\n";
+}
+
+// Test 4: Request validation and HTTP errors
+void test_errors(MessageHandler& handler, WebView& webView, TestServer& server) {
+    std::cout << "Test 4: Errors...\n";
+
+    auto refused = [&](nlohmann::json request) {
+        request["_type"] = "download";
+        nlohmann::json r = handler.handle(request, "1");
+        assert(r["success"] == false);
+    };
+    refused({{"path", "x.bin"}});
+    refused({{"url", server.url("/file")}});
+    refused({{"url", "ftp://example.com/x"}, {"path", "x.bin"}});
+    refused({{"url", "http://exa mple.com/x"}, {"path", "x.bin"}});
+    refused({{"url", server.url("/file")}, {"path", "../x.bin"}});
+    refused({{"url", server.url("/file")}, {"path", "missing/x.bin"}});
+    refused({{"url", server.url("/file")}, {"path", "x.bin"}, {"headers", {{"Range", "bytes=0-"}}}});
+    refused({{"url", server.url("/file")}, {"path", "x.bin"}, {"headers", {{"X-A", "b\r\nX-B: c"}}}});
+    refused({{"url", server.url("/file")}, {"path", "x.bin"}, {"resume", "yes"}});
+    if (!http::Client::httpsSupported()) {
+        refused({{"url", "https://example.com/x"}, {"path", "x.bin"}});
+    }
+
+    JobEvents e = run(handler, webView, "download",
+                      {{"url", server.url("/nope")}, {"path", "x.bin"}, {"headers", {{"X-Test", "1"}}}});
+    assert(e.done["status"] == 404 && e.done["error"] == "HTTP 404");
+    assert(!fs::exists("x.bin") && !fs::exists(".x.bin.download"));
+
+    e = run(handler, webView, "download", {{"url", "http://127.0.0.1:1/file"}, {"path", "x.bin"}});
+    assert(e.done["status"] == 0 && e.done.contains("error"));
+
+    std::cout << "✓ Test 4 passed\n\n";
+}
+
+// Test 5: Request headers follow a redirect on the same origin only
+void test_redirect_headers(MessageHandler& handler, WebView& webView, TestServer& server) {
+    std::cout << "Test 5: Redirect headers...\n";
+
+    nlohmann::json headers = {{"Authorization", "Bearer secret"}, {"Accept", "*/*"}};
+    {
+        std::lock_guard<std::mutex> lock(server.mutex);
+        server.awayTarget = "/auth";
+    }
+    JobEvents e = run(handler, webView, "download",
+                      {{"url", server.url("/away")}, {"path", "same.txt"}, {"headers", headers}});
+    assert(e.done["status"] == 200 && readFile("same.txt") == "Bearer secret");
+
+    TestServer other;
+    {
+        std::lock_guard<std::mutex> lock(server.mutex);
+        server.awayTarget = other.url("/auth");
+    }
+    e = run(handler, webView, "download", {{"url", server.url("/away")}, {"path", "other.txt"}, {"headers", headers}});
+    assert(e.done["status"] == 200 && fs::exists("other.txt") && readFile("other.txt").empty());
+
+    // Back on the first origin after a hop elsewhere, the stripped headers stay stripped
+    {
+        std::lock_guard<std::mutex> lock(other.mutex);
+        other.awayTarget = server.url("/auth");
+    }
+    {
+        std::lock_guard<std::mutex> lock(server.mutex);
+        server.awayTarget = other.url("/away");
+    }
+    e = run(handler, webView, "download", {{"url", server.url("/away")}, {"path", "back.txt"}, {"headers", headers}});
+    assert(e.done["status"] == 200 && fs::exists("back.txt") && readFile("back.txt").empty());
+
+    std::cout << "✓ Test 5 passed\n\n";
+}
+
+// Test 6: Staging files are hidden and marked; user files by similar names are left alone
+void test_staging_names(MessageHandler& handler, WebView& webView, TestServer& server) {
+    std::cout << "Test 6: Staging names...\n";
+
+    { std::ofstream("u.bin.part") << "mine"; }
+    { std::ofstream("u.bin.part.meta") << "mine too"; }
+    JobEvents e = run(handler, webView, "download", {{"url", server.url("/chunked")}, {"path", "u.bin"}});
+    assert(e.done["status"] == 200 && readFile("u.bin") == server.payload);
+    assert(readFile("u.bin.part") == "mine" && readFile("u.bin.part.meta") == "mine too");
+
+    // Not written by a download: neither resumed nor deleted
+    { std::ofstream(".v.bin.download") << "not ours"; }
+    e = run(handler, webView, "download", {{"url", server.url("/chunked")}, {"path", "v.bin"}});
+    std::string error = e.done.value("error", "");
+    assert(error.find("in the way") != std::string::npos);
+    assert(!fs::exists("v.bin") && readFile(".v.bin.download") == "not ours");
+
+    std::cout << "✓ Test 6 passed\n\n";
+}
+
+int main() {
+    std::cout << "Running DownloadHandler tests...\n\n";
+
+    fs::path dir = enterTempDir("crossdev_download_test");
+    Window window(nullptr, nullptr, 0, 0, 100, 100, "Download Test");
+    WebView webView(&window, &window, 0, 0, 100, 100);
+    auto handler = createDownloadHandler(&webView);
+    {
+        TestServer server;
+        test_download(*handler, webView, server);
+        test_resume(*handler, webView, server);
+        test_cancel(*handler, webView, server);
+        test_errors(*handler, webView, server);
+        test_redirect_headers(*handler, webView, server);
+        test_staging_names(*handler, webView, server);
+    }
+
+    handler.reset();
+    fs::current_path(fs::temp_directory_path());
+    fs::remove_all(dir);
+
+    std::cout << "All DownloadHandler tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,252 @@
+#include "../include/file_content_cache.h"
+#include "../include/file_watcher.h"
+#include "../include/base64.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <thread>
+#include <cassert>
+
+namespace fs = std::filesystem;
+
+static fs::path tempDir(const std::string& name) {
+    fs::path dir = fs::temp_directory_path() / name;
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    return dir;
+}
+
+static void writeFile(const fs::path& path, const std::string& data) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << data;
+}
+
+static std::string text(const FileContentCache::Bytes& bytes) {
+    assert(bytes);
+    return std::string(bytes->begin(), bytes->end());
+}
+
+// Changes made behind the cache's back show up once the watcher (or a stat) notices
+static std::string awaitContent(const fs::path& path, const std::string& expected) {
+    std::string error;
+    std::string current;
+    for (int i = 0; i < 200; ++i) {
+        current = text(FileContentCache::getInstance().get(path.string(), error));
+        if (current == expected) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return current;
+}
+
+// Test 1: Repeated reads are served from memory, shared by every caller
+void test_hits() {
+    std::cout << "Test 1: Hits...\n";
+
+    FileContentCache& cache = FileContentCache::getInstance();
+    cache.clear();
+    auto dir = tempDir("crossdev_content_cache_test1");
+    writeFile(dir / "reference.json", "{\"a\": 1}");
+
+    std::string error;
+    FileContentCache::Stats before = cache.stats();
+    FileContentCache::Bytes first = cache.get((dir / "reference.json").string(), error);
+    FileContentCache::Bytes second = cache.get((dir / "." / "reference.json").string(), error);
+    std::string content = text(first);
+    assert(content == "{\"a\": 1}");
+    assert(first == second);  // same key after normalisation, same buffer
+    FileContentCache::Stats after = cache.stats();
+    assert(after.misses == before.misses + 1 && after.hits == before.hits + 1);
+    assert(after.entries == 1 && after.bytes == 8);
+
+    uint64_t size = 0;
+    auto encoded = cache.getBase64((dir / "reference.json").string(), size, error);
+    assert(encoded && size == 8 && *encoded == base64::encode(*first));
+    auto again = cache.getBase64((dir / "reference.json").string(), size, error);
+    assert(again == encoded);  // encoded once
+    assert(cache.stats().bytes == 8 + encoded->size());
+
+    FileContentCache::Bytes bytes = cache.get((dir / "missing.json").string(), error);
+    assert(!bytes && error.find("does not exist") != std::string::npos);
+    bytes = cache.get(dir.string(), error);
+    assert(!bytes && error.find("Not a regular file") != std::string::npos);
+
+    fs::remove_all(dir);
+    std::cout << "✓ Test 1 passed\n\n";
+}
+
+// Test 2: Edits, atomic replaces and deletes made by other processes are picked up
+void test_external_changes() {
+    std::cout << "Test 2: External changes...\n";
+
+    FileContentCache& cache = FileContentCache::getInstance();
+    auto dir = tempDir("crossdev_content_cache_test2");
+    fs::path file = dir / "template.html";
+    writeFile(file, "version 1");
+    std::string error;
+    std::string content = text(cache.get(file.string(), error));
+    assert(content == "version 1");
+
+    // Same size, rewritten in place
+    writeFile(file, "version 2");
+    content = awaitContent(file, "version 2");
+    assert(content == "version 2");
+
+    // Replaced by rename, as editors and writeFile do
+    writeFile(dir / "template.tmp", "version three");
+    fs::rename(dir / "template.tmp", file);
+    content = awaitContent(file, "version three");
+    assert(content == "version three");
+
+    fs::remove(file);
+    bool gone = false;
+    for (int i = 0; i < 200 && !gone; ++i) {
+        gone = !cache.get(file.string(), error);
+        if (!gone) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    assert(gone);
+
+    fs::remove_all(dir);
+    std::cout << "✓ Test 2 passed (" << (FileWatcher::isEventDriven() ? "watcher" : "stat") << " validation)\n\n";
+}
+
+// Test 3: invalidate() takes effect immediately, even when size and mtime are unchanged
+void test_invalidate() {
+    std::cout << "Test 3: Invalidate...\n";
+
+    FileContentCache& cache = FileContentCache::getInstance();
+    auto dir = tempDir("crossdev_content_cache_test3");
+    fs::create_directories(dir / "sub");
+    writeFile(dir / "sub" / "a.txt", "aaaa");
+    writeFile(dir / "b.txt", "bbbb");
+    std::string error;
+    std::string content = text(cache.get((dir / "sub" / "a.txt").string(), error));
+    assert(content == "aaaa");
+    content = text(cache.get((dir / "b.txt").string(), error));
+    assert(content == "bbbb");
+
+    auto mtime = fs::last_write_time(dir / "sub" / "a.txt");
+    writeFile(dir / "sub" / "a.txt", "AAAA");
+    fs::last_write_time(dir / "sub" / "a.txt", mtime);
+    cache.invalidate((dir / "sub").string());  // everything below the directory
+    content = text(cache.get((dir / "sub" / "a.txt").string(), error));
+    assert(content == "AAAA");
+    content = text(cache.get((dir / "b.txt").string(), error));
+    assert(content == "bbbb");
+
+    fs::remove_all(dir);
+    std::cout << "✓ Test 3 passed\n\n";
+}
+
+// Test 4: The memory budget evicts least recently used entries; large files bypass the cache
+void test_budget() {
+    std::cout << "Test 4: Budget...\n";
+
+    FileContentCache& cache = FileContentCache::getInstance();
+    cache.clear();
+    cache.setBudget(4000);
+    assert(cache.maxEntryBytes() == 1000);
+    auto dir = tempDir("crossdev_content_cache_test4");
+    std::string error;
+    for (int i = 0; i < 5; ++i) {
+        writeFile(dir / ("f" + std::to_string(i)), std::string(1000, static_cast<char>('a' + i)));
+    }
+    for (int i = 0; i < 4; ++i) cache.get((dir / ("f" + std::to_string(i))).string(), error);
+    assert(cache.stats().entries == 4 && cache.stats().bytes == 4000);
+    cache.get((dir / "f0").string(), error);  // f1 is now the oldest
+    cache.get((dir / "f4").string(), error);
+    assert(cache.stats().entries == 4 && cache.stats().bytes == 4000);
+
+    FileContentCache::Stats before = cache.stats();
+    cache.get((dir / "f0").string(), error);
+    assert(cache.stats().hits == before.hits + 1);
+    cache.get((dir / "f1").string(), error);
+    assert(cache.stats().misses == before.misses + 1);
+
+    writeFile(dir / "big", std::string(1001, 'x'));
+    FileContentCache::Bytes bytes = cache.get((dir / "big").string(), error);
+    assert(bytes->size() == 1001);
+    assert(cache.stats().bytes <= 4000 && cache.stats().entries == 4);
+
+    cache.setBudget(1500);
+    assert(cache.stats().entries == 1);
+    cache.clear();
+    assert(cache.stats().entries == 0 && cache.stats().bytes == 0);
+    cache.setBudget(64ull * 1024 * 1024);
+
+    fs::remove_all(dir);
+    std::cout << "✓ Test 4 passed\n\n";
+}
+
+// Test 5: Concurrent readers while the file is being replaced only ever see whole versions
+void test_concurrent() {
+    std::cout << "Test 5: Concurrent readers...\n";
+
+    auto dir = tempDir("crossdev_content_cache_test5");
+    fs::path file = dir / "shared.json";
+    writeFile(file, std::string(5000, '0'));
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&file]() {
+            std::string error;
+            for (int i = 0; i < 500; ++i) {
+                auto bytes = FileContentCache::getInstance().get(file.string(), error);
+                assert(bytes && bytes->size() == 5000);
+                for (unsigned char c : *bytes) assert(c == (*bytes)[0]);
+            }
+        });
+    }
+    for (int v = 1; v < 10; ++v) {
+        writeFile(dir / "shared.tmp", std::string(5000, static_cast<char>('0' + v)));
+        fs::rename(dir / "shared.tmp", file);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    for (auto& reader : readers) reader.join();
+    std::string content = awaitContent(file, std::string(5000, '9'));
+    assert(content == std::string(5000, '9'));
+
+    fs::remove_all(dir);
+    std::cout << "✓ Test 5 passed\n\n";
+}
+
+// Test 6: Replacing the file's whole directory (mv dir dir.old; mkdir dir) is noticed, and so
+// are edits to the new directory's file afterwards
+void test_directory_replaced() {
+    std::cout << "Test 6: Directory replaced...\n";
+
+    fs::path root = tempDir("crossdev_cache_test6");
+    fs::path dir = root / "dir";
+    fs::create_directories(dir);
+    writeFile(dir / "a.json", "OLD");
+    std::string error;
+    std::string content = text(FileContentCache::getInstance().get((dir / "a.json").string(), error));
+    assert(content == "OLD");
+
+    fs::rename(dir, root / "dir.old");
+    fs::create_directories(dir);
+    writeFile(dir / "a.json", "NEW");
+    content = awaitContent(dir / "a.json", "NEW");
+    assert(content == "NEW");
+
+    writeFile(dir / "a.json", "NEWER");
+    content = awaitContent(dir / "a.json", "NEWER");
+    assert(content == "NEWER");
+
+    fs::remove_all(root);
+    std::cout << "✓ Test 6 passed\n\n";
+}
+
+int main() {
+    std::cout << "=== FileContentCache Tests ===\n\n";
+
+    test_hits();
+    test_external_changes();
+    test_invalidate();
+    test_budget();
+    test_concurrent();
+    test_directory_replaced();
+
+    std::cout << "All FileContentCache tests passed!\n";
+    return 0;
+}
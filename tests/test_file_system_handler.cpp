@@ -0,0 +1,257 @@
+#include "../include/handlers/file_system_handler.h"
+#include "../include/deferred_delete.h"
+#include "../include/window.h"
+#include "../include/webview.h"
+#include "test_support.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <set>
+#include <cstdio>
+#include <thread>
+#include <cassert>
+
+static nlohmann::json listDir(MessageHandler& handler, nlohmann::json payload) {
+    payload["_type"] = "listDir";
+    return handler.handle(payload, "1");
+}
+
+static std::vector<std::string> names(const nlohmann::json& result) {
+    std::vector<std::string> out;
+    for (const auto& e : result["entries"]) out.push_back(e["name"]);
+    return out;
+}
+
+// Test 1: Default listing keeps the original entry shape
+void test_default_fields() {
+    std::cout << "Test 1: Default fields...\n";
+
+    enterTempDir("crossdev_fs_test1");
+    std::filesystem::create_directory("sub");
+    writeFile("a.txt", 10);
+    auto handler = createFileSystemHandler();
+
+    nlohmann::json r = listDir(*handler, {{"path", "."}});
+    assert(r["success"] == true && r["entries"].size() == 2 && !r.contains("nextCursor"));
+    for (const auto& e : r["entries"]) {
+        if (e["name"] == "a.txt") {
+            assert(e["isFile"] == true && e["isDirectory"] == false && e["size"] == 10);
+        } else {
+            assert(e["name"] == "sub" && e["isDirectory"] == true && !e.contains("size"));
+        }
+    }
+
+    std::cout << "✓ Test 1 passed\n\n";
+}
+
+// Test 2: fields selects what is returned (and read)
+void test_fields() {
+    std::cout << "Test 2: Field selection...\n";
+
+    enterTempDir("crossdev_fs_test2");
+    writeFile("f.bin", 3);
+    auto handler = createFileSystemHandler();
+
+    nlohmann::json r = listDir(*handler, {{"path", "."}, {"fields", {"name"}}});
+    assert(r["success"] == true && r["entries"][0] == nlohmann::json({{"name", "f.bin"}}));
+
+    r = listDir(*handler, {{"path", "."}, {"fields", {"name", "mtime", "isSymlink"}}});
+    assert(r["entries"][0]["mtime"].get<int64_t>() > 1500000000000LL);
+    assert(r["entries"][0]["isSymlink"] == false && !r["entries"][0].contains("size"));
+
+    r = listDir(*handler, {{"path", "."}, {"fields", {"owner"}}});
+    assert(r["success"] == false);
+    r = listDir(*handler, {{"path", "."}, {"fields", "name"}});
+    assert(r["success"] == false);
+
+    std::cout << "✓ Test 2 passed\n\n";
+}
+
+// Test 3: Native sorting
+void test_sorting() {
+    std::cout << "Test 3: Sorting...\n";
+
+    enterTempDir("crossdev_fs_test3");
+    writeFile("b", 30);
+    writeFile("c", 10);
+    writeFile("a", 20);
+    std::filesystem::create_directory("z");
+    auto handler = createFileSystemHandler();
+
+    std::vector<std::string> listed = names(listDir(*handler, {{"path", "."}, {"sortBy", "name"}}));
+    assert(listed == std::vector<std::string>({"a", "b", "c", "z"}));
+    listed = names(listDir(*handler, {{"path", "."}, {"sortBy", "name"}, {"descending", true}}));
+    assert(listed == std::vector<std::string>({"z", "c", "b", "a"}));
+    // Directories have no size (-1) and sort first
+    listed = names(listDir(*handler, {{"path", "."}, {"sortBy", "size"}, {"fields", {"name"}}}));
+    assert(listed == std::vector<std::string>({"z", "c", "a", "b"}));
+    listed = names(listDir(*handler, {{"path", "."}, {"sortBy", "type"}}));
+    assert(listed == std::vector<std::string>({"z", "a", "b", "c"}));
+    nlohmann::json r = listDir(*handler, {{"path", "."}, {"sortBy", "color"}});
+    assert(r["success"] == false);
+
+    std::cout << "✓ Test 3 passed\n\n";
+}
+
+// Test 4: offset/limit pages and continuation cursors, sorted and streaming
+void test_paging() {
+    std::cout << "Test 4: Paging...\n";
+
+    enterTempDir("crossdev_fs_test4");
+    for (int i = 0; i < 250; ++i) {
+        char name[16];
+        std::snprintf(name, sizeof(name), "f%03d", i);
+        writeFile(name, 1);
+    }
+    auto handler = createFileSystemHandler();
+
+    nlohmann::json r = listDir(*handler, {{"path", "."}, {"sortBy", "name"}, {"offset", 10}, {"limit", 5}});
+    assert(names(r) == std::vector<std::string>({"f010", "f011", "f012", "f013", "f014"}));
+    assert(r["total"] == 250 && r["nextCursor"].is_string());
+
+    // Sorted: the cursor serves the rest without re-reading the directory
+    std::string cursor = r["nextCursor"];
+    r = listDir(*handler, {{"path", "."}, {"cursor", cursor}, {"limit", 100}});
+    assert(r["entries"].size() == 100 && r["entries"][0]["name"] == "f015" && r["entries"][0]["size"] == 1);
+    r = listDir(*handler, {{"path", "."}, {"cursor", cursor}});
+    assert(r["entries"].size() == 135 && r["entries"].back()["name"] == "f249" && !r.contains("nextCursor"));
+    r = listDir(*handler, {{"path", "."}, {"cursor", cursor}});
+    assert(r["success"] == false && r["cursorExpired"] == true);
+
+    // Unsorted: pages continue the open directory iterator; together they cover every entry once
+    std::set<std::string> seen;
+    r = listDir(*handler, {{"path", "."}, {"limit", 64}, {"fields", {"name"}}});
+    while (true) {
+        assert(r["success"] == true && r["entries"].size() <= 64);
+        for (const auto& name : names(r)) assert(seen.insert(name).second);
+        if (!r.contains("nextCursor")) break;
+        r = listDir(*handler, {{"path", "."}, {"cursor", r["nextCursor"]}, {"limit", 64}});
+    }
+    assert(seen.size() == 250);
+
+    r = listDir(*handler, {{"path", "."}, {"offset", 240}});
+    assert(r["entries"].size() == 10);
+
+    // Cursors are bound to their directory
+    std::filesystem::create_directory("other");
+    r = listDir(*handler, {{"path", "."}, {"sortBy", "name"}, {"limit", 1}});
+    r = listDir(*handler, {{"path", "other"}, {"cursor", r["nextCursor"]}});
+    assert(r["success"] == false);
+    r = listDir(*handler, {{"path", "."}, {"limit", -1}});
+    assert(r["success"] == false);
+
+    std::cout << "✓ Test 4 passed\n\n";
+}
+
+// Pump main-thread tasks until "delete:done" arrives for jobId
+static nlohmann::json waitDeleted(WebView& webView, const std::string& jobId) {
+    auto deadline = std::chrono::steady_clock::now() + kJobTimeout;
+    while (true) {
+        assert(std::chrono::steady_clock::now() < deadline);
+        platform::mockRunMainThreadTasks();
+        for (const auto& raw : platform::mockTakePostedMessages(webView.getNativeHandle())) {
+            nlohmann::json msg = nlohmann::json::parse(raw);
+            if (msg["name"] == "delete:done" && msg["payload"]["jobId"] == jobId) return msg["payload"];
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+// Test 5: Deferred deletion returns at once, removes in the background and recovers leftovers
+void test_deferred_delete() {
+    std::cout << "Test 5: Deferred delete...\n";
+
+    namespace fs = std::filesystem;
+    fs::path dir = enterTempDir("crossdev_fs_test5");
+    Window window(nullptr, nullptr, 0, 0, 100, 100, "FS Test");
+    WebView webView(&window, &window, 0, 0, 100, 100);
+    auto handler = createFileSystemHandler(&webView);
+
+    for (int d = 0; d < 20; ++d) {
+        fs::create_directories("big/d" + std::to_string(d) + "/sub");
+        for (int f = 0; f < 100; ++f) {
+            writeFile("big/d" + std::to_string(d) + "/sub/f" + std::to_string(f), 16);
+        }
+    }
+    nlohmann::json r = handler->handle({{"_type", "deleteFile"}, {"path", "big"}, {"deferred", true}}, "1");
+    assert(r["success"] == true && r["deferred"] == true && r["jobId"].is_string());
+    assert(!fs::exists("big"));
+    nlohmann::json done = waitDeleted(webView, r["jobId"]);
+    assert(done["path"] == "big" && !done.contains("error") && done["removedCount"] == 2000 + 41);
+    bool idle = DeferredDeleter::getInstance().waitIdle(std::chrono::seconds(10));
+    assert(idle);
+    assert(!fs::exists(DeferredDeleter::kTrashDirName));
+
+    writeFile("single.txt", 3);
+    r = handler->handle({{"_type", "deleteFile"}, {"path", "single.txt"}, {"deferred", true}}, "2");
+    nlohmann::json deleted = waitDeleted(webView, r["jobId"]);
+    assert(deleted["removedCount"] == 1 && !fs::exists("single.txt"));
+
+    auto error = [&handler](nlohmann::json payload) {
+        payload["_type"] = "deleteFile";
+        nlohmann::json result = handler->handle(payload, "3");
+        assert(result["success"] == false);
+        return result["error"].get<std::string>();
+    };
+    std::string message = error({{"path", "missing"}, {"deferred", true}});
+    assert(message == "Path does not exist");
+    message = error({{"path", "."}, {"deferred", true}});
+    assert(message.find("working directory") != std::string::npos);
+    message = error({{"path", "x"}, {"deferred", "yes"}});
+    assert(message.find("deferred") != std::string::npos);
+
+    // Leftovers of an interrupted run: a staged tree, and a marker naming a hidden sibling
+    fs::create_directories(fs::path(DeferredDeleter::kTrashDirName) / "0123456789abcdef-old" / "nested");
+    writeFile(std::string(DeferredDeleter::kTrashDirName) + "/0123456789abcdef-old/nested/file", 8);
+    fs::create_directories(".mount.fedcba9876543210.deleting/inner");
+    {
+        std::ofstream marker(fs::path(DeferredDeleter::kTrashDirName) / "fedcba9876543210.ref", std::ios::binary);
+        marker << (dir / ".mount.fedcba9876543210.deleting").u8string();
+    }
+    // A marker naming something outside the sandbox is dropped, its target left alone
+    fs::path outside = dir.parent_path() / "crossdev_fs_test5_outside.deleting";
+    fs::create_directories(outside / "keep");
+    {
+        std::ofstream marker(fs::path(DeferredDeleter::kTrashDirName) / "00000000deadbeef.ref", std::ios::binary);
+        marker << outside.u8string();
+    }
+    {
+        std::ofstream marker(fs::path(DeferredDeleter::kTrashDirName) / "00000000feedface.ref", std::ios::binary);
+        marker << (dir / ".." / outside.filename()).u8string();
+    }
+
+    // The trash is neither listed nor reachable through the sandboxed handlers
+    nlohmann::json listing = listDir(*handler, {{"path", "."}});
+    for (const auto& name : names(listing)) assert(name != DeferredDeleter::kTrashDirName);
+    r = listDir(*handler, {{"path", DeferredDeleter::kTrashDirName}});
+    assert(r["success"] == false);
+    assert(resolveSandboxedPath(std::string(DeferredDeleter::kTrashDirName) + "/x.ref", dir).empty());
+    assert(resolveSandboxedPath(".CrossDev-Trash/x.ref", dir).empty());
+    assert(!resolveSandboxedPath("sub/.crossdev-trash/x", dir).empty());
+
+    DeferredDeleter::getInstance().recover(dir);
+    idle = DeferredDeleter::getInstance().waitIdle(std::chrono::seconds(10));
+    assert(idle);
+    assert(!fs::exists(DeferredDeleter::kTrashDirName) && !fs::exists(".mount.fedcba9876543210.deleting"));
+    assert(fs::exists(outside / "keep"));
+    fs::remove_all(outside);
+
+    handler.reset();
+    fs::current_path(fs::temp_directory_path());
+    fs::remove_all(dir);
+
+    std::cout << "✓ Test 5 passed\n\n";
+}
+
+int main() {
+    std::cout << "=== FileSystem Handler Tests ===\n\n";
+
+    test_default_fields();
+    test_fields();
+    test_sorting();
+    test_paging();
+    test_deferred_delete();
+
+    std::cout << "=== All tests passed! ===\n";
+    return 0;
+}
@@ -0,0 +1,265 @@
+#include "../include/handlers/find_files_handler.h"
+#include "../include/thread_pool.h"
+#include "../include/window.h"
+#include "../include/webview.h"
+#include "test_support.h"
+#include <nlohmann/json.hpp>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <set>
+#include <thread>
+#include <atomic>
+#include <cassert>
+
+struct FindResult {
+    std::set<std::string> paths;
+    nlohmann::json matches = nlohmann::json::array();
+    nlohmann::json done;
+};
+
+// Pump main-thread tasks until "find:done" arrives for searchId
+static FindResult collect(WebView& webView, const std::string& searchId) {
+    FindResult out;
+    auto deadline = std::chrono::steady_clock::now() + kJobTimeout;
+    while (out.done.is_null()) {
+        assert(std::chrono::steady_clock::now() < deadline);
+        platform::mockRunMainThreadTasks();
+        for (const auto& raw : platform::mockTakePostedMessages(webView.getNativeHandle())) {
+            nlohmann::json msg = nlohmann::json::parse(raw);
+            const nlohmann::json& payload = msg["payload"];
+            if (payload["searchId"] != searchId) continue;
+            if (msg["name"] == "find:matches") {
+                for (const auto& m : payload["matches"]) {
+                    out.paths.insert(m["path"].get<std::string>());
+                    out.matches.push_back(m);
+                }
+            } else if (msg["name"] == "find:done") {
+                out.done = payload;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return out;
+}
+
+static FindResult find(MessageHandler& handler, WebView& webView, nlohmann::json payload,
+                       const std::string& type = "findFiles") {
+    payload["_type"] = type;
+    nlohmann::json r = handler.handle(payload, "1");
+    assert(r["success"] == true);
+    return collect(webView, r["searchId"]);
+}
+
+// tree/
+//   a.txt (10)  b.log (2000)  .hidden (1)
+//   src/ main.cpp (100)  util.h (5)  deep/ x.cpp (7)  deep/deeper/ y.cpp (3)
+//   node_modules/ pkg.cpp (1)
+static void makeTree() {
+    std::filesystem::create_directories("tree/src/deep/deeper");
+    std::filesystem::create_directories("tree/node_modules");
+    writeFile("tree/a.txt", 10);
+    writeFile("tree/b.log", 2000);
+    writeFile("tree/.hidden", 1);
+    writeFile("tree/src/main.cpp", 100);
+    writeFile("tree/src/util.h", 5);
+    writeFile("tree/src/deep/x.cpp", 7);
+    writeFile("tree/src/deep/deeper/y.cpp", 3);
+    writeFile("tree/node_modules/pkg.cpp", 1);
+}
+
+// Test 1: The pool runs every task, including ones submitted from workers
+void test_thread_pool() {
+    std::cout << "Test 1: Thread pool...\n";
+
+    std::atomic<int> count{0};
+    {
+        ThreadPool pool(4);
+        for (int i = 0; i < 100; ++i) {
+            pool.submit([&pool, &count]() {
+                count++;
+                for (int j = 0; j < 10; ++j) pool.submit([&count]() { count++; });
+            });
+        }
+    }  // Destructor drains the queues
+    assert(count == 1100);
+
+    std::cout << "✓ Test 1 passed\n\n";
+}
+
+// Test 2: Globs on names and relative paths, exclusions, hidden files
+void test_globs(MessageHandler& handler, WebView& webView) {
+    std::cout << "Test 2: Globs and exclusions...\n";
+
+    FindResult r = find(handler, webView, {{"path", "tree"}, {"glob", "*.cpp"}});
+    assert((r.paths == std::set<std::string>{"src/main.cpp", "src/deep/x.cpp", "src/deep/deeper/y.cpp",
+                                             "node_modules/pkg.cpp"}));
+    assert(r.done["count"] == 4 && r.done["truncated"] == false && r.done["cancelled"] == false);
+    assert(r.done["directoriesScanned"] == 5);
+
+    r = find(handler, webView, {{"path", "tree"}, {"glob", "*.cpp"}, {"exclude", "node_modules"}});
+    assert(r.paths.size() == 3 && !r.paths.count("node_modules/pkg.cpp"));
+    assert(r.done["directoriesScanned"] == 4);  // Excluded directory is not entered
+
+    r = find(handler, webView, {{"path", "tree"}, {"glob", "src/**/*.cpp"}});
+    assert((r.paths == std::set<std::string>{"src/main.cpp", "src/deep/x.cpp", "src/deep/deeper/y.cpp"}));
+
+    r = find(handler, webView, {{"path", "tree"}, {"glob", {"*.[th]*", "B.LOG"}}, {"ignoreCase", true}});
+    assert((r.paths == std::set<std::string>{"a.txt", "b.log", ".hidden", "src/util.h"}));
+
+    r = find(handler, webView, {{"path", "tree"}, {"maxDepth", 1}, {"skipHidden", true}});
+    assert((r.paths == std::set<std::string>{"a.txt", "b.log"}));
+
+    r = find(handler, webView, {{"path", "tree"}, {"nameContains", "ma"}});
+    assert((r.paths == std::set<std::string>{"src/main.cpp"}));
+
+    std::cout << "✓ Test 2 passed\n\n";
+}
+
+// Test 3: Size predicates, stats, walk includes directories
+void test_predicates(MessageHandler& handler, WebView& webView) {
+    std::cout << "Test 3: Predicates and walk...\n";
+
+    FindResult r = find(handler, webView, {{"path", "tree"}, {"minSize", 7}, {"maxSize", 100}, {"withStats", true}});
+    assert((r.paths == std::set<std::string>{"a.txt", "src/main.cpp", "src/deep/x.cpp"}));
+    for (const auto& m : r.matches) {
+        assert(m["size"].get<int64_t>() >= 7 && m.contains("mtime") && m["isDirectory"] == false);
+    }
+
+    r = find(handler, webView, {{"path", "tree"}, {"modifiedAfter", 0}, {"modifiedBefore", 1}});
+    assert(r.paths.empty() && r.done["count"] == 0);
+
+    r = find(handler, webView, {{"path", "tree/src"}, {"maxDepth", 2}}, "walk");
+    assert((r.paths == std::set<std::string>{"main.cpp", "util.h", "deep", "deep/x.cpp", "deep/deeper"}));
+    for (const auto& m : r.matches) {
+        assert(m["isDirectory"] == (m["path"] == "deep" || m["path"] == "deep/deeper"));
+    }
+
+    std::cout << "✓ Test 3 passed\n\n";
+}
+
+// Test 4: maxResults truncates; many batches arrive for large trees
+void test_limits(MessageHandler& handler, WebView& webView) {
+    std::cout << "Test 4: Limits and batching...\n";
+
+    for (int d = 0; d < 20; ++d) {
+        std::string dir = "big/d" + std::to_string(d);
+        std::filesystem::create_directories(dir);
+        for (int f = 0; f < 50; ++f) writeFile(dir + "/f" + std::to_string(f), 0);
+    }
+    FindResult r = find(handler, webView, {{"path", "big"}});
+    assert(r.paths.size() == 1000 && r.done["count"] == 1000);
+
+    r = find(handler, webView, {{"path", "big"}, {"maxResults", 10}});
+    assert(r.paths.size() == 10 && r.done["count"] == 10 && r.done["truncated"] == true);
+
+    std::cout << "✓ Test 4 passed\n\n";
+}
+
+// Test 5: Cancel and invalid requests
+void test_cancel_and_errors(MessageHandler& handler, WebView& webView) {
+    std::cout << "Test 5: Cancel and errors...\n";
+
+    nlohmann::json r = handler.handle({{"_type", "findFiles"}, {"path", "big"}}, "1");
+    assert(r["success"] == true);
+    nlohmann::json c = handler.handle({{"_type", "cancelFind"}, {"searchId", r["searchId"]}}, "2");
+    assert(c["success"] == true);
+    FindResult done = collect(webView, r["searchId"]);
+    assert(done.done["count"].get<size_t>() <= 1000);
+    if (c["found"] == true && done.done["count"].get<size_t>() < 1000) {
+        assert(done.done["cancelled"] == true);
+    }
+
+    r = handler.handle({{"_type", "findFiles"}, {"path", "../"}}, "3");
+    assert(r["success"] == false);
+    r = handler.handle({{"_type", "findFiles"}, {"path", "tree/a.txt"}}, "4");
+    assert(r["success"] == false);
+    r = handler.handle({{"_type", "findFiles"}, {"path", "tree"}, {"maxDepth", 0}}, "5");
+    assert(r["success"] == false);
+    r = handler.handle({{"_type", "findFiles"}, {"path", "tree"}, {"minSize", "x"}}, "6");
+    assert(r["success"] == false);
+    r = handler.handle({{"_type", "findFiles"}, {"path", "tree"}, {"glob", {1}}}, "7");
+    assert(r["success"] == false);
+    r = handler.handle({{"_type", "cancelFind"}}, "8");
+    assert(r["success"] == false);
+
+    std::cout << "✓ Test 5 passed\n\n";
+}
+
+// Test 6: Followed symlinks: cycles are entered once, links out of the root not at all
+void test_symlinks(MessageHandler& handler, WebView& webView) {
+    std::cout << "Test 6: Symlinks...\n";
+
+    std::filesystem::create_directories("links/a/b");
+    std::filesystem::create_directories("outside");
+    writeFile("links/a/b/leaf.txt", 1);
+    writeFile("outside/secret.txt", 1);
+    std::filesystem::create_directory_symlink("..", "links/a/b/up");    // cycle back to links/a
+    std::filesystem::create_directory_symlink("../../outside", "links/a/out");
+
+    FindResult r = find(handler, webView, {{"path", "links"}, {"followSymlinks", true}});
+    assert(r.paths.count("a/b/leaf.txt") == 1);
+    for (const auto& path : r.paths) {
+        assert(path.find("secret") == std::string::npos);
+        assert(path.find("up/") == std::string::npos);  // links/a was already entered
+    }
+    assert(r.done["truncated"] == false);
+
+    // Nothing matches: the cycle still ends
+    r = find(handler, webView, {{"path", "links"}, {"followSymlinks", true}, {"glob", "*.none"}});
+    assert(r.paths.empty() && r.done["count"] == 0);
+
+    std::cout << "✓ Test 6 passed\n\n";
+}
+
+// Test 7: Many-star patterns take time linear in pattern x name, not exponential in the stars
+void test_many_stars(MessageHandler& handler, WebView& webView) {
+    std::cout << "Test 7: Many-star globs...\n";
+
+    std::string as(100, 'a');
+    std::filesystem::create_directories("stars/" + as + "/" + as);
+    writeFile("stars/" + as + "/" + as + "/" + as, 1);
+    writeFile("stars/" + as + "/" + as + "/" + as + "b", 1);
+
+    auto started = std::chrono::steady_clock::now();
+    std::string stars;
+    for (int i = 0; i < 12; ++i) stars += "*a";
+    FindResult r = find(handler, webView, {{"path", "stars"}, {"glob", stars + "*b"}});
+    assert((r.paths == std::set<std::string>{as + "/" + as + "/" + as + "b"}));
+    r = find(handler, webView, {{"path", "stars"}, {"glob", "**/" + stars + "*c"}});
+    assert(r.paths.empty());
+    r = find(handler, webView, {{"path", "stars"}, {"glob", "**a**a**a**a**a**a**a**a**/**b"}});
+    assert(r.paths.size() == 1);
+    r = find(handler, webView, {{"path", "stars"}, {"glob", "*/" + stars + "/*a*"}, {"includeDirectories", true}});
+    assert((r.paths == std::set<std::string>{as + "/" + as + "/" + as, as + "/" + as + "/" + as + "b"}));
+    auto elapsed = std::chrono::steady_clock::now() - started;
+    assert(elapsed < std::chrono::seconds(5));
+
+    std::cout << "✓ Test 7 passed\n\n";
+}
+
+int main() {
+    std::cout << "Running FindFilesHandler tests...\n\n";
+
+    test_thread_pool();
+
+    std::filesystem::path dir = enterTempDir("crossdev_find_test");
+    makeTree();
+    Window window(nullptr, nullptr, 0, 0, 100, 100, "Find Test");
+    WebView webView(&window, &window, 0, 0, 100, 100);
+    auto handler = createFindFilesHandler(&webView);
+
+    test_globs(*handler, webView);
+    test_predicates(*handler, webView);
+    test_limits(*handler, webView);
+    test_cancel_and_errors(*handler, webView);
+    test_symlinks(*handler, webView);
+    test_many_stars(*handler, webView);
+
+    handler.reset();
+    std::filesystem::current_path(std::filesystem::temp_directory_path());
+    std::filesystem::remove_all(dir);
+
+    std::cout << "All FindFilesHandler tests passed!\n";
+    return 0;
+}
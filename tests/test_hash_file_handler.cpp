@@ -0,0 +1,173 @@
+#include "../include/handlers/hash_file_handler.h"
+#include "../include/hashing.h"
+#include "../include/window.h"
+#include "../include/webview.h"
+#include "test_support.h"
+#include <nlohmann/json.hpp>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <thread>
+#include <cstdio>
+#include <iterator>
+#include <cassert>
+
+// Deterministic bytes: (i * 131 + 7) & 255
+static std::string pattern(size_t len) {
+    std::string data(len, '\0');
+    for (size_t i = 0; i < len; ++i) data[i] = static_cast<char>((i * 131 + 7) & 255);
+    return data;
+}
+
+struct Reference {
+    size_t len;
+    const char* xxh3;
+    const char* sha256;
+};
+
+// Digests of pattern(len) from the reference xxHash and OpenSSL implementations
+static const Reference kReferences[] = {
+    {0, "2d06800538d394c2", "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"},
+    {3, "6e3e2670e61106ac", "17aef23a39d753e713c203c152454d29fa8e39a98e83a69b39a5094dba9ae951"},
+    {100, "5da67eac6d4093d5", "b493defffa04821dbe4b757ed039293591680fd3f05a08182b145193205fcba0"},
+    {200, "c0fbc0f4e181c826", "78bbb470b40e45fffa0526d26567d7d3887d082518e712cc05d0a8f4903e231b"},
+    {1000, "571d5cbfef44331b", "533b698850849b7908b20a22658f639c0b2a476f1791f85f50188287c31a9aba"},
+    {100000, "14ce8d6fc2c4868b", "5e36f5cea4f178344affaa2b166010422f54e15171b43f374816075d477ee60e"},
+};
+
+// Test 1: Digests match the reference implementations, one-shot and streamed in odd chunks
+void test_digests() {
+    std::cout << "Test 1: Reference digests...\n";
+
+    for (const auto& ref : kReferences) {
+        std::string data = pattern(ref.len);
+        assert(hashing::hashBuffer(hashing::Algorithm::Xxh3, data.data(), data.size()) == ref.xxh3);
+        assert(hashing::hashBuffer(hashing::Algorithm::Sha256, data.data(), data.size()) == ref.sha256);
+
+        hashing::Xxh3 xxh;
+        hashing::Sha256 sha;
+        for (size_t off = 0, step = 1; off < data.size(); off += step, step = step * 3 % 517 + 1) {
+            size_t n = std::min(step, data.size() - off);
+            xxh.update(data.data() + off, n);
+            sha.update(data.data() + off, n);
+        }
+        char hex[17];
+        snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(xxh.digest()));
+        assert(std::string(hex) == ref.xxh3);
+        unsigned char digest[32];
+        sha.digest(digest);
+        std::string shaHex;
+        for (unsigned char b : digest) {
+            char pair[3];
+            snprintf(pair, sizeof(pair), "%02x", b);
+            shaHex += pair;
+        }
+        assert(shaHex == ref.sha256);
+    }
+
+    std::cout << "✓ Test 1 passed\n\n";
+}
+
+// Test 2: hashFile streams a large file and reports progress
+void test_hash_file(MessageHandler& handler, WebView& webView) {
+    std::cout << "Test 2: hashFile...\n";
+
+    writeFile("small.bin", pattern(1000));
+    nlohmann::json r = handler.handle({{"_type", "hashFile"}, {"path", "small.bin"}}, "1");
+    assert(r["success"] == true && r["fileCount"] == 1 && r["bytesTotal"] == 1000);
+    nlohmann::json done = waitDone(webView, "hash", r["jobId"]).done;
+    assert(done["algorithm"] == "xxh3" && done["cancelled"] == false);
+    assert(done["results"].size() == 1 && done["results"][0]["hash"] == "571d5cbfef44331b");
+    assert(done["results"][0]["size"] == 1000 && done["results"][0]["path"] == "small.bin");
+
+    // Larger than one read chunk, so the chunk boundaries are exercised
+    std::string big = pattern(5 * 1024 * 1024 + 17);
+    writeFile("big.bin", big);
+    r = handler.handle({{"_type", "hashFile"}, {"path", "big.bin"}, {"algorithm", "sha256"}}, "2");
+    done = waitDone(webView, "hash", r["jobId"]).done;
+    assert(done["results"][0]["hash"] == hashing::hashBuffer(hashing::Algorithm::Sha256, big.data(), big.size()));
+
+    std::cout << "✓ Test 2 passed\n\n";
+}
+
+// Test 3: hashFiles runs files in parallel; per-file errors do not fail the job
+void test_hash_files(MessageHandler& handler, WebView& webView) {
+    std::cout << "Test 3: hashFiles...\n";
+
+    nlohmann::json paths = nlohmann::json::array();
+    for (const auto& ref : kReferences) {
+        std::string name = "f" + std::to_string(ref.len);
+        writeFile(name, pattern(ref.len));
+        paths.push_back(name);
+    }
+    paths.push_back("missing.bin");
+    paths.push_back("../outside");
+
+    nlohmann::json r = handler.handle({{"_type", "hashFiles"}, {"paths", paths}, {"algorithm", "sha256"}}, "1");
+    assert(r["success"] == true && r["fileCount"] == paths.size());
+    nlohmann::json done = waitDone(webView, "hash", r["jobId"]).done;
+    const nlohmann::json& results = done["results"];
+    assert(results.size() == paths.size());
+    for (size_t i = 0; i < std::size(kReferences); ++i) {
+        assert(results[i]["path"] == paths[i] && results[i]["hash"] == kReferences[i].sha256);
+    }
+    assert(results[paths.size() - 2].contains("error") && !results[paths.size() - 2].contains("hash"));
+    assert(results[paths.size() - 1]["error"] == "Invalid or disallowed path");
+
+    std::cout << "✓ Test 3 passed\n\n";
+}
+
+// Test 4: Cancel and invalid requests
+void test_cancel_and_errors(MessageHandler& handler, WebView& webView) {
+    std::cout << "Test 4: Cancel and errors...\n";
+
+    nlohmann::json paths = nlohmann::json::array();
+    for (int i = 0; i < 200; ++i) paths.push_back("big.bin");
+    nlohmann::json r = handler.handle({{"_type", "hashFiles"}, {"paths", paths}, {"algorithm", "sha256"}}, "1");
+    nlohmann::json c = handler.handle({{"_type", "cancelHash"}, {"jobId", r["jobId"]}}, "2");
+    assert(c["success"] == true && c["found"] == true);
+    nlohmann::json done = waitDone(webView, "hash", r["jobId"]).done;
+    assert(done["cancelled"] == true);
+    size_t cancelled = 0;
+    for (const auto& item : done["results"]) {
+        if (item.contains("error")) cancelled++;
+    }
+    assert(cancelled > 0);
+
+    r = handler.handle({{"_type", "hashFile"}, {"path", "missing.bin"}}, "3");
+    assert(r["success"] == false);
+    r = handler.handle({{"_type", "hashFile"}, {"path", "../x"}}, "4");
+    assert(r["success"] == false);
+    r = handler.handle({{"_type", "hashFile"}, {"path", "big.bin"}, {"algorithm", "md5"}}, "5");
+    assert(r["success"] == false);
+    r = handler.handle({{"_type", "hashFiles"}, {"paths", nlohmann::json::array()}}, "6");
+    assert(r["success"] == false);
+    r = handler.handle({{"_type", "hashFiles"}, {"paths", {1}}}, "7");
+    assert(r["success"] == false);
+    r = handler.handle({{"_type", "cancelHash"}}, "8");
+    assert(r["success"] == false);
+
+    std::cout << "✓ Test 4 passed\n\n";
+}
+
+int main() {
+    std::cout << "Running HashFileHandler tests...\n\n";
+
+    test_digests();
+
+    std::filesystem::path dir = enterTempDir("crossdev_hash_test");
+    Window window(nullptr, nullptr, 0, 0, 100, 100, "Hash Test");
+    WebView webView(&window, &window, 0, 0, 100, 100);
+    auto handler = createHashFileHandler(&webView);
+
+    test_hash_file(*handler, webView);
+    test_hash_files(*handler, webView);
+    test_cancel_and_errors(*handler, webView);
+
+    handler.reset();
+    std::filesystem::current_path(std::filesystem::temp_directory_path());
+    std::filesystem::remove_all(dir);
+
+    std::cout << "All HashFileHandler tests passed!\n";
+    return 0;
+}
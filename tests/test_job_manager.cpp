@@ -0,0 +1,584 @@
+#include "../include/job_manager.h"
+#include "../include/handler_jobs.h"
+#include "../include/handlers/job_handler.h"
+#include "../include/handlers/batch_file_handler.h"
+#include "../include/native_event_bus.h"
+#include "../include/window.h"
+#include "../include/webview.h"
+#include "test_support.h"
+#include <nlohmann/json.hpp>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <cassert>
+
+namespace fs = std::filesystem;
+
+// Collects a manager's events (on the worker threads)
+struct Events {
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::vector<std::pair<std::string, nlohmann::json>> all;
+
+    JobManager::EventSink sink() {
+        return [this](const std::string& name, const nlohmann::json& payload) {
+            std::lock_guard<std::mutex> lock(mutex);
+            all.emplace_back(name, payload);
+            changed.notify_all();
+        };
+    }
+
+    nlohmann::json waitDone(const std::string& jobId) {
+        std::unique_lock<std::mutex> lock(mutex);
+        nlohmann::json done;
+        bool ok = changed.wait_for(lock, std::chrono::seconds(10), [&]() {
+            for (const auto& e : all) {
+                if (e.first == "job:done" && e.second["jobId"] == jobId) {
+                    done = e.second;
+                    return true;
+                }
+            }
+            return false;
+        });
+        assert(ok);
+        return done;
+    }
+
+    int count(const std::string& name, const std::string& jobId) {
+        std::lock_guard<std::mutex> lock(mutex);
+        int n = 0;
+        for (const auto& e : all) {
+            if (e.first == name && e.second["jobId"] == jobId) ++n;
+        }
+        return n;
+    }
+};
+
+// Holds jobs on a worker until opened
+struct Gate {
+    std::mutex mutex;
+    std::condition_variable changed;
+    bool open = false;
+    int waiting = 0;
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        ++waiting;
+        changed.notify_all();
+        changed.wait(lock, [this]() { return open; });
+    }
+    void waitForWaiting(int n) {
+        std::unique_lock<std::mutex> lock(mutex);
+        bool reached = changed.wait_for(lock, std::chrono::seconds(10), [&]() { return waiting >= n; });
+        assert(reached);
+    }
+    void release() {
+        std::lock_guard<std::mutex> lock(mutex);
+        open = true;
+        changed.notify_all();
+    }
+};
+
+static std::string stateOf(JobManager& manager, const std::string& id) {
+    nlohmann::json status;
+    bool found = manager.status(id, status);
+    assert(found);
+    return status["state"];
+}
+
+// Test 1: Queued jobs start by priority, FIFO within one, never more at once than there are workers
+void test_priorities() {
+    std::cout << "Test 1: Priorities and bounded workers...\n";
+
+    Events events;
+    JobManager manager(1);
+    manager.setEventSink(events.sink());
+    assert(manager.workerCount() == 1);
+
+    Gate gate;
+    std::string blocker = manager.start("block", JobManager::Priority::Low, [&](JobContext&) { gate.wait(); return nullptr; });
+    gate.waitForWaiting(1);
+
+    std::vector<std::string> order;  // only the one worker writes it
+    auto record = [&](const std::string& name) {
+        return [&, name](JobContext& context) -> nlohmann::json {
+            assert(JobContext::current() == &context && context.kind() == "record");
+            order.push_back(name);
+            return {{"name", name}};
+        };
+    };
+    std::vector<std::string> ids;
+    ids.push_back(manager.start("record", JobManager::Priority::Low, record("low1")));
+    ids.push_back(manager.start("record", JobManager::Priority::Normal, record("normal1")));
+    ids.push_back(manager.start("record", JobManager::Priority::High, record("high1")));
+    ids.push_back(manager.start("record", JobManager::Priority::Normal, record("normal2")));
+    ids.push_back(manager.start("record", JobManager::Priority::High, record("high2")));
+    assert(stateOf(manager, blocker) == "running" && stateOf(manager, ids[0]) == "queued");
+    assert(JobContext::current() == nullptr);
+
+    nlohmann::json all = manager.list();
+    assert(all.size() == 6 && all[0]["jobId"] == blocker && all[5]["jobId"] == ids[4]);
+    assert(all[1]["priority"] == "low" && all[3]["priority"] == "high");
+
+    gate.release();
+    for (const auto& id : ids) {
+        nlohmann::json done = events.waitDone(id);
+        assert(done["state"] == "done" && done["kind"] == "record" && done.contains("elapsedMs"));
+    }
+    assert((order == std::vector<std::string>{"high1", "high2", "normal1", "normal2", "low1"}));
+    nlohmann::json first = events.waitDone(ids[2]);
+    assert(first["result"]["name"] == "high1");
+
+    // Many jobs, two workers: two at a time
+    JobManager pair(2);
+    pair.setEventSink(events.sink());
+    std::atomic<int> running{0};
+    std::atomic<int> peak{0};
+    std::vector<std::string> busy;
+    for (int i = 0; i < 8; ++i) {
+        busy.push_back(pair.start("busy", JobManager::Priority::Normal, [&](JobContext&) {
+            int now = ++running;
+            int seen = peak.load();
+            while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            --running;
+            return nullptr;
+        }));
+    }
+    for (const auto& id : busy) {
+        events.waitDone(id);
+    }
+    assert(peak == 2);
+
+    std::cout << "✓ Test 1 passed\n\n";
+}
+
+// Test 2: Results, failures, progress and forgetting old jobs
+void test_outcomes() {
+    std::cout << "Test 2: Outcomes and progress...\n";
+
+    Events events;
+    JobManager manager(1);
+    manager.setEventSink(events.sink());
+
+    std::string ok = manager.start("ok", JobManager::Priority::Normal, [](JobContext&) {
+        return nlohmann::json{{"success", true}, {"count", 3}};
+    });
+    std::string failed = manager.start("failed", JobManager::Priority::Normal, [](JobContext&) {
+        return nlohmann::json{{"success", false}, {"error", "Disk full"}};
+    });
+    std::string threw = manager.start("threw", JobManager::Priority::Normal, [](JobContext&) -> nlohmann::json {
+        throw std::runtime_error("Bad input");
+    });
+    nlohmann::json done = events.waitDone(ok);
+    assert(done["state"] == "done" && done["result"]["count"] == 3 && !done.contains("error"));
+    done = events.waitDone(failed);
+    assert(done["state"] == "failed" && done["error"] == "Disk full" && done["result"]["success"] == false);
+    done = events.waitDone(threw);
+    assert(done["state"] == "failed" && done["error"] == "Bad input" && !done.contains("result"));
+
+    // Every update lands in jobStatus; events are throttled
+    Gate gate;
+    std::string progress = manager.start("progress", JobManager::Priority::Normal, [&](JobContext& context) {
+        for (int i = 1; i <= 1000; ++i) {
+            context.progress({{"done", i}, {"total", 1000}});
+        }
+        gate.wait();
+        return nullptr;
+    });
+    gate.waitForWaiting(1);
+    nlohmann::json status;
+    bool found = manager.status(progress, status);
+    assert(found && status["state"] == "running" && status["progress"]["done"] == 1000);
+    int progressEvents = events.count("job:progress", progress);
+    assert(progressEvents >= 1 && progressEvents < 10);
+    gate.release();
+    done = events.waitDone(progress);
+    assert(done["state"] == "done" && !done.contains("result"));
+
+    std::string first = ok;
+    for (size_t i = 0; i < JobManager::kKeepFinished; ++i) {
+        events.waitDone(manager.start("filler", JobManager::Priority::Low, [](JobContext&) { return nullptr; }));
+    }
+    found = manager.status(first, status);
+    assert(!found);
+    assert(manager.list().size() == JobManager::kKeepFinished);
+
+    std::cout << "✓ Test 2 passed\n\n";
+}
+
+// Test 3: Cancelling queued, running and finished jobs
+void test_cancel() {
+    std::cout << "Test 3: Cancel...\n";
+
+    Events events;
+    JobManager manager(1);
+    manager.setEventSink(events.sink());
+
+    std::string running = manager.start("loop", JobManager::Priority::Normal, [](JobContext& context) {
+        while (!context.cancelled()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return nlohmann::json{{"partial", true}};
+    });
+    while (stateOf(manager, running) != "running") {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    bool ran = false;
+    std::string queued = manager.start("never", JobManager::Priority::High, [&](JobContext&) { ran = true; return nullptr; });
+
+    bool cancelled = manager.cancel(queued);
+    assert(cancelled);
+    nlohmann::json done = events.waitDone(queued);
+    assert(done["state"] == "cancelled" && done["elapsedMs"] == 0);
+    cancelled = manager.cancel(running);
+    assert(cancelled);
+    done = events.waitDone(running);
+    assert(done["state"] == "cancelled" && done["result"]["partial"] == true);
+    assert(!ran);
+
+    cancelled = manager.cancel(running);
+    assert(!cancelled);
+    cancelled = manager.cancel(queued);
+    assert(!cancelled);
+    cancelled = manager.cancel("job-999");
+    assert(!cancelled);
+
+    // Destroying the manager stops running work and drops the queue
+    bool dropped = true;
+    {
+        JobManager doomed(1);
+        doomed.setEventSink([](const std::string&, const nlohmann::json&) {});
+        doomed.start("loop", JobManager::Priority::Normal, [](JobContext& context) {
+            while (!context.cancelled()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            return nullptr;
+        });
+        doomed.start("never", JobManager::Priority::Normal, [&](JobContext&) { dropped = false; return nullptr; });
+    }
+    assert(dropped);
+
+    std::cout << "✓ Test 3 passed\n\n";
+}
+
+// Pump main-thread tasks until webView receives "job:done" for jobId; counts its "job:progress"
+static nlohmann::json waitWindowDone(WebView& webView, const std::string& jobId, int* progressEvents = nullptr) {
+    auto deadline = std::chrono::steady_clock::now() + kJobTimeout;
+    while (true) {
+        assert(std::chrono::steady_clock::now() < deadline);
+        platform::mockRunMainThreadTasks();
+        for (const auto& raw : platform::mockTakePostedMessages(webView.getNativeHandle())) {
+            nlohmann::json msg = nlohmann::json::parse(raw);
+            assert(msg["type"] == "crossdev:event");
+            if (msg["payload"]["jobId"] != jobId) continue;
+            if (msg["name"] == "job:progress" && progressEvents) ++*progressEvents;
+            if (msg["name"] == "job:done") return msg["payload"];
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+// Reports one progress step from inside a job
+class ProgressHandler : public MessageHandler {
+public:
+    bool canHandle(const std::string& messageType) const override { return messageType == "step"; }
+    bool canRunAsJob(const std::string& messageType) const override { return messageType == "step"; }
+    nlohmann::json handle(const nlohmann::json& payload, const std::string& requestId) override {
+        (void)payload;
+        (void)requestId;
+        JobContext::current()->progress({{"step", 1}});
+        return {{"success", true}, {"value", 42}};
+    }
+    std::vector<std::string> getSupportedTypes() const override { return {"step"}; }
+};
+
+// Test 4: Events go to the window that started the job, not to every window; finished jobs
+// keep their status but not their result
+void test_window_events() {
+    std::cout << "Test 4: Per-window delivery...\n";
+
+    Window window(nullptr, nullptr, 0, 0, 100, 100, "Job Test");
+    WebView starter(&window, &window, 0, 0, 100, 100);
+    WebView other(&window, &window, 0, 0, 100, 100);
+    NativeEventBus::getInstance().subscribe(&starter);
+    NativeEventBus::getInstance().subscribe(&other);
+    platform::mockTakePostedMessages(starter.getNativeHandle());
+    platform::mockTakePostedMessages(other.getNativeHandle());
+
+    JobManager manager(1);
+    std::shared_ptr<MessageHandler> step = std::make_shared<ProgressHandler>();
+    auto handler = createJobHandler(&starter, [&](const std::string& type) -> std::shared_ptr<MessageHandler> {
+        return type == "step" ? step : nullptr;
+    }, manager);
+    nlohmann::json r = handler->handle({{"_type", "startJob"}, {"type", "step"}}, "1");
+    assert(r["success"] == true);
+    int progressEvents = 0;
+    nlohmann::json done = waitWindowDone(starter, r["jobId"], &progressEvents);
+    assert(progressEvents == 1 && done["state"] == "done" && done["kind"] == "step" && done["result"]["value"] == 42);
+    platform::mockRunMainThreadTasks();
+    assert(platform::mockTakePostedMessages(other.getNativeHandle()).empty());
+
+    nlohmann::json status;
+    bool found = manager.status(r["jobId"], status);
+    assert(found && status["state"] == "done" && status["progress"]["step"] == 1);
+    assert(!status.contains("result"));
+
+    // Another window neither sees nor cancels the job
+    auto otherHandler = createJobHandler(&other, [&](const std::string& type) -> std::shared_ptr<MessageHandler> {
+        return type == "step" ? step : nullptr;
+    }, manager);
+    nlohmann::json seen = otherHandler->handle({{"_type", "jobStatus"}, {"jobId", r["jobId"]}}, "3");
+    assert(seen["success"] == false);
+    seen = otherHandler->handle({{"_type", "jobStatus"}}, "4");
+    assert(seen["jobs"].empty());
+    seen = otherHandler->handle({{"_type", "cancelJob"}, {"jobId", r["jobId"]}}, "5");
+    assert(seen["success"] == true && seen["found"] == false);
+    seen = handler->handle({{"_type", "jobStatus"}}, "6");
+    assert(seen["jobs"].size() == 1 && manager.list().size() == 1);
+
+    // A handler that went away (its window closed) drops the events of jobs it started
+    r = handler->handle({{"_type", "startJob"}, {"type", "step"}}, "2");
+    std::string orphan = r["jobId"];
+    handler.reset();
+    while (stateOf(manager, orphan) != "done") {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    platform::mockRunMainThreadTasks();
+    assert(platform::mockTakePostedMessages(starter.getNativeHandle()).empty());
+
+    NativeEventBus::getInstance().unsubscribe(&starter);
+    NativeEventBus::getInstance().unsubscribe(&other);
+
+    std::cout << "✓ Test 4 passed\n\n";
+}
+
+// Test 5: startJob / jobStatus / cancelJob, running a real handler that opts in
+void test_job_handler(const fs::path& dir) {
+    std::cout << "Test 5: JobHandler...\n";
+
+    Window window(nullptr, nullptr, 0, 0, 100, 100, "Job Test");
+    WebView webView(&window, &window, 0, 0, 100, 100);
+    JobManager manager(2);
+    std::shared_ptr<MessageHandler> batch = createBatchFileHandler();
+    auto handler = createJobHandler(&webView, [&](const std::string& type) -> std::shared_ptr<MessageHandler> {
+        if (batch->canHandle(type)) return batch;
+        if (type == "startJob") return createJobHandler(&webView, nullptr, manager);
+        return nullptr;
+    }, manager);
+    assert(handler->canHandle("startJob") && handler->canHandle("jobStatus") && handler->canHandle("cancelJob"));
+    assert(!handler->canRunAsJob("startJob") && batch->canRunAsJob("readFiles") && !batch->canRunAsJob("readFile"));
+
+    writeFile(dir / "a.txt", "alpha");
+    nlohmann::json r = handler->handle({{"_type", "startJob"}, {"type", "readFiles"}, {"priority", "high"},
+                                        {"payload", {{"paths", {"a.txt", "missing.txt"}}}}}, "1");
+    assert(r["success"] == true && r["jobId"].is_string());
+    nlohmann::json done = waitWindowDone(webView, r["jobId"]);
+    assert(done["state"] == "done" && done["kind"] == "readFiles");
+    assert(done["result"]["success"] == true && done["result"]["results"].size() == 2);
+
+    r = handler->handle({{"_type", "jobStatus"}, {"jobId", r["jobId"]}}, "2");
+    assert(r["success"] == true && r["job"]["state"] == "done" && r["job"]["priority"] == "high");
+    r = handler->handle({{"_type", "jobStatus"}}, "3");
+    assert(r["success"] == true && r["jobs"].size() == 1);
+    r = handler->handle({{"_type", "jobStatus"}, {"jobId", "job-999"}}, "4");
+    assert(r["success"] == false);
+
+    // The handler's own validation fails the job, not the request
+    r = handler->handle({{"_type", "startJob"}, {"type", "statMany"}}, "5");
+    done = waitWindowDone(webView, r["jobId"]);
+    assert(done["state"] == "failed" && done["error"].get<std::string>().find("paths") != std::string::npos);
+
+    r = handler->handle({{"_type", "startJob"}, {"type", "startJob"}}, "6");
+    assert(r["success"] == false && r["error"] == "Message type cannot run as a job: startJob");
+    r = handler->handle({{"_type", "startJob"}, {"type", "nope"}}, "7");
+    assert(r["success"] == false && r["error"] == "Unknown message type: nope");
+    r = handler->handle({{"_type", "startJob"}, {"type", "readFiles"}, {"priority", "urgent"}}, "8");
+    assert(r["success"] == false);
+    r = handler->handle({{"_type", "startJob"}, {"type", "readFiles"}, {"payload", "a.txt"}}, "9");
+    assert(r["success"] == false);
+    r = handler->handle({{"_type", "startJob"}}, "10");
+    assert(r["success"] == false);
+
+    r = handler->handle({{"_type", "cancelJob"}, {"jobId", "job-999"}}, "11");
+    assert(r["success"] == true && r["found"] == false);
+    r = handler->handle({{"_type", "cancelJob"}}, "12");
+    assert(r["success"] == false);
+
+    std::cout << "✓ Test 5 passed\n\n";
+}
+
+// Test 6: Posted tasks run beside the workers, never holding one from the jobs, and stay out
+// of the job list and its events; shutdown() joins the running ones (their owner cancels
+// them) and later posts are dropped
+void test_post() {
+    std::cout << "Test 6: Posted tasks...\n";
+
+    Events events;
+    JobManager manager(1);
+    manager.setEventSink(events.sink());
+
+    Gate gate;
+    std::atomic<int> ran{0};
+    for (int i = 0; i < 3; ++i) {
+        manager.post([&]() { gate.wait(); ++ran; });
+    }
+    gate.waitForWaiting(3);
+    std::string job = manager.start("beside", JobManager::Priority::Low, [](JobContext&) { return nullptr; });
+    events.waitDone(job);  // with every posted task still blocked
+    std::string state = stateOf(manager, job);
+    assert(state == "done" && manager.list().size() == 1 && ran == 0);
+    gate.release();
+    {
+        std::lock_guard<std::mutex> lock(events.mutex);
+        assert(events.all.size() == 1);
+    }
+
+    std::atomic<bool> started{false};
+    std::atomic<bool> cancelled{false};
+    manager.post([&]() {
+        started = true;
+        while (!cancelled) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        ++ran;
+    });
+    while (!started) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    std::thread owner([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        cancelled = true;
+    });
+    manager.shutdown();
+    owner.join();
+    assert(ran == 4);
+    manager.post([&]() { ran += 100; });
+    assert(ran == 4);
+
+    std::cout << "✓ Test 6 passed\n\n";
+}
+
+// Test 7: More posted tasks than the limit wait for a posted thread instead of each getting
+// one of their own; stalled ones never hold up the jobs
+void test_post_limit() {
+    std::cout << "Test 7: Posted thread limit...\n";
+
+    Events events;
+    JobManager manager(1, 2);
+    manager.setEventSink(events.sink());
+    assert(manager.postedThreadLimit() == 2);
+
+    Gate gate;
+    std::mutex mutex;
+    std::vector<int> order;
+    std::set<std::thread::id> threads;
+    for (int i = 0; i < 6; ++i) {
+        manager.post([&, i]() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                threads.insert(std::this_thread::get_id());
+            }
+            if (i < 2) gate.wait();
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(i);
+        });
+    }
+    gate.waitForWaiting(2);
+    std::string job = manager.start("beside", JobManager::Priority::Normal, [](JobContext&) { return nullptr; });
+    events.waitDone(job);  // both posted threads stalled, the worker still free
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        assert(order.empty() && threads.size() == 2);
+    }
+
+    gate.release();
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (order.size() == 6) break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    // The queued four ran once the stalled pair let go, on the same two threads
+    assert(threads.size() == 2);
+
+    std::cout << "✓ Test 7 passed\n\n";
+}
+
+// A handler job as HandlerJobs wants it
+struct OperationJob {
+    std::string id;
+    std::atomic<bool> cancelled{false};
+};
+
+// Test 8: Handler jobs (HandlerJobs) show up in jobStatus under their own ids and kind, for
+// their window only, and cancelJob sets their cancel flag
+void test_handler_jobs() {
+    std::cout << "Test 8: Handler jobs through jobStatus / cancelJob...\n";
+
+    Window window(nullptr, nullptr, 0, 0, 100, 100, "Job Test");
+    WebView mine(&window, &window, 0, 0, 100, 100);
+    WebView other(&window, &window, 0, 0, 100, 100);
+    JobManager manager(1);
+    auto lookup = [](const std::string&) -> std::shared_ptr<MessageHandler> { return nullptr; };
+    auto handler = createJobHandler(&mine, lookup, manager);
+    auto otherHandler = createJobHandler(&other, lookup, manager);
+
+    auto copies = std::make_shared<HandlerJobs<OperationJob>>(&mine, "copy", manager);
+    auto copy = std::make_shared<OperationJob>();
+    auto failing = std::make_shared<OperationJob>();
+    auto done = std::make_shared<OperationJob>();
+    copies->add(copy);
+    copies->add(failing);
+    copies->add(done);
+    assert(copy->id == "copy-1");
+
+    nlohmann::json r = handler->handle({{"_type", "jobStatus"}, {"jobId", "copy-1"}}, "1");
+    assert(r["success"] == true && r["job"]["kind"] == "copy" && r["job"]["state"] == "running");
+    r = handler->handle({{"_type", "jobStatus"}}, "2");
+    assert(r["jobs"].size() == 3 && r["jobs"][0]["jobId"] == "copy-1");
+    r = otherHandler->handle({{"_type", "jobStatus"}}, "3");
+    assert(r["jobs"].empty());
+    r = otherHandler->handle({{"_type", "cancelJob"}, {"jobId", "copy-1"}}, "4");
+    assert(r["found"] == false && !copy->cancelled);
+
+    r = handler->handle({{"_type", "cancelJob"}, {"jobId", "copy-1"}}, "5");
+    assert(r["success"] == true && r["found"] == true && copy->cancelled);
+    copies->finish(*copy, "copy:done", {{"jobId", copy->id}, {"cancelled", true}});
+    copies->finish(*failing, "copy:done", {{"jobId", failing->id}, {"error", "Disk full"}});
+    copies->finish(*done, "copy:done", {{"jobId", done->id}});
+    assert(stateOf(manager, "copy-1") == "cancelled" && stateOf(manager, "copy-3") == "done");
+    r = handler->handle({{"_type", "jobStatus"}, {"jobId", "copy-2"}}, "6");
+    assert(r["job"]["state"] == "failed" && r["job"]["error"] == "Disk full");
+    r = handler->handle({{"_type", "cancelJob"}, {"jobId", "copy-3"}}, "7");
+    assert(r["found"] == false);
+
+    assert(manager.list().size() == 3);  // finished ones keep their status
+    copies->close();
+
+    std::cout << "✓ Test 8 passed\n\n";
+}
+
+int main() {
+    std::cout << "Running JobManager tests...\n\n";
+
+    fs::path dir = enterTempDir("crossdev_job_manager_test");
+
+    test_priorities();
+    test_outcomes();
+    test_cancel();
+    test_window_events();
+    test_job_handler(dir);
+    test_post();
+    test_post_limit();
+    test_handler_jobs();
+
+    fs::current_path(fs::temp_directory_path());
+    fs::remove_all(dir);
+
+    std::cout << "All JobManager tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,138 @@
+#include "../include/message_router.h"
+#include "../include/window.h"
+#include "../include/webview.h"
+#include <nlohmann/json.hpp>
+#include <iostream>
+#include <stdexcept>
+#include <cassert>
+
+namespace platform {
+std::vector<std::string> mockTakePostedMessages(void* webViewHandle);
+}
+
+// Test handler that counts instances and calls
+class CountingHandler : public MessageHandler {
+public:
+    CountingHandler() { ++instances; }
+
+    bool canHandle(const std::string& messageType) const override {
+        return messageType == "ping" || messageType == "pong";
+    }
+
+    nlohmann::json handle(const nlohmann::json& payload, const std::string& requestId) override {
+        (void)payload;
+        (void)requestId;
+        ++calls;
+        return {{"success", true}};
+    }
+
+    std::vector<std::string> getSupportedTypes() const override {
+        return {"ping", "pong"};
+    }
+
+    static int instances;
+    static int calls;
+};
+
+int CountingHandler::instances = 0;
+int CountingHandler::calls = 0;
+
+static std::string message(const std::string& type) {
+    return "{\"type\":\"" + type + "\",\"payload\":{},\"requestId\":\"1\"}";
+}
+
+// Test 1: Lazy handler is built on first message and shared by all its types
+void test_lazy_instantiation() {
+    std::cout << "Test 1: Lazy instantiation...\n";
+
+    Window window(nullptr, nullptr, 0, 0, 100, 100, "Router Test");
+    WebView webView(&window, &window, 0, 0, 100, 100);
+    MessageRouter router(&webView);
+
+    CountingHandler::instances = 0;
+    CountingHandler::calls = 0;
+    router.registerHandlerFactory({"ping", "pong"}, []() { return std::make_shared<CountingHandler>(); });
+    assert(CountingHandler::instances == 0);
+
+    router.routeMessage(message("ping"));
+    assert(CountingHandler::instances == 1);
+    assert(CountingHandler::calls == 1);
+
+    router.routeMessage(message("pong"));
+    router.routeMessage(message("ping"));
+    assert(CountingHandler::instances == 1);
+    assert(CountingHandler::calls == 3);
+
+    std::cout << "✓ Test 1 passed\n\n";
+}
+
+// Test 2: Unused factories are never built; later eager registration wins
+void test_override() {
+    std::cout << "Test 2: Override...\n";
+
+    Window window(nullptr, nullptr, 0, 0, 100, 100, "Router Test");
+    WebView webView(&window, &window, 0, 0, 100, 100);
+    MessageRouter router(&webView);
+
+    CountingHandler::instances = 0;
+    CountingHandler::calls = 0;
+    bool factoryCalled = false;
+    router.registerHandlerFactory({"ping"}, [&factoryCalled]() {
+        factoryCalled = true;
+        return std::make_shared<CountingHandler>();
+    });
+    router.registerHandler(std::make_shared<CountingHandler>());
+    router.routeMessage(message("ping"));
+    router.routeMessage(message("unknown"));
+    assert(!factoryCalled);
+    assert(CountingHandler::instances == 1);
+    assert(CountingHandler::calls == 1);
+
+    std::cout << "✓ Test 2 passed\n\n";
+}
+
+// Test 3: A factory that fails is not retried; its types answer with the failure
+void test_failed_factory() {
+    std::cout << "Test 3: Failed factory...\n";
+
+    Window window(nullptr, nullptr, 0, 0, 100, 100, "Router Test");
+    WebView webView(&window, &window, 0, 0, 100, 100);
+    MessageRouter router(&webView);
+    platform::mockTakePostedMessages(webView.getNativeHandle());
+
+    int attempts = 0;
+    router.registerHandlerFactory({"ping", "pong"}, [&attempts]() -> std::shared_ptr<MessageHandler> {
+        ++attempts;
+        throw std::runtime_error("cannot load libping.so");
+    });
+    router.routeMessage(message("ping"));
+    router.routeMessage(message("ping"));
+    router.routeMessage(message("pong"));
+    assert(attempts == 1);
+    auto posted = platform::mockTakePostedMessages(webView.getNativeHandle());
+    assert(posted.size() == 3);
+    for (const auto& raw : posted) {
+        nlohmann::json response = nlohmann::json::parse(raw);
+        assert(response["error"].get<std::string>().find("cannot load libping.so") != std::string::npos);
+    }
+    assert(!router.findHandler("pong"));
+
+    // Registering the type again clears the failure
+    CountingHandler::calls = 0;
+    router.registerHandlerFactory({"ping"}, []() { return std::make_shared<CountingHandler>(); });
+    router.routeMessage(message("ping"));
+    assert(CountingHandler::calls == 1 && attempts == 1);
+
+    std::cout << "✓ Test 3 passed\n\n";
+}
+
+int main() {
+    std::cout << "=== MessageRouter Tests ===\n\n";
+
+    test_lazy_instantiation();
+    test_override();
+    test_failed_factory();
+
+    std::cout << "=== All tests passed! ===\n";
+    return 0;
+}
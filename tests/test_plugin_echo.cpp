@@ -0,0 +1,40 @@
+// Minimal ABI v2 plugin used by test_plugin_host: echoes the request, fails on "fail".
+#include "../include/crossdev_plugin_abi.h"
+#include <cstdlib>
+#include <cstring>
+
+static const char* const kTypes[] = {"echo", "fail", nullptr};
+
+static char* copyBuffer(const char* data, size_t len) {
+    char* out = static_cast<char*>(std::malloc(len ? len : 1));
+    if (out && len) std::memcpy(out, data, len);
+    return out;
+}
+
+static int echoHandle(const char* type, const char* request, size_t requestLen,
+                      char** response, size_t* responseLen) {
+    if (std::strcmp(type, "fail") == 0) {
+        static const char msg[] = "echo plugin: requested failure";
+        *response = copyBuffer(msg, sizeof(msg) - 1);
+        *responseLen = sizeof(msg) - 1;
+        return 1;
+    }
+    *response = copyBuffer(request, requestLen);
+    *responseLen = requestLen;
+    return 0;
+}
+
+static void echoFree(char* buffer) {
+    std::free(buffer);
+}
+
+extern "C"
+#if defined(_WIN32)
+__declspec(dllexport)
+#else
+__attribute__((visibility("default")))
+#endif
+const CrossDevPluginApi* crossdevPluginGetApi(void) {
+    static const CrossDevPluginApi api = {CROSSDEV_PLUGIN_ABI_VERSION, "echo", kTypes, echoHandle, echoFree};
+    return &api;
+}
@@ -0,0 +1,143 @@
+#include "../include/plugin_host.h"
+#include "../include/message_router.h"
+#include "../include/window.h"
+#include "../include/webview.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <cassert>
+
+// Path of the echo plugin library (argv[1], passed by CTest)
+static std::string g_echoLibrary;
+
+static std::filesystem::path tempDir(const std::string& name) {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    return dir;
+}
+
+static void writeFile(const std::filesystem::path& path, const std::string& content) {
+    std::ofstream out(path);
+    out << content;
+}
+
+// Test 1: Manifests are validated and library paths resolved against the manifest directory
+void test_parse_manifest() {
+    std::cout << "Test 1: Parse manifest...\n";
+
+    auto dir = tempDir("crossdev_plugin_test1");
+    writeFile(dir / "good.json", R"({"abi": 2, "name": "good", "library": "libgood.so", "messageTypes": ["a", "b"],
+                                     "jobTypes": ["b", "c"]})");
+    writeFile(dir / "old.json", R"({"abi": 1, "library": "libold.so", "messageTypes": ["a"]})");
+    writeFile(dir / "empty.json", R"({"abi": 2, "library": "libempty.so", "messageTypes": []})");
+    writeFile(dir / "broken.json", "{ not json");
+    std::filesystem::create_directories(dir / "mistyped");
+    writeFile(dir / "mistyped" / "abi_string.json", R"({"abi": "2", "library": "liba.so", "messageTypes": ["a"]})");
+    writeFile(dir / "mistyped" / "name_number.json", R"({"abi": 2, "name": 42, "library": "libn.so", "messageTypes": ["a"]})");
+
+    PluginHost::Manifest m;
+    std::string error;
+    bool parsed = PluginHost::parseManifest((dir / "good.json").string(), m, error);
+    assert(parsed);
+    assert(m.name == "good");
+    assert(m.libraryPath == (dir / "libgood.so").lexically_normal().string());
+    assert(m.messageTypes.size() == 2);
+    assert(m.jobTypes == std::vector<std::string>{"b"});  // only declared message types
+
+    parsed = PluginHost::parseManifest((dir / "old.json").string(), m, error);
+    assert(!parsed);
+    parsed = PluginHost::parseManifest((dir / "empty.json").string(), m, error);
+    assert(!parsed);
+    parsed = PluginHost::parseManifest((dir / "broken.json").string(), m, error);
+    assert(!parsed);
+    assert(!error.empty());
+
+    // Wrong-typed fields are refused, not thrown (scanDirectory runs them all at startup)
+    error.clear();
+    parsed = PluginHost::parseManifest((dir / "mistyped" / "abi_string.json").string(), m, error);
+    assert(!parsed && error.find("unsupported plugin ABI") != std::string::npos);
+    error.clear();
+    parsed = PluginHost::parseManifest((dir / "mistyped" / "name_number.json").string(), m, error);
+    assert(!parsed && error.find("\"name\"") != std::string::npos);
+    size_t found = PluginHost::getInstance().scanDirectory((dir / "mistyped").string());
+    assert(found == 0);
+
+    std::filesystem::remove_all(dir);
+    std::cout << "✓ Test 1 passed\n\n";
+}
+
+// Test 2: Scanning reads manifests only; the library is loaded by the first message
+void test_lazy_load_and_call() {
+    std::cout << "Test 2: Lazy load and call...\n";
+
+    auto dir = tempDir("crossdev_plugin_test2");
+    nlohmann::json manifest = {{"abi", 2}, {"name", "echo"}, {"library", g_echoLibrary},
+                               {"messageTypes", {"echo", "fail"}}};
+    writeFile(dir / "echo.json", manifest.dump());
+
+    PluginHost& host = PluginHost::getInstance();
+    size_t found = host.scanDirectory(dir.string());
+    assert(found == 1);
+    found = host.scanDirectory((dir / "missing").string());
+    assert(found == 0);
+
+    Window window(nullptr, nullptr, 0, 0, 100, 100, "Plugin Test");
+    WebView webView(&window, &window, 0, 0, 100, 100);
+    MessageRouter router(&webView);
+    host.registerHandlers(&router);
+
+    // Routing goes through the C ABI (mock platform swallows the responses)
+    router.routeMessage(R"({"type":"echo","payload":{"x":1},"requestId":"1"})");
+    router.routeMessage(R"({"type":"fail","payload":{},"requestId":"2"})");
+
+    // The library is cached: a direct load returns the same API
+    std::string error;
+    const CrossDevPluginApi* api = host.load(host.getManifests().back(), error);
+    assert(api && api->abiVersion == CROSSDEV_PLUGIN_ABI_VERSION);
+    const CrossDevPluginApi* again = host.load(host.getManifests().back(), error);
+    assert(again == api);
+
+    char* response = nullptr;
+    size_t responseLen = 0;
+    std::string request = R"({"x":1})";
+    int status = api->handle("echo", request.data(), request.size(), &response, &responseLen);
+    assert(status == 0);
+    assert(std::string(response, responseLen) == request);
+    api->freeBuffer(response);
+
+    std::filesystem::remove_all(dir);
+    std::cout << "✓ Test 2 passed\n\n";
+}
+
+// Test 3: A missing library is reported, not fatal
+void test_missing_library() {
+    std::cout << "Test 3: Missing library...\n";
+
+    PluginHost::Manifest m;
+    m.name = "missing";
+    m.libraryPath = "/nonexistent/libmissing.so";
+    m.messageTypes = {"missing"};
+    std::string error;
+    const CrossDevPluginApi* api = PluginHost::getInstance().load(m, error);
+    assert(api == nullptr);
+    assert(!error.empty());
+
+    std::cout << "✓ Test 3 passed\n\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "=== PluginHost Tests ===\n\n";
+    if (argc < 2) {
+        std::cerr << "usage: test_plugin_host <echo plugin library>\n";
+        return 1;
+    }
+    g_echoLibrary = std::filesystem::absolute(argv[1]).string();
+
+    test_parse_manifest();
+    test_lazy_load_and_call();
+    test_missing_library();
+
+    std::cout << "=== All tests passed! ===\n";
+    return 0;
+}
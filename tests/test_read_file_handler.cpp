@@ -0,0 +1,193 @@
+#include "../include/handlers/read_file_handler.h"
+#include "../include/base64.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <cassert>
+#include <cstring>
+#include <thread>
+
+static std::filesystem::path tempDir(const std::string& name) {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    return dir;
+}
+
+// Deterministic content so any window can be checked without keeping the file in memory
+static unsigned char byteAt(uint64_t i) {
+    return static_cast<unsigned char>((i * 131 + (i >> 8)) & 0xFF);
+}
+
+static std::string writePattern(const std::filesystem::path& path, size_t size) {
+    std::ofstream out(path, std::ios::binary);
+    for (size_t i = 0; i < size; ++i) {
+        out.put(static_cast<char>(byteAt(i)));
+    }
+    return path.string();
+}
+
+static std::string expectedBase64(uint64_t offset, size_t length) {
+    std::vector<unsigned char> bytes(length);
+    for (size_t i = 0; i < length; ++i) bytes[i] = byteAt(offset + i);
+    return base64::encode(bytes);
+}
+
+static nlohmann::json readFile(const nlohmann::json& payload) {
+    static auto handler = createReadFileHandler();
+    return handler->handle(payload, "1");
+}
+
+// Test 1: Whole-file reads keep the original response shape
+void test_whole_file() {
+    std::cout << "Test 1: Whole file...\n";
+
+    auto dir = tempDir("crossdev_read_file_test1");
+    std::string small = writePattern(dir / "small.bin", 1000);
+    nlohmann::json r = readFile({{"path", small}});
+    assert(r["success"] == true);
+    assert(r["size"] == 1000 && r["totalSize"] == 1000 && r["offset"] == 0 && r["eof"] == true);
+    assert(r["data"] == expectedBase64(0, 1000));
+
+    std::string empty = writePattern(dir / "empty.bin", 0);
+    r = readFile({{"path", empty}});
+    assert(r["success"] == true && r["size"] == 0 && r["data"] == "" && r["eof"] == true);
+
+    r = readFile({{"path", (dir / "missing.bin").string()}});
+    assert(r["success"] == false);
+    r = readFile({{"path", dir.string()}});
+    assert(r["success"] == false);
+
+    std::cout << "✓ Test 1 passed\n\n";
+}
+
+// Test 2: offset/length windows, clamped at EOF
+void test_ranges() {
+    std::cout << "Test 2: Ranges...\n";
+
+    auto dir = tempDir("crossdev_read_file_test2");
+    const size_t size = 3 * 1024 * 1024 + 77;
+    std::string path = writePattern(dir / "large.bin", size);
+
+    nlohmann::json r = readFile({{"path", path}, {"offset", 12345}, {"length", 100}});
+    assert(r["success"] == true && r["size"] == 100 && r["offset"] == 12345 && r["eof"] == false);
+    assert(r["data"] == expectedBase64(12345, 100));
+
+    // Unaligned offset into a mapped range
+    r = readFile({{"path", path}, {"offset", 4097}, {"length", 1024 * 1024}});
+    assert(r["success"] == true && r["size"] == 1024 * 1024);
+    assert(r["data"] == expectedBase64(4097, 1024 * 1024));
+
+    r = readFile({{"path", path}, {"offset", size - 10}, {"length", 1000}});
+    assert(r["success"] == true && r["size"] == 10 && r["eof"] == true);
+    assert(r["data"] == expectedBase64(size - 10, 10));
+
+    r = readFile({{"path", path}, {"offset", size}});
+    assert(r["success"] == true && r["size"] == 0 && r["eof"] == true);
+
+    r = readFile({{"path", path}, {"offset", size + 1}});
+    assert(r["success"] == false);
+    r = readFile({{"path", path}, {"offset", -1}});
+    assert(r["success"] == false);
+    r = readFile({{"path", path}, {"length", "10"}});
+    assert(r["success"] == false);
+
+    std::cout << "✓ Test 2 passed\n\n";
+}
+
+// Test 3: Chunked mode walks the file in fixed windows that reassemble to the original
+void test_chunks() {
+    std::cout << "Test 3: Chunks...\n";
+
+    auto dir = tempDir("crossdev_read_file_test3");
+    const size_t size = 1024 * 1024 + 5;
+    std::string path = writePattern(dir / "chunks.bin", size);
+
+    const uint64_t chunkSize = 300 * 1024;
+    std::vector<unsigned char> assembled;
+    for (uint64_t index = 0;; ++index) {
+        nlohmann::json r = readFile({{"path", path}, {"chunkSize", chunkSize}, {"chunkIndex", index}});
+        assert(r["success"] == true);
+        assert(r["chunkIndex"] == index && r["chunkCount"] == 4 && r["offset"] == index * chunkSize);
+        std::string data = r["data"].get<std::string>();
+        assert(data == expectedBase64(index * chunkSize, r["size"].get<size_t>()));
+        assembled.resize(assembled.size() + r["size"].get<size_t>());
+        if (r["eof"] == true) break;
+    }
+    assert(assembled.size() == size);
+
+    nlohmann::json past = readFile({{"path", path}, {"chunkSize", chunkSize}, {"chunkIndex", 99}});
+    assert(past["success"] == true && past["size"] == 0 && past["eof"] == true);
+    nlohmann::json r = readFile({{"path", path}, {"chunkSize", 0}});
+    assert(r["success"] == false);
+
+    std::cout << "✓ Test 3 passed\n\n";
+}
+
+// Test 4: Ranges above the memory cap are refused with rangeRequired instead of allocated
+void test_memory_cap() {
+    std::cout << "Test 4: Memory cap...\n";
+
+    auto dir = tempDir("crossdev_read_file_test4");
+    std::string path = writePattern(dir / "capped.bin", 2 * 1024 * 1024);
+
+    nlohmann::json r = readFile({{"path", path}, {"maxBytes", 1024 * 1024}});
+    assert(r["success"] == false && r["rangeRequired"] == true && r["totalSize"] == 2 * 1024 * 1024);
+
+    r = readFile({{"path", path}, {"maxBytes", 1024 * 1024}, {"offset", 1024 * 1024}});
+    assert(r["success"] == true && r["size"] == 1024 * 1024);
+
+    r = readFile({{"path", path}, {"maxBytes", 1024 * 1024}, {"chunkSize", 2 * 1024 * 1024}});
+    assert(r["success"] == false && r["rangeRequired"] == true);
+
+    // A sparse file larger than the default cap is never read in one piece
+    std::filesystem::path sparse = dir / "sparse.bin";
+    { std::ofstream out(sparse, std::ios::binary); }
+    std::filesystem::resize_file(sparse, 100ull * 1024 * 1024);
+    r = readFile({{"path", sparse.string()}});
+    assert(r["success"] == false && r["rangeRequired"] == true);
+    r = readFile({{"path", sparse.string()}, {"offset", 50 * 1024 * 1024}, {"length", 4096}});
+    assert(r["success"] == true && r["data"] == base64::encode(std::vector<unsigned char>(4096, 0)));
+
+    std::cout << "✓ Test 4 passed\n\n";
+}
+
+// Test 5: A file truncated while large ranges are read fails the read, never the process
+void test_truncated_while_reading() {
+    std::cout << "Test 5: Truncated while reading...\n";
+
+    auto dir = tempDir("crossdev_read_file_test5");
+    std::string path = (dir / "rotating.log").string();
+    const size_t size = 8 * 1024 * 1024;
+    int ok = 0, changed = 0;
+    for (int round = 0; round < 20; ++round) {
+        writePattern(path, size);
+        std::thread rotate([&]() { std::filesystem::resize_file(path, 0); });
+        nlohmann::json r = readFile({{"path", path}, {"offset", 0}, {"length", size}, {"maxBytes", size}});
+        rotate.join();
+        if (r["success"] == true) {
+            ++ok;
+            assert(r["size"] == 0 || r["data"] == expectedBase64(0, r["size"].get<size_t>()));
+        } else {
+            ++changed;
+            assert(r["error"].get<std::string>().find("changed while reading") != std::string::npos ||
+                   r["error"].get<std::string>().find("past the end") != std::string::npos);
+        }
+    }
+    std::cout << "  " << ok << " read, " << changed << " reported a change\n";
+
+    std::cout << "✓ Test 5 passed\n\n";
+}
+
+int main() {
+    std::cout << "=== ReadFile Handler Tests ===\n\n";
+
+    test_whole_file();
+    test_ranges();
+    test_chunks();
+    test_memory_cap();
+    test_truncated_while_reading();
+
+    std::cout << "=== All tests passed! ===\n";
+    return 0;
+}
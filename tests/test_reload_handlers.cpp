@@ -0,0 +1,88 @@
+#include "../include/handlers/reload_main_content_handler.h"
+#include "../include/handlers/reload_main_window_handler.h"
+#include "../include/webview_window.h"
+#include "../include/config_manager.h"
+#include "../include/asset_bundle.h"
+#include <nlohmann/json.hpp>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <cstdlib>
+#include <cassert>
+
+namespace platform {
+// tests/mock_platform.cpp
+std::string mockLastLoad(void* webViewHandle);
+}
+
+namespace fs = std::filesystem;
+
+// options.json with the given htmlLoading section, then each reload handler in turn
+static void reloadWith(const nlohmann::json& htmlLoading, WebViewWindow& main, std::string loads[2]) {
+    fs::create_directories(ConfigManager::getConfigDirectory());
+    std::ofstream(ConfigManager::getOptionsFilePath()) << nlohmann::json{{"htmlLoading", htmlLoading}}.dump();
+    void* handle = main.getWebView()->getNativeHandle();
+
+    nlohmann::json r = createReloadMainContentHandler(&main)->handle({{"_type", "reloadMainContent"}}, "1");
+    assert(r["success"] == true);
+    loads[0] = platform::mockLastLoad(handle);
+
+    r = createReloadMainWindowHandler(&main)->handle({{"_type", "reloadMainWindow"}}, "2");
+    assert(r["success"] == true);
+    loads[1] = platform::mockLastLoad(handle);
+}
+
+// Test 1: "app" reloads the bundled entry over the app scheme
+void test_reload_app(WebViewWindow& main) {
+    std::cout << "Test 1: Reload with method \"app\"...\n";
+
+    std::string loads[2];
+    reloadWith({{"method", "app"}}, main, loads);
+    assert(loads[0] == "url:" + asset_bundle::url("index.html"));
+    assert(loads[1] == "url:" + asset_bundle::url("index.html"));
+    assert(loads[0] == "url:crossdev://app/index.html");
+
+    reloadWith({{"method", "app"}, {"appEntry", "js/app.js"}}, main, loads);
+    assert(loads[0] == "url:crossdev://app/js/app.js" && loads[1] == loads[0]);
+
+    // An entry missing from the bundle says so instead of falling back to demo.html
+    reloadWith({{"method", "app"}, {"appEntry", "missing.html"}}, main, loads);
+    for (const std::string& load : loads) {
+        assert(load.find("html:") == 0 && load.find("missing.html is not bundled") != std::string::npos);
+    }
+
+    std::cout << "✓ Test 1 passed\n\n";
+}
+
+// Test 2: The other methods still load what they did
+void test_reload_other_methods(WebViewWindow& main) {
+    std::cout << "Test 2: Reload with html / url...\n";
+
+    std::string loads[2];
+    reloadWith({{"method", "url"}, {"url", "https://example.com/"}}, main, loads);
+    assert(loads[0] == "url:https://example.com/" && loads[1] == loads[0]);
+
+    reloadWith({{"method", "html"}, {"htmlContent", "<p>hi</p>"}}, main, loads);
+    assert(loads[0] == "html:<p>hi</p>" && loads[1] == loads[0]);
+
+    std::cout << "✓ Test 2 passed\n\n";
+}
+
+int main() {
+    std::cout << "Running reload handler tests...\n\n";
+
+    // Options live under $HOME; point it at a scratch directory
+    fs::path home = fs::temp_directory_path() / "crossdev_reload_test";
+    fs::remove_all(home);
+    fs::create_directories(home);
+    setenv("HOME", home.c_str(), 1);
+
+    WebViewWindow main(nullptr, 0, 0, 800, 600, "Main", WebViewContentType::Html, "<html></html>");
+    test_reload_app(main);
+    test_reload_other_methods(main);
+
+    fs::remove_all(home);
+
+    std::cout << "All reload handler tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include "../include/shared_state_store.h"
+#include "../include/window.h"
+#include "../include/webview.h"
+#include <iostream>
+#include <cassert>
+
+// Test 1: Versions start at 0 and only bump on real changes
+void test_versions() {
+    std::cout << "Test 1: Versions...\n";
+
+    SharedStateStore& store = SharedStateStore::getInstance();
+    assert(store.get("t1").version == 0);
+    assert(store.get("t1").value.is_null());
+
+    uint64_t version = store.set("t1", {{"a", 1}});
+    assert(version == 1);
+    version = store.set("t1", {{"a", 1}});
+    assert(version == 1);  // Unchanged: no bump
+    version = store.set("t1", {{"a", 2}});
+    assert(version == 2);
+    assert(store.get("t1").value["a"] == 2);
+
+    std::cout << "✓ Test 1 passed\n\n";
+}
+
+// Test 2: Deltas since a known version are JSON patches that reproduce the current value
+void test_deltas() {
+    std::cout << "Test 2: Deltas...\n";
+
+    SharedStateStore& store = SharedStateStore::getInstance();
+    nlohmann::json v1 = {{"theme", "light"}, {"items", {1, 2}}};
+    nlohmann::json v2 = {{"theme", "dark"}, {"items", {1, 2}}};
+    nlohmann::json v3 = {{"theme", "dark"}, {"items", {1, 2, 3}}, {"zoom", 1.5}};
+    store.set("t2", v1);
+    store.set("t2", v2);
+    store.set("t2", v3);
+
+    SharedStateStore::Delta d = store.getDelta("t2", 1);
+    assert(d.isPatch);
+    assert(d.fromVersion == 1 && d.version == 3);
+    assert(v1.patch(d.patch) == v3);
+
+    d = store.getDelta("t2", 3);
+    assert(d.isPatch && d.patch.empty());
+
+    // Unknown version: full value
+    d = store.getDelta("t2", 0);
+    assert(!d.isPatch && d.value == v3);
+
+    std::cout << "✓ Test 2 passed\n\n";
+}
+
+// Test 3: History is bounded; readers too far behind get the full value
+void test_history_limit() {
+    std::cout << "Test 3: History limit...\n";
+
+    SharedStateStore& store = SharedStateStore::getInstance();
+    for (int i = 0; i < static_cast<int>(SharedStateStore::MAX_HISTORY) + 10; ++i) {
+        store.set("t3", {{"n", i}});
+    }
+    uint64_t current = store.get("t3").version;
+    assert(!store.getDelta("t3", 1).isPatch);
+    assert(store.getDelta("t3", current - 5).isPatch);
+
+    std::cout << "✓ Test 3 passed\n\n";
+}
+
+// Test 4: Subscriptions catch up from the known version and survive unsubscribeAll
+void test_subscribe() {
+    std::cout << "Test 4: Subscribe...\n";
+
+    SharedStateStore& store = SharedStateStore::getInstance();
+    Window window(nullptr, nullptr, 0, 0, 100, 100, "State Test");
+    WebView webView(&window, &window, 0, 0, 100, 100);
+
+    store.set("t4", {{"x", 1}});
+    SharedStateStore::Delta d = store.subscribe(&webView, "t4", 0);
+    assert(!d.isPatch && d.value["x"] == 1 && d.version == 1);
+
+    // Change is delivered to the subscriber (mock platform swallows the message)
+    uint64_t version = store.set("t4", {{"x", 2}});
+    assert(version == 2);
+
+    store.unsubscribeAll(&webView);
+    version = store.set("t4", {{"x", 3}});
+    assert(version == 3);
+
+    std::cout << "✓ Test 4 passed\n\n";
+}
+
+int main() {
+    std::cout << "=== SharedStateStore Tests ===\n\n";
+
+    test_versions();
+    test_deltas();
+    test_history_limit();
+    test_subscribe();
+
+    std::cout << "=== All tests passed! ===\n";
+    return 0;
+}
@@ -0,0 +1,165 @@
+#include "../include/single_instance.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <cassert>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+// Collects what a primary receives
+struct Received {
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::vector<std::vector<std::string>> batches;
+
+    SingleInstance::PathsHandler handler() {
+        return [this](const std::vector<std::string>& paths) {
+            std::lock_guard<std::mutex> lock(mutex);
+            batches.push_back(paths);
+            changed.notify_all();
+        };
+    }
+
+    bool waitFor(size_t count) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return changed.wait_for(lock, std::chrono::seconds(5), [&]() { return batches.size() >= count; });
+    }
+};
+
+// Test 1: The first launch is the primary; later ones forward their paths and return at once
+void test_forward(const fs::path& dir) {
+    std::cout << "Test 1: Primary and forwarding...\n";
+
+    std::string socket = (dir / "app.instance").u8string();
+    std::string error;
+    SingleInstance primary(socket);
+    SingleInstance::Role role = primary.acquire({}, error);
+    assert(role == SingleInstance::Role::Primary);
+    assert(fs::exists(socket));
+
+    // Before the primary has a handler: acknowledged now, delivered once one is set
+    auto start = std::chrono::steady_clock::now();
+    SingleInstance second(socket);
+    role = second.acquire({"/docs/a b.txt", "/docs/line\nbreak.txt", ""}, error);
+    assert(role == SingleInstance::Role::Forwarded);
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "  forwarded in " << ms << " ms\n";
+    assert(ms < 1000);
+
+    Received received;
+    primary.setHandler(received.handler());
+    bool arrived = received.waitFor(1);
+    assert(arrived);
+    assert((received.batches[0] == std::vector<std::string>{"/docs/a b.txt", "/docs/line\nbreak.txt", ""}));
+
+    SingleInstance third(socket);
+    role = third.acquire({"/docs/c.txt"}, error);
+    assert(role == SingleInstance::Role::Forwarded);
+    arrived = received.waitFor(2);
+    assert(arrived && received.batches[1] == std::vector<std::string>{"/docs/c.txt"});
+    SingleInstance empty(socket);
+    role = empty.acquire({}, error);
+    assert(role == SingleInstance::Role::Forwarded);
+    arrived = received.waitFor(3);
+    assert(arrived && received.batches[2].empty());
+
+    std::cout << "✓ Test 1 passed\n\n";
+}
+
+// Test 2: Leftovers of a crashed primary do not block the next launch; an exit hands over
+void test_stale_and_handover(const fs::path& dir) {
+    std::cout << "Test 2: Stale socket and handover...\n";
+
+    std::string socket = (dir / "stale.instance").u8string();
+    std::ofstream(socket) << "not a socket";
+    std::ofstream(socket + ".lock");
+    std::string error;
+    {
+        SingleInstance primary(socket);
+        SingleInstance::Role role = primary.acquire({}, error);
+        assert(role == SingleInstance::Role::Primary);
+    }
+    assert(!fs::exists(socket));
+
+    SingleInstance next(socket);
+    SingleInstance::Role role = next.acquire({}, error);
+    assert(role == SingleInstance::Role::Primary);
+    Received received;
+    next.setHandler(received.handler());
+    SingleInstance later(socket);
+    role = later.acquire({"/x"}, error);
+    assert(role == SingleInstance::Role::Forwarded);
+    bool arrived = received.waitFor(1);
+    assert(arrived);
+
+    std::cout << "✓ Test 2 passed\n\n";
+}
+
+// Test 3: A primary that holds the lock but never answers costs the launch its timeout only
+void test_unresponsive(const fs::path& dir) {
+    std::cout << "Test 3: Unresponsive primary...\n";
+
+    std::string socket = (dir / "hung.instance").u8string();
+    int lock = open((socket + ".lock").c_str(), O_RDWR | O_CREAT, 0600);
+    assert(lock >= 0);
+    int locked = flock(lock, LOCK_EX | LOCK_NB);
+    assert(locked == 0);
+
+    std::string error;
+    auto start = std::chrono::steady_clock::now();
+    SingleInstance launch(socket);
+    SingleInstance::Role role = launch.acquire({"/a"}, error, 300);
+    assert(role == SingleInstance::Role::Standalone && !error.empty());
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    assert(ms >= 250 && ms < 2000);
+    close(lock);
+
+    SingleInstance tooLong(dir.u8string() + "/" + std::string(200, 'x'));
+    role = tooLong.acquire({}, error);
+    assert(role == SingleInstance::Role::Standalone);
+
+    std::cout << "✓ Test 3 passed\n\n";
+}
+
+// Test 4: The paths a launch forwards
+void test_open_paths(const fs::path& dir) {
+    std::cout << "Test 4: openPaths...\n";
+
+    const char* argv[] = {"app", "--new-instance", "doc.txt", "../up/b.txt", "/abs/c.txt", "file:///d.txt", nullptr};
+    std::vector<std::string> paths = SingleInstance::openPaths(6, argv);
+    assert(paths.size() == 4);
+    assert(paths[0] == (dir / "doc.txt").u8string());
+    assert(paths[1] == (dir.parent_path() / "up" / "b.txt").u8string());
+    assert(paths[2] == "/abs/c.txt" && paths[3] == "file:///d.txt");
+
+    assert(SingleInstance::defaultSocketPath("App", "/cfg").find("App.instance") != std::string::npos ||
+           SingleInstance::defaultSocketPath("App", "/cfg") == "/cfg/instance.sock");
+
+    std::cout << "✓ Test 4 passed\n\n";
+}
+
+int main() {
+    std::cout << "Running SingleInstance tests...\n\n";
+
+    fs::path dir = fs::temp_directory_path() / "crossdev_single_instance_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    fs::current_path(dir);
+
+    test_forward(dir);
+    test_stale_and_handover(dir);
+    test_unresponsive(dir);
+    test_open_paths(dir);
+
+    fs::current_path(fs::temp_directory_path());
+    fs::remove_all(dir);
+
+    std::cout << "All SingleInstance tests passed!\n";
+    return 0;
+}
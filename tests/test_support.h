@@ -0,0 +1,235 @@
+#ifndef TEST_SUPPORT_H
+#define TEST_SUPPORT_H
+
+// Fixtures shared by the handler tests: temp working directories, file helpers and a
+// collector for the "<prefix>:progress" / "<prefix>:done" events a job posts to its WebView.
+
+#include "../include/message_handler.h"
+#include "../include/webview.h"
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <cassert>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#ifndef _WIN32
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace platform {
+size_t mockRunMainThreadTasks();
+std::vector<std::string> mockTakePostedMessages(void* webViewHandle);
+}
+
+// Handlers resolve paths against the working directory, so tests run inside a fresh temp dir
+inline std::filesystem::path enterTempDir(const std::string& name) {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / name;
+    std::filesystem::current_path(std::filesystem::temp_directory_path());
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    std::filesystem::current_path(dir);
+    return dir;
+}
+
+inline void writeFile(const std::filesystem::path& path, const std::string& content, bool append = false) {
+    std::ofstream out(path, std::ios::binary | (append ? std::ios::app : std::ios::trunc));
+    out << content;
+}
+
+// size bytes of 'x'
+inline void writeFile(const std::filesystem::path& path, size_t size) {
+    writeFile(path, std::string(size, 'x'));
+}
+
+inline std::string readFile(const std::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+// Incompressible bytes (xorshift32)
+inline std::string noise(size_t len, uint32_t seed = 2463534242u) {
+    std::string data(len, '\0');
+    uint32_t x = seed;
+    for (auto& c : data) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        c = static_cast<char>(x);
+    }
+    return data;
+}
+
+// What one job posted before its "<prefix>:done"
+struct JobEvents {
+    size_t progress = 0;
+    nlohmann::json lastProgress;
+    std::vector<nlohmann::json> items;  // any other "<prefix>:*" payloads, in order
+    nlohmann::json done;
+};
+
+// Longest a test waits for a job's "<prefix>:done"
+constexpr std::chrono::seconds kJobTimeout(30);
+
+// Pump main-thread tasks until "<prefix>:done" arrives for jobId; onProgress may cancel.
+// Fails the test if it has not arrived within kJobTimeout.
+inline JobEvents waitDone(WebView& webView, const std::string& prefix, const std::string& jobId,
+                          const std::function<void(const nlohmann::json&)>& onProgress = nullptr) {
+    JobEvents events;
+    auto deadline = std::chrono::steady_clock::now() + kJobTimeout;
+    while (true) {
+        assert(std::chrono::steady_clock::now() < deadline);
+        platform::mockRunMainThreadTasks();
+        for (const auto& raw : platform::mockTakePostedMessages(webView.getNativeHandle())) {
+            nlohmann::json msg = nlohmann::json::parse(raw);
+            const std::string name = msg["name"];
+            if (msg["payload"]["jobId"] != jobId || name.compare(0, prefix.size() + 1, prefix + ":") != 0) continue;
+            if (name == prefix + ":done") {
+                events.done = msg["payload"];
+                return events;
+            }
+            if (name == prefix + ":progress") {
+                ++events.progress;
+                events.lastProgress = msg["payload"];
+                if (onProgress) onProgress(msg["payload"]);
+            } else {
+                events.items.push_back(msg["payload"]);
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+// Start request's job ("_type" defaults to prefix) and wait for it to finish
+inline JobEvents run(MessageHandler& handler, WebView& webView, const std::string& prefix, nlohmann::json request) {
+    if (!request.contains("_type")) request["_type"] = prefix;
+    nlohmann::json r = handler.handle(request, "1");
+    assert(r["success"] == true);
+    return waitDone(webView, prefix, r["jobId"]);
+}
+
+#ifndef _WIN32
+// Loopback HTTP/1.1 server with keep-alive. respond(fd, head) answers one request, given its
+// request line and headers, and returns false to close the connection.
+class LoopbackServer {
+public:
+    using Respond = std::function<bool(int fd, const std::string& head)>;
+
+    std::atomic<size_t> connections{0};
+
+    explicit LoopbackServer(Respond respond) : respond_(std::move(respond)) {
+        listener_ = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        int bound = bind(listener_, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        int listening = listen(listener_, 16);
+        assert(bound == 0 && listening == 0);
+        socklen_t length = sizeof(address);
+        getsockname(listener_, reinterpret_cast<sockaddr*>(&address), &length);
+        port_ = ntohs(address.sin_port);
+        acceptor_ = std::thread([this]() { acceptLoop(); });
+    }
+
+    ~LoopbackServer() {
+        stop_ = true;
+        acceptor_.join();
+        for (auto& t : workers_) t.join();
+        close(listener_);
+    }
+
+    std::string url(const std::string& path) const {
+        return "http://127.0.0.1:" + std::to_string(port_) + path;
+    }
+
+    // Set once the server is being destroyed; long responses check it
+    bool stopping() const { return stop_; }
+
+    static std::string requestPath(const std::string& head) {
+        size_t start = head.find(' ') + 1;
+        return head.substr(start, head.find(' ', start) - start);
+    }
+
+    // Value of the header called name (lower case), empty if absent
+    static std::string headerValue(const std::string& head, const std::string& name) {
+        std::istringstream lines(head);
+        std::string line;
+        while (std::getline(lines, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            size_t colon = line.find(':');
+            if (colon == std::string::npos) continue;
+            std::string key = line.substr(0, colon);
+            for (auto& c : key) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            if (key == name) return line.substr(line.find_first_not_of(' ', colon + 1));
+        }
+        return "";
+    }
+
+    static bool sendAll(int fd, const char* data, size_t size) {
+        while (size > 0) {
+            ssize_t n = send(fd, data, size, MSG_NOSIGNAL);
+            if (n <= 0) return false;
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    static bool sendAll(int fd, const std::string& data) {
+        return sendAll(fd, data.data(), data.size());
+    }
+
+private:
+    bool readable(int fd) {
+        while (!stop_) {
+            pollfd p = {fd, POLLIN, 0};
+            if (poll(&p, 1, 20) > 0) return true;
+        }
+        return false;
+    }
+
+    void acceptLoop() {
+        while (readable(listener_)) {
+            int fd = accept(listener_, nullptr, nullptr);
+            if (fd < 0) continue;
+            ++connections;
+            workers_.emplace_back([this, fd]() { serve(fd); close(fd); });
+        }
+    }
+
+    void serve(int fd) {
+        std::string buffer;
+        char chunk[4096];
+        while (true) {
+            size_t end;
+            while ((end = buffer.find("\r\n\r\n")) == std::string::npos) {
+                if (!readable(fd)) return;
+                ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) return;
+                buffer.append(chunk, static_cast<size_t>(n));
+            }
+            std::string head = buffer.substr(0, end);
+            buffer.erase(0, end + 4);
+            if (!respond_(fd, head)) return;
+        }
+    }
+
+    Respond respond_;
+    int listener_ = -1;
+    int port_ = 0;
+    std::atomic<bool> stop_{false};
+    std::thread acceptor_;
+    std::vector<std::thread> workers_;
+};
+#endif
+
+#endif // TEST_SUPPORT_H
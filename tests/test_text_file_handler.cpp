@@ -0,0 +1,298 @@
+#include "../include/handlers/text_file_handler.h"
+#include "../include/line_index.h"
+#include "../include/window.h"
+#include "../include/webview.h"
+#include "test_support.h"
+#include <nlohmann/json.hpp>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <thread>
+#include <cassert>
+
+namespace fs = std::filesystem;
+
+// "line <i>" lines of varying length, a few with CRLF endings
+static std::string numberedLines(uint64_t from, uint64_t to) {
+    std::string text;
+    for (uint64_t i = from; i < to; ++i) {
+        text += "line " + std::to_string(i) + std::string(i % 37, '.') + (i % 10 == 3 ? "\r\n" : "\n");
+    }
+    return text;
+}
+
+static std::string expectedLine(uint64_t i) {
+    return "line " + std::to_string(i) + std::string(i % 37, '.');
+}
+
+// Newline count by the plain loop
+static uint64_t countNewlines(const std::string& data) {
+    uint64_t n = 0;
+    for (char c : data) n += c == '\n';
+    return n;
+}
+
+static nlohmann::json readLines(MessageHandler& handler, const std::string& path, uint64_t start, uint64_t count) {
+    nlohmann::json r = handler.handle({{"_type", "readLines"}, {"path", path}, {"start", start}, {"count", count}}, "1");
+    assert(r["success"] == true);
+    return r;
+}
+
+// Test 1: Every kernel finds the same newlines at every alignment and count
+void test_kernels() {
+    std::cout << "Test 1: Newline kernels...\n";
+
+    std::string data(5000, 'x');
+    uint32_t x = 12345;
+    for (auto& c : data) {
+        x = x * 1103515245u + 12345u;
+        if ((x >> 16) % 11 == 0) c = '\n';
+    }
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data.data());
+    line_scan::Kernel original = line_scan::activeKernel();
+    for (line_scan::Kernel kernel : line_scan::supportedKernels()) {
+        bool selected = line_scan::setKernel(kernel);
+        assert(selected);
+        for (size_t offset : {size_t(0), size_t(1), size_t(7), size_t(63), size_t(64), size_t(100)}) {
+            std::string slice = data.substr(offset);
+            uint64_t total = countNewlines(slice);
+            for (uint64_t want : {uint64_t(1), uint64_t(2), uint64_t(17), uint64_t(64), total, total + 5}) {
+                uint64_t n = want;
+                size_t pos = line_scan::skipNewlines(bytes + offset, slice.size(), n);
+                if (want <= total) {
+                    assert(n == 0 && pos > 0 && slice[pos - 1] == '\n');
+                    assert(countNewlines(slice.substr(0, pos)) == want);
+                } else {
+                    assert(pos == slice.size() && n == want - total);
+                }
+            }
+        }
+        std::cout << "  " << line_scan::kernelName(kernel) << " ok\n";
+    }
+    line_scan::setKernel(original);
+
+    std::string out;
+    size_t replaced = line_scan::sanitizeUtf8("plain ascii text", 16, out);
+    assert(replaced == 0 && out == "plain ascii text");
+    replaced = line_scan::sanitizeUtf8("caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80", 14, out);
+    assert(replaced == 0);
+    replaced = line_scan::sanitizeUtf8("a\xFF" "b\xC3", 4, out);
+    assert(replaced == 2 && out == "a\xEF\xBF\xBD" "b\xEF\xBF\xBD");
+    replaced = line_scan::sanitizeUtf8("\xED\xA0\x80", 3, out);
+    assert(replaced == 3);  // surrogate
+    replaced = line_scan::sanitizeUtf8("\xC0\xAF", 2, out);
+    assert(replaced == 2);  // overlong
+
+    std::cout << "✓ Test 1 passed\n\n";
+}
+
+// Test 2: readTextFile returns text as a string, BOM stripped, invalid bytes replaced
+void test_read_text_file(MessageHandler& handler) {
+    std::cout << "Test 2: readTextFile...\n";
+
+    writeFile("plain.txt", "hello\nworld\n");
+    nlohmann::json r = handler.handle({{"_type", "readTextFile"}, {"path", "plain.txt"}}, "1");
+    assert(r["success"] == true && r["text"] == "hello\nworld\n" && r["invalidUtf8"] == 0 && r["size"] == 12);
+
+    writeFile("bom.txt", "\xEF\xBB\xBFtext \xFF end");
+    r = handler.handle({{"_type", "readTextFile"}, {"path", "bom.txt"}}, "2");
+    assert(r["success"] == true && r["text"] == "text \xEF\xBF\xBD end" && r["invalidUtf8"] == 1);
+
+    writeFile("utf16.txt", std::string("\xFF\xFEh\0i\0", 6));
+    r = handler.handle({{"_type", "readTextFile"}, {"path", "utf16.txt"}}, "3");
+    assert(r["success"] == false && r["error"].get<std::string>().find("UTF-16") != std::string::npos);
+
+    r = handler.handle({{"_type", "readTextFile"}, {"path", "plain.txt"}, {"maxBytes", 4}}, "4");
+    assert(r["success"] == false && r["rangeRequired"] == true && r["totalSize"] == 12);
+
+    r = handler.handle({{"_type", "readTextFile"}, {"path", "missing.txt"}}, "5");
+    assert(r["error"] == "File does not exist");
+    r = handler.handle({{"_type", "readTextFile"}, {"path", "../x"}}, "6");
+    assert(r["error"] == "Invalid or disallowed path");
+    r = handler.handle({{"_type", "readTextFile"}, {"path", "."}}, "7");
+    assert(r["error"] == "Not a file");
+
+    std::cout << "✓ Test 2 passed\n\n";
+}
+
+// Test 3: readLines pages through a file, from any line, across checkpoints
+void test_read_lines(MessageHandler& handler, WebView& webView) {
+    std::cout << "Test 3: readLines...\n";
+
+    const uint64_t total = 200000;
+    writeFile("big.log", numberedLines(0, total));
+
+    nlohmann::json r = readLines(handler, "big.log", 0, 3);
+    assert(r["lines"].size() == 3 && r["lines"][0] == expectedLine(0) && r["lines"][2] == expectedLine(2));
+    assert(r["nextLine"] == 3 && r["eof"] == false);
+
+    for (uint64_t start : {uint64_t(255), uint64_t(256), uint64_t(257), uint64_t(12345), uint64_t(150000), total - 2}) {
+        r = readLines(handler, "big.log", start, 5);
+        assert(r["start"] == start && r["nextLine"] == std::min(start + 5, total));
+        for (uint64_t i = 0; i < r["lines"].size(); ++i) {
+            assert(r["lines"][i] == expectedLine(start + i));
+        }
+        assert(r["eof"] == (start + 5 >= total));
+    }
+
+    r = readLines(handler, "big.log", total + 10, 5);
+    assert(r["lines"].empty() && r["eof"] == true && r["complete"] == true && r["totalLines"] == total);
+
+    // maxBytes ends a page early; the cut-off line starts the next one
+    r = handler.handle({{"_type", "readLines"}, {"path", "big.log"}, {"start", 0}, {"count", 100}, {"maxBytes", 20}}, "2");
+    assert(r["lines"].size() == 2 && r["nextLine"] == 2 && r["truncated"] == false);
+    writeFile("long.txt", std::string(1000, 'z') + "\nshort\n");
+    r = handler.handle({{"_type", "readLines"}, {"path", "long.txt"}, {"maxBytes", 10}}, "3");
+    assert(r["lines"].size() == 1 && r["lines"][0] == std::string(10, 'z') && r["truncated"] == true && r["nextLine"] == 1);
+
+    // A last line without '\n' counts
+    writeFile("open.txt", "a\nb");
+    r = readLines(handler, "open.txt", 0, 10);
+    assert(r["lines"] == nlohmann::json::array({"a", "b"}) && r["eof"] == true && r["totalLines"] == 2);
+
+    r = handler.handle({{"_type", "readLines"}, {"path", "big.log"}, {"count", 0}}, "4");
+    assert(r["success"] == false);
+    r = handler.handle({{"_type", "readLines"}, {"path", "big.log"}, {"start", -1}}, "5");
+    assert(r["success"] == false);
+
+    // An incomplete index is finished in the background
+    writeFile("fresh.log", numberedLines(0, total));
+    r = readLines(handler, "fresh.log", 0, 1);
+    assert(r["complete"] == false && !r.contains("totalLines"));
+    bool indexed = false;
+    for (int spin = 0; spin < 10000 && !indexed; ++spin) {
+        platform::mockRunMainThreadTasks();
+        for (const auto& raw : platform::mockTakePostedMessages(webView.getNativeHandle())) {
+            nlohmann::json msg = nlohmann::json::parse(raw);
+            if (msg["name"] == "lines:indexed" && msg["payload"]["path"] == "fresh.log") {
+                assert(msg["payload"]["totalLines"] == total);
+                indexed = true;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    assert(indexed);
+
+    std::cout << "✓ Test 3 passed\n\n";
+}
+
+// Test 4: Appends extend the index; rewrites rebuild it
+void test_index_updates(MessageHandler& handler) {
+    std::cout << "Test 4: Index updates...\n";
+
+    writeFile("grow.log", numberedLines(0, 1000));
+    nlohmann::json r = readLines(handler, "grow.log", 2000, 1);
+    assert(r["totalLines"] == 1000);
+    std::string error;
+    uint64_t before = LineIndex::forFile("grow.log", error)->status().bytesIndexed;
+
+    writeFile("grow.log", numberedLines(1000, 3000), true);
+    std::shared_ptr<LineIndex> index = LineIndex::forFile("grow.log", error);
+    assert(index->status().bytesIndexed == before && index->status().complete == false);
+    r = readLines(handler, "grow.log", 2998, 5);
+    assert(r["lines"].size() == 2 && r["lines"][1] == expectedLine(2999) && r["eof"] == true);
+    r = readLines(handler, "grow.log", 5000, 1);
+    assert(r["totalLines"] == 3000);
+
+    // Replaced with different content (smaller, then same size)
+    writeFile("grow.log", "x\ny\n");
+    r = readLines(handler, "grow.log", 0, 10);
+    assert(r["lines"] == nlohmann::json::array({"x", "y"}) && r["totalLines"] == 2);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    writeFile("grow.log", "p\nq\r\n");
+    r = readLines(handler, "grow.log", 1, 10);
+    assert(r["lines"] == nlohmann::json::array({"q"}));
+
+    std::cout << "✓ Test 4 passed\n\n";
+}
+
+// Test 5: A line far into a large file is not scanned for on the UI thread: the reply says
+// indexing and the line is there once "lines:indexed" arrives
+void test_deferred_index(MessageHandler& handler, WebView& webView) {
+    std::cout << "Test 5: Deferred indexing...\n";
+
+    const uint64_t total = 1000000;  // about 25 MiB, over the 8 MiB scanned per request
+    writeFile("huge.log", numberedLines(0, total));
+    nlohmann::json r = readLines(handler, "huge.log", total - 5, 5);
+    assert(r["indexing"] == true && r["lines"].empty() && r["nextLine"] == total - 5 && r["eof"] == false);
+    assert(r["complete"] == false && r["linesIndexed"].get<uint64_t>() < total - 5);
+
+    bool indexed = false;
+    for (int spin = 0; spin < 20000 && !indexed; ++spin) {
+        platform::mockRunMainThreadTasks();
+        for (const auto& raw : platform::mockTakePostedMessages(webView.getNativeHandle())) {
+            nlohmann::json msg = nlohmann::json::parse(raw);
+            if (msg["name"] == "lines:indexed" && msg["payload"]["path"] == "huge.log") indexed = true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    assert(indexed);
+
+    r = readLines(handler, "huge.log", total - 5, 5);
+    assert(!r.contains("indexing") && r["lines"].size() == 5 && r["lines"][4] == expectedLine(total - 1));
+    assert(r["eof"] == true && r["totalLines"] == total);
+
+    std::cout << "✓ Test 5 passed\n\n";
+}
+
+// Test 6: A cut line far longer than the scan budget is not read to its end on the UI thread;
+// the line after it comes from the index
+void test_oversized_line(MessageHandler& handler, WebView& webView) {
+    std::cout << "Test 6: Oversized line...\n";
+
+    std::string huge(24 * 1024 * 1024, 'x');  // three times the 8 MiB scanned per request
+    writeFile("wide.log", "head\n" + huge + "\ntail\n");
+    nlohmann::json cut = {{"_type", "readLines"}, {"path", "wide.log"}, {"start", 1}, {"maxBytes", 16}};
+    nlohmann::json r = handler.handle(cut, "1");
+    assert(r["lines"].size() == 1 && r["lines"][0] == std::string(16, 'x') && r["truncated"] == true);
+    assert(r["nextLine"] == 2 && r["eof"] == false && r["complete"] == false);
+
+    r = readLines(handler, "wide.log", 2, 5);
+    if (r.contains("indexing")) {
+        assert(r["lines"].empty());
+        nlohmann::json indexed;
+        for (int spin = 0; spin < 20000 && indexed.is_null(); ++spin) {
+            platform::mockRunMainThreadTasks();
+            for (const auto& raw : platform::mockTakePostedMessages(webView.getNativeHandle())) {
+                nlohmann::json msg = nlohmann::json::parse(raw);
+                if (msg["name"] == "lines:indexed" && msg["payload"]["path"] == "wide.log") indexed = msg["payload"];
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        assert(indexed["totalLines"] == 3);
+        r = readLines(handler, "wide.log", 2, 5);
+    }
+    assert(r["lines"] == nlohmann::json::array({"tail"}) && r["eof"] == true);
+
+    // Cut last line: not scanned to the end of the file either
+    writeFile("wide_end.log", "head\n" + huge);
+    cut["path"] = "wide_end.log";
+    r = handler.handle(cut, "2");
+    assert(r["lines"].size() == 1 && r["truncated"] == true && r["nextLine"] == 2);
+    assert(r["eof"] == false && r["complete"] == false);
+
+    std::cout << "✓ Test 6 passed\n\n";
+}
+
+int main() {
+    std::cout << "Running TextFileHandler tests...\n\n";
+
+    fs::path dir = enterTempDir("crossdev_text_file_test");
+    Window window(nullptr, nullptr, 0, 0, 100, 100, "Text Test");
+    WebView webView(&window, &window, 0, 0, 100, 100);
+    auto handler = createTextFileHandler(&webView);
+
+    test_kernels();
+    test_read_text_file(*handler);
+    test_read_lines(*handler, webView);
+    test_index_updates(*handler);
+    test_deferred_index(*handler, webView);
+    test_oversized_line(*handler, webView);
+
+    handler.reset();
+    fs::current_path(fs::temp_directory_path());
+    fs::remove_all(dir);
+
+    std::cout << "All TextFileHandler tests passed!\n";
+    return 0;
+}
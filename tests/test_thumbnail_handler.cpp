@@ -0,0 +1,182 @@
+#include "../include/handlers/thumbnail_handler.h"
+#include "../include/thumbnail_cache.h"
+#include "../include/base64.h"
+#include "../include/window.h"
+#include "../include/webview.h"
+#include "test_support.h"
+#include <nlohmann/json.hpp>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <map>
+#include <thread>
+#include <cassert>
+
+namespace platform {
+size_t mockThumbnailDecodes();
+}
+
+namespace fs = std::filesystem;
+
+// Binary PPM header (the mock decoder only reads the dimensions)
+static void writeImage(const fs::path& path, int width, int height) {
+    std::ofstream out(path, std::ios::binary);
+    out << "P6\n" << width << " " << height << "\n255\n" << std::string(64, '\x7f');
+}
+
+// "thumbnail:ready" payloads by path
+static std::map<std::string, nlohmann::json> ready(const JobEvents& e) {
+    std::map<std::string, nlohmann::json> byPath;
+    for (const auto& item : e.items) byPath[item["path"]] = item;
+    return byPath;
+}
+
+static std::string decoded(const nlohmann::json& ready) {
+    std::vector<unsigned char> data = base64::decode(ready["data"].get<std::string>());
+    return std::string(data.begin(), data.end());
+}
+
+// Test 1: Decode, then serve from the disk cache until the file changes
+void test_cache(MessageHandler& handler, WebView& webView) {
+    std::cout << "Test 1: Decode and cache...\n";
+
+    writeImage("car.ppm", 2000, 1000);
+    JobEvents e = run(handler, webView, "thumbnail", {{"path", "car.ppm"}});
+    nlohmann::json t = ready(e)["car.ppm"];
+    assert(t["cached"] == false && t["width"] == 256 && t["height"] == 128 && t["mimeType"] == "image/jpeg");
+    assert(decoded(t) == "mock-jpeg 256x128");
+    assert(e.done["count"] == 1 && e.done["cached"] == 0 && e.done["failed"] == 0);
+
+    size_t decodes = platform::mockThumbnailDecodes();
+    e = run(handler, webView, "thumbnail", {{"path", "car.ppm"}});
+    t = ready(e)["car.ppm"];
+    assert(t["cached"] == true && decoded(t) == "mock-jpeg 256x128");
+    assert(e.done["cached"] == 1 && platform::mockThumbnailDecodes() == decodes);
+
+    // Another size is another entry
+    e = run(handler, webView, "thumbnail", {{"path", "car.ppm"}, {"size", 64}});
+    t = ready(e)["car.ppm"];
+    assert(t["cached"] == false && t["width"] == 64);
+
+    // A replaced image is decoded again
+    writeImage("car.ppm", 300, 600);
+    fs::last_write_time("car.ppm", fs::last_write_time("car.ppm") + std::chrono::seconds(5));
+    e = run(handler, webView, "thumbnail", {{"path", "car.ppm"}});
+    t = ready(e)["car.ppm"];
+    assert(t["cached"] == false && t["width"] == 128 && t["height"] == 256);
+
+    // Small images are not enlarged
+    writeImage("icon.ppm", 40, 30);
+    e = run(handler, webView, "thumbnail", {{"path", "icon.ppm"}});
+    t = ready(e)["icon.ppm"];
+    assert(t["width"] == 40 && t["height"] == 30);
+
+    std::cout << "✓ Test 1 passed\n\n";
+}
+
+// Test 2: Batches report every file, failures included
+void test_batch(MessageHandler& handler, WebView& webView) {
+    std::cout << "Test 2: Batch...\n";
+
+    nlohmann::json paths = nlohmann::json::array();
+    for (int i = 0; i < 50; ++i) {
+        writeImage("photo" + std::to_string(i) + ".ppm", 1000 + i, 800);
+        paths.push_back("photo" + std::to_string(i) + ".ppm");
+    }
+    std::ofstream("notes.txt") << "not an image";
+    for (const char* bad : {"notes.txt", "missing.ppm", "../escape.ppm", "."}) paths.push_back(bad);
+
+    JobEvents e = run(handler, webView, "thumbnail", {{"paths", paths}, {"size", 128}});
+    std::map<std::string, nlohmann::json> byPath = ready(e);
+    assert(byPath.size() == 54 && e.done["count"] == 54 && e.done["failed"] == 4);
+    assert(byPath["photo7.ppm"]["width"] == 128);
+    assert(byPath["notes.txt"]["error"] == "Not a supported image");
+    assert(byPath["missing.ppm"]["error"] == "File does not exist");
+    assert(byPath["../escape.ppm"]["error"] == "Invalid or disallowed path");
+    assert(byPath["."]["error"] == "Not a file");
+
+    std::cout << "✓ Test 2 passed\n\n";
+}
+
+// Test 3: The cache outlives the handler, and is trimmed to its budget
+void test_persistence_and_prune(WebView& webView, const fs::path& cacheDir) {
+    std::cout << "Test 3: Persistence and pruning...\n";
+
+    auto handler = createThumbnailHandler(&webView, cacheDir.u8string());
+    JobEvents e = run(*handler, webView, "thumbnail", {{"path", "photo3.ppm"}, {"size", 128}});
+    assert(ready(e)["photo3.ppm"]["cached"] == true);
+
+    // Every handler over one directory shares its cache object (and so its pruning)
+    assert(ThumbnailCache::forDirectory(cacheDir.u8string()) == ThumbnailCache::forDirectory((cacheDir / "").u8string()));
+    assert(ThumbnailCache::forDirectory(cacheDir.u8string()) != ThumbnailCache::forDirectory((cacheDir / "other").u8string()));
+
+    fs::path small = fs::current_path() / "small-cache";
+    ThumbnailCache cache(small.u8string(), 2000);
+    Thumbnail thumbnail;
+    thumbnail.data.assign(400, 'j');
+    thumbnail.mimeType = "image/jpeg";
+    thumbnail.width = thumbnail.height = 10;
+    for (int i = 0; i < 10; ++i) {
+        cache.store("key" + std::to_string(i), thumbnail);
+    }
+    Thumbnail read;
+    bool found = cache.lookup("key9", read);
+    assert(found && read.data == thumbnail.data && read.width == 10 && read.mimeType == "image/jpeg");
+    found = cache.lookup("nope", read);
+    assert(!found);
+    cache.prune();
+    uint64_t total = 0;
+    for (const auto& entry : fs::directory_iterator(small)) total += entry.file_size();
+    found = cache.lookup("key9", read);
+    assert(total <= 1500 && found);
+
+    std::cout << "✓ Test 3 passed\n\n";
+}
+
+// Test 4: Request validation and cancellation
+void test_validation(MessageHandler& handler, WebView& webView) {
+    std::cout << "Test 4: Validation and cancel...\n";
+
+    nlohmann::json r = handler.handle({{"_type", "thumbnail"}}, "1");
+    assert(r["success"] == false);
+    r = handler.handle({{"_type", "thumbnail"}, {"path", "car.ppm"}, {"size", 4}}, "2");
+    assert(r["success"] == false);
+    r = handler.handle({{"_type", "thumbnail"}, {"paths", nlohmann::json::array()}}, "3");
+    assert(r["success"] == false);
+    r = handler.handle({{"_type", "thumbnail"}, {"paths", {1, 2}}}, "4");
+    assert(r["success"] == false);
+
+    nlohmann::json paths = nlohmann::json::array();
+    for (int i = 0; i < 50; ++i) paths.push_back("photo" + std::to_string(i) + ".ppm");
+    r = handler.handle({{"_type", "thumbnail"}, {"paths", paths}, {"size", 32}}, "5");
+    nlohmann::json c = handler.handle({{"_type", "cancelThumbnail"}, {"jobId", r["jobId"]}}, "6");
+    assert(c["success"] == true);
+    JobEvents e = waitDone(webView, "thumbnail", r["jobId"]);
+    assert(ready(e).size() == 50 && e.done["cancelled"] == c["found"]);
+    r = handler.handle({{"_type", "cancelThumbnail"}, {"jobId", r["jobId"]}}, "7");
+    assert(r["found"] == false);
+
+    std::cout << "✓ Test 4 passed\n\n";
+}
+
+int main() {
+    std::cout << "Running ThumbnailHandler tests...\n\n";
+
+    fs::path dir = enterTempDir("crossdev_thumbnail_test");
+    fs::path cacheDir = dir / "cache";
+    Window window(nullptr, nullptr, 0, 0, 100, 100, "Thumbnail Test");
+    WebView webView(&window, &window, 0, 0, 100, 100);
+    auto handler = createThumbnailHandler(&webView, cacheDir.u8string());
+
+    test_cache(*handler, webView);
+    test_batch(*handler, webView);
+    test_persistence_and_prune(webView, cacheDir);
+    test_validation(*handler, webView);
+
+    handler.reset();
+    fs::current_path(fs::temp_directory_path());
+    fs::remove_all(dir);
+
+    std::cout << "All ThumbnailHandler tests passed!\n";
+    return 0;
+}
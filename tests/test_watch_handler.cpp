@@ -0,0 +1,230 @@
+#include "../include/handlers/watch_handler.h"
+#include "../include/window.h"
+#include "../include/webview.h"
+#include "test_support.h"
+#include <nlohmann/json.hpp>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <thread>
+#include <chrono>
+#include <cassert>
+
+// inotify delivers within the debounce interval; the stat-polling fallback needs a poll period more
+#ifdef __linux__
+static const int kSettleMs = 400;
+#else
+static const int kSettleMs = 1200;
+#endif
+
+// "file:changed" payloads delivered to webView within waitMs
+static std::vector<nlohmann::json> events(WebView& webView, int waitMs) {
+    std::vector<nlohmann::json> out;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(waitMs);
+    while (std::chrono::steady_clock::now() < deadline) {
+        platform::mockRunMainThreadTasks();
+        for (const auto& raw : platform::mockTakePostedMessages(webView.getNativeHandle())) {
+            nlohmann::json msg = nlohmann::json::parse(raw);
+            if (msg["name"] == "file:changed") out.push_back(msg["payload"]);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return out;
+}
+
+static std::string watch(MessageHandler& handler, const std::string& path, int debounceMs = 50) {
+    nlohmann::json r = handler.handle({{"_type", "watchPath"}, {"path", path}, {"debounceMs", debounceMs}}, "1");
+    assert(r["success"] == true);
+    return r["watchId"];
+}
+
+// Test 1: Directory watch reports created / modified / deleted children
+void test_directory(MessageHandler& handler, WebView& webView) {
+    std::cout << "Test 1: Directory watch...\n";
+
+    std::filesystem::create_directory("dir");
+    std::string id = watch(handler, "dir");
+
+    writeFile("dir/a.txt", "one");
+    auto ev = events(webView, kSettleMs);
+    assert(ev.size() == 1 && ev[0]["watchId"] == id && ev[0]["path"] == "dir");
+    assert(ev[0]["changes"].size() == 1);
+    assert(ev[0]["changes"][0]["path"] == "dir/a.txt" && ev[0]["changes"][0]["kind"] == "created");
+
+    writeFile("dir/a.txt", "two");
+    ev = events(webView, kSettleMs);
+    assert(ev.size() == 1 && ev[0]["changes"][0]["kind"] == "modified");
+
+    std::filesystem::remove("dir/a.txt");
+    ev = events(webView, kSettleMs);
+    assert(ev.size() == 1 && ev[0]["changes"][0]["kind"] == "deleted");
+
+    nlohmann::json r = handler.handle({{"_type", "unwatch"}, {"watchId", id}}, "2");
+    assert(r["success"] == true);
+    writeFile("dir/b.txt", "x");
+    ev = events(webView, kSettleMs);
+    assert(ev.empty());
+
+    std::cout << "✓ Test 1 passed\n\n";
+}
+
+// Test 2: Bursts are coalesced into one event
+void test_coalescing(MessageHandler& handler, WebView& webView) {
+    std::cout << "Test 2: Coalescing...\n";
+
+    std::filesystem::create_directory("storm");
+    std::string id = watch(handler, "storm", 100);
+    for (int i = 0; i < 50; ++i) {
+        std::ofstream out("storm/log.txt", std::ios::app);
+        out << "line " << i << "\n";
+    }
+    writeFile("storm/tmp", "x");
+    std::filesystem::remove("storm/tmp");  // Created and deleted within the burst: not reported
+
+    auto ev = events(webView, kSettleMs);
+    assert(ev.size() == 1 && ev[0]["changes"].size() == 1);
+    assert(ev[0]["changes"][0]["path"] == "storm/log.txt" && ev[0]["changes"][0]["kind"] == "created");
+
+    handler.handle({{"_type", "unwatch"}, {"watchId", id}}, "2");
+    std::cout << "✓ Test 2 passed\n\n";
+}
+
+// Test 3: A file watch survives atomic replacement and ignores siblings
+void test_file_watch(MessageHandler& handler, WebView& webView) {
+    std::cout << "Test 3: File watch...\n";
+
+    std::filesystem::create_directory("conf");
+    writeFile("conf/settings.json", "{}");
+    std::string id = watch(handler, "conf/settings.json");
+
+    writeFile("conf/other.json", "{}");
+    auto ev = events(webView, kSettleMs);
+    assert(ev.empty());
+
+    // Atomic save: write a temp file, rename over the original
+    writeFile("conf/.settings.json.tmp", "{\"a\":1}");
+    std::filesystem::rename("conf/.settings.json.tmp", "conf/settings.json");
+    ev = events(webView, kSettleMs);
+    assert(ev.size() == 1 && ev[0]["changes"].size() == 1);
+    assert(ev[0]["changes"][0]["path"] == "conf/settings.json" && ev[0]["changes"][0]["kind"] == "modified");
+
+    // Still watched after the replacement
+    writeFile("conf/settings.json", "{\"a\":2}");
+    ev = events(webView, kSettleMs);
+    assert(ev.size() == 1 && ev[0]["changes"][0]["kind"] == "modified");
+
+    handler.handle({{"_type", "unwatch"}, {"watchId", id}}, "2");
+    std::cout << "✓ Test 3 passed\n\n";
+}
+
+// Test 4: Events go only to the subscribing window; handler teardown ends its watches
+void test_isolation(MessageHandler& handler, WebView& webView, Window& window) {
+    std::cout << "Test 4: Per-window delivery...\n";
+
+    std::filesystem::create_directory("shared");
+    WebView other(&window, &window, 0, 0, 100, 100);
+    auto otherHandler = createWatchHandler(&other);
+    std::string id = watch(handler, "shared");
+    watch(*otherHandler, "shared");
+
+    writeFile("shared/x", "1");
+    auto ev = events(webView, kSettleMs);
+    assert(ev.size() == 1);
+    ev = events(other, kSettleMs);
+    assert(ev.size() == 1);
+
+    otherHandler.reset();
+    writeFile("shared/y", "1");
+    ev = events(webView, kSettleMs);
+    assert(ev.size() == 1);
+    ev = events(other, kSettleMs);
+    assert(ev.empty());
+
+    handler.handle({{"_type", "unwatch"}, {"watchId", id}}, "2");
+    std::cout << "✓ Test 4 passed\n\n";
+}
+
+// Test 5: Invalid requests
+void test_errors(MessageHandler& handler) {
+    std::cout << "Test 5: Errors...\n";
+
+    nlohmann::json r = handler.handle({{"_type", "watchPath"}, {"path", "../"}}, "1");
+    assert(r["success"] == false);
+    r = handler.handle({{"_type", "watchPath"}, {"path", "missing"}}, "2");
+    assert(r["success"] == false);
+    r = handler.handle({{"_type", "watchPath"}, {"path", "dir"}, {"debounceMs", -1}}, "3");
+    assert(r["success"] == false);
+    r = handler.handle({{"_type", "watchPath"}}, "4");
+    assert(r["success"] == false);
+    r = handler.handle({{"_type", "unwatch"}, {"watchId", "watch-999"}}, "5");
+    assert(r["success"] == false);
+
+    std::cout << "✓ Test 5 passed\n\n";
+}
+
+// Test 6: Moving the watched directory away ends its watches with a last deleted / overflow
+// (inotify; the polling fallback just diffs whatever is at the path)
+void test_directory_moved(MessageHandler& handler, WebView& webView) {
+    std::cout << "Test 6: Watched directory moved...\n";
+
+#ifdef __linux__
+    std::filesystem::create_directory("logs");
+    writeFile("logs/a.json", "old");
+    std::string fileId = watch(handler, "logs/a.json");
+    std::string dirId = watch(handler, "logs");
+
+    std::filesystem::rename("logs", "logs.old");
+    std::filesystem::create_directory("logs");
+    writeFile("logs/a.json", "new");
+    auto ev = events(webView, kSettleMs);
+    assert(ev.size() == 2);
+    for (const auto& e : ev) {
+        if (e["watchId"] == fileId) {
+            assert(e["changes"].size() == 1 && e["changes"][0]["kind"] == "deleted");
+        } else {
+            assert(e["watchId"] == dirId && e["overflow"] == true);
+        }
+    }
+
+    // Neither the moved directory nor its replacement reports through the ended watches
+    writeFile("logs/a.json", "newer");
+    writeFile("logs.old/a.json", "older");
+    ev = events(webView, kSettleMs);
+    assert(ev.empty());
+
+    // Watching the path again observes the new directory
+    std::string again = watch(handler, "logs/a.json");
+    writeFile("logs/a.json", "newest");
+    ev = events(webView, kSettleMs);
+    assert(ev.size() == 1 && ev[0]["watchId"] == again && ev[0]["changes"][0]["kind"] == "modified");
+
+    handler.handle({{"_type", "unwatch"}, {"watchId", fileId}}, "2");
+    handler.handle({{"_type", "unwatch"}, {"watchId", dirId}}, "3");
+    handler.handle({{"_type", "unwatch"}, {"watchId", again}}, "4");
+#endif
+
+    std::cout << "✓ Test 6 passed\n\n";
+}
+
+int main() {
+    std::cout << "Running WatchHandler tests...\n\n";
+
+    std::filesystem::path dir = enterTempDir("crossdev_watch_test");
+    Window window(nullptr, nullptr, 0, 0, 100, 100, "Watch Test");
+    WebView webView(&window, &window, 0, 0, 100, 100);
+    auto handler = createWatchHandler(&webView);
+
+    test_directory(*handler, webView);
+    test_coalescing(*handler, webView);
+    test_file_watch(*handler, webView);
+    test_isolation(*handler, webView, window);
+    test_errors(*handler);
+    test_directory_moved(*handler, webView);
+
+    handler.reset();
+    std::filesystem::current_path(std::filesystem::temp_directory_path());
+    std::filesystem::remove_all(dir);
+
+    std::cout << "All WatchHandler tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include "../include/web_precache.h"
+#include <nlohmann/json.hpp>
+#include <iostream>
+#include <vector>
+#include <cassert>
+
+// Test 1: Manifest entries resolve against the page like the page's own fetch() would
+void test_resolve() {
+    std::cout << "Test 1: resolve...\n";
+
+    std::string page = "http://127.0.0.1:8080/app/index.html?lang=en";
+    std::vector<std::string> urls = web_precache::resolve(page, {
+        "app.js", "./css/../style.css", "/shared/logo.svg", "app.js#top", "../up.js", "../../../root.js",
+        "http://127.0.0.1:8080/app/app.js", "https://127.0.0.1:8080/app/secure.js", "http://cdn.example/lib.js",
+        "data:text/javascript,1", "", "img/"});
+    assert((urls == std::vector<std::string>{
+        "http://127.0.0.1:8080/app/app.js", "http://127.0.0.1:8080/app/style.css",
+        "http://127.0.0.1:8080/shared/logo.svg", "http://127.0.0.1:8080/up.js", "http://127.0.0.1:8080/root.js",
+        "http://127.0.0.1:8080/app/img/"}));
+
+    assert(web_precache::resolve("file:///app/index.html", {"app.js"}).empty());
+    assert(web_precache::resolve("not a url", {"app.js"}).empty());
+
+    std::string script = web_precache::script({"http://h/a.js", "http://h/it's.js"});
+    assert(script.find("[\"http://h/a.js\",\"http://h/it's.js\"]") != std::string::npos);
+    assert(script.find("cache:'no-cache'") != std::string::npos);
+
+    std::cout << "✓ Test 1 passed\n\n";
+}
+
+// The url list a script() passes to its fetch loop
+static std::vector<std::string> scriptUrls(const std::string& script) {
+    size_t open = script.rfind("})(");
+    assert(open != std::string::npos && script.compare(script.size() - 2, 2, ");") == 0);
+    return nlohmann::json::parse(script.substr(open + 3, script.size() - open - 5)).get<std::vector<std::string>>();
+}
+
+// Test 2: The script for a page's manifest carries exactly the resolved same-origin assets,
+// each fetched with cache:'no-cache' so a cached copy is revalidated rather than trusted.
+// Whether the WebView's disk cache keeps them across launches is up to the platform and
+// needs a real WebView run.
+void test_script() {
+    std::cout << "Test 2: Precache script...\n";
+
+    std::string page = "http://127.0.0.1:8080/app/index.html";
+    std::vector<std::string> manifest = {"app.js", "./style.css", "app.js#again", "../fonts/ui.woff2",
+                                         "http://cdn.example/lib.js", "data:text/css,", "missing.js"};
+    std::string script = web_precache::script(web_precache::resolve(page, manifest));
+    assert((scriptUrls(script) == std::vector<std::string>{
+        "http://127.0.0.1:8080/app/app.js", "http://127.0.0.1:8080/app/style.css",
+        "http://127.0.0.1:8080/fonts/ui.woff2", "http://127.0.0.1:8080/app/missing.js"}));
+    assert(script.find("fetch(u,{cache:'no-cache',credentials:'same-origin'})") != std::string::npos);
+    // One at a time, after the page goes idle
+    assert(script.find("requestIdleCallback") != std::string::npos && script.find("then(next)") != std::string::npos);
+
+    assert(scriptUrls(web_precache::script({})).empty());
+
+    std::cout << "✓ Test 2 passed\n\n";
+}
+
+int main() {
+    std::cout << "Running web precache tests...\n\n";
+
+    test_resolve();
+    test_script();
+
+    std::cout << "All web precache tests passed!\n";
+    return 0;
+}
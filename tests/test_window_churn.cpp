@@ -0,0 +1,127 @@
+#include "../include/event_handler.h"
+#include "../include/webview_window.h"
+#include <iostream>
+#include <fstream>
+#include <cassert>
+#include <chrono>
+
+namespace platform {
+// tests/mock_platform.cpp
+size_t mockLiveHandleCount();
+void mockDeliverMessage(void* webViewHandle, const std::string& jsonMessage);
+}
+
+// Handler that counts live instances so a leaked router shows up as a leaked handler
+class LiveCountingHandler : public MessageHandler {
+public:
+    LiveCountingHandler() { ++live; }
+    ~LiveCountingHandler() override { --live; }
+
+    bool canHandle(const std::string& messageType) const override {
+        return messageType == "churnPing";
+    }
+
+    nlohmann::json handle(const nlohmann::json& payload, const std::string& requestId) override {
+        (void)payload;
+        (void)requestId;
+        ++calls;
+        return {{"success", true}};
+    }
+
+    std::vector<std::string> getSupportedTypes() const override {
+        return {"churnPing"};
+    }
+
+    static int live;
+    static int calls;
+};
+
+int LiveCountingHandler::live = 0;
+int LiveCountingHandler::calls = 0;
+
+static const char* kPing = R"({"type":"churnPing","payload":{},"requestId":"1"})";
+
+// Resident set size in KB (Linux); 0 where /proc is unavailable
+static long residentKb() {
+    std::ifstream statm("/proc/self/statm");
+    long pages = 0, resident = 0;
+    if (!(statm >> pages >> resident)) {
+        return 0;
+    }
+    return resident * 4;  // 4 KB pages
+}
+
+static std::vector<MessageRouter::LazyHandler> churnHandlers() {
+    return {{{"churnPing"}, []() { return std::make_shared<LiveCountingHandler>(); }}};
+}
+
+// Open a child window, attach it, route one message (builds the lazy handler), close it
+static void openAndClose(EventHandler& events, WebViewWindow* main) {
+    auto* child = new WebViewWindow(main, 0, 0, 200, 200, "Churn", WebViewContentType::Html, "<html></html>");
+    events.attachWebView(child->getWebView(), churnHandlers());
+    platform::mockDeliverMessage(child->getWebView()->getNativeHandle(), kPing);
+    delete child;
+}
+
+// Test 1: A closed window releases its router and handlers
+void test_router_released(EventHandler& events, WebViewWindow* main) {
+    std::cout << "Test 1: Router released with WebView...\n";
+
+    size_t handlesBefore = platform::mockLiveHandleCount();
+    auto* child = new WebViewWindow(main, 0, 0, 200, 200, "Child", WebViewContentType::Html, "<html></html>");
+    events.attachWebView(child->getWebView(), churnHandlers());
+
+    LiveCountingHandler::calls = 0;
+    platform::mockDeliverMessage(child->getWebView()->getNativeHandle(), kPing);
+    assert(LiveCountingHandler::calls == 1);
+    assert(LiveCountingHandler::live == 1);
+
+    delete child;
+    assert(LiveCountingHandler::live == 0);
+    assert(platform::mockLiveHandleCount() == handlesBefore);
+
+    std::cout << "✓ Test 1 passed\n\n";
+}
+
+// Test 2: Soak - 10k open/close cycles keep handlers, native handles and RSS bounded
+void test_churn_soak(EventHandler& events, WebViewWindow* main) {
+    std::cout << "Test 2: Window churn soak (10000 cycles)...\n";
+
+    const int warmup = 500;
+    const int cycles = 10000;
+    for (int i = 0; i < warmup; ++i) {
+        openAndClose(events, main);
+    }
+    size_t handlesBefore = platform::mockLiveHandleCount();
+    long rssBefore = residentKb();
+    auto start = std::chrono::steady_clock::now();
+
+    LiveCountingHandler::calls = 0;
+    for (int i = 0; i < cycles; ++i) {
+        openAndClose(events, main);
+    }
+
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    long rssAfter = residentKb();
+    assert(LiveCountingHandler::calls == cycles);
+    assert(LiveCountingHandler::live == 0);
+    assert(platform::mockLiveHandleCount() == handlesBefore);
+    // One leaked router + handler per cycle is well over 100 bytes; 10k cycles would exceed this
+    assert(rssAfter - rssBefore < 1024);
+    std::cout << "  " << cycles << " cycles in " << ms << " ms, RSS " << rssBefore << " KB -> " << rssAfter << " KB\n";
+
+    std::cout << "✓ Test 2 passed\n\n";
+}
+
+int main() {
+    std::cout << "=== Window Churn Tests ===\n\n";
+
+    WebViewWindow main(nullptr, 0, 0, 400, 300, "Main", WebViewContentType::Html, "<html></html>");
+    EventHandler events(main.getWindow(), main.getWebView(), "");
+
+    test_router_released(events, &main);
+    test_churn_soak(events, &main);
+
+    std::cout << "=== All tests passed! ===\n";
+    return 0;
+}
@@ -0,0 +1,208 @@
+#include "../include/handlers/write_file_handler.h"
+#include "../include/base64.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <cassert>
+
+static std::filesystem::path tempDir(const std::string& name) {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    return dir;
+}
+
+static std::string readAll(const std::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+static std::string encode(const std::string& s) {
+    return base64::encode(reinterpret_cast<const unsigned char*>(s.data()), s.size());
+}
+
+static size_t fileCount(const std::filesystem::path& dir) {
+    size_t n = 0;
+    for (auto it = std::filesystem::directory_iterator(dir); it != std::filesystem::directory_iterator(); ++it) ++n;
+    return n;
+}
+
+static nlohmann::json call(MessageHandler& handler, const std::string& type, nlohmann::json payload) {
+    payload["_type"] = type;
+    return handler.handle(payload, "1");
+}
+
+// Test 1: One-shot writeFile replaces the target and leaves no temp file
+void test_write_file() {
+    std::cout << "Test 1: writeFile...\n";
+
+    auto dir = tempDir("crossdev_write_file_test1");
+    auto handler = createWriteFileHandler();
+    std::string target = (dir / "out.bin").string();
+
+    nlohmann::json r = call(*handler, "writeFile", {{"path", target}, {"data", encode("hello")}});
+    assert(r["success"] == true && r["bytesWritten"] == 5);
+    assert(readAll(target) == "hello");
+
+    r = call(*handler, "writeFile", {{"path", target}, {"data", {{"__base64", encode("replaced!")}}}, {"fsync", true}});
+    assert(r["success"] == true && readAll(target) == "replaced!");
+    assert(fileCount(dir) == 1);
+
+    r = call(*handler, "writeFile", {{"path", target}, {"data", "***"}});
+    assert(r["success"] == false);
+    r = call(*handler, "writeFile", {{"path", (dir / "missing" / "x").string()}, {"data", encode("x")}});
+    assert(r["success"] == false);
+    assert(readAll(target) == "replaced!");
+
+    std::cout << "✓ Test 1 passed\n\n";
+}
+
+// Test 2: Chunks are streamed into a temp file; the target only changes on commit
+void test_session_commit() {
+    std::cout << "Test 2: Session commit...\n";
+
+    auto dir = tempDir("crossdev_write_file_test2");
+    auto handler = createWriteFileHandler();
+    std::string target = (dir / "stream.txt").string();
+    { std::ofstream(target) << "old"; }
+
+    nlohmann::json r = call(*handler, "openWrite", {{"path", target}, {"fsync", true}});
+    assert(r["success"] == true);
+    std::string session = r["sessionId"];
+
+    std::string expected;
+    for (int i = 0; i < 100; ++i) {
+        std::string chunk = "chunk " + std::to_string(i) + "\n";
+        r = call(*handler, "appendChunk", {{"sessionId", session}, {"data", encode(chunk)}, {"offset", expected.size()}});
+        assert(r["success"] == true);
+        expected += chunk;
+        assert(r["bytesWritten"] == expected.size());
+    }
+    assert(readAll(target) == "old");
+    assert(fileCount(dir) == 2);  // target + temp
+
+    // Out-of-order chunk is rejected without touching the session
+    r = call(*handler, "appendChunk", {{"sessionId", session}, {"data", encode("x")}, {"offset", 3}});
+    assert(r["success"] == false);
+
+    r = call(*handler, "commitWrite", {{"sessionId", session}});
+    assert(r["success"] == true && r["bytesWritten"] == expected.size());
+    assert(readAll(target) == expected);
+    assert(fileCount(dir) == 1);
+
+    r = call(*handler, "appendChunk", {{"sessionId", session}, {"data", encode("x")}});
+    assert(r["success"] == false);
+    r = call(*handler, "commitWrite", {{"sessionId", session}});
+    assert(r["success"] == false);
+
+    std::cout << "✓ Test 2 passed\n\n";
+}
+
+// Test 3: Abort and handler teardown discard temp files and keep the original
+void test_session_abort() {
+    std::cout << "Test 3: Session abort...\n";
+
+    auto dir = tempDir("crossdev_write_file_test3");
+    std::string target = (dir / "keep.txt").string();
+    { std::ofstream(target) << "original"; }
+    {
+        auto handler = createWriteFileHandler();
+        std::string session = call(*handler, "openWrite", {{"path", target}})["sessionId"];
+        nlohmann::json r = call(*handler, "appendChunk", {{"sessionId", session}, {"data", encode("partial")}});
+        assert(r["success"] == true);
+        r = call(*handler, "abortWrite", {{"sessionId", session}});
+        assert(r["success"] == true);
+        assert(fileCount(dir) == 1);
+
+        // Left open: cleaned up when the handler (and its WebView) goes away
+        std::string open = call(*handler, "openWrite", {{"path", target}})["sessionId"];
+        r = call(*handler, "appendChunk", {{"sessionId", open}, {"data", encode("partial")}});
+        assert(r["success"] == true);
+        assert(fileCount(dir) == 2);
+    }
+    assert(fileCount(dir) == 1);
+    assert(readAll(target) == "original");
+
+    std::cout << "✓ Test 3 passed\n\n";
+}
+
+// Test 4: Padded base64 round-trips for every tail length
+void test_padding() {
+    std::cout << "Test 4: Base64 padding...\n";
+
+    auto dir = tempDir("crossdev_write_file_test4");
+    auto handler = createWriteFileHandler();
+    std::string target = (dir / "pad.bin").string();
+    for (std::string s : {"a", "ab", "abc", "abcd"}) {
+        nlohmann::json r = call(*handler, "writeFile", {{"path", target}, {"data", encode(s)}});
+        assert(r["success"] == true);
+        assert(readAll(target) == s);
+    }
+    assert(base64::decode("YQ=a").empty());
+    assert(base64::decode("Y===").empty());
+    assert(base64::decode("YQ==YQ==").empty());
+
+    std::cout << "✓ Test 4 passed\n\n";
+}
+
+#ifndef _WIN32
+// Test 5: Writes go through symlinks (dangling ones too) and keep hard links together
+void test_links() {
+    std::cout << "Test 5: Symlinks and hard links...\n";
+
+    namespace fs = std::filesystem;
+    auto dir = tempDir("crossdev_write_file_test5");
+    fs::create_directories(dir / "real");
+    auto handler = createWriteFileHandler();
+    {
+        std::ofstream(dir / "real" / "data.txt") << "old";
+    }
+    fs::create_symlink(fs::path("real") / "data.txt", dir / "link.txt");
+
+    nlohmann::json r = call(*handler, "writeFile", {{"path", (dir / "link.txt").string()}, {"data", encode("via link")}});
+    assert(r["success"] == true);
+    assert(fs::is_symlink(fs::symlink_status(dir / "link.txt")));
+    assert(readAll(dir / "real" / "data.txt") == "via link");
+    assert(fileCount(dir / "real") == 1 && fileCount(dir) == 2);
+
+    // Streamed, through a dangling link: the file it names is created
+    fs::create_symlink(dir / "real" / "new.txt", dir / "dangling.txt");
+    r = call(*handler, "openWrite", {{"path", (dir / "dangling.txt").string()}});
+    assert(r["success"] == true);
+    std::string session = r["sessionId"];
+    r = call(*handler, "appendChunk", {{"sessionId", session}, {"data", encode("created")}});
+    assert(r["success"] == true);
+    r = call(*handler, "commitWrite", {{"sessionId", session}});
+    assert(r["success"] == true);
+    assert(fs::is_symlink(fs::symlink_status(dir / "dangling.txt")));
+    assert(readAll(dir / "real" / "new.txt") == "created");
+
+    fs::create_hard_link(dir / "real" / "data.txt", dir / "hard.txt");
+    r = call(*handler, "writeFile", {{"path", (dir / "hard.txt").string()}, {"data", encode("both names")}});
+    assert(r["success"] == true);
+    assert(fs::hard_link_count(dir / "hard.txt") == 2);
+    assert(readAll(dir / "real" / "data.txt") == "both names" && readAll(dir / "link.txt") == "both names");
+    assert(fileCount(dir) == 4 && fileCount(dir / "real") == 2);
+
+    fs::remove_all(dir);
+    std::cout << "✓ Test 5 passed\n\n";
+}
+#endif
+
+int main() {
+    std::cout << "=== WriteFile Handler Tests ===\n\n";
+
+    test_write_file();
+    test_session_commit();
+    test_session_abort();
+    test_padding();
+#ifndef _WIN32
+    test_links();
+#endif
+
+    std::cout << "=== All tests passed! ===\n";
+    return 0;
+}